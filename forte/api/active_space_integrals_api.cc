@@ -29,6 +29,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include "helpers/helpers.h"
 #include "integrals/active_space_integrals.h"
 
 namespace py = pybind11;
@@ -57,6 +58,36 @@ void export_ActiveSpaceIntegrals(py::module& m) {
         .def("tei_aa", &ActiveSpaceIntegrals::tei_aa, "alpha-alpha two-electron integral <pq||rs>")
         .def("tei_ab", &ActiveSpaceIntegrals::tei_ab, "alpha-beta two-electron integral <pq|rs>")
         .def("tei_bb", &ActiveSpaceIntegrals::tei_bb, "beta-beta two-electron integral <pq||rs>")
+        .def(
+            "oei_a_array",
+            [](ActiveSpaceIntegrals& ints) {
+                return vector_to_np(ints.oei_a_vector(), std::vector<size_t>(2, ints.nmo()));
+            },
+            "Return the alpha effective one-electron integrals as a dense array")
+        .def(
+            "oei_b_array",
+            [](ActiveSpaceIntegrals& ints) {
+                return vector_to_np(ints.oei_b_vector(), std::vector<size_t>(2, ints.nmo()));
+            },
+            "Return the beta effective one-electron integrals as a dense array")
+        .def(
+            "tei_aa_array",
+            [](ActiveSpaceIntegrals& ints) {
+                return vector_to_np(ints.tei_aa_vector(), std::vector<size_t>(4, ints.nmo()));
+            },
+            "Return the alpha-alpha two-electron integrals <pq||rs> as a dense array")
+        .def(
+            "tei_ab_array",
+            [](ActiveSpaceIntegrals& ints) {
+                return vector_to_np(ints.tei_ab_vector(), std::vector<size_t>(4, ints.nmo()));
+            },
+            "Return the alpha-beta two-electron integrals <pq|rs> as a dense array")
+        .def(
+            "tei_bb_array",
+            [](ActiveSpaceIntegrals& ints) {
+                return vector_to_np(ints.tei_bb_vector(), std::vector<size_t>(4, ints.nmo()));
+            },
+            "Return the beta-beta two-electron integrals <pq||rs> as a dense array")
         .def("print", &ActiveSpaceIntegrals::print, "Print the integrals (alpha-alpha case)");
 }
 
@@ -64,6 +64,7 @@
 #include "integrals/one_body_integrals.h"
 #include "sci/tdci.h"
 #include "genci/ci_occupation.h"
+#include "v2rdm/v2rdm.h"
 
 #include "post_process/spin_corr.h"
 
@@ -115,6 +116,8 @@ void export_ActiveSpaceSolver(py::module& m) {
              "Return a map of StateInfo to the computed nroots of energies")
         .def("set_active_space_integrals", &ActiveSpaceSolver::set_active_space_integrals,
              "Set the active space integrals manually")
+        .def("set_warm_start", &ActiveSpaceSolver::set_warm_start, "value"_a,
+             "Warm start the next computation from the previous solution")
         .def("set_Uactv", &ActiveSpaceSolver::set_Uactv,
              "Set unitary matrices for changing orbital basis in RDMs when computing dipoles")
         .def("compute_dipole_moment", &ActiveSpaceSolver::compute_dipole_moment,
@@ -200,6 +203,8 @@ PYBIND11_MODULE(_forte, m) {
     m.def("make_ints_from_psi4", &make_forte_integrals_from_psi4, "ref_wfn"_a, "options"_a,
           "mo_space_info"_a, "int_type"_a = "", "Make a Forte integral object from psi4");
     m.def("make_active_space_method", &make_active_space_method, "Make an active space method");
+    m.def("write_v2rdm_densities", &write_v2rdm_densities, "rdms"_a, "mo_space_info"_a,
+          "Write spin-dependent RDMs to the PSIO files in the format of v2RDM-CASSCF");
     m.def("make_active_space_solver", &make_active_space_solver, "Make an active space solver",
           "method"_a, "state_nroots_map"_a, "scf_info"_a, "mo_space_info"_a, "options"_a,
           "as_ints"_a = std::shared_ptr<ActiveSpaceIntegrals>());
@@ -355,6 +360,8 @@ PYBIND11_MODULE(_forte, m) {
     py::class_<MASTER_DSRG>(m, "MASTER_DSRG")
         .def("compute_energy", &MASTER_DSRG::compute_energy, "Compute the DSRG energy")
         .def("compute_gradient", &MASTER_DSRG::compute_gradient, "Compute the DSRG gradient")
+        .def("compute_energy_multi_state", &MASTER_DSRG::compute_energy_multi_state,
+             "Compute the MS or XMS DSRG energies")
         .def("compute_Heff_actv", &MASTER_DSRG::compute_Heff_actv,
              "Return the DSRG dressed ActiveSpaceIntegrals")
         .def("deGNO_DMbar_actv", &MASTER_DSRG::deGNO_DMbar_actv,
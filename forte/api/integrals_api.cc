@@ -31,8 +31,10 @@
 
 #include "helpers/helpers.h"
 #include "integrals/integrals.h"
+#include "integrals/paralleldfmo.h"
 
 namespace py = pybind11;
+using namespace pybind11::literals;
 
 namespace forte {
 
@@ -40,6 +42,8 @@ namespace forte {
 void export_ForteIntegrals(py::module& m) {
     py::class_<ForteIntegrals, std::shared_ptr<ForteIntegrals>>(m, "ForteIntegrals")
         .def("rotate_orbitals", &ForteIntegrals::rotate_orbitals, "Rotate MOs during contructor")
+        .def("rotate_integrals", &ForteIntegrals::rotate_integrals,
+             "Rotate MOs and the stored integrals in place (no new integral transformation)")
         .def("Ca", &ForteIntegrals::Ca, "Return the alpha MO coefficients")
         .def("Cb", &ForteIntegrals::Cb, "Return the beta MO coefficients")
         .def("nmo", &ForteIntegrals::nmo, "Return the total number of moleuclar orbitals")
@@ -83,6 +87,13 @@ void export_ForteIntegrals(py::module& m) {
                 return ambit_to_np(ints.aptei_bb_block(p, q, r, s));
             },
             "Return the beta-beta 2e-integrals in physicists' notation")
+        .def(
+            "three_integral_block",
+            [](ForteIntegrals& ints, const std::vector<size_t>& A, const std::vector<size_t>& p,
+               const std::vector<size_t>& q) {
+                return ambit_to_np(ints.three_integral_block(A, p, q));
+            },
+            "Return the three-index integrals (A|pq) (DF and Cholesky integrals)")
         .def("set_nuclear_repulsion", &ForteIntegrals::set_nuclear_repulsion,
              "Set the nuclear repulsion energy")
         .def("set_scalar", &ForteIntegrals::set_scalar, "Set the scalar energy")
@@ -90,5 +101,19 @@ void export_ForteIntegrals(py::module& m) {
         .def("set_tei", &ForteIntegrals::set_tei_all, "Set the two-electron integrals")
         .def("initialize", &ForteIntegrals::initialize, "Initialize the integrals")
         .def("print_ints", &ForteIntegrals::print_ints, "Print the integrals");
+
+    py::class_<ParallelDFMO, std::shared_ptr<ParallelDFMO>>(m, "ParallelDFMO")
+        .def(py::init<std::shared_ptr<psi::BasisSet>, std::shared_ptr<psi::BasisSet>>(),
+             "primary"_a, "auxiliary"_a)
+        .def("set_C", &ParallelDFMO::set_C, "Set the MO coefficients in the AO basis")
+        .def("set_distributed", &ParallelDFMO::set_distributed,
+             "Store the integrals in a Global Array (true) or in this process (false)")
+        .def("set_memory", &ParallelDFMO::set_memory,
+             "Set the memory (in bytes) available to this process")
+        .def("set_print", &ParallelDFMO::set_print, "Set the print level")
+        .def("compute_integrals", &ParallelDFMO::compute_integrals,
+             "Compute the fitted MO three-index integrals (Q|pq)")
+        .def("Q_PQ_local", &ParallelDFMO::Q_PQ_local,
+             "Return the (Q|pq) integrals as a naux x (nmo * nmo) matrix (threaded mode)");
 }
 } // namespace forte
@@ -43,10 +43,12 @@
 #include "genci/genci_string_lists.h"
 #include "genci/genci_vector.h"
 
+#include "base_classes/forte_options.h"
 #include "base_classes/mo_space_info.h"
 
 #include "sparse_ci/determinant.h"
 #include "sparse_ci/determinant_hashvector.h"
+#include "sparse_ci/ci_reference.h"
 #include "sparse_ci/sparse_state_vector.h"
 #include "sparse_ci/sparse_operator.h"
 #include "sparse_ci/sparse_fact_exp.h"
@@ -252,10 +254,38 @@ void export_Determinant(py::module& m) {
         .def(py::init<const det_hashvec&>())
         .def("add", &DeterminantHashVec::add, "Add a determinant")
         .def("size", &DeterminantHashVec::size, "Get the size of the vector")
+        .def("reserve", &DeterminantHashVec::reserve, "Reserve space for a number of determinants")
         .def("determinants", &DeterminantHashVec::determinants, "Return a vector of Determinants")
         .def("get_det", &DeterminantHashVec::get_det, "Return a specific determinant by reference")
         .def("get_idx", &DeterminantHashVec::get_idx, " Return the index of a determinant");
 
+    py::class_<CI_Reference>(m, "CI_Reference", "A class to build reference determinant spaces")
+        .def(py::init<std::shared_ptr<SCFInfo>, std::shared_ptr<ForteOptions>,
+                      std::shared_ptr<MOSpaceInfo>, std::shared_ptr<ActiveSpaceIntegrals>, int,
+                      double, int, StateInfo>(),
+             "scf_info"_a, "options"_a, "mo_space_info"_a, "as_ints"_a, "multiplicity"_a,
+             "twice_ms"_a, "symmetry"_a, "state_info"_a)
+        .def(
+            "build_cas_reference_full",
+            [](CI_Reference& ref) {
+                DeterminantHashVec ref_space;
+                ref.build_cas_reference_full(ref_space);
+                return ref_space;
+            },
+            "Return all the determinants of the CAS space")
+        .def("cas_reference_size", &CI_Reference::cas_reference_size,
+             "Return the number of determinants of the CAS space")
+        .def(
+            "build_gas_reference",
+            [](CI_Reference& ref) {
+                DeterminantHashVec ref_space;
+                ref.build_gas_reference(ref_space);
+                return ref_space;
+            },
+            "Return all the determinants of the GAS space")
+        .def("gas_reference_size", &CI_Reference::gas_reference_size,
+             "Return the number of determinants of the GAS space");
+
     py::class_<FCIStringAddress>(m, "StringAddress", "A class to compute the address of a string")
         .def(py::init<int, int, const std::vector<std::vector<String>>&>(),
              "Construct a StringAddress object from a list of lists of strings")
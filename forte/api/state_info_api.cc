@@ -59,6 +59,19 @@ void export_StateInfo(py::module& m) {
         .def("gas_max", &StateInfo::gas_max, "The maximum occupation of each gas state")
         .def("__eq__", [](const StateInfo& a, const StateInfo& b) { return a == b; })
         .def("__lt__", [](const StateInfo& a, const StateInfo& b) { return a < b; })
-        .def("__hash__", [](const StateInfo& a) { return a.hash(); });
+        .def("__hash__", [](const StateInfo& a) { return a.hash(); })
+        .def(py::pickle(
+            [](const StateInfo& a) {
+                return py::make_tuple(a.na(), a.nb(), a.multiplicity(), a.twice_ms(), a.irrep(),
+                                      a.irrep_label(), a.gas_min(), a.gas_max());
+            },
+            [](py::tuple t) {
+                if (t.size() != 8)
+                    throw std::runtime_error("Invalid state for StateInfo");
+                return std::make_shared<StateInfo>(
+                    t[0].cast<int>(), t[1].cast<int>(), t[2].cast<int>(), t[3].cast<int>(),
+                    t[4].cast<int>(), t[5].cast<std::string>(), t[6].cast<std::vector<size_t>>(),
+                    t[7].cast<std::vector<size_t>>());
+            }));
 }
 } // namespace forte
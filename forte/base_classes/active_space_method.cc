@@ -48,6 +48,7 @@
 #include "pci/pci.h"
 #include "ci_ex_states/excited_state_solver.h"
 #include "external/external_active_space_method.h"
+#include "v2rdm/v2rdm.h"
 #ifdef HAVE_CHEMPS2
 #include "dmrg/dmrgsolver.h"
 #endif
@@ -80,6 +81,8 @@ void ActiveSpaceMethod::set_maxiter(size_t value) { maxiter_ = value; }
 
 void ActiveSpaceMethod::set_read_wfn_guess(bool read) { read_wfn_guess_ = read; }
 
+void ActiveSpaceMethod::set_warm_start(bool value) { warm_start_ = value; }
+
 void ActiveSpaceMethod::set_dump_wfn(bool dump) { dump_wfn_ = dump; }
 
 void ActiveSpaceMethod::set_dump_trdm(bool dump) { dump_trdm_ = dump; }
@@ -465,6 +468,8 @@ std::shared_ptr<ActiveSpaceMethod> make_active_space_method(
             std::make_unique<ProjectorCI>(state, nroot, scf_info, options, mo_space_info, as_ints));
     } else if (type == "EXTERNAL") {
         method = std::make_unique<ExternalActiveSpaceMethod>(state, nroot, mo_space_info, as_ints);
+    } else if (type == "V2RDM") {
+        method = std::make_unique<V2RDM>(state, nroot, mo_space_info, as_ints);
     } else if (type == "DMRG") {
 #ifdef HAVE_CHEMPS2
         method =
@@ -268,6 +268,11 @@ class ActiveSpaceMethod {
         throw std::runtime_error("ActiveSpaceMethod::ci_wave_functions: Not yet implemented!");
     }
 
+    /// @return the determinants of the CI wave functions returned by ci_wave_functions()
+    virtual DeterminantHashVec ci_determinants() {
+        throw std::runtime_error("ActiveSpaceMethod::ci_determinants: Not yet implemented!");
+    }
+
     // ==> Base Class Functionality (inherited by derived classes) <==
 
     /// Pass a set of ActiveSpaceIntegrals to the solver (e.g. an effective Hamiltonian)
@@ -315,6 +320,12 @@ class ActiveSpaceMethod {
     /// Set if we dump the wave function to disk
     void set_read_wfn_guess(bool read);
 
+    /// Set if the next call to compute_energy() should be warm started from the previous one.
+    /// When true, solvers that support this option reuse the integral-independent intermediates
+    /// (string lists, determinant spaces) and use the previous CI vectors as the initial guess.
+    /// Only the integral-dependent quantities (e.g. the Hamiltonian diagonal) are recomputed.
+    void set_warm_start(bool value);
+
     /// Set if we dump the wave function to disk
     void set_dump_wfn(bool dump);
 
@@ -396,6 +407,8 @@ class ActiveSpaceMethod {
 
     /// Read wave function from disk as initial guess?
     bool read_wfn_guess_ = false;
+    /// Warm start from the previous call to compute_energy()?
+    bool warm_start_ = false;
     /// Dump transition density matrix to disk?
     bool dump_trdm_ = false;
     /// Dump wave function to disk?
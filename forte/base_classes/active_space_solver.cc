@@ -124,8 +124,8 @@ const std::map<StateInfo, std::vector<double>>& ActiveSpaceSolver::compute_energ
         const auto& state = state_nroot.first;
         size_t nroot = state_nroot.second;
 
-        // so far only FCI and DETCI supports restarting from a previous wavefunction
-        if ((method_ == "FCI") or (method_ == "DETCI")) {
+        // so far only FCI, DETCI, and DMRG support restarting from a previous wavefunction
+        if ((method_ == "FCI") or (method_ == "DETCI") or (method_ == "DMRG")) {
             auto [it, inserted] = state_method_map_.try_emplace(state);
             if (inserted) {
                 it->second = make_active_space_method(method_, state, nroot, scf_info_,
@@ -147,6 +147,7 @@ const std::map<StateInfo, std::vector<double>>& ActiveSpaceSolver::compute_energ
             state_filename_map_[state] = method->wfn_filename();
             method->set_read_wfn_guess(read_initial_guess_);
         }
+        method->set_warm_start(warm_start_);
 
         // compute the energy of state and save it
         method->compute_energy();
@@ -657,6 +658,12 @@ std::map<StateInfo, std::shared_ptr<psi::Matrix>> ActiveSpaceSolver::state_ci_wf
     return out;
 }
 
+std::pair<DeterminantHashVec, std::shared_ptr<psi::Matrix>>
+ActiveSpaceSolver::state_ci_wfn(const StateInfo& state) const {
+    const auto& method = state_method_map_.at(state);
+    return {method->ci_determinants(), method->ci_wave_functions()};
+}
+
 const std::map<StateInfo, std::vector<double>>&
 ActiveSpaceSolver::compute_contracted_energy(std::shared_ptr<ActiveSpaceIntegrals> as_ints,
                                              int max_rdm_level) {
@@ -168,6 +168,9 @@ class ActiveSpaceSolver {
     const std::map<StateInfo, std::vector<double>>& state_energies_map() const;
     /// Return a map of StateInfo to the CI wave functions (deterministic determinant space)
     std::map<StateInfo, std::shared_ptr<psi::Matrix>> state_ci_wfn_map() const;
+    /// Return the determinants and the CI wave functions of a given state
+    std::pair<DeterminantHashVec, std::shared_ptr<psi::Matrix>>
+    state_ci_wfn(const StateInfo& state) const;
 
     /// Pass a set of ActiveSpaceIntegrals to the solver (e.g. an effective Hamiltonian)
     /// @param as_ints the pointer to a set of active-space integrals
@@ -195,6 +198,10 @@ class ActiveSpaceSolver {
     /// Set if read wave function from file as initial guess
     void set_read_initial_guess(bool read_guess) { read_initial_guess_ = read_guess; }
 
+    /// Set if compute_energy() should be warm started from the previous solution (e.g. when the
+    /// integrals change slightly during the DSRG reference relaxation)
+    void set_warm_start(bool value) { warm_start_ = value; }
+
     /// Return the eigen vectors for a given state
     std::vector<ambit::Tensor> eigenvectors(const StateInfo& state) const;
     /// Set unitary matrices for changing orbital basis in RDMs when computing dipole moments
@@ -264,6 +271,9 @@ class ActiveSpaceSolver {
     /// Read wave function from disk as initial guess
     bool read_initial_guess_;
 
+    /// Warm start the active space methods from their previous solution
+    bool warm_start_ = false;
+
     /// Only print the transitions between states with different gas
     bool gas_diff_only_;
 
@@ -62,6 +62,7 @@ void DynamicCorrelationSolver::startup() {
     diis_freq_ = foptions_->get_int("DSRG_DIIS_FREQ");
     diis_min_vec_ = foptions_->get_int("DSRG_DIIS_MIN_VEC");
     diis_max_vec_ = foptions_->get_int("DSRG_DIIS_MAX_VEC");
+    diis_storage_ = foptions_->get_str("DSRG_DIIS_STORAGE");
     if (diis_min_vec_ < 1) {
         diis_min_vec_ = 1;
     }
@@ -149,6 +149,8 @@ class DynamicCorrelationSolver {
     int diis_max_vec_;
     /// Frequency of extrapolating the current DIIS vectors
     int diis_freq_;
+    /// Storage of the DIIS vectors (PSI4, DISK, or DISK_COMPRESSED)
+    std::string diis_storage_;
 
     // ==> amplitudes file names <==
 
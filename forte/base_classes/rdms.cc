@@ -187,89 +187,216 @@ ambit::Tensor RDMs::SF_L2() const {
     _test_rdm_level(2, "L2");
     timer t("make_cumulant_L2");
     auto G1 = SF_G1();
-    auto L2 = SF_G2().clone();
-    L2("pqrs") -= G1("pr") * G1("qs");
-    L2("pqrs") += 0.5 * G1("ps") * G1("qr");
-    L2.set_name("SF_L2");
+    auto G2 = SF_G2();
+    const auto& g1 = G1.data();
+    const auto& g2 = G2.data();
+
+    auto L2 = ambit::Tensor::build(ambit::CoreTensor, "SF_L2", G2.dims());
+    auto& l2 = L2.data();
+    const size_t n = G1.dim(0);
+#pragma omp parallel for collapse(2)
+    for (size_t p = 0; p < n; ++p) {
+        for (size_t q = 0; q < n; ++q) {
+            for (size_t r = 0; r < n; ++r) {
+                for (size_t s = 0; s < n; ++s) {
+                    const size_t pqrs = ((p * n + q) * n + r) * n + s;
+                    l2[pqrs] = g2[pqrs] - g1[p * n + r] * g1[q * n + s] +
+                               0.5 * g1[p * n + s] * g1[q * n + r];
+                }
+            }
+        }
+    }
     return L2;
 }
 
+namespace {
+/// The permutational symmetry of a 3-body tensor T(pqr,stu) with respect to a simultaneous
+/// exchange of the index pairs (p,s), (q,t), and (r,u)
+enum class PairSymmetry {
+    /// invariant to all permutations of the three pairs
+    Full,
+    /// invariant to the exchange of the first two pairs
+    First2,
+    /// invariant to the exchange of the last two pairs
+    Last2
+};
+
+/// @brief Fill a 3-body tensor of dimension n^6 by evaluating fn(p,q,r,s,t,u) only for the
+///        symmetry-unique pairs (ps), (qt), (ru) and copying the value to the equivalent elements
+///
+/// The unique elements are those with compound pair indices (ps) <= (qt) <= (ru) (Full),
+/// (ps) <= (qt) (First2), or (qt) <= (ru) (Last2).
+/// Each element of T is written by one iteration only, so the outer loop is run in parallel.
+template <typename Fn> void fill_pair_symmetric(ambit::Tensor& T, PairSymmetry sym, Fn&& fn) {
+    const size_t n = T.dim(0);
+    const size_t n2 = n * n;
+    auto& data = T.data();
+
+    auto address = [n](size_t a, size_t b, size_t c) {
+        const size_t p = a / n, s = a % n;
+        const size_t q = b / n, t = b % n;
+        const size_t r = c / n, u = c % n;
+        return ((((p * n + q) * n + r) * n + s) * n + t) * n + u;
+    };
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t a = 0; a < n2; ++a) {
+        const size_t p = a / n, s = a % n;
+        for (size_t b = (sym == PairSymmetry::Last2 ? 0 : a); b < n2; ++b) {
+            const size_t q = b / n, t = b % n;
+            for (size_t c = (sym == PairSymmetry::First2 ? 0 : b); c < n2; ++c) {
+                const size_t r = c / n, u = c % n;
+                const double value = fn(p, q, r, s, t, u);
+                data[address(a, b, c)] = value;
+                if (sym == PairSymmetry::Full) {
+                    data[address(a, c, b)] = value;
+                    data[address(b, a, c)] = value;
+                    data[address(b, c, a)] = value;
+                    data[address(c, a, b)] = value;
+                    data[address(c, b, a)] = value;
+                } else if (sym == PairSymmetry::First2) {
+                    data[address(b, a, c)] = value;
+                } else {
+                    data[address(a, c, b)] = value;
+                }
+            }
+        }
+    }
+}
+} // namespace
+
 ambit::Tensor RDMs::SF_L3() const {
     _test_rdm_level(3, "SF_L3");
     timer t("make_cumulant_L3");
 
     auto G1 = SF_G1();
     auto G2 = SF_G2();
-    auto L3 = SF_G3().clone();
-
-    L3("pqrstu") -= G1("ps") * G2("qrtu");
-    L3("pqrstu") -= G1("qt") * G2("prsu");
-    L3("pqrstu") -= G1("ru") * G2("pqst");
-
-    L3("pqrstu") += 0.5 * G1("pt") * G2("qrsu");
-    L3("pqrstu") += 0.5 * G1("pu") * G2("qrts");
-
-    L3("pqrstu") += 0.5 * G1("qs") * G2("prtu");
-    L3("pqrstu") += 0.5 * G1("qu") * G2("prst");
-
-    L3("pqrstu") += 0.5 * G1("rs") * G2("pqut");
-    L3("pqrstu") += 0.5 * G1("rt") * G2("pqsu");
-
-    L3("pqrstu") += 2.0 * G1("ps") * G1("qt") * G1("ru");
-
-    L3("pqrstu") -= G1("ps") * G1("qu") * G1("rt");
-    L3("pqrstu") -= G1("pu") * G1("qt") * G1("rs");
-    L3("pqrstu") -= G1("pt") * G1("qs") * G1("ru");
-
-    L3("pqrstu") += 0.5 * G1("pt") * G1("qu") * G1("rs");
-    L3("pqrstu") += 0.5 * G1("pu") * G1("qs") * G1("rt");
-
-    L3.set_name("SF_L3");
+    auto G3 = SF_G3();
+    const auto& g1 = G1.data();
+    const auto& g2 = G2.data();
+    const auto& g3 = G3.data();
+    const size_t n = G1.dim(0);
+
+    auto L3 = ambit::Tensor::build(ambit::CoreTensor, "SF_L3", G3.dims());
+    fill_pair_symmetric(L3, PairSymmetry::Full, [&](size_t p, size_t q, size_t r, size_t s,
+                                                    size_t t, size_t u) {
+        auto G1_ = [&](size_t i, size_t j) { return g1[i * n + j]; };
+        auto G2_ = [&](size_t i, size_t j, size_t k, size_t l) {
+            return g2[((i * n + j) * n + k) * n + l];
+        };
+        double value = g3[((((p * n + q) * n + r) * n + s) * n + t) * n + u];
+
+        value -= G1_(p, s) * G2_(q, r, t, u);
+        value -= G1_(q, t) * G2_(p, r, s, u);
+        value -= G1_(r, u) * G2_(p, q, s, t);
+
+        value += 0.5 * G1_(p, t) * G2_(q, r, s, u);
+        value += 0.5 * G1_(p, u) * G2_(q, r, t, s);
+
+        value += 0.5 * G1_(q, s) * G2_(p, r, t, u);
+        value += 0.5 * G1_(q, u) * G2_(p, r, s, t);
+
+        value += 0.5 * G1_(r, s) * G2_(p, q, u, t);
+        value += 0.5 * G1_(r, t) * G2_(p, q, s, u);
+
+        value += 2.0 * G1_(p, s) * G1_(q, t) * G1_(r, u);
+
+        value -= G1_(p, s) * G1_(q, u) * G1_(r, t);
+        value -= G1_(p, u) * G1_(q, t) * G1_(r, s);
+        value -= G1_(p, t) * G1_(q, s) * G1_(r, u);
+
+        value += 0.5 * G1_(p, t) * G1_(q, u) * G1_(r, s);
+        value += 0.5 * G1_(p, u) * G1_(q, s) * G1_(r, t);
+        return value;
+    });
     return L3;
 }
 
 ambit::Tensor RDMs::make_cumulant_L2aa(const ambit::Tensor& g1a, const ambit::Tensor& g2aa) {
     timer t("make_cumulant_L2aa");
-    auto L2aa = g2aa.clone();
-    L2aa("pqrs") -= g1a("pr") * g1a("qs");
-    L2aa("pqrs") += g1a("ps") * g1a("qr");
+    const auto& g1 = g1a.data();
+    const auto& g2 = g2aa.data();
+
+    auto L2aa = ambit::Tensor::build(ambit::CoreTensor, "L2aa", g2aa.dims());
+    auto& l2 = L2aa.data();
+    const size_t n = g1a.dim(0);
+#pragma omp parallel for collapse(2)
+    for (size_t p = 0; p < n; ++p) {
+        for (size_t q = 0; q < n; ++q) {
+            for (size_t r = 0; r < n; ++r) {
+                for (size_t s = 0; s < n; ++s) {
+                    const size_t pqrs = ((p * n + q) * n + r) * n + s;
+                    l2[pqrs] = g2[pqrs] - g1[p * n + r] * g1[q * n + s] +
+                               g1[p * n + s] * g1[q * n + r];
+                }
+            }
+        }
+    }
     return L2aa;
 }
 
 ambit::Tensor RDMs::make_cumulant_L2ab(const ambit::Tensor& g1a, const ambit::Tensor& g1b,
                                        const ambit::Tensor& g2ab) {
     timer t("make_cumulant_L2ab");
-    auto L2ab = g2ab.clone();
-    L2ab("pqrs") -= g1a("pr") * g1b("qs");
+    const auto& ga = g1a.data();
+    const auto& gb = g1b.data();
+    const auto& g2 = g2ab.data();
+
+    auto L2ab = ambit::Tensor::build(ambit::CoreTensor, "L2ab", g2ab.dims());
+    auto& l2 = L2ab.data();
+    const size_t n = g1a.dim(0);
+#pragma omp parallel for collapse(2)
+    for (size_t p = 0; p < n; ++p) {
+        for (size_t q = 0; q < n; ++q) {
+            for (size_t r = 0; r < n; ++r) {
+                for (size_t s = 0; s < n; ++s) {
+                    const size_t pqrs = ((p * n + q) * n + r) * n + s;
+                    l2[pqrs] = g2[pqrs] - ga[p * n + r] * gb[q * n + s];
+                }
+            }
+        }
+    }
     return L2ab;
 }
 
 ambit::Tensor RDMs::make_cumulant_L3aaa(const ambit::Tensor& g1a, const ambit::Tensor& g2aa,
                                         const ambit::Tensor& g3aaa) {
     timer t("make_cumulant_L3aaa");
-
-    auto L3aaa = g3aaa.clone();
-
-    L3aaa("pqrstu") -= g1a("ps") * g2aa("qrtu");
-    L3aaa("pqrstu") += g1a("pt") * g2aa("qrsu");
-    L3aaa("pqrstu") += g1a("pu") * g2aa("qrts");
-
-    L3aaa("pqrstu") -= g1a("qt") * g2aa("prsu");
-    L3aaa("pqrstu") += g1a("qs") * g2aa("prtu");
-    L3aaa("pqrstu") += g1a("qu") * g2aa("prst");
-
-    L3aaa("pqrstu") -= g1a("ru") * g2aa("pqst");
-    L3aaa("pqrstu") += g1a("rs") * g2aa("pqut");
-    L3aaa("pqrstu") += g1a("rt") * g2aa("pqsu");
-
-    L3aaa("pqrstu") += 2.0 * g1a("ps") * g1a("qt") * g1a("ru");
-    L3aaa("pqrstu") += 2.0 * g1a("pt") * g1a("qu") * g1a("rs");
-    L3aaa("pqrstu") += 2.0 * g1a("pu") * g1a("qs") * g1a("rt");
-
-    L3aaa("pqrstu") -= 2.0 * g1a("ps") * g1a("qu") * g1a("rt");
-    L3aaa("pqrstu") -= 2.0 * g1a("pu") * g1a("qt") * g1a("rs");
-    L3aaa("pqrstu") -= 2.0 * g1a("pt") * g1a("qs") * g1a("ru");
-
+    const auto& g1 = g1a.data();
+    const auto& g2 = g2aa.data();
+    const auto& g3 = g3aaa.data();
+    const size_t n = g1a.dim(0);
+
+    auto L3aaa = ambit::Tensor::build(ambit::CoreTensor, "L3aaa", g3aaa.dims());
+    fill_pair_symmetric(L3aaa, PairSymmetry::Full, [&](size_t p, size_t q, size_t r, size_t s,
+                                                       size_t t, size_t u) {
+        auto G1_ = [&](size_t i, size_t j) { return g1[i * n + j]; };
+        auto G2_ = [&](size_t i, size_t j, size_t k, size_t l) {
+            return g2[((i * n + j) * n + k) * n + l];
+        };
+        double value = g3[((((p * n + q) * n + r) * n + s) * n + t) * n + u];
+
+        value -= G1_(p, s) * G2_(q, r, t, u);
+        value += G1_(p, t) * G2_(q, r, s, u);
+        value += G1_(p, u) * G2_(q, r, t, s);
+
+        value -= G1_(q, t) * G2_(p, r, s, u);
+        value += G1_(q, s) * G2_(p, r, t, u);
+        value += G1_(q, u) * G2_(p, r, s, t);
+
+        value -= G1_(r, u) * G2_(p, q, s, t);
+        value += G1_(r, s) * G2_(p, q, u, t);
+        value += G1_(r, t) * G2_(p, q, s, u);
+
+        value += 2.0 * G1_(p, s) * G1_(q, t) * G1_(r, u);
+        value += 2.0 * G1_(p, t) * G1_(q, u) * G1_(r, s);
+        value += 2.0 * G1_(p, u) * G1_(q, s) * G1_(r, t);
+
+        value -= 2.0 * G1_(p, s) * G1_(q, u) * G1_(r, t);
+        value -= 2.0 * G1_(p, u) * G1_(q, t) * G1_(r, s);
+        value -= 2.0 * G1_(p, t) * G1_(q, s) * G1_(r, u);
+        return value;
+    });
     return L3aaa;
 }
 
@@ -277,19 +404,33 @@ ambit::Tensor RDMs::make_cumulant_L3aab(const ambit::Tensor& g1a, const ambit::T
                                         const ambit::Tensor& g2aa, const ambit::Tensor& g2ab,
                                         const ambit::Tensor& g3aab) {
     timer t("make_cumulant_L3aab");
-
-    auto L3aab = g3aab.clone();
-    L3aab("pqRstU") -= g1b("RU") * g2aa("pqst");
-
-    L3aab("pqRstU") -= g1a("ps") * g2ab("qRtU");
-    L3aab("pqRstU") += g1a("pt") * g2ab("qRsU");
-
-    L3aab("pqRstU") -= g1a("qt") * g2ab("pRsU");
-    L3aab("pqRstU") += g1a("qs") * g2ab("pRtU");
-
-    L3aab("pqRstU") += 2.0 * g1a("ps") * g1a("qt") * g1b("RU");
-    L3aab("pqRstU") -= 2.0 * g1a("pt") * g1a("qs") * g1b("RU");
-
+    const auto& ga = g1a.data();
+    const auto& gb = g1b.data();
+    const auto& gaa = g2aa.data();
+    const auto& gab = g2ab.data();
+    const auto& g3 = g3aab.data();
+    const size_t n = g1a.dim(0);
+
+    auto L3aab = ambit::Tensor::build(ambit::CoreTensor, "L3aab", g3aab.dims());
+    fill_pair_symmetric(L3aab, PairSymmetry::First2, [&](size_t p, size_t q, size_t R, size_t s,
+                                                         size_t t, size_t U) {
+        auto G2_ = [&](const std::vector<double>& g2, size_t i, size_t j, size_t k, size_t l) {
+            return g2[((i * n + j) * n + k) * n + l];
+        };
+        double value = g3[((((p * n + q) * n + R) * n + s) * n + t) * n + U];
+
+        value -= gb[R * n + U] * G2_(gaa, p, q, s, t);
+
+        value -= ga[p * n + s] * G2_(gab, q, R, t, U);
+        value += ga[p * n + t] * G2_(gab, q, R, s, U);
+
+        value -= ga[q * n + t] * G2_(gab, p, R, s, U);
+        value += ga[q * n + s] * G2_(gab, p, R, t, U);
+
+        value += 2.0 * ga[p * n + s] * ga[q * n + t] * gb[R * n + U];
+        value -= 2.0 * ga[p * n + t] * ga[q * n + s] * gb[R * n + U];
+        return value;
+    });
     return L3aab;
 }
 
@@ -297,19 +438,33 @@ ambit::Tensor RDMs::make_cumulant_L3abb(const ambit::Tensor& g1a, const ambit::T
                                         const ambit::Tensor& g2ab, const ambit::Tensor& g2bb,
                                         const ambit::Tensor& g3abb) {
     timer t("make_cumulant_L3abb");
-
-    auto L3abb = g3abb.clone();
-    L3abb("pQRsTU") -= g1a("ps") * g2bb("QRTU");
-
-    L3abb("pQRsTU") -= g1b("QT") * g2ab("pRsU");
-    L3abb("pQRsTU") += g1b("QU") * g2ab("pRsT");
-
-    L3abb("pQRsTU") -= g1b("RU") * g2ab("pQsT");
-    L3abb("pQRsTU") += g1b("RT") * g2ab("pQsU");
-
-    L3abb("pQRsTU") += 2.0 * g1a("ps") * g1b("QT") * g1b("RU");
-    L3abb("pQRsTU") -= 2.0 * g1a("ps") * g1b("QU") * g1b("RT");
-
+    const auto& ga = g1a.data();
+    const auto& gb = g1b.data();
+    const auto& gab = g2ab.data();
+    const auto& gbb = g2bb.data();
+    const auto& g3 = g3abb.data();
+    const size_t n = g1a.dim(0);
+
+    auto L3abb = ambit::Tensor::build(ambit::CoreTensor, "L3abb", g3abb.dims());
+    fill_pair_symmetric(L3abb, PairSymmetry::Last2, [&](size_t p, size_t Q, size_t R, size_t s,
+                                                        size_t T, size_t U) {
+        auto G2_ = [&](const std::vector<double>& g2, size_t i, size_t j, size_t k, size_t l) {
+            return g2[((i * n + j) * n + k) * n + l];
+        };
+        double value = g3[((((p * n + Q) * n + R) * n + s) * n + T) * n + U];
+
+        value -= ga[p * n + s] * G2_(gbb, Q, R, T, U);
+
+        value -= gb[Q * n + T] * G2_(gab, p, R, s, U);
+        value += gb[Q * n + U] * G2_(gab, p, R, s, T);
+
+        value -= gb[R * n + U] * G2_(gab, p, Q, s, T);
+        value += gb[R * n + T] * G2_(gab, p, Q, s, U);
+
+        value += 2.0 * ga[p * n + s] * gb[Q * n + T] * gb[R * n + U];
+        value -= 2.0 * ga[p * n + s] * gb[Q * n + U] * gb[R * n + T];
+        return value;
+    });
     return L3abb;
 }
 
@@ -334,23 +489,47 @@ ambit::Tensor RDMs::sf2_to_sd2ab(const ambit::Tensor& G2) {
 }
 
 ambit::Tensor RDMs::sf3_to_sd3aaa(const ambit::Tensor& G3) {
-    auto g3aaa = G3.clone();
-    g3aaa("pqrstu") += G3("pqrtus") + G3("pqrust");
-    g3aaa.scale(1.0 / 12.0);
+    const auto& g3 = G3.data();
+    const size_t n = G3.dim(0);
+    auto g3aaa = ambit::Tensor::build(ambit::CoreTensor, G3.name(), G3.dims());
+    fill_pair_symmetric(g3aaa, PairSymmetry::Full, [&](size_t p, size_t q, size_t r, size_t s,
+                                                       size_t t, size_t u) {
+        const size_t pqr = (p * n + q) * n + r;
+        auto G3_ = [&](size_t i, size_t j, size_t k) {
+            return g3[((pqr * n + i) * n + j) * n + k];
+        };
+        return (G3_(s, t, u) + G3_(t, u, s) + G3_(u, s, t)) / 12.0;
+    });
     return g3aaa;
 }
 
 ambit::Tensor RDMs::sf3_to_sd3aab(const ambit::Tensor& G3) {
-    auto g3aab = G3.clone();
-    g3aab("pqrstu") -= G3("pqrtus") + G3("pqrust") + 2.0 * G3("pqrtsu");
-    g3aab.scale(1.0 / 12.0);
+    const auto& g3 = G3.data();
+    const size_t n = G3.dim(0);
+    auto g3aab = ambit::Tensor::build(ambit::CoreTensor, G3.name(), G3.dims());
+    fill_pair_symmetric(g3aab, PairSymmetry::First2, [&](size_t p, size_t q, size_t r, size_t s,
+                                                         size_t t, size_t u) {
+        const size_t pqr = (p * n + q) * n + r;
+        auto G3_ = [&](size_t i, size_t j, size_t k) {
+            return g3[((pqr * n + i) * n + j) * n + k];
+        };
+        return (G3_(s, t, u) - G3_(t, u, s) - G3_(u, s, t) - 2.0 * G3_(t, s, u)) / 12.0;
+    });
     return g3aab;
 }
 
 ambit::Tensor RDMs::sf3_to_sd3abb(const ambit::Tensor& G3) {
-    auto g3abb = G3.clone();
-    g3abb("pqrstu") -= G3("pqrtus") + G3("pqrust") + 2.0 * G3("pqrsut");
-    g3abb.scale(1.0 / 12.0);
+    const auto& g3 = G3.data();
+    const size_t n = G3.dim(0);
+    auto g3abb = ambit::Tensor::build(ambit::CoreTensor, G3.name(), G3.dims());
+    fill_pair_symmetric(g3abb, PairSymmetry::Last2, [&](size_t p, size_t q, size_t r, size_t s,
+                                                        size_t t, size_t u) {
+        const size_t pqr = (p * n + q) * n + r;
+        auto G3_ = [&](size_t i, size_t j, size_t k) {
+            return g3[((pqr * n + i) * n + j) * n + k];
+        };
+        return (G3_(s, t, u) - G3_(t, u, s) - G3_(u, s, t) - 2.0 * G3_(s, u, t)) / 12.0;
+    });
     return g3abb;
 }
 
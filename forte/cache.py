@@ -0,0 +1,157 @@
+import hashlib
+import os
+import pickle
+import tempfile
+
+from forte.core import flog
+
+
+class Cache:
+    """
+    A content-addressed, on-disk cache for the outputs of nodes of a computational graph.
+
+    Each entry is identified by a key obtained by hashing a description of everything
+    that determines the output of a node (the node type, its parameters and options, and the
+    keys of its input nodes). Entries are dictionaries of picklable objects (numpy arrays,
+    floats, lists, psi4 wave function dictionaries,...) stored in one file per key.
+
+    The cache directory is taken from (in order of precedence):
+        1. the ``path`` argument
+        2. the ``FORTE_CACHE_DIR`` environment variable
+        3. ``~/.cache/forte``
+
+    Usage::
+
+        cache = Cache()
+        key = cache.key('HF', repr(model), options)
+        payload = cache.load(key)
+        if payload is None:
+            payload = {...} # compute the data
+            cache.store(key, payload)
+    """
+
+    def __init__(self, path=None):
+        """
+        Parameters
+        ----------
+        path: str
+            the directory where the cache files are stored
+        """
+        if path is None:
+            path = os.environ.get("FORTE_CACHE_DIR", os.path.join(os.path.expanduser("~"), ".cache", "forte"))
+        self._path = path
+        os.makedirs(self._path, exist_ok=True)
+
+    def __repr__(self):
+        """
+        return a string representation of this object
+        """
+        return f"Cache('{self._path}')"
+
+    @property
+    def path(self):
+        return self._path
+
+    @staticmethod
+    def key(*args):
+        """
+        Return a hash key for the objects in ``args``.
+
+        Objects are converted to a canonical string representation (dictionaries are sorted)
+        so that the same input always produces the same key.
+        """
+        h = hashlib.sha256()
+        for arg in args:
+            h.update(Cache._canonical(arg).encode("utf-8"))
+            h.update(b"\0")
+        return h.hexdigest()
+
+    @staticmethod
+    def _canonical(obj):
+        if isinstance(obj, dict):
+            items = sorted((Cache._canonical(k), Cache._canonical(v)) for k, v in obj.items())
+            return "{" + ",".join(f"{k}:{v}" for k, v in items) + "}"
+        if isinstance(obj, (list, tuple)):
+            return "[" + ",".join(Cache._canonical(v) for v in obj) + "]"
+        if isinstance(obj, float):
+            # use the exact representation of floats
+            return obj.hex()
+        return repr(obj)
+
+    def _filename(self, key):
+        return os.path.join(self._path, f"{key}.pkl")
+
+    def contains(self, key):
+        """Return True if the cache has an entry for ``key``"""
+        return os.path.isfile(self._filename(key))
+
+    def load(self, key):
+        """
+        Return the entry stored for ``key`` or None if it is not in the cache.
+
+        Corrupted entries are removed and treated as a cache miss.
+        """
+        filename = self._filename(key)
+        if not os.path.isfile(filename):
+            flog("info", f"Cache: miss for key {key}")
+            return None
+        try:
+            with open(filename, "rb") as f:
+                payload = pickle.load(f)
+        except (OSError, EOFError, pickle.UnpicklingError) as e:
+            flog("warning", f"Cache: could not read entry {key} ({e}). Removing it.")
+            self.remove(key)
+            return None
+        flog("info", f"Cache: hit for key {key}")
+        return payload
+
+    def store(self, key, payload):
+        """
+        Store ``payload`` under ``key``.
+
+        The entry is first written to a temporary file and then moved in place, so that
+        concurrent readers never see partially written entries.
+        """
+        fd, tmp_filename = tempfile.mkstemp(dir=self._path, suffix=".tmp")
+        try:
+            with os.fdopen(fd, "wb") as f:
+                pickle.dump(payload, f, protocol=pickle.HIGHEST_PROTOCOL)
+            os.replace(tmp_filename, self._filename(key))
+        except BaseException:
+            if os.path.exists(tmp_filename):
+                os.remove(tmp_filename)
+            raise
+        flog("info", f"Cache: stored entry {key}")
+
+    def remove(self, key):
+        """Remove the entry stored for ``key`` (if present)"""
+        filename = self._filename(key)
+        if os.path.isfile(filename):
+            os.remove(filename)
+
+    def clear(self):
+        """Remove all the entries in the cache"""
+        for filename in os.listdir(self._path):
+            if filename.endswith(".pkl"):
+                os.remove(os.path.join(self._path, filename))
+
+
+def make_cache(cache):
+    """
+    Convert the user input for the ``cache`` argument of solvers/modules to a Cache object.
+
+    Parameters
+    ----------
+    cache: None, bool, str, or Cache
+        None/False disable caching, True uses the default cache directory,
+        a string is interpreted as the cache directory
+    """
+    if cache is None or cache is False:
+        return None
+    if cache is True:
+        return Cache()
+    if isinstance(cache, str):
+        return Cache(cache)
+    if isinstance(cache, Cache):
+        return cache
+    raise ValueError(f"could not parse cache input {cache}")
@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <cmath>
 #include <ctype.h>
 #include <numeric>
 
@@ -152,7 +153,12 @@ void CASSCF_ORB_GRAD::setup_mos() {
     BlockedTensor::add_mo_space("v", "a,b", label_to_mos_["v"], NoSpin);
     BlockedTensor::add_mo_space("u", "A,B", label_to_mos_["u"], NoSpin);
 
+    // alpha and beta active spaces for spin-dependent (transition) RDMs
+    BlockedTensor::add_mo_space("o", "o0,o1,o2,o3", actv_mos_, NoSpin);
+    BlockedTensor::add_mo_space("O", "O0,O1,O2,O3", actv_mos_, NoSpin);
+
     BlockedTensor::add_composite_mo_space("F", "M,N", {"f", "u"});
+    BlockedTensor::add_composite_mo_space("e", "k,l", {"c", "v"});
     BlockedTensor::add_composite_mo_space("g", "p,q,r,s", {"c", "a", "v"});
     BlockedTensor::add_composite_mo_space("G", "P,Q,R,S", {"f", "c", "a", "v", "u"});
 
@@ -168,6 +174,12 @@ void CASSCF_ORB_GRAD::read_options() {
 
     ortho_trans_algo_ = options_->get_str("CASSCF_ORB_ORTHO_TRANS");
 
+    incremental_tei_ = options_->get_bool("CASSCF_INCREMENTAL_TEI");
+    incremental_tei_threshold_ = options_->get_double("CASSCF_INCREMENTAL_TEI_THRESHOLD");
+    incremental_tei_maxiter_ = options_->get_int("CASSCF_INCREMENTAL_TEI_MAXITER");
+    if (ints_->integral_type() == Custom)
+        incremental_tei_ = false;
+
     // zero rotations
     zero_rots_.resize(nirrep_);
     auto zero_rots = options_->get_gen_list("CASSCF_ZERO_ROT");
@@ -403,6 +415,12 @@ void CASSCF_ORB_GRAD::init_tensors() {
     // two-electron integrals
     V_ = ambit::BlockedTensor::build(tensor_type, "V", {"Gaaa"});
 
+    // integrals for incremental updates
+    if (incremental_tei_ and not allocate_tei_ref()) {
+        outfile->Printf(" Turn off CASSCF_INCREMENTAL_TEI.");
+        incremental_tei_ = false;
+    }
+
     // 1-RDM and 2-RDM
     D1_ = ambit::BlockedTensor::build(tensor_type, "1RDM", {"aa"});
     D2_ = ambit::BlockedTensor::build(tensor_type, "2RDM", {"aaaa"});
@@ -431,14 +449,34 @@ void CASSCF_ORB_GRAD::init_tensors() {
     U_->identity();
 }
 
+bool CASSCF_ORB_GRAD::allocate_tei_ref() {
+    // (Pr|xy) and (Pu|ky), k in core and virtual
+    size_t nextn = ncmo_ - nactv_;
+    size_t n_elements = nmo_ * nactv_ * nactv_ * (ncmo_ + nextn);
+    size_t mem_sys = psi::Process::environment.get_memory() * 0.5;
+    if (n_elements * sizeof(double) > mem_sys) {
+        outfile->Printf("\n  Not enough memory to store (pq|xy) and (px|qy) integrals "
+                        "(%.2f GB needed).",
+                        n_elements * sizeof(double) / 1073741824.0);
+        return false;
+    }
+
+    V_ref_J_ = ambit::BlockedTensor::build(CoreTensor, "V_ref_J", {"Ggaa"});
+    V_ref_K_ = ambit::BlockedTensor::build(CoreTensor, "V_ref_K", {"Gaea"});
+    store_tei_ref_ = true;
+    return true;
+}
+
 void CASSCF_ORB_GRAD::build_mo_integrals() {
+    tei_ref_current_ = false;
+
     // form closed-shell Fock matrix
     build_fock_inactive();
 
     // form the MO 2e-integrals
     if (ints_->integral_type() == Custom) {
         fill_tei_custom(V_);
-    } else {
+    } else if (not(incremental_tei_ and update_tei_incremental())) {
         build_tei_from_ao();
     }
 }
@@ -458,6 +496,31 @@ void CASSCF_ORB_GRAD::fill_tei_custom(ambit::BlockedTensor V) {
     }
 }
 
+void CASSCF_ORB_GRAD::fill_tei_ref_custom() {
+    // (pq|xy) = <px|qy> and (px|qy) = <pq|xy>, frozen orbitals are not available
+    const auto& mo_a = label_to_cmos_["a"];
+    for (const std::string& space_p : {"c", "a", "v"}) {
+        const auto& mo_p = label_to_cmos_[space_p];
+        for (const std::string& space_q : {"c", "a", "v"}) {
+            const auto& mo_q = label_to_cmos_[space_q];
+
+            V_ref_J_.block(space_p + space_q + "aa")
+                .iterate([&](const std::vector<size_t>& i, double& value) {
+                    value = ints_->aptei_ab(mo_p[i[0]], mo_a[i[2]], mo_q[i[1]], mo_a[i[3]]);
+                });
+
+            if (space_q == "a")
+                continue;
+
+            V_ref_K_.block(space_p + "a" + space_q + "a")
+                .iterate([&](const std::vector<size_t>& i, double& value) {
+                    value = ints_->aptei_ab(mo_p[i[0]], mo_q[i[2]], mo_a[i[1]], mo_a[i[3]]);
+                });
+        }
+    }
+    tei_ref_current_ = true;
+}
+
 void CASSCF_ORB_GRAD::build_tei_from_ao() {
     if (nactv_ == 0)
         return;
@@ -505,8 +568,10 @@ void CASSCF_ORB_GRAD::build_tei_from_ao() {
     // (pu|xy) = C_{Mp}^T C_{Nu} C_{Rx}^T C_{Sy} (MN|RS)
     //         = C_{Mp}^T C_{Nu} J_{MN}^{xy}
     //         = C_{Mp}^T J_{MN}^{xy} C_{Nu}
+    // For incremental updates, we also store (pq|xy) = C_{Mp}^T J_{MN}^{xy} C_{Nq}
+    // and (px|qy) = C_{Mp}^T K_{MN}^{xy} C_{Nq}, where K_{MN}^{xy} = (MR|NS) C_{Rx} C_{Sy}
 
-    JK_->set_do_K(false);
+    JK_->set_do_K(store_tei_ref_);
     std::vector<std::shared_ptr<psi::Matrix>>& Cl = JK_->C_left();
     std::vector<std::shared_ptr<psi::Matrix>>& Cr = JK_->C_right();
     Cl.clear();
@@ -514,7 +579,8 @@ void CASSCF_ORB_GRAD::build_tei_from_ao() {
 
     // figure out memory bottleneck
     size_t mem_sys = psi::Process::environment.get_memory() * 0.85;
-    size_t max_elements = nactv_ * nactv_ * nso_ * nso_ * sizeof(double);
+    size_t max_elements =
+        (store_tei_ref_ ? 2 : 1) * nactv_ * nactv_ * nso_ * nso_ * sizeof(double);
     size_t n_buckets = max_elements / mem_sys + (max_elements % mem_sys ? 1 : 0);
 
     size_t n_pairs = nactv_ * (nactv_ + 1) / 2;
@@ -558,6 +624,13 @@ void CASSCF_ORB_GRAD::build_tei_from_ao() {
             auto x = std::get<0>(pairs[i + offset]);
             auto y = std::get<1>(pairs[i + offset]);
 
+            if (store_tei_ref_) {
+                auto J = psi::linalg::triplet(C_nosym, JK_->J()[i], C_nosym, true, false, false);
+                auto K = psi::linalg::triplet(C_nosym, JK_->K()[i], C_nosym, true, false, false);
+                fill_tei_ref(x, y, J, K);
+                continue;
+            }
+
             auto half_trans = psi::linalg::triplet(C_nosym, JK_->J()[i], Cact, true, false, false);
 
             for (size_t p = 0; p < nmo_; ++p) {
@@ -577,9 +650,103 @@ void CASSCF_ORB_GRAD::build_tei_from_ao() {
         offset += n_pairs;
     }
 
+    if (store_tei_ref_) {
+        V_["Puxy"] = V_ref_J_["Puxy"];
+        U_ref_ = U_->clone();
+        n_incremental_tei_ = 0;
+        tei_ref_current_ = true;
+    }
+
     timer_off("Build (pu|xy) integrals");
 }
 
+void CASSCF_ORB_GRAD::fill_tei_ref(size_t x, size_t y, std::shared_ptr<psi::Matrix> J,
+                                   std::shared_ptr<psi::Matrix> K) {
+    // J: (pq|xy) = (pq|yx), K: (px|qy) = (qy|px)
+    size_t nactv2 = nactv_ * nactv_;
+
+    for (size_t p = 0; p < nmo_; ++p) {
+        const auto& [space_p, np] = mos_rel_space_[p];
+
+        for (size_t q = 0; q < nmo_; ++q) {
+            const auto& [space_q, nq] = mos_rel_space_[q];
+            if (space_q == "f" or space_q == "u")
+                continue;
+
+            auto& data_j = V_ref_J_.block(space_p + space_q + "aa").data();
+            size_t nq_size = label_to_mos_[space_q].size();
+            size_t idx = (np * nq_size + nq) * nactv2;
+            data_j[idx + x * nactv_ + y] = J->get(p, q);
+            data_j[idx + y * nactv_ + x] = J->get(p, q);
+
+            if (space_q == "a")
+                continue;
+
+            auto& data_k = V_ref_K_.block(space_p + "a" + space_q + "a").data();
+            data_k[((np * nactv_ + x) * nq_size + nq) * nactv_ + y] = K->get(p, q);
+            data_k[((np * nactv_ + y) * nq_size + nq) * nactv_ + x] = K->get(q, p);
+        }
+    }
+}
+
+bool CASSCF_ORB_GRAD::update_tei_incremental() {
+    if (U_ref_ == nullptr or n_incremental_tei_ >= incremental_tei_maxiter_)
+        return false;
+
+    // rotation since the last full transformation: C = C_ref W, where W = U_ref^T U
+    auto W = psi::linalg::doublet(U_ref_, U_, true, false);
+
+    // the norm of the block that mixes active with core and virtual orbitals,
+    // the incremental update neglects terms quadratic in this block
+    double e_norm = 0.0;
+    for (int h = 0; h < nirrep_; ++h) {
+        for (int u = ndoccpi_[h]; u < ndoccpi_[h] + nactvpi_[h]; ++u) {
+            for (int p = 0; p < nmopi_[h]; ++p) {
+                if (p < ndoccpi_[h] or p >= ndoccpi_[h] + nactvpi_[h])
+                    e_norm += W->get(h, p, u) * W->get(h, p, u);
+            }
+        }
+    }
+    e_norm = std::sqrt(e_norm);
+    if (e_norm > incremental_tei_threshold_)
+        return false;
+
+    timer_on("Update (pu|xy) integrals");
+
+    auto Wt = ambit::BlockedTensor::build(CoreTensor, "W", {"GG"});
+    format_fock(W, Wt);
+
+    // (Qu|zw) = W_{ru} (Qr|zw), r = active, core, virtual
+    auto T = ambit::BlockedTensor::build(CoreTensor, "T", {"Gaaa"});
+    T["Quzw"] = Wt["ru"] * V_ref_J_["Qrzw"];
+
+    // rotate the last two indices within the active space
+    auto X = ambit::BlockedTensor::build(CoreTensor, "X", {"Gaaa"});
+    X["Quxw"] = Wt["zx"] * T["Quzw"];
+    T["Quxy"] = Wt["wy"] * X["Quxw"];
+
+    // first-order terms that mix core/virtual into the last two indices
+    // S_{Qu,xy} = W_{vu} W_{wy} W_{kx} (Qv|kw), then (Qu|xy) += S_{Qu,xy} + S_{Qu,yx}
+    auto S1 = ambit::BlockedTensor::build(CoreTensor, "S1", {"Gaea"});
+    S1["Quky"] = Wt["vu"] * Wt["wy"] * V_ref_K_["Qvkw"];
+    X["Quxy"] = Wt["kx"] * S1["Quky"];
+    T["Quxy"] += X["Quxy"];
+    T["Quxy"] += X["Quyx"];
+
+    // rotate the first index
+    V_["Puxy"] = Wt["QP"] * T["Quxy"];
+
+    n_incremental_tei_++;
+
+    if (debug_print_) {
+        outfile->Printf("\n  Incremental update of (pu|xy) integrals (%d/%d), |W_ext| = %.3e",
+                        n_incremental_tei_, incremental_tei_maxiter_, e_norm);
+    }
+
+    timer_off("Update (pu|xy) integrals");
+    return true;
+}
+
 void CASSCF_ORB_GRAD::build_fock(bool rebuild_inactive) {
     if (rebuild_inactive) {
         build_fock_inactive();
@@ -662,6 +829,18 @@ void CASSCF_ORB_GRAD::format_fock(std::shared_ptr<psi::Matrix> Fock, ambit::Bloc
     });
 }
 
+std::shared_ptr<psi::Matrix> CASSCF_ORB_GRAD::format_matrix(const std::string& name,
+                                                            ambit::BlockedTensor T) {
+    auto M = std::make_shared<psi::Matrix>(name, nmopi_, nmopi_);
+    T.iterate([&](const std::vector<size_t>& i, const std::vector<SpinType>&, double& value) {
+        const auto& [h1, p] = mos_rel_[i[0]];
+        const auto& [h2, q] = mos_rel_[i[1]];
+        if (h1 == h2)
+            M->set(h1, p, q, value);
+    });
+    return M;
+}
+
 std::shared_ptr<psi::Matrix> CASSCF_ORB_GRAD::fock(std::shared_ptr<RDMs> rdms) {
     // put spin-summed 1RDM to psi4 Matrix
     auto rdm1 = tensor_to_matrix(rdms->SF_G1(), nactvpi_);
@@ -882,6 +1061,190 @@ void CASSCF_ORB_GRAD::compute_orbital_grad() {
     }
 }
 
+void CASSCF_ORB_GRAD::transition_grad(std::shared_ptr<RDMs> rdms,
+                                      std::shared_ptr<psi::Vector> g) {
+    // densities in chemists' notation
+    auto D1 = ambit::BlockedTensor::build(CoreTensor, "T1RDM", {"aa"});
+    D1.block("aa").copy(rdms->SF_G1());
+
+    auto D2 = ambit::BlockedTensor::build(CoreTensor, "T2RDM", {"aaaa"});
+    D2.block("aaaa")("pqrs") = rdms->SF_G2()("prqs");
+    D2.block("aaaa")("pqrs") += rdms->SF_G2()("qrps");
+    D2.scale(0.5);
+
+    // active Fock matrix built from the transition 1-RDM
+    auto Fa = ints_->make_fock_active_restricted(tensor_to_matrix(rdms->SF_G1(), nactvpi_));
+    auto F = ambit::BlockedTensor::build(CoreTensor, "F_active", {"gg"});
+    format_fock(Fa, F);
+
+    // the closed-shell energy and inactive Fock contributions vanish for orthogonal CI vectors
+    auto A = ambit::BlockedTensor::build(CoreTensor, "A", {"gg"});
+    A["ri"] = 2.0 * F["ri"];
+    A["ru"] = Fc_["rt"] * D1["tu"];
+    A["ru"] += V_["rtvw"] * D2["tuvw"];
+
+    auto G = ambit::BlockedTensor::build(CoreTensor, "g", g_.block_labels());
+    G["pq"] = 2.0 * A["pq"];
+    G["pq"] -= 2.0 * A["qp"];
+
+    reshape_rot_ambit(G, g);
+}
+
+std::shared_ptr<ActiveSpaceIntegrals>
+CASSCF_ORB_GRAD::hess_vec(std::shared_ptr<psi::Vector> x, std::shared_ptr<psi::Vector> Hx,
+                          bool do_ints) {
+    /* Derivative of the orbital gradient along x at fixed RDMs
+     *
+     * The orbitals change as C_q -> C_q + sum_{m} C_m X_{mq}, where X is antisymmetric.
+     * Every MO index of the integrals is transformed by X, and the core and active densities
+     * change by Xc + Xc^T and Y + Y^T, where (Xc)_{mi} = X_{mi} and Y_{mu} = X_{mt} D1_{tu}.
+     * Let L(Z)_{rs} = sum_{pq} Z_{pq} [4 (pq|rs) - (pr|sq) - (ps|rq)], then
+     *
+     * dA_{ri} = 2 [X^T F + F X + L(Xc + Y / 2)]_{ri}
+     * dA_{ru} = dFc_{rt} D1_{tu} + X_{mr} (mt|vw) D2_{tuvw} + (rm|vw) X_{mt} D2_{tuvw}
+     *         + (rt|mw) X_{mv} (D2_{tuvw} + D2_{tuwv})
+     * dFc_{pq} = [X^T Fc + Fc X + L(Xc)]_{pq}
+     * Hx = 2 (dA - dA^T)
+     *
+     * Rotations are composed in the frame of the current orbitals, such that Hx differs from
+     * the exact Hessian product by a term antisymmetric in the rotations.
+     */
+    timer_on("Orbital Hessian-vector product");
+
+    if (not store_tei_ref_ and not allocate_tei_ref())
+        throw std::runtime_error("Not enough memory for the orbital Hessian-vector product!");
+
+    if (not tei_ref_current_) {
+        if (ints_->integral_type() == Custom) {
+            fill_tei_ref_custom();
+        } else {
+            build_tei_from_ao();
+        }
+    }
+
+    // antisymmetric rotation matrix
+    auto X = ambit::BlockedTensor::build(CoreTensor, "X", {"gg"});
+    for (size_t n = 0; n < nrot_; ++n) {
+        const auto& [block, i, j] = rot_mos_block_[n];
+        std::string block_t{block[1], block[0]};
+        auto& data = X.block(block).data();
+        auto& data_t = X.block(block_t).data();
+        data[i * X.block(block).dim(1) + j] = x->get(n);
+        data_t[j * X.block(block_t).dim(1) + i] = -x->get(n);
+    }
+
+    // Fock-like terms from the change of core and active densities
+    auto Z = ambit::BlockedTensor::build(CoreTensor, "Z", {"gg"});
+    Z["pi"] = X["pi"];
+    auto Lc = ambit::BlockedTensor::build(CoreTensor, "L(Xc)", {"gg"});
+    format_fock(contract_RB_mo(format_matrix("Xc", Z)), Lc);
+
+    Z["pu"] = 0.5 * X["pt"] * D1_["tu"];
+    auto L = ambit::BlockedTensor::build(CoreTensor, "L(Z)", {"gg"});
+    format_fock(contract_RB_mo(format_matrix("Z", Z)), L);
+
+    auto dA = ambit::BlockedTensor::build(CoreTensor, "dA", {"gg"});
+    dA["ri"] = 2.0 * X["pr"] * F_["pi"];
+    dA["ri"] += 2.0 * F_["rp"] * X["pi"];
+    dA["ri"] += 2.0 * L["ri"];
+
+    auto dFc = ambit::BlockedTensor::build(CoreTensor, "dFc", {"ga"});
+    dFc["rt"] = X["pr"] * Fc_["pt"];
+    dFc["rt"] += Fc_["rp"] * X["pt"];
+    dFc["rt"] += Lc["rt"];
+    dA["ru"] = dFc["rt"] * D1_["tu"];
+
+    auto T = ambit::BlockedTensor::build(CoreTensor, "T", {"ga"});
+    T["pu"] = V_["ptvw"] * D2_["tuvw"];
+    dA["ru"] += X["pr"] * T["pu"];
+
+    auto XD2 = ambit::BlockedTensor::build(CoreTensor, "XD2", {"gaaa"});
+    XD2["puvw"] = X["pt"] * D2_["tuvw"];
+    dA["ru"] += V_ref_J_["rpvw"] * XD2["puvw"];
+
+    auto D2s = ambit::BlockedTensor::build(CoreTensor, "D2s", {"aaaa"});
+    D2s["tuvw"] = D2_["tuvw"];
+    D2s["tuvw"] += D2_["tuwv"];
+    auto XD2e = ambit::BlockedTensor::build(CoreTensor, "XD2e", {"aaea"});
+    XD2e["tukw"] = X["kv"] * D2s["tuvw"];
+    dA["ru"] += V_ref_K_["rtkw"] * XD2e["tukw"];
+    auto XD2a = ambit::BlockedTensor::build(CoreTensor, "XD2a", {"aaaa"});
+    XD2a["tuxw"] = X["xv"] * D2s["tuvw"];
+    dA["ru"] += V_["rtxw"] * XD2a["tuxw"];
+
+    auto G = ambit::BlockedTensor::build(CoreTensor, "Hx", g_.block_labels());
+    G["pq"] = 2.0 * dA["pq"];
+    G["pq"] -= 2.0 * dA["qp"];
+    reshape_rot_ambit(G, Hx);
+
+    timer_off("Orbital Hessian-vector product");
+
+    if (not do_ints)
+        return nullptr;
+
+    // derivative of the active space integrals
+    auto dV = ambit::BlockedTensor::build(CoreTensor, "dV", {"aaaa"});
+    dV["tuvw"] = X["pt"] * V_["puvw"];
+    dV["tuvw"] += X["pu"] * V_["ptvw"];
+    dV["tuvw"] += X["pv"] * V_["pwtu"];
+    dV["tuvw"] += X["pw"] * V_["pvtu"];
+
+    auto actv_sym = mo_space_info_->symmetry("ACTIVE");
+    auto dints = std::make_shared<ActiveSpaceIntegrals>(ints_, actv_mos_, actv_sym, core_mos_);
+
+    auto actv_ab = ambit::Tensor::build(CoreTensor, "dtei_actv_ab", std::vector<size_t>(4, nactv_));
+    actv_ab("pqrs") = dV.block("aaaa")("prqs");
+
+    auto actv_aa = ambit::Tensor::build(CoreTensor, "dtei_actv_aa", std::vector<size_t>(4, nactv_));
+    actv_aa.copy(actv_ab);
+    actv_aa("uvxy") -= actv_ab("uvyx");
+
+    dints->set_active_integrals(actv_aa, actv_ab, actv_aa);
+
+    auto& oei = dFc.block("aa").data();
+    dints->set_restricted_one_body_operator(oei, oei);
+    dints->set_scalar_energy(0.0);
+
+    return dints;
+}
+
+std::shared_ptr<psi::Matrix> CASSCF_ORB_GRAD::contract_RB_mo(std::shared_ptr<psi::Matrix> Z) {
+    if (ints_->integral_type() != Custom)
+        return contract_RB_Z(Z, C_, C_, C_, C_);
+
+    // L_{pq,rs} = 4 <pr|qs> - <ps|rq> - <pr|sq> using the correlated MOs
+    std::vector<size_t> mos, cmos;
+    for (const std::string& space : {"c", "a", "v"}) {
+        mos.insert(mos.end(), label_to_mos_[space].begin(), label_to_mos_[space].end());
+        cmos.insert(cmos.end(), label_to_cmos_[space].begin(), label_to_cmos_[space].end());
+    }
+
+    auto LZ = std::make_shared<psi::Matrix>("L(Z)", nmopi_, nmopi_);
+    for (size_t p = 0, n = mos.size(); p < n; ++p) {
+        const auto& [hp, np] = mos_rel_[mos[p]];
+        for (size_t q = 0; q < n; ++q) {
+            const auto& [hq, nq] = mos_rel_[mos[q]];
+            if (hp != hq or std::fabs(Z->get(hp, np, nq)) < numerical_zero_)
+                continue;
+            double z = Z->get(hp, np, nq);
+
+            for (size_t r = 0; r < n; ++r) {
+                const auto& [hr, nr] = mos_rel_[mos[r]];
+                for (size_t s = 0; s < n; ++s) {
+                    const auto& [hs, ns] = mos_rel_[mos[s]];
+                    if (hr != hs)
+                        continue;
+                    double value = 4.0 * ints_->aptei_ab(cmos[p], cmos[r], cmos[q], cmos[s]);
+                    value -= ints_->aptei_ab(cmos[p], cmos[s], cmos[r], cmos[q]);
+                    value -= ints_->aptei_ab(cmos[p], cmos[r], cmos[s], cmos[q]);
+                    LZ->add(hr, nr, ns, z * value);
+                }
+            }
+        }
+    }
+    return LZ;
+}
+
 void CASSCF_ORB_GRAD::hess_diag(std::shared_ptr<psi::Vector>,
                                 const std::shared_ptr<psi::Vector>& h0) {
     compute_orbital_hess_diag();
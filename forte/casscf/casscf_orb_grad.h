@@ -69,6 +69,16 @@ class CASSCF_ORB_GRAD {
     /// Evaluate the diagonal orbital Hessian
     void hess_diag(std::shared_ptr<psi::Vector> x, const std::shared_ptr<psi::Vector>& h0);
 
+    /// Compute the orbital gradient of the given (transition) RDMs using the current orbitals
+    /// Terms proportional to the overlap between bra and ket CI vectors are excluded
+    void transition_grad(std::shared_ptr<RDMs> rdms, std::shared_ptr<psi::Vector> g);
+
+    /// Compute the product of the orbital Hessian with x using the current orbitals and RDMs
+    /// If do_ints, also return the derivative of the active space integrals along x
+    std::shared_ptr<ActiveSpaceIntegrals> hess_vec(std::shared_ptr<psi::Vector> x,
+                                                   std::shared_ptr<psi::Vector> Hx,
+                                                   bool do_ints = false);
+
     /// Set RDMs used for orbital optimization
     void set_rdms(std::shared_ptr<RDMs> rdms);
 
@@ -190,6 +200,13 @@ class CASSCF_ORB_GRAD {
     /// 3. Pade: Psi4 implementation of U = exp(R)
     std::string ortho_trans_algo_;
 
+    /// Update the (pu|xy) integrals incrementally for small orbital rotations
+    bool incremental_tei_;
+    /// Max norm of the active-inactive block of the rotation since the last full transformation
+    double incremental_tei_threshold_;
+    /// Max number of consecutive incremental updates before a full transformation
+    int incremental_tei_maxiter_;
+
     /// Keep internal (GASn-GASn) rotations
     bool internal_rot_;
     /// If the active space is from GAS
@@ -218,6 +235,19 @@ class CASSCF_ORB_GRAD {
     /// Two-electron integrals in chemists' notation (pu|xy)
     ambit::BlockedTensor V_;
 
+    /// Orthogonal transformation at the last full integral transformation
+    std::shared_ptr<psi::Matrix> U_ref_;
+    /// Coulomb-type integrals (pq|xy) at the last full integral transformation
+    ambit::BlockedTensor V_ref_J_;
+    /// Exchange-type integrals (pu|qy) at the last full integral transformation
+    ambit::BlockedTensor V_ref_K_;
+    /// Number of incremental updates since the last full integral transformation
+    int n_incremental_tei_ = 0;
+    /// Store (pq|xy) and (px|qy) in every full integral transformation
+    bool store_tei_ref_ = false;
+    /// If (pq|xy) and (px|qy) are computed using the current orbitals
+    bool tei_ref_current_ = false;
+
     /// Spin-summed 1-RDM
     ambit::BlockedTensor D1_;
     std::shared_ptr<psi::Matrix> rdm1_;
@@ -256,8 +286,21 @@ class CASSCF_ORB_GRAD {
     /// Build two-electron integrals
     void build_tei_from_ao();
 
+    /// Allocate the (pq|xy) and (px|qy) integrals, return false if there is not enough memory
+    bool allocate_tei_ref();
+
+    /// Fill the integrals used for incremental updates given MO J^{xy} and K^{xy} matrices
+    void fill_tei_ref(size_t x, size_t y, std::shared_ptr<psi::Matrix> J,
+                      std::shared_ptr<psi::Matrix> K);
+
+    /// Update two-electron integrals by rotating those of the last full transformation
+    /// Return false if the rotation is too large and a full transformation is needed
+    bool update_tei_incremental();
+
     /// Fill two-electron integrals for custom integrals
     void fill_tei_custom(ambit::BlockedTensor V);
+    /// Fill (pq|xy) and (px|qy) for custom integrals
+    void fill_tei_ref_custom();
 
     /// JK build for Fock-like terms
     void JK_build(std::shared_ptr<psi::Matrix> Cl, std::shared_ptr<psi::Matrix> Cr);
@@ -301,6 +344,8 @@ class CASSCF_ORB_GRAD {
     void dump_tpdm_iwl();
     /// Dump the Hartree-Fock MO 2-RDM to file using IWL
     void dump_tpdm_iwl_hf();
+    /// Write the DF 3-index and metric 2-RDMs in the AO basis (no IWL file)
+    void write_df_tpdm();
 
     /// Are there any frozen orbitals?
     bool is_frozen_orbs_;
@@ -341,11 +386,17 @@ class CASSCF_ORB_GRAD {
                                                std::shared_ptr<psi::Matrix> C_row,
                                                std::shared_ptr<psi::Matrix> C_col);
 
+    /// Contract the Roothaan-Bagus supermatrix with Z using the current orbitals (MO basis)
+    std::shared_ptr<psi::Matrix> contract_RB_mo(std::shared_ptr<psi::Matrix> Z);
+
     // => Some helper functions <=
 
     /// Format the Fock matrix from SharedMatrix to BlockedTensor
     void format_fock(std::shared_ptr<psi::Matrix> Fock, ambit::BlockedTensor F);
 
+    /// Format the BlockedTensor with two general indices to SharedMatrix
+    std::shared_ptr<psi::Matrix> format_matrix(const std::string& name, ambit::BlockedTensor T);
+
     /// Format the 1RDM from BlockedTensor to SharedMatrix
     void format_1rdm();
 
@@ -26,9 +26,16 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+
+#include "psi4/lib3index/3index.h"
 #include "psi4/libiwl/iwl.hpp"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/mintshelper.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
 #include "psi4/psifiles.h"
 
 #include "helpers/printing.h"
@@ -43,6 +50,27 @@ using namespace ambit;
 
 namespace forte {
 
+namespace {
+/// Return the MO coefficients in the AO basis without symmetry blocking (Pitzer ordering)
+std::shared_ptr<psi::Matrix> c1_orbitals(std::shared_ptr<psi::Wavefunction> wfn,
+                                         std::shared_ptr<psi::Matrix> C) {
+    auto aotoso = wfn->aotoso();
+    int nao = wfn->basisset()->nbf();
+    auto nsopi = C->rowspi();
+    auto nmopi = C->colspi();
+    int nmo = nmopi.sum();
+
+    auto Cao = std::make_shared<psi::Matrix>("C (AO)", nao, nmo);
+    for (int h = 0, index = 0; h < C->nirrep(); ++h) {
+        for (int i = 0; i < nmopi[h]; ++i, ++index) {
+            C_DGEMV('N', nao, nsopi[h], 1.0, aotoso->pointer(h)[0], nsopi[h], &C->pointer(h)[0][i],
+                    nmopi[h], 0.0, &Cao->pointer()[0][index], nmo);
+        }
+    }
+    return Cao;
+}
+} // namespace
+
 void CASSCF_ORB_GRAD::compute_nuclear_gradient() {
     print_h2("MCSCF Gradient");
 
@@ -77,6 +105,12 @@ void CASSCF_ORB_GRAD::compute_nuclear_gradient() {
     // back-transform 1-RDM
     compute_opdm_ao();
 
+    if (ints_->integral_type() == DF) {
+        // contract the separable 2-RDM with the fitted 3-index integrals, nothing goes to IWL
+        write_df_tpdm();
+        return;
+    }
+
     // dump 2-RDM to disk
     dump_tpdm_iwl();
 
@@ -607,4 +641,232 @@ void CASSCF_ORB_GRAD::dump_tpdm_iwl_hf() {
     d2.set_keep_flag(1);
     d2.close();
 }
+
+void CASSCF_ORB_GRAD::write_df_tpdm() {
+    /* The MCSCF 2-RDM is separable into core and active pieces. Its contraction with the
+     * derivative integrals is expressed through the 3-index density (R = auxiliary index)
+     *
+     *   G_{R,pq} = sum_{rs} Gamma_{pqrs} c_{R,rs},   c_{R,rs} = sum_P [J^-1]_{RP} (P|rs)
+     *
+     * which for the occupied block of the MCSCF density (i,j: core; u,v,x,y: active) reads
+     *
+     *   G_{R,ij} = delta_{ij} (2 sum_k c_{R,kk} + sum_{uv} d_{uv} c_{R,uv}) - c_{R,ij}
+     *   G_{R,uv} = d_{uv} sum_k c_{R,kk} + 1/4 sum_{xy} (D_{uvxy} + D_{xyuv}) c_{R,xy}
+     *   G_{R,iu} = G_{R,ui} = -1/2 sum_v c_{R,iv} d_{vu}
+     *
+     * The frozen-orbital response (see dump_tpdm_iwl_hf) adds a term of the same form in the
+     * Hartree-Fock basis (j: HF docc; P: projector onto the HF docc orbitals)
+     *
+     *   G_{R,pq} += Z_{pq} sum_j c_{R,jj} + P_{pq} sum_{rs} Z_{rs} c_{R,rs}
+     *               - 1/2 (Z c_R P + P c_R Z)_{pq}
+     *
+     * G is back-transformed to the AO basis auxiliary function by auxiliary function and Psi4
+     * contracts it with the DF derivative integrals. The metric derivative density reads
+     *
+     *   N_{RS} = sum_{pq} c_{R,pq} G_{S,pq}
+     *
+     * The densities follow the DSRG-MRPT2 DF gradient (see DSRG_MRPT2::write_df_rdm).
+     */
+    psi::outfile->Printf("\n    Computing DF TPDM .........");
+
+    auto wfn = ints_->wfn();
+    auto primary = wfn->basisset();
+    auto auxiliary = wfn->get_basisset("DF_BASIS_SCF");
+    size_t nbf = primary->nbf();
+    size_t nbf2 = nbf * nbf;
+    size_t naux = auxiliary->nbf();
+
+    // fitted 3-index integrals c_{R,mn} = sum_P [J^-1]_{RP} (P|mn)
+    auto cfit = std::make_shared<psi::Matrix>("Fitted (Q|mn)", naux, nbf2);
+    {
+        auto metric = std::make_shared<psi::FittingMetric>(auxiliary, true);
+        // "form_full_eig_inverse()" generates J^(-1)
+        metric->form_full_eig_inverse(
+            psi::Process::environment.options.get_double("DF_FITTING_CONDITION"));
+        auto Jinv = metric->get_metric();
+
+        psi::MintsHelper mints(primary);
+        auto Pmn = mints.ao_eri(auxiliary, psi::BasisSet::zero_ao_basis_set(), primary, primary);
+        C_DGEMM('N', 'N', naux, nbf2, naux, 1.0, Jinv->pointer()[0], naux, Pmn->pointer()[0],
+                nbf2, 0.0, cfit->pointer()[0], nbf2);
+    }
+
+    // occupied (core + active) MCSCF orbitals in the AO basis
+    auto docc_mos = mo_space_info_->absolute_mo("INACTIVE_DOCC");
+    size_t ndocc = docc_mos.size();
+    size_t nocc = ndocc + nactv_;
+
+    auto Cao = c1_orbitals(wfn, C_);
+    std::vector<double> Cocc(nbf * nocc);
+    for (size_t m = 0; m < nbf; ++m) {
+        for (size_t i = 0; i < ndocc; ++i) {
+            Cocc[m * nocc + i] = Cao->get(m, docc_mos[i]);
+        }
+        for (size_t u = 0; u < nactv_; ++u) {
+            Cocc[m * nocc + ndocc + u] = Cao->get(m, actv_mos_[u]);
+        }
+    }
+
+    const auto& d1_data = D1_.block("aa").data();
+    const auto& d2_data = D2_.block("aaaa").data();
+    size_t na2 = nactv_ * nactv_;
+
+    // Hartree-Fock orbitals and Z vector for the frozen-orbital response
+    size_t nmo_hf = is_frozen_orbs_ ? nmo_ : 0;
+    std::shared_ptr<psi::Matrix> Chf;
+    std::vector<double> Zhf(nmo_hf * nmo_hf);
+    if (is_frozen_orbs_) {
+        Chf = c1_orbitals(wfn, C0_);
+        for (int h = 0, offset = 0; h < nirrep_; ++h) {
+            for (int p = 0; p < nmopi_[h]; ++p) {
+                for (int q = 0; q < nmopi_[h]; ++q) {
+                    Zhf[(p + offset) * nmo_hf + q + offset] = Z_->get(h, p, q);
+                }
+            }
+            offset += nmopi_[h];
+        }
+    }
+
+    // 3-index density in the AO basis
+    auto M = std::make_shared<psi::Matrix>("3-Center Reference Density", naux, nbf2);
+
+#pragma omp parallel
+    {
+        size_t nmax = std::max(nocc, nmo_hf);
+        std::vector<double> T(nbf * nmax);
+        std::vector<double> X(nmax * nmax);
+        std::vector<double> G(nmax * nmax);
+        std::vector<double> Y(nmax * nmax);
+
+#pragma omp for schedule(dynamic)
+        for (size_t R = 0; R < naux; ++R) {
+            double* cR = cfit->pointer()[R];
+            double* mR = M->pointer()[R];
+
+            // X = Cocc^T c_R Cocc
+            C_DGEMM('N', 'N', nbf, nocc, nbf, 1.0, cR, nbf, Cocc.data(), nocc, 0.0, T.data(),
+                    nocc);
+            C_DGEMM('T', 'N', nocc, nocc, nbf, 1.0, Cocc.data(), nocc, T.data(), nocc, 0.0,
+                    X.data(), nocc);
+
+            double tc = 0.0;
+            for (size_t i = 0; i < ndocc; ++i) {
+                tc += X[i * nocc + i];
+            }
+            double ta = 0.0;
+            for (size_t u = 0; u < nactv_; ++u) {
+                for (size_t v = 0; v < nactv_; ++v) {
+                    ta += d1_data[u * nactv_ + v] * X[(ndocc + u) * nocc + ndocc + v];
+                }
+            }
+
+            std::fill(G.begin(), G.begin() + nocc * nocc, 0.0);
+            for (size_t i = 0; i < ndocc; ++i) {
+                for (size_t j = 0; j < ndocc; ++j) {
+                    G[i * nocc + j] = -X[i * nocc + j];
+                }
+                G[i * nocc + i] += 2.0 * tc + ta;
+            }
+            for (size_t u = 0; u < nactv_; ++u) {
+                for (size_t v = 0; v < nactv_; ++v) {
+                    double value = d1_data[u * nactv_ + v] * tc;
+                    for (size_t x = 0; x < nactv_; ++x) {
+                        for (size_t y = 0; y < nactv_; ++y) {
+                            double d2 = d2_data[(u * nactv_ + v) * na2 + x * nactv_ + y] +
+                                        d2_data[(x * nactv_ + y) * na2 + u * nactv_ + v];
+                            value += 0.25 * d2 * X[(ndocc + x) * nocc + ndocc + y];
+                        }
+                    }
+                    G[(ndocc + u) * nocc + ndocc + v] = value;
+                }
+            }
+            for (size_t i = 0; i < ndocc; ++i) {
+                for (size_t u = 0; u < nactv_; ++u) {
+                    double value = 0.0;
+                    for (size_t v = 0; v < nactv_; ++v) {
+                        value -= 0.5 * X[i * nocc + ndocc + v] * d1_data[v * nactv_ + u];
+                    }
+                    G[i * nocc + ndocc + u] = value;
+                    G[(ndocc + u) * nocc + i] = value;
+                }
+            }
+
+            // M_R = Cocc G Cocc^T
+            C_DGEMM('N', 'N', nbf, nocc, nocc, 1.0, Cocc.data(), nocc, G.data(), nocc, 0.0,
+                    T.data(), nocc);
+            C_DGEMM('N', 'T', nbf, nbf, nocc, 1.0, T.data(), nocc, Cocc.data(), nocc, 0.0, mR,
+                    nbf);
+
+            if (is_frozen_orbs_) {
+                double* chf = Chf->pointer()[0];
+
+                // Y = Chf^T c_R Chf
+                C_DGEMM('N', 'N', nbf, nmo_hf, nbf, 1.0, cR, nbf, chf, nmo_hf, 0.0, T.data(),
+                        nmo_hf);
+                C_DGEMM('T', 'N', nmo_hf, nmo_hf, nbf, 1.0, chf, nmo_hf, T.data(), nmo_hf, 0.0,
+                        Y.data(), nmo_hf);
+
+                double tp = 0.0;
+                for (auto j : hf_docc_mos_) {
+                    tp += Y[j * nmo_hf + j];
+                }
+                double tz = C_DDOT(nmo_hf * nmo_hf, Zhf.data(), 1, Y.data(), 1);
+
+                // G = Z tr(P c_R) + P tr(Z c_R) - 1/2 (Z c_R P + P c_R Z)
+                for (size_t pq = 0; pq < nmo_hf * nmo_hf; ++pq) {
+                    G[pq] = tp * Zhf[pq];
+                }
+                for (auto j : hf_docc_mos_) {
+                    G[j * nmo_hf + j] += tz;
+                    for (size_t p = 0; p < nmo_hf; ++p) {
+                        double value = 0.0;
+                        for (size_t r = 0; r < nmo_hf; ++r) {
+                            value += Zhf[p * nmo_hf + r] * Y[r * nmo_hf + j];
+                        }
+                        G[p * nmo_hf + j] -= 0.5 * value;
+                        G[j * nmo_hf + p] -= 0.5 * value;
+                    }
+                }
+
+                // M_R += Chf G Chf^T
+                C_DGEMM('N', 'N', nbf, nmo_hf, nmo_hf, 1.0, chf, nmo_hf, G.data(), nmo_hf, 0.0,
+                        T.data(), nmo_hf);
+                C_DGEMM('N', 'T', nbf, nbf, nmo_hf, 1.0, T.data(), nmo_hf, chf, nmo_hf, 1.0, mR,
+                        nbf);
+            }
+
+            // symmetrize in the AO indices
+            for (size_t m = 0; m < nbf; ++m) {
+                for (size_t n = 0; n < m; ++n) {
+                    double value = 0.5 * (mR[m * nbf + n] + mR[n * nbf + m]);
+                    mR[m * nbf + n] = value;
+                    mR[n * nbf + m] = value;
+                }
+            }
+        }
+    }
+
+    // metric derivative density N_{RS} = sum_{mn} c_{R,mn} G_{S,mn}
+    auto N = std::make_shared<psi::Matrix>("Metric Reference Density", naux, naux);
+    C_DGEMM('N', 'T', naux, naux, nbf2, 1.0, cfit->pointer()[0], nbf2, M->pointer()[0], nbf2, 0.0,
+            N->pointer()[0], naux);
+    N->hermitivitize();
+    cfit.reset();
+
+    // assume "alpha == beta"
+    M->scale(2.0);
+
+    auto psio = _default_psio_lib_;
+    M->save(psio, PSIF_AO_TPDM, psi::Matrix::SaveType::ThreeIndexLowerTriangle);
+    N->save(psio, PSIF_AO_TPDM, psi::Matrix::SaveType::LowerTriangle);
+
+    // there is no correlation contribution beyond the MCSCF density
+    size_t naux_corr = wfn->get_basisset("DF_BASIS_MP2")->nbf();
+    M = std::make_shared<psi::Matrix>("3-Center Correlation Density", naux_corr, nbf2);
+    M->save(psio, PSIF_AO_TPDM, psi::Matrix::SaveType::ThreeIndexLowerTriangle);
+    N = std::make_shared<psi::Matrix>("Metric Correlation Density", naux_corr, naux_corr);
+    N->save(psio, PSIF_AO_TPDM, psi::Matrix::SaveType::LowerTriangle);
+
+    psi::outfile->Printf(" Done.");
+}
 } // namespace forte
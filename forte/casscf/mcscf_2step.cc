@@ -106,6 +106,12 @@ void MCSCF_2STEP::read_options() {
     max_rot_ = options_->get_double("CASSCF_MAX_ROTATION");
     internal_rot_ = options_->get_bool("CASSCF_INTERNAL_ROT");
 
+    // augmented Hessian options
+    orb_rotation_algo_ = options_->get_str("ORB_ROTATION_ALGORITHM");
+    ah_maxiter_ = options_->get_int("CASSCF_AH_MAXITER");
+    ah_trust_radius_ = options_->get_double("CASSCF_AH_TRUST_RADIUS");
+    ah_ci_coupling_ = options_->get_bool("CASSCF_AH_CI_COUPLING");
+
     // DIIS options
     diis_freq_ = options_->get_int("CASSCF_DIIS_FREQ");
     diis_start_ = options_->get_int("CASSCF_DIIS_START");
@@ -123,7 +129,12 @@ void MCSCF_2STEP::print_options() {
 
     std::vector<std::pair<std::string, std::string>> info_string;
 
-    if (do_diis_) {
+    bool do_ah = orb_rotation_algo_ == "AUGMENTED_HESSIAN";
+    if (do_ah) {
+        info_int.emplace_back("Max number of AH iterations", ah_maxiter_);
+    }
+
+    if (do_diis_ and not do_ah) {
         info_int.emplace_back("DIIS start", diis_start_);
         info_int.emplace_back("Min DIIS vectors", diis_min_vec_);
         info_int.emplace_back("Max DIIS vectors", diis_max_vec_);
@@ -132,17 +143,27 @@ void MCSCF_2STEP::print_options() {
 
     table_printer printer;
     printer.add_int_data(info_int);
-    printer.add_double_data({{"Energy convergence", e_conv_},
-                             {"Gradient convergence", g_conv_},
-                             {"Max value for rotation", max_rot_}});
+    std::vector<std::pair<std::string, double>> info_double{{"Energy convergence", e_conv_},
+                                                           {"Gradient convergence", g_conv_},
+                                                           {"Max value for rotation", max_rot_}};
+    if (do_ah) {
+        info_double.emplace_back("Initial trust radius", ah_trust_radius_);
+    }
+    printer.add_double_data(info_double);
     printer.add_string_data({{"Print level", to_string(print_)},
                              {"Integral type", int_type_},
                              {"CI solver type", ci_type_},
+                             {"Orbital rotation algorithm", orb_rotation_algo_},
                              {"Final orbital type", orb_type_redundant_},
                              {"Derivative type", der_type_}});
-    printer.add_bool_data({{"Optimize orbitals", opt_orbs_},
-                           {"Include internal rotations", internal_rot_},
-                           {"Debug printing", debug_print_}});
+    std::vector<std::pair<std::string, bool>> info_bool{
+        {"Optimize orbitals", opt_orbs_},
+        {"Include internal rotations", internal_rot_},
+        {"Debug printing", debug_print_}};
+    if (do_ah) {
+        info_bool.emplace_back("CI-orbital coupling", ah_ci_coupling_);
+    }
+    printer.add_bool_data(info_bool);
 
     std::string table = printer.get_table("MCSCF Calculation Information");
     psi::outfile->Printf("%s", table.c_str());
@@ -237,7 +258,10 @@ double MCSCF_2STEP::compute_energy() {
             psi::outfile->Printf("\n\n  SCF converged in %d iterations!", lbfgs.iter());
             psi::outfile->Printf("\n  @ Final energy: %.15f", energy_);
         }
-    } else { // Case 3: multi-determinant SCF
+    } else if (orb_rotation_algo_ == "AUGMENTED_HESSIAN") { // Case 3: second-order MCSCF
+        converged = compute_energy_ah(cas_grad, R, e_c);
+        pass_energy_to_psi4(converged);
+    } else { // Case 4: multi-determinant SCF
         // DIIS extrapolation for macro iteration
         psi::DIISManager diis_manager(do_diis_ ? diis_max_vec_ : 0, "MCSCF DIIS",
                                       psi::DIISManager::RemovalPolicy::OldestAdded,
@@ -133,6 +133,15 @@ class MCSCF_2STEP {
     /// DIIS extrapolation frequency
     int diis_freq_;
 
+    /// Orbital rotation algorithm (DIAGONAL or AUGMENTED_HESSIAN)
+    std::string orb_rotation_algo_;
+    /// Max number of Davidson iterations to solve the augmented Hessian equations
+    int ah_maxiter_;
+    /// Initial trust radius for augmented Hessian steps
+    double ah_trust_radius_;
+    /// Include the CI-orbital coupling in the augmented Hessian
+    bool ah_ci_coupling_;
+
     /// Energy convergence criteria
     double e_conv_;
     /// Orbital gradient convergence criteria
@@ -153,6 +162,13 @@ class MCSCF_2STEP {
                                    std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
                                    const std::tuple<PrintLevel, double, double, bool>& params);
 
+    /// Optimize orbitals using augmented Hessian steps within a trust region
+    /// @param cas_grad the orbital gradient object evaluated at R with the current RDMs
+    /// @param R the orbital rotation vector, updated in place
+    /// @param e_c the energy of the current CI solution
+    /// @return true if converged
+    bool compute_energy_ah(CASSCF_ORB_GRAD& cas_grad, std::shared_ptr<psi::Vector> R, double e_c);
+
     /// Test if we are doing a single-reference orbital optimization
     bool is_single_reference();
 
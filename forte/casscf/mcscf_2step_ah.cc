@@ -0,0 +1,459 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2024 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ambit/blocked_tensor.h"
+
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
+
+#include "base_classes/rdms.h"
+#include "integrals/active_space_integrals.h"
+#include "helpers/printing.h"
+#include "helpers/timer.h"
+
+#include "casscf/casscf_orb_grad.h"
+#include "casscf/mcscf_2step.h"
+
+using namespace ambit;
+
+namespace forte {
+
+namespace {
+/// Estimate of the CI excitation energy used to precondition the CI residual
+constexpr double ci_precond_shift = 0.5;
+/// Threshold for linear dependency in the Davidson subspace
+constexpr double ah_lindep = 1.0e-8;
+
+std::shared_ptr<psi::Vector> get_block(const psi::Vector& v, size_t offset, size_t n) {
+    auto x = std::make_shared<psi::Vector>(static_cast<int>(n));
+    for (size_t i = 0; i < n; ++i) {
+        x->set(i, v.get(offset + i));
+    }
+    return x;
+}
+
+void add_block(psi::Vector& v, size_t offset, const psi::Vector& x, double factor = 1.0) {
+    for (int i = 0, n = x.dim(); i < n; ++i) {
+        v.add(offset + i, factor * x.get(i));
+    }
+}
+} // namespace
+
+bool MCSCF_2STEP::compute_energy_ah(CASSCF_ORB_GRAD& cas_grad, std::shared_ptr<psi::Vector> R,
+                                    double e_c) {
+    /* Augmented Hessian (AH) optimization in the space of orbital rotations x and
+     * CI parameters y (orthogonal to the CI vectors of each state):
+     *
+     *   | 0  g^T | | 1 |         | 1 |       H = | H_oo  H_oc |
+     *   | g  H   | | s | = theta | s |,          | H_co  H_cc |
+     *
+     * The Hessian-vector products are computed analytically as:
+     *   H_oo x: derivative of the orbital gradient along x (CASSCF_ORB_GRAD::hess_vec)
+     *   H_co x: 2 w P (dH/dx) c, CI sigma vector of the derivative active-space integrals
+     *   H_oc y: w * orbital gradient of the transition RDMs <c|E|y> + <y|E|c>
+     *   H_cc y: 2 w P (H - E) y, using the CI sigma vector
+     * where P projects out the CI vectors and w is the state weight.
+     *
+     * H_oo x contains an antisymmetric term proportional to the gradient (rotations are composed
+     * in the frame of the current orbitals), which is removed by symmetrizing the subspace Hessian.
+     *
+     * The orbital part of the step s is taken and the CI is solved again for the new orbitals.
+     * The step is scaled to lie within a trust radius, updated by comparing the actual energy
+     * change with the one predicted by the orbital block of the quadratic model.
+     */
+    timer t_ah("MCSCF augmented Hessian");
+
+    auto nrot = cas_grad.nrot();
+    auto r_conv = options_->get_double("R_CONVERGENCE");
+    auto print_level = debug_print_ ? PrintLevel::Debug
+                                    : (print_ >= PrintLevel::Verbose ? PrintLevel::Verbose
+                                                                     : PrintLevel::Quiet);
+
+    bool coupling = ah_ci_coupling_;
+    if (coupling and ci_type_ != "DETCI") {
+        psi::outfile->Printf("\n\n  CI-orbital coupling is only available for the DETCI solver.");
+        psi::outfile->Printf("\n  The CI will be relaxed after each orbital step.");
+        coupling = false;
+    }
+
+    as_solver_->set_maxiter(options_->get_int("DL_MAXITER"));
+
+    // the CI parameters of each root with nonzero weight
+    struct CIBlock {
+        StateInfo state;
+        size_t root;
+        double weight;
+        size_t offset;
+        size_t ndets;
+        double e_act;
+    };
+    std::vector<CIBlock> ci_blocks;
+    size_t nparam = nrot;
+    if (coupling) {
+        for (const auto& [state, weights] : state_weights_map_) {
+            auto ndets = as_solver_->eigenvectors(state)[0].dim(0);
+            for (size_t root = 0, nroots = weights.size(); root < nroots; ++root) {
+                if (weights[root] == 0.0)
+                    continue;
+                ci_blocks.push_back({state, root, weights[root], nparam, ndets, 0.0});
+                nparam += ndets;
+            }
+        }
+    }
+
+    // the CI vectors of each state for the current orbitals
+    std::map<StateInfo, std::vector<std::shared_ptr<psi::Vector>>> evecs;
+
+    auto sigma = [&](const StateInfo& state, std::shared_ptr<psi::Vector> x) {
+        auto s = std::make_shared<psi::Vector>(x->dim());
+        as_solver_->generalized_sigma(state, x, s);
+        return s;
+    };
+
+    auto project = [&](const StateInfo& state, psi::Vector& x) {
+        for (const auto& c : evecs[state]) {
+            x.axpy(-c->vector_dot(x), *c);
+        }
+    };
+
+    auto transition_rdms = [&](const CIBlock& b, const psi::Vector& y) {
+        std::vector<double> X(b.ndets);
+        for (size_t i = 0; i < b.ndets; ++i) {
+            X[i] = y.get(i);
+        }
+
+        // <c|E|y> + <y|E|c>, the order of alpha and beta blocks does not matter
+        auto g1 = BlockedTensor::build(CoreTensor, "T1", {"oo", "OO"});
+        auto g1r = BlockedTensor::build(CoreTensor, "T1 ket", {"oo", "OO"});
+        auto g2 = BlockedTensor::build(CoreTensor, "T2", {"oooo", "oOoO", "OOOO"});
+        auto g2r = BlockedTensor::build(CoreTensor, "T2 ket", {"oooo", "oOoO", "OOOO"});
+
+        as_solver_->generalized_rdms(b.state, b.root, X, g1, false, 1);
+        as_solver_->generalized_rdms(b.state, b.root, X, g1r, true, 1);
+        as_solver_->generalized_rdms(b.state, b.root, X, g2, false, 2);
+        as_solver_->generalized_rdms(b.state, b.root, X, g2r, true, 2);
+
+        for (const std::string& block : {"oo", "OO"}) {
+            g1.block(block)("pq") += g1r.block(block)("pq");
+        }
+        for (const std::string& block : {"oooo", "oOoO", "OOOO"}) {
+            g2.block(block)("pqrs") += g2r.block(block)("pqrs");
+        }
+
+        return std::make_shared<RDMsSpinDependent>(g1.block("oo"), g1.block("OO"),
+                                                   g2.block("oooo"), g2.block("oOoO"),
+                                                   g2.block("OOOO"));
+    };
+
+    // integrals of the current orbitals
+    auto fci_ints = cas_grad.active_space_ints();
+    auto dG = std::make_shared<psi::Vector>("dG", nrot);
+    auto g_tmp = std::make_shared<psi::Vector>("g", nrot);
+
+    auto hessian_product = [&](const psi::Vector& v, psi::Vector& Hv) {
+        Hv.zero();
+
+        for (const auto& b : ci_blocks) {
+            auto y = get_block(v, b.offset, b.ndets);
+            if (y->norm() < ah_lindep)
+                continue;
+
+            // H_cc y
+            auto hy = sigma(b.state, y);
+            project(b.state, *hy);
+            hy->axpy(-b.e_act, *y);
+            add_block(Hv, b.offset, *hy, 2.0 * b.weight);
+
+            // H_oc y
+            cas_grad.transition_grad(transition_rdms(b, *y), g_tmp);
+            add_block(Hv, 0, *g_tmp, b.weight);
+        }
+
+        auto x = get_block(v, 0, nrot);
+        if (x->norm() < ah_lindep)
+            return;
+
+        // H_oo x
+        auto dints = cas_grad.hess_vec(x, g_tmp, not ci_blocks.empty());
+        add_block(Hv, 0, *g_tmp);
+
+        // H_co x
+        if (ci_blocks.empty())
+            return;
+        as_solver_->set_active_space_integrals(dints);
+        for (const auto& b : ci_blocks) {
+            auto ds = sigma(b.state, evecs[b.state][b.root]);
+            project(b.state, *ds);
+            add_block(Hv, b.offset, *ds, 2.0 * b.weight);
+        }
+        as_solver_->set_active_space_integrals(fci_ints);
+    };
+
+    // solve the AH equations using the Davidson method, return the step and predicted energy
+    auto solve_ah = [&](const psi::Vector& grad, const psi::Vector& hdiag, int& niter) {
+        std::vector<std::shared_ptr<psi::Vector>> basis, sigmas;
+
+        auto add_trial = [&](std::shared_ptr<psi::Vector> t) {
+            for (int pass = 0; pass < 2; ++pass) {
+                for (const auto& b : basis) {
+                    t->axpy(-b->vector_dot(*t), *b);
+                }
+            }
+            double norm = t->norm();
+            if (norm < ah_lindep)
+                return false;
+            t->scale(1.0 / norm);
+
+            auto s = std::make_shared<psi::Vector>("sigma", nparam);
+            hessian_product(*t, *s);
+            basis.push_back(t);
+            sigmas.push_back(s);
+            return true;
+        };
+
+        auto precondition = [&](const psi::Vector& r, double theta) {
+            auto t = std::make_shared<psi::Vector>("trial", nparam);
+            for (size_t i = 0; i < nparam; ++i) {
+                double d = hdiag.get(i) - theta;
+                if (std::fabs(d) < 1.0e-4)
+                    d = std::copysign(1.0e-4, d);
+                t->set(i, -r.get(i) / d);
+            }
+            for (const auto& b : ci_blocks) {
+                auto y = get_block(*t, b.offset, b.ndets);
+                project(b.state, *y);
+                for (size_t i = 0; i < b.ndets; ++i) {
+                    t->set(b.offset + i, y->get(i));
+                }
+            }
+            return t;
+        };
+
+        double g_norm = grad.norm();
+        double r_tol = std::max(std::min(0.1 * g_norm, g_norm * g_norm), 0.1 * g_conv_);
+
+        auto u = std::make_shared<psi::Vector>("u", nparam);
+        auto Hu = std::make_shared<psi::Vector>("Hu", nparam);
+        double a0 = 1.0;
+
+        add_trial(precondition(grad, 0.0));
+
+        for (niter = 1; niter <= ah_maxiter_ and not basis.empty(); ++niter) {
+            // subspace augmented Hessian, the first basis vector is (1, 0)
+            int m = static_cast<int>(basis.size()) + 1;
+            auto M = std::make_shared<psi::Matrix>("AH", m, m);
+            for (int k = 1; k < m; ++k) {
+                M->set(0, k, grad.vector_dot(*basis[k - 1]));
+                M->set(k, 0, M->get(0, k));
+                for (int l = 1; l <= k; ++l) {
+                    double value = 0.5 * (basis[k - 1]->vector_dot(*sigmas[l - 1]) +
+                                          basis[l - 1]->vector_dot(*sigmas[k - 1]));
+                    M->set(k, l, value);
+                    M->set(l, k, value);
+                }
+            }
+
+            auto evecs_ah = std::make_shared<psi::Matrix>("AH evecs", m, m);
+            auto evals_ah = std::make_shared<psi::Vector>("AH evals", m);
+            M->diagonalize(evecs_ah, evals_ah);
+            double theta = evals_ah->get(0);
+            a0 = evecs_ah->get(0, 0);
+
+            u->zero();
+            Hu->zero();
+            for (int k = 1; k < m; ++k) {
+                u->axpy(evecs_ah->get(k, 0), *basis[k - 1]);
+                Hu->axpy(evecs_ah->get(k, 0), *sigmas[k - 1]);
+            }
+
+            // residual: a0 * g + H u - theta * u
+            auto r = std::make_shared<psi::Vector>(*Hu);
+            r->axpy(a0, grad);
+            r->axpy(-theta, *u);
+
+            if (debug_print_) {
+                psi::outfile->Printf("\n    AH iter %3d: theta = %15.10f, |r| = %.3e", niter,
+                                     theta, r->norm());
+            }
+
+            if (r->norm() < r_tol or niter == ah_maxiter_)
+                break;
+
+            if (not add_trial(precondition(*r, theta)))
+                break;
+        }
+
+        // step s = u / a0 and predicted energy change g^T s + 1/2 s^T H s
+        if (std::fabs(a0) < ah_lindep)
+            a0 = std::copysign(ah_lindep, a0);
+        u->scale(1.0 / a0);
+        Hu->scale(1.0 / a0);
+        return std::make_tuple(u, Hu);
+    };
+
+    std::string dash = std::string(86, '-');
+    print_h2("MCSCF Iterations (Augmented Hessian)");
+    psi::outfile->Printf("\n    Iter.        Total Energy       Delta  Orb. Grad.  Trust Rad.     "
+                         "Ratio  AH Iter.  Step");
+    psi::outfile->Printf("\n    %s", dash.c_str());
+
+    bool converged = false;
+    bool has_step = false;
+    double trust = ah_trust_radius_;
+    double e_prev = e_c, e_pred = 0.0, step_norm = 0.0;
+    int n_ah = 0;
+    auto R_prev = std::make_shared<psi::Vector>(*R);
+
+    // move to the orbitals R, solve the CI, and set the RDMs for the orbital gradient
+    auto relax_ci = [&]() {
+        cas_grad.evaluate(R, g_tmp, false);
+        fci_ints = cas_grad.active_space_ints();
+        double e =
+            diagonalize_hamiltonian(as_solver_, fci_ints, {print_level, e_conv_, r_conv, false});
+        auto rdms = as_solver_->compute_average_rdms(state_weights_map_, 2, RDMsType::spin_free);
+        cas_grad.set_rdms(rdms);
+        return e;
+    };
+
+    for (int macro = 1; macro <= maxiter_; ++macro) {
+        // trust-region update based on the actual and predicted energy changes
+        double de = has_step ? e_c - e_prev : 0.0;
+        double ratio = (has_step and std::fabs(e_pred) > 1.0e-14) ? de / e_pred : 1.0;
+        std::string status = has_step ? "" : "  --";
+        if (has_step) {
+            if (de > e_conv_ and ratio < 0.0) {
+                psi::outfile->Printf("\n    %4d %20.12f %11.4e  %10s  %10.4e %9.3f  %8d  Rej.",
+                                     macro, e_c, de, "", trust, ratio, n_ah);
+                R->copy(*R_prev);
+                trust *= 0.5;
+                has_step = false;
+                e_c = relax_ci();
+                continue;
+            }
+            if (ratio < 0.25) {
+                trust *= 0.5;
+            } else if (ratio > 0.75 and step_norm > 0.8 * trust) {
+                trust = std::min(2.0 * trust, 4.0 * ah_trust_radius_);
+            }
+        }
+
+        // gradient at the current orbitals and RDMs
+        energy_ = e_c;
+        cas_grad.evaluate(R, dG);
+        double g_rms = dG->rms();
+
+        psi::outfile->Printf("\n    %4d %20.12f %11.4e  %10.4e  %10.4e %9.3f  %8d  %s", macro, e_c,
+                             de, g_rms, trust, ratio, n_ah, status.c_str());
+
+        if (g_rms < g_conv_ and (not has_step or std::fabs(de) < e_conv_)) {
+            psi::outfile->Printf("\n    %s", dash.c_str());
+            if (macro == 1) {
+                psi::outfile->Printf("\n\n  Initial orbitals are already converged!");
+            } else {
+                psi::outfile->Printf(
+                    "\n\n  A miracle has come to pass: MCSCF iterations have converged!");
+            }
+            converged = true;
+            break;
+        }
+
+        // the full gradient and diagonal Hessian
+        auto grad = std::make_shared<psi::Vector>("AH gradient", nparam);
+        auto hdiag = std::make_shared<psi::Vector>("AH diagonal Hessian", nparam);
+        add_block(*grad, 0, *dG);
+        cas_grad.hess_diag(R, g_tmp);
+        add_block(*hdiag, 0, *g_tmp);
+
+        evecs.clear();
+        for (auto& b : ci_blocks) {
+            if (evecs.find(b.state) == evecs.end()) {
+                for (const auto& evec : as_solver_->eigenvectors(b.state)) {
+                    auto c = std::make_shared<psi::Vector>(static_cast<int>(b.ndets));
+                    for (size_t i = 0; i < b.ndets; ++i) {
+                        c->set(i, evec.data()[i]);
+                    }
+                    evecs[b.state].push_back(c);
+                }
+            }
+
+            // CI gradient 2 w P H c
+            auto c = evecs[b.state][b.root];
+            auto hc = sigma(b.state, c);
+            b.e_act = c->vector_dot(*hc);
+            project(b.state, *hc);
+            add_block(*grad, b.offset, *hc, 2.0 * b.weight);
+
+            for (size_t i = 0; i < b.ndets; ++i) {
+                hdiag->set(b.offset + i, 2.0 * b.weight * ci_precond_shift);
+            }
+        }
+
+        auto [s, Hs] = solve_ah(*grad, *hdiag, n_ah);
+
+        // scale the step to the trust radius and the max rotation
+        double scale = 1.0;
+        step_norm = s->norm();
+        if (step_norm > trust)
+            scale = trust / step_norm;
+        double max_x = 0.0;
+        for (size_t i = 0; i < nrot; ++i) {
+            max_x = std::max(max_x, std::fabs(s->get(i)));
+        }
+        if (scale * max_x > max_rot_)
+            scale = max_rot_ / max_x;
+        step_norm *= scale;
+
+        // predicted energy change of the orbital step, the CI part is discarded
+        auto s_orb = get_block(*s, 0, nrot);
+        if (ci_blocks.empty()) {
+            g_tmp->copy(*get_block(*Hs, 0, nrot));
+        } else {
+            cas_grad.hess_vec(s_orb, g_tmp);
+        }
+        e_pred = scale * dG->vector_dot(*s_orb) + 0.5 * scale * scale * s_orb->vector_dot(*g_tmp);
+
+        // take the orbital step and relax the CI
+        R_prev->copy(*R);
+        R->axpy(scale, *s_orb);
+        has_step = true;
+        e_prev = e_c;
+        e_c = relax_ci();
+    }
+
+    if (not converged) {
+        psi::outfile->Printf("\n    %s", dash.c_str());
+    }
+
+    return converged;
+}
+
+} // namespace forte
@@ -539,6 +539,35 @@ ExcitedStateSolver::rdms(const std::vector<std::pair<size_t, size_t>>& root_list
 
     std::vector<std::shared_ptr<RDMs>> refs;
 
+    // The dynamic algorithm computes the spin-dependent RDMs of all pairs in one sweep
+    if (direct_rdms_ and (rdm_type == RDMsType::spin_dependent) and (not test_rdms_) and
+        (max_rdm_level >= 1) and (root_list.size() > 1)) {
+        CI_RDMS ci_rdms(as_ints_->active_mo_symmetry(), final_wfn_, evecs_, 0, 0);
+        auto rdms_vec = ci_rdms.compute_rdms_dynamic(root_list, max_rdm_level);
+
+        std::vector<std::string> labels{"g1a",   "g1b",   "g2aa",  "g2ab", "g2bb",
+                                        "g3aaa", "g3aab", "g3abb", "g3bbb"};
+        for (auto& rdm : rdms_vec) {
+            std::vector<ambit::Tensor> g;
+            for (size_t c = 0; c < rdm.size(); ++c) {
+                const size_t rank = c < 2 ? 2 : (c < 5 ? 4 : 6);
+                auto T = ambit::Tensor::build(ambit::CoreTensor, labels[c],
+                                              std::vector<size_t>(rank, nact_));
+                T.data() = std::move(rdm[c]);
+                g.push_back(T);
+            }
+            if (max_rdm_level == 1) {
+                refs.push_back(std::make_shared<RDMsSpinDependent>(g[0], g[1]));
+            } else if (max_rdm_level == 2) {
+                refs.push_back(std::make_shared<RDMsSpinDependent>(g[0], g[1], g[2], g[3], g[4]));
+            } else {
+                refs.push_back(std::make_shared<RDMsSpinDependent>(g[0], g[1], g[2], g[3], g[4],
+                                                                   g[5], g[6], g[7], g[8]));
+            }
+        }
+        return refs;
+    }
+
     for (const auto& root_pair : root_list) {
         refs.push_back(compute_rdms(as_ints_, final_wfn_, evecs_, root_pair.first, root_pair.second,
                                     max_rdm_level, rdm_type));
@@ -709,21 +738,20 @@ ExcitedStateSolver::compute_rdms(std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
     if (direct_rdms_) {
         // TODO: Implement order-by-order version of direct algorithm
         if (rdm_type == RDMsType::spin_dependent) {
-            ordm_a = ambit::Tensor::build(ambit::CoreTensor, "g1a", dim2);
-            ordm_b = ambit::Tensor::build(ambit::CoreTensor, "g1b", dim2);
-
-            trdm_aa = ambit::Tensor::build(ambit::CoreTensor, "g2aa", dim4);
-            trdm_ab = ambit::Tensor::build(ambit::CoreTensor, "g2ab", dim4);
-            trdm_bb = ambit::Tensor::build(ambit::CoreTensor, "g2bb", dim4);
-
-            trdm_aaa = ambit::Tensor::build(ambit::CoreTensor, "g3aaa", dim6);
-            trdm_aab = ambit::Tensor::build(ambit::CoreTensor, "g3aab", dim6);
-            trdm_abb = ambit::Tensor::build(ambit::CoreTensor, "g3abb", dim6);
-            trdm_bbb = ambit::Tensor::build(ambit::CoreTensor, "g3bbb", dim6);
-
-            ci_rdms.compute_rdms_dynamic(ordm_a.data(), ordm_b.data(), trdm_aa.data(),
-                                         trdm_ab.data(), trdm_bb.data(), trdm_aaa.data(),
-                                         trdm_aab.data(), trdm_abb.data(), trdm_bbb.data());
+            // the RDM test needs all the RDMs
+            const int level = (test_rdms_ or max_rdm_level < 1) ? 3 : std::min(max_rdm_level, 3);
+            auto rdm = std::move(ci_rdms.compute_rdms_dynamic(
+                {std::make_pair(size_t(root1), size_t(root2))}, level)[0]);
+
+            std::vector<ambit::Tensor*> g{&ordm_a,   &ordm_b,   &trdm_aa,  &trdm_ab, &trdm_bb,
+                                          &trdm_aaa, &trdm_aab, &trdm_abb, &trdm_bbb};
+            std::vector<std::string> labels{"g1a",   "g1b",   "g2aa",  "g2ab", "g2bb",
+                                            "g3aaa", "g3aab", "g3abb", "g3bbb"};
+            for (size_t c = 0; c < rdm.size(); ++c) {
+                *g[c] = ambit::Tensor::build(ambit::CoreTensor, labels[c],
+                                             c < 2 ? dim2 : (c < 5 ? dim4 : dim6));
+                g[c]->data() = std::move(rdm[c]);
+            }
             //        print_nos();
         } else {
             G1 = ambit::Tensor::build(ambit::CoreTensor, "G1", dim2);
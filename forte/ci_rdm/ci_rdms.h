@@ -102,6 +102,15 @@ class CI_RDMS {
                               std::vector<double>& tprdm_bb, std::vector<double>& tprdm_aaa,
                               std::vector<double>& tprdm_aab, std::vector<double>& tprdm_abb,
                               std::vector<double>& tprdm_bbb);
+    /// Compute the spin-dependent RDMs of several pairs of roots with a single threaded sweep
+    /// over the sorted string lists
+    /// @param root_pairs the list of (root1, root2) pairs
+    /// @param max_rdm_level the highest level of the RDMs computed (1, 2, or 3)
+    /// @return for each pair, the RDMs up to max_rdm_level in the order
+    ///         (a, b, aa, ab, bb, aaa, aab, abb, bbb)
+    std::vector<std::vector<std::vector<double>>>
+    compute_rdms_dynamic(const std::vector<std::pair<size_t, size_t>>& root_pairs,
+                         int max_rdm_level);
     void compute_rdms_dynamic_sf(std::vector<double>& rdm1, std::vector<double>& rdm2,
                                  std::vector<double>& rdm3);
 
@@ -236,10 +245,5 @@ class CI_RDMS {
     // Function to fill 3rdm with all (or half of all) permutations of the 6 indices
     void fill_3rdm(std::vector<double>& tprdm, double value, int p, int q, int r, int s, int t,
                    int u, bool half = false);
-
-    // Function to build non-trivial mixed-spin components of 1-, 2-, and 3- RDMs
-    void make_ab(SortedStringList a_sorted_string_list_, const std::vector<String>& sorted_astr,
-                 const std::vector<Determinant>& sorted_a_dets, std::vector<double>& tprdm_ab,
-                 std::vector<double>& tprdm_aab, std::vector<double>& tprdm_abb);
 };
 } // namespace forte
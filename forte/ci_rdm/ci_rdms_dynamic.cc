@@ -26,6 +26,11 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/wavefunction.h"
 
@@ -37,705 +42,719 @@
 #include "base_classes/rdms.h"
 #include "sparse_ci/determinant.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#define omp_get_thread_num() 0
+#endif
+
 using namespace psi;
 
 namespace forte {
 
-void CI_RDMS::compute_rdms_dynamic(std::vector<double>& oprdm_a, std::vector<double>& oprdm_b,
-                                   std::vector<double>& tprdm_aa, std::vector<double>& tprdm_ab,
-                                   std::vector<double>& tprdm_bb, std::vector<double>& tprdm_aaa,
-                                   std::vector<double>& tprdm_aab, std::vector<double>& tprdm_abb,
-                                   std::vector<double>& tprdm_bbb) {
-    oprdm_a.resize(norb2_, 0.0);
-    oprdm_b.resize(norb2_, 0.0);
-
-    tprdm_aa.resize(norb4_, 0.0);
-    tprdm_ab.resize(norb4_, 0.0);
-    tprdm_bb.resize(norb4_, 0.0);
-
-    tprdm_aaa.resize(norb5_ * norb_, 0.0);
-    tprdm_aab.resize(norb5_ * norb_, 0.0);
-    tprdm_abb.resize(norb5_ * norb_, 0.0);
-    tprdm_bbb.resize(norb5_ * norb_, 0.0);
-
-    SortedStringList a_sorted_string_list_(norb_, wfn_, DetSpinType::Alpha);
-    SortedStringList b_sorted_string_list_(norb_, wfn_, DetSpinType::Beta);
-    const std::vector<String>& sorted_bstr = b_sorted_string_list_.sorted_half_dets();
-    size_t num_bstr = sorted_bstr.size();
-    const auto& sorted_b_dets = b_sorted_string_list_.sorted_dets();
-    const auto& sorted_a_dets = a_sorted_string_list_.sorted_dets();
-    local_timer diag;
-    //*-  Diagonal Contributions  -*//
-    for (size_t I = 0; I < dim_space_; ++I) {
-        size_t Ia = b_sorted_string_list_.add(I);
-        double CIa = evecs_->get(Ia, root1_) * evecs_->get(Ia, root2_);
-        String det_a = sorted_b_dets[I].get_alfa_bits();
-        String det_b = sorted_b_dets[I].get_beta_bits();
-
-        for (size_t nda = 0; nda < na_; ++nda) {
-            size_t p = det_a.find_first_one();
-            oprdm_a[p * norb_ + p] += CIa;
-
-            String det_ac(det_a);
-            det_a.clear_first_one();
-            for (size_t ndaa = nda; ndaa < na_; ++ndaa) {
-                size_t q = det_ac.find_first_one();
-                // aa 2-rdm
-                tprdm_aa[p * norb3_ + q * norb2_ + p * norb_ + q] += CIa;
-                tprdm_aa[q * norb3_ + p * norb2_ + q * norb_ + p] += CIa;
-                tprdm_aa[p * norb3_ + q * norb2_ + q * norb_ + p] -= CIa;
-                tprdm_aa[q * norb3_ + p * norb2_ + p * norb_ + q] -= CIa;
-
-                det_ac.clear_first_one();
-                // aaa 3rdm
-                String det_acc(det_ac);
-                for (size_t ndaaa = ndaa + 1; ndaaa < na_; ++ndaaa) {
-                    size_t r = det_acc.find_first_one();
-                    fill_3rdm(tprdm_aaa, CIa, p, q, r, p, q, r, true);
-                    det_acc.clear_first_one();
-                }
+namespace {
+
+/// The spin components of the RDMs computed by the dynamic algorithm
+enum DynamicRDMComponent : size_t {
+    rdm_a,
+    rdm_b,
+    rdm_aa,
+    rdm_ab,
+    rdm_bb,
+    rdm_aaa,
+    rdm_aab,
+    rdm_abb,
+    rdm_bbb,
+    rdm_ncomponents
+};
+
+/// Return the number of elements of a spin component of the RDMs
+size_t component_size(size_t component, size_t norb) {
+    const size_t norb2 = norb * norb;
+    if (component <= rdm_b)
+        return norb2;
+    if (component <= rdm_bb)
+        return norb2 * norb2;
+    return norb2 * norb2 * norb2;
+}
 
-                // aab 3rdm
-                String det_bc(det_b);
-                for (size_t n = 0; n < nb_; ++n) {
-                    size_t r = det_bc.find_first_one();
-                    tprdm_aab[p * norb5_ + q * norb4_ + r * norb3_ + p * norb2_ + q * norb_ + r] +=
-                        CIa;
-                    tprdm_aab[p * norb5_ + q * norb4_ + r * norb3_ + q * norb2_ + p * norb_ + r] -=
-                        CIa;
-                    tprdm_aab[q * norb5_ + p * norb4_ + r * norb3_ + p * norb2_ + q * norb_ + r] -=
-                        CIa;
-                    tprdm_aab[q * norb5_ + p * norb4_ + r * norb3_ + q * norb2_ + p * norb_ + r] +=
-                        CIa;
-
-                    det_bc.clear_first_one();
-                }
-            }
+/// Return the list of orbitals occupied in a string
+std::vector<int> occupied(String s) {
+    std::vector<int> occ;
+    for (size_t n = 0, maxn = s.count(); n < maxn; ++n) {
+        occ.push_back(s.find_and_clear_first_one());
+    }
+    return occ;
+}
+
+/// Return the number of spin components of the RDMs up to a given level
+size_t num_components(int max_rdm_level) {
+    if (max_rdm_level <= 1)
+        return rdm_aa;
+    if (max_rdm_level == 2)
+        return rdm_aaa;
+    return rdm_ncomponents;
+}
 
-            String det_bc(det_b);
-            for (size_t n = 0; n < nb_; ++n) {
-                size_t q = det_bc.find_first_one();
-                tprdm_ab[p * norb3_ + q * norb2_ + p * norb_ + q] += CIa;
-                det_bc.clear_first_one();
+/// @brief Buffers for the RDMs of several pairs of roots
+///
+/// The contributions of all the pairs to a given element are stored contiguously, that is, element
+/// idx of a component for the n-th pair is stored at buffer[idx * npairs + n]. Before adding the
+/// contributions of a pair of determinants (I,J), the weights C_I(root1) C_J(root2) and the
+/// transposed weights C_J(root1) C_I(root2) are set for all the pairs with set_weights(). A call
+/// to add*() adds an element with the first set of weights, while add*_tr() also adds the
+/// transposed element (creation and annihilation indices swapped) with the transposed weights.
+///
+/// The 1- and 2-RDMs are accumulated in buffers private to each thread. The 3-RDMs are too large
+/// to be copied for each thread, so they are accumulated in buffers shared by all the threads
+/// and updated atomically.
+class DynamicRDMAccumulator {
+  public:
+    DynamicRDMAccumulator(size_t norb, const std::vector<std::pair<size_t, size_t>>& pairs,
+                          int max_rdm_level, std::vector<std::vector<double>>& shared)
+        : norb_(norb), norb2_(norb * norb), norb3_(norb2_ * norb), norb4_(norb3_ * norb),
+          norb5_(norb4_ * norb), pairs_(pairs), npairs_(pairs.size()),
+          max_rdm_level_(max_rdm_level), w_(pairs.size()), wt_(pairs.size()) {
+        const size_t ncomponents = num_components(max_rdm_level);
+        for (size_t c = 0; c < ncomponents; ++c) {
+            if (c < rdm_aaa) {
+                buffers_[c].assign(component_size(c, norb) * npairs_, 0.0);
+                data_[c] = buffers_[c].data();
+            } else {
+                data_[c] = shared[c - rdm_aaa].data();
             }
         }
-        det_a = sorted_b_dets[I].get_alfa_bits();
-        det_b = sorted_b_dets[I].get_beta_bits();
-        size_t Ib = a_sorted_string_list_.add(I);
-        double CIb = evecs_->get(Ib, root1_) * evecs_->get(Ib, root2_);
-        for (size_t ndb = 0; ndb < nb_; ++ndb) {
-            size_t p = det_b.find_first_one();
-
-            // b -1rdm
-            oprdm_b[p * norb_ + p] += CIb;
-            String det_bc(det_b);
-            for (size_t ndbb = ndb; ndbb < nb_; ++ndbb) {
-                size_t q = det_bc.find_first_one();
-                // bb-2rdm
-                tprdm_bb[p * norb3_ + q * norb2_ + p * norb_ + q] += CIb;
-                tprdm_bb[q * norb3_ + p * norb2_ + q * norb_ + p] += CIb;
-                tprdm_bb[p * norb3_ + q * norb2_ + q * norb_ + p] -= CIb;
-                tprdm_bb[q * norb3_ + p * norb2_ + p * norb_ + q] -= CIb;
-                det_bc.clear_first_one();
-
-                // bbb-3rdm
-                String det_bcc(det_bc);
-                for (size_t ndbbb = ndbb + 1; ndbbb < nb_; ++ndbbb) {
-                    size_t r = det_bcc.find_first_one();
-                    fill_3rdm(tprdm_bbb, CIa, p, q, r, p, q, r, true);
-                    det_bcc.clear_first_one();
-                }
+    }
+
+    /// Return the highest level of the RDMs accumulated
+    int max_rdm_level() const { return max_rdm_level_; }
+
+    /// Set the weights of each pair from the root-major coefficients of two determinants
+    void set_weights(const double* CI, const double* CJ) {
+        for (size_t n = 0; n < npairs_; ++n) {
+            w_[n] = CI[pairs_[n].first] * CJ[pairs_[n].second];
+            wt_[n] = CJ[pairs_[n].first] * CI[pairs_[n].second];
+        }
+    }
 
-                // abb - 3rdm
-                String det_ac(det_a);
-                for (size_t n = 0; n < na_; ++n) {
-                    size_t r = det_ac.find_first_one();
-                    tprdm_abb[r * norb5_ + p * norb4_ + q * norb3_ + r * norb2_ + p * norb_ + q] +=
-                        CIb;
-                    tprdm_abb[r * norb5_ + p * norb4_ + q * norb3_ + r * norb2_ + q * norb_ + p] -=
-                        CIb;
-                    tprdm_abb[r * norb5_ + q * norb4_ + p * norb3_ + r * norb2_ + p * norb_ + q] -=
-                        CIb;
-                    tprdm_abb[r * norb5_ + q * norb4_ + p * norb3_ + r * norb2_ + q * norb_ + p] +=
-                        CIb;
-
-                    det_ac.clear_first_one();
+    void add1(size_t c, size_t p, size_t q, double sign) { add(c, index1(p, q), sign, w_); }
+    void add2(size_t c, size_t p, size_t q, size_t r, size_t s, double sign) {
+        add(c, index2(p, q, r, s), sign, w_);
+    }
+    void add3(size_t c, size_t p, size_t q, size_t r, size_t s, size_t t, size_t u, double sign) {
+        add(c, index3(p, q, r, s, t, u), sign, w_);
+    }
+
+    void add1_tr(size_t c, size_t p, size_t q, double sign) {
+        add(c, index1(p, q), sign, w_);
+        add(c, index1(q, p), sign, wt_);
+    }
+    void add2_tr(size_t c, size_t p, size_t q, size_t r, size_t s, double sign) {
+        add(c, index2(p, q, r, s), sign, w_);
+        add(c, index2(r, s, p, q), sign, wt_);
+    }
+    void add3_tr(size_t c, size_t p, size_t q, size_t r, size_t s, size_t t, size_t u,
+                 double sign) {
+        add(c, index3(p, q, r, s, t, u), sign, w_);
+        add(c, index3(s, t, u, p, q, r), sign, wt_);
+    }
+
+    /// Add all the antisymmetric permutations of the element <pqr|stu> (and of <stu|pqr> if half
+    /// is false) of a same-spin 3-RDM
+    void fill_3rdm(size_t c, double sign, size_t p, size_t q, size_t r, size_t s, size_t t,
+                   size_t u, bool half) {
+        const size_t cre[6][3] = {{p, q, r}, {p, r, q}, {q, p, r},
+                                  {q, r, p}, {r, p, q}, {r, q, p}};
+        const size_t ann[6][3] = {{s, t, u}, {s, u, t}, {t, s, u},
+                                  {t, u, s}, {u, s, t}, {u, t, s}};
+        const double parity[6] = {1.0, -1.0, -1.0, 1.0, 1.0, -1.0};
+        for (int i = 0; i < 6; ++i) {
+            for (int j = 0; j < 6; ++j) {
+                const double value = sign * parity[i] * parity[j];
+                if (half) {
+                    add3(c, cre[i][0], cre[i][1], cre[i][2], ann[j][0], ann[j][1], ann[j][2],
+                         value);
+                } else {
+                    add3_tr(c, cre[i][0], cre[i][1], cre[i][2], ann[j][0], ann[j][1], ann[j][2],
+                            value);
                 }
             }
-            det_b.clear_first_one();
         }
     }
-    outfile->Printf("\n  Diag takes %1.6f", diag.get());
-
-    local_timer aaa;
-    //-* All Alpha RDMs *-//
-
-    // loop through all beta strings
-    for (size_t bstr = 0; bstr < num_bstr; ++bstr) {
-        const String& Ib = sorted_bstr[bstr];
-        const auto& range_I = b_sorted_string_list_.range(Ib);
-
-        String Ia;
-        String Ja;
-        size_t first_I = range_I.first;
-        size_t last_I = range_I.second;
-
-        // Double loop through determinants with same beta string
-        for (size_t I = first_I; I < last_I; ++I) {
-            Ia = sorted_b_dets[I].get_alfa_bits();
-            double CI = evecs_->get(b_sorted_string_list_.add(I), root1_);
-            for (size_t J = I + 1; J < last_I; ++J) {
-                Ja = sorted_b_dets[J].get_alfa_bits();
-                String IJa = Ia ^ Ja;
-
-                int ndiff = IJa.count();
-
-                if (ndiff == 2) {
-                    // 1-rdm
-                    String Ia_sub = Ia & IJa;
-                    u_int64_t p = Ia_sub.find_first_one();
-                    String Ja_sub = Ja & IJa;
-                    u_int64_t q = Ja_sub.find_first_one();
-
-                    double Csq = CI * evecs_->get(b_sorted_string_list_.add(J), root2_);
-                    double value = Csq * Ia.slater_sign(p, q);
-                    oprdm_a[p * norb_ + q] += value;
-                    oprdm_a[q * norb_ + p] += value;
-
-                    // 2-rdm
-                    auto Iac = Ia;
-                    Iac ^= Ia_sub;
-                    for (size_t nbit_a = 1; nbit_a < na_; nbit_a++) {
-                        uint64_t m = Iac.find_first_one();
-
-                        tprdm_aa[p * norb3_ + m * norb2_ + q * norb_ + m] += value;
-                        tprdm_aa[m * norb3_ + p * norb2_ + q * norb_ + m] -= value;
-                        tprdm_aa[m * norb3_ + p * norb2_ + m * norb_ + q] += value;
-                        tprdm_aa[p * norb3_ + m * norb2_ + m * norb_ + q] -= value;
-
-                        tprdm_aa[q * norb3_ + m * norb2_ + p * norb_ + m] += value;
-                        tprdm_aa[m * norb3_ + q * norb2_ + p * norb_ + m] -= value;
-                        tprdm_aa[m * norb3_ + q * norb2_ + m * norb_ + p] += value;
-                        tprdm_aa[q * norb3_ + m * norb2_ + m * norb_ + p] -= value;
-
-                        Iac.clear_first_one();
-
-                        auto Ibc = Ib;
-                        for (size_t idx = 0; idx < nb_; ++idx) {
-                            uint64_t n = Ibc.find_first_one();
-
-                            tprdm_aab[p * norb5_ + m * norb4_ + n * norb3_ + q * norb2_ +
-                                      m * norb_ + n] += value;
-                            tprdm_aab[p * norb5_ + m * norb4_ + n * norb3_ + m * norb2_ +
-                                      q * norb_ + n] -= value;
-                            tprdm_aab[m * norb5_ + p * norb4_ + n * norb3_ + m * norb2_ +
-                                      q * norb_ + n] += value;
-                            tprdm_aab[m * norb5_ + p * norb4_ + n * norb3_ + q * norb2_ +
-                                      m * norb_ + n] -= value;
-
-                            tprdm_aab[q * norb5_ + m * norb4_ + n * norb3_ + p * norb2_ +
-                                      m * norb_ + n] += value;
-                            tprdm_aab[q * norb5_ + m * norb4_ + n * norb3_ + m * norb2_ +
-                                      p * norb_ + n] -= value;
-                            tprdm_aab[m * norb5_ + q * norb4_ + n * norb3_ + m * norb2_ +
-                                      p * norb_ + n] += value;
-                            tprdm_aab[m * norb5_ + q * norb4_ + n * norb3_ + p * norb2_ +
-                                      m * norb_ + n] -= value;
-                            Ibc.clear_first_one();
-                        }
-                    }
-                    auto Ibc = Ib;
-                    for (size_t nidx = 0; nidx < nb_; ++nidx) {
-                        uint64_t n = Ibc.find_first_one();
-                        tprdm_ab[p * norb3_ + n * norb2_ + q * norb_ + n] += value;
-                        tprdm_ab[q * norb3_ + n * norb2_ + p * norb_ + n] += value;
-                        Ibc.clear_first_one();
-
-                        String Ibcc = Ibc;
-                        for (size_t idx = nidx + 1; idx < nb_; ++idx) {
-                            uint64_t m = Ibcc.find_first_one();
-
-                            tprdm_abb[p * norb5_ + m * norb4_ + n * norb3_ + q * norb2_ +
-                                      m * norb_ + n] += value;
-                            tprdm_abb[p * norb5_ + m * norb4_ + n * norb3_ + q * norb2_ +
-                                      n * norb_ + m] -= value;
-                            tprdm_abb[p * norb5_ + n * norb4_ + m * norb3_ + q * norb2_ +
-                                      n * norb_ + m] += value;
-                            tprdm_abb[p * norb5_ + n * norb4_ + m * norb3_ + q * norb2_ +
-                                      m * norb_ + n] -= value;
-
-                            tprdm_abb[q * norb5_ + m * norb4_ + n * norb3_ + p * norb2_ +
-                                      m * norb_ + n] += value;
-                            tprdm_abb[q * norb5_ + m * norb4_ + n * norb3_ + p * norb2_ +
-                                      n * norb_ + m] -= value;
-                            tprdm_abb[q * norb5_ + n * norb4_ + m * norb3_ + p * norb2_ +
-                                      n * norb_ + m] += value;
-                            tprdm_abb[q * norb5_ + n * norb4_ + m * norb3_ + p * norb2_ +
-                                      m * norb_ + n] -= value;
-                            Ibcc.clear_first_one();
-                        }
-                    }
-                    // 3-rdm
-                    String Iacc = Ia ^ Ia_sub;
-                    for (size_t id = 1; id < na_; ++id) {
-                        uint64_t n = Iacc.find_first_one();
-                        String I_n(Iacc);
-                        I_n.clear_first_one(); // TODO: not clear what is going on here (Francesco)
-                        for (size_t idd = id + 1; idd < na_; ++idd) {
-                            // while( I_n > 0 ){
-                            uint64_t m = I_n.find_first_one();
-                            fill_3rdm(tprdm_aaa, value, p, n, m, q, n, m, false);
-                            I_n.clear_first_one();
-                        }
-                        Iacc.clear_first_one();
-                    }
 
-                } else if (ndiff == 4) {
-                    // 2-rdm
-                    auto Ia_sub = Ia & IJa;
-                    uint64_t p = Ia_sub.find_first_one();
-                    Ia_sub.clear_first_one();
-                    uint64_t q = Ia_sub.find_first_one();
-
-                    auto Ja_sub = Ja & IJa;
-                    uint64_t r = Ja_sub.find_first_one();
-                    Ja_sub.clear_first_one();
-                    uint64_t s = Ja_sub.find_first_one();
-
-                    double Csq = CI * evecs_->get(b_sorted_string_list_.add(J), root2_);
-                    double value = Csq * Ia.slater_sign(p, q) * Ja.slater_sign(r, s);
-
-                    tprdm_aa[p * norb3_ + q * norb2_ + r * norb_ + s] += value;
-                    tprdm_aa[p * norb3_ + q * norb2_ + s * norb_ + r] -= value;
-                    tprdm_aa[q * norb3_ + p * norb2_ + r * norb_ + s] -= value;
-                    tprdm_aa[q * norb3_ + p * norb2_ + s * norb_ + r] += value;
-
-                    tprdm_aa[r * norb3_ + s * norb2_ + p * norb_ + q] += value;
-                    tprdm_aa[s * norb3_ + r * norb2_ + p * norb_ + q] -= value;
-                    tprdm_aa[r * norb3_ + s * norb2_ + q * norb_ + p] -= value;
-                    tprdm_aa[s * norb3_ + r * norb2_ + q * norb_ + p] += value;
-
-                    // 3-rdm
-                    String Iac(Ia);
-                    Iac ^= Ia_sub;
-                    for (size_t nda = 1; nda < na_; ++nda) {
-                        uint64_t n = Iac.find_first_one();
-                        fill_3rdm(tprdm_aaa, value, p, q, n, r, s, n, false);
-                        Iac.clear_first_one();
-                    }
+    const std::vector<double>& buffer(size_t c) const { return buffers_[c]; }
 
-                    String Ibc = Ib;
-                    for (size_t ndb = 0; ndb < nb_; ++ndb) {
-                        uint64_t n = Ibc.find_first_one();
-
-                        tprdm_aab[p * norb5_ + q * norb4_ + n * norb3_ + r * norb2_ + s * norb_ +
-                                  n] += value;
-                        tprdm_aab[p * norb5_ + q * norb4_ + n * norb3_ + s * norb2_ + r * norb_ +
-                                  n] -= value;
-                        tprdm_aab[q * norb5_ + p * norb4_ + n * norb3_ + s * norb2_ + r * norb_ +
-                                  n] += value;
-                        tprdm_aab[q * norb5_ + p * norb4_ + n * norb3_ + r * norb2_ + s * norb_ +
-                                  n] -= value;
-
-                        tprdm_aab[r * norb5_ + s * norb4_ + n * norb3_ + p * norb2_ + q * norb_ +
-                                  n] += value;
-                        tprdm_aab[s * norb5_ + r * norb4_ + n * norb3_ + p * norb2_ + q * norb_ +
-                                  n] -= value;
-                        tprdm_aab[s * norb5_ + r * norb4_ + n * norb3_ + q * norb2_ + p * norb_ +
-                                  n] += value;
-                        tprdm_aab[r * norb5_ + s * norb4_ + n * norb3_ + q * norb2_ + p * norb_ +
-                                  n] -= value;
-                        Ibc.clear_first_one();
-                    }
+  private:
+    size_t index1(size_t p, size_t q) const { return p * norb_ + q; }
+    size_t index2(size_t p, size_t q, size_t r, size_t s) const {
+        return p * norb3_ + q * norb2_ + r * norb_ + s;
+    }
+    size_t index3(size_t p, size_t q, size_t r, size_t s, size_t t, size_t u) const {
+        return p * norb5_ + q * norb4_ + r * norb3_ + s * norb2_ + t * norb_ + u;
+    }
 
-                } else if (ndiff == 6) {
-                    auto Ia_sub = Ia & IJa;
-                    uint64_t p = Ia_sub.find_first_one();
-                    Ia_sub.clear_first_one();
-                    uint64_t q = Ia_sub.find_first_one();
-                    Ia_sub.clear_first_one();
-                    uint64_t r = Ia_sub.find_first_one();
-
-                    auto Ja_sub = Ja & IJa;
-                    uint64_t s = Ja_sub.find_first_one();
-                    Ja_sub.clear_first_one();
-                    uint64_t t = Ja_sub.find_first_one();
-                    Ja_sub.clear_first_one();
-                    uint64_t u = Ja_sub.find_first_one();
-                    double Csq = CI * evecs_->get(b_sorted_string_list_.add(J), root2_);
-                    double el = Csq * Ia.slater_sign(p, q) * Ia.slater_sign(r) *
-                                Ja.slater_sign(s, t) * Ja.slater_sign(u);
-                    fill_3rdm(tprdm_aaa, el, p, q, r, s, t, u, false);
-                }
+    void add(size_t c, size_t idx, double sign, const std::vector<double>& w) {
+        double* x = data_[c] + idx * npairs_;
+        if (c < rdm_aaa) {
+            for (size_t n = 0; n < npairs_; ++n) {
+                x[n] += sign * w[n];
+            }
+        } else {
+            for (size_t n = 0; n < npairs_; ++n) {
+#pragma omp atomic
+                x[n] += sign * w[n];
             }
         }
     }
-    outfile->Printf("\n all alpha takes %1.6f", aaa.get());
-
-    //- All beta RDMs -//
-    local_timer bbb;
-    // loop through all alpha strings
-    const std::vector<String>& sorted_astr = a_sorted_string_list_.sorted_half_dets();
-    size_t num_astr = sorted_astr.size();
-    for (size_t astr = 0; astr < num_astr; ++astr) {
-        const String& Ia = sorted_astr[astr];
-        const auto& range_I = a_sorted_string_list_.range(Ia);
-
-        String Ib;
-        String Jb;
-        String IJb;
-        size_t first_I = range_I.first;
-        size_t last_I = range_I.second;
-
-        // Double loop through determinants with same alpha string
-        for (size_t I = first_I; I < last_I; ++I) {
-            Ib = sorted_a_dets[I].get_beta_bits();
-            double CI = evecs_->get(a_sorted_string_list_.add(I), root1_);
-            for (size_t J = I + 1; J < last_I; ++J) {
-                Jb = sorted_a_dets[J].get_beta_bits();
-                IJb = Ib ^ Jb;
-                int ndiff = IJb.count();
-
-                if (ndiff == 2) {
-                    auto Ib_sub = Ib & IJb;
-                    uint64_t p = Ib_sub.find_first_one();
-                    auto Jb_sub = Jb & IJb;
-                    uint64_t q = Jb_sub.find_first_one();
-                    double Csq = CI * evecs_->get(a_sorted_string_list_.add(J), root2_);
-
-                    double value = Csq * Ib.slater_sign(p, q);
-                    oprdm_b[p * norb_ + q] += value;
-                    oprdm_b[q * norb_ + p] += value;
-                    auto Ibc = Ib;
-                    Ibc ^= Ib_sub;
-                    for (size_t ndb = 1; ndb < nb_; ++ndb) {
-                        uint64_t m = Ibc.find_first_one();
-
-                        tprdm_bb[p * norb3_ + m * norb2_ + q * norb_ + m] += value;
-                        tprdm_bb[m * norb3_ + p * norb2_ + q * norb_ + m] -= value;
-                        tprdm_bb[m * norb3_ + p * norb2_ + m * norb_ + q] += value;
-                        tprdm_bb[p * norb3_ + m * norb2_ + m * norb_ + q] -= value;
-
-                        tprdm_bb[q * norb3_ + m * norb2_ + p * norb_ + m] += value;
-                        tprdm_bb[m * norb3_ + q * norb2_ + p * norb_ + m] -= value;
-                        tprdm_bb[m * norb3_ + q * norb2_ + m * norb_ + p] += value;
-                        tprdm_bb[q * norb3_ + m * norb2_ + m * norb_ + p] -= value;
-
-                        Ibc.clear_first_one();
-
-                        String Iac = Ia;
-                        for (size_t idx = 0; idx < na_; ++idx) {
-                            uint64_t n = Iac.find_first_one();
-
-                            tprdm_abb[n * norb5_ + p * norb4_ + m * norb3_ + n * norb2_ +
-                                      q * norb_ + m] += value;
-                            tprdm_abb[n * norb5_ + p * norb4_ + m * norb3_ + n * norb2_ +
-                                      m * norb_ + q] -= value;
-                            tprdm_abb[n * norb5_ + m * norb4_ + p * norb3_ + n * norb2_ +
-                                      m * norb_ + q] += value;
-                            tprdm_abb[n * norb5_ + m * norb4_ + p * norb3_ + n * norb2_ +
-                                      q * norb_ + m] -= value;
-
-                            tprdm_abb[n * norb5_ + q * norb4_ + m * norb3_ + n * norb2_ +
-                                      p * norb_ + m] += value;
-                            tprdm_abb[n * norb5_ + q * norb4_ + m * norb3_ + n * norb2_ +
-                                      m * norb_ + p] -= value;
-                            tprdm_abb[n * norb5_ + m * norb4_ + q * norb3_ + n * norb2_ +
-                                      m * norb_ + p] += value;
-                            tprdm_abb[n * norb5_ + m * norb4_ + q * norb3_ + n * norb2_ +
-                                      p * norb_ + m] -= value;
-                            Iac.clear_first_one();
-                        }
-                    }
-                    auto Iac = Ia;
-                    for (size_t nidx = 0; nidx < na_; ++nidx) {
-                        uint64_t n = Iac.find_first_one();
-                        tprdm_ab[n * norb3_ + p * norb2_ + n * norb_ + q] += value;
-                        tprdm_ab[n * norb3_ + q * norb2_ + n * norb_ + p] += value;
-                        Iac.clear_first_one();
-
-                        auto Iacc = Iac;
-                        for (size_t midx = nidx + 1; midx < na_; ++midx) {
-                            uint64_t m = Iacc.find_first_one();
-
-                            tprdm_aab[n * norb5_ + m * norb4_ + p * norb3_ + n * norb2_ +
-                                      m * norb_ + q] += value;
-                            tprdm_aab[n * norb5_ + m * norb4_ + p * norb3_ + m * norb2_ +
-                                      n * norb_ + q] -= value;
-                            tprdm_aab[m * norb5_ + n * norb4_ + p * norb3_ + m * norb2_ +
-                                      n * norb_ + q] += value;
-                            tprdm_aab[m * norb5_ + n * norb4_ + p * norb3_ + n * norb2_ +
-                                      m * norb_ + q] -= value;
-
-                            tprdm_aab[n * norb5_ + m * norb4_ + q * norb3_ + n * norb2_ +
-                                      m * norb_ + p] += value;
-                            tprdm_aab[n * norb5_ + m * norb4_ + q * norb3_ + m * norb2_ +
-                                      n * norb_ + p] -= value;
-                            tprdm_aab[m * norb5_ + n * norb4_ + q * norb3_ + m * norb2_ +
-                                      n * norb_ + p] += value;
-                            tprdm_aab[m * norb5_ + n * norb4_ + q * norb3_ + n * norb2_ +
-                                      m * norb_ + p] -= value;
-                            Iacc.clear_first_one();
-                        }
-                    }
-                    // 3-rdm
-                    String Ibcc(Ib);
-                    Ibcc ^= Ib_sub;
-                    for (size_t ndb = 1; ndb < nb_; ++ndb) {
-                        // while(Ibcc >0){
-                        uint64_t n = Ibcc.find_first_one();
-                        Ibcc.clear_first_one();
-                        String I_n = Ibcc;
-                        for (size_t ndbb = ndb + 1; ndbb < nb_; ++ndbb) {
-                            // while( I_n > 0){
-                            uint64_t m = I_n.find_first_one();
-                            fill_3rdm(tprdm_bbb, value, p, m, n, q, m, n, false);
-                            I_n.clear_first_one();
-                        }
-                    }
-                } else if (ndiff == 4) {
-                    auto Ib_sub = Ib & IJb;
-                    uint64_t p = Ib_sub.find_first_one();
-                    Ib_sub.clear_first_one();
-                    uint64_t q = Ib_sub.find_first_one();
-
-                    auto Jb_sub = Jb & IJb;
-                    uint64_t r = Jb_sub.find_first_one();
-                    Jb_sub.clear_first_one();
-                    uint64_t s = Jb_sub.find_first_one();
-
-                    double Csq = CI * evecs_->get(a_sorted_string_list_.add(J), root2_);
-                    double value = Csq * Ib.slater_sign(p, q) * Jb.slater_sign(r, s);
-
-                    tprdm_bb[p * norb3_ + q * norb2_ + r * norb_ + s] += value;
-                    tprdm_bb[p * norb3_ + q * norb2_ + s * norb_ + r] -= value;
-                    tprdm_bb[q * norb3_ + p * norb2_ + r * norb_ + s] -= value;
-                    tprdm_bb[q * norb3_ + p * norb2_ + s * norb_ + r] += value;
-
-                    tprdm_bb[r * norb3_ + s * norb2_ + p * norb_ + q] += value;
-                    tprdm_bb[s * norb3_ + r * norb2_ + p * norb_ + q] -= value;
-                    tprdm_bb[r * norb3_ + s * norb2_ + q * norb_ + p] -= value;
-                    tprdm_bb[s * norb3_ + r * norb2_ + q * norb_ + p] += value;
-
-                    // 3-rdm
-                    auto Ibc = Ib;
-                    Ibc ^= Ib_sub;
-                    for (size_t ndb = 1; ndb < nb_; ++ndb) {
-                        uint64_t n = Ibc.find_first_one();
-                        fill_3rdm(tprdm_bbb, value, p, q, n, r, s, n, false);
-                        Ibc.clear_first_one();
+
+    size_t norb_, norb2_, norb3_, norb4_, norb5_;
+    const std::vector<std::pair<size_t, size_t>>& pairs_;
+    size_t npairs_;
+    int max_rdm_level_;
+    /// The weights C_I(root1) C_J(root2) of each pair
+    std::vector<double> w_;
+    /// The transposed weights C_J(root1) C_I(root2) of each pair
+    std::vector<double> wt_;
+    std::array<std::vector<double>, rdm_aaa> buffers_;
+    std::array<double*, rdm_ncomponents> data_{};
+};
+
+/// Add the contributions of a determinant with occupied orbitals occ_a and occ_b to the RDMs
+void add_diagonal(DynamicRDMAccumulator& acc, const std::vector<int>& occ_a,
+                  const std::vector<int>& occ_b) {
+    const int level = acc.max_rdm_level();
+    const size_t na = occ_a.size();
+    const size_t nb = occ_b.size();
+    for (size_t i = 0; i < na; ++i) {
+        const int p = occ_a[i];
+        acc.add1(rdm_a, p, p, 1.0);
+        if (level < 2)
+            continue;
+        for (size_t j = i + 1; j < na; ++j) {
+            const int q = occ_a[j];
+            acc.add2(rdm_aa, p, q, p, q, 1.0);
+            acc.add2(rdm_aa, q, p, q, p, 1.0);
+            acc.add2(rdm_aa, p, q, q, p, -1.0);
+            acc.add2(rdm_aa, q, p, p, q, -1.0);
+            if (level < 3)
+                continue;
+            for (size_t k = j + 1; k < na; ++k) {
+                const int r = occ_a[k];
+                acc.fill_3rdm(rdm_aaa, 1.0, p, q, r, p, q, r, true);
+            }
+            for (int r : occ_b) {
+                acc.add3(rdm_aab, p, q, r, p, q, r, 1.0);
+                acc.add3(rdm_aab, p, q, r, q, p, r, -1.0);
+                acc.add3(rdm_aab, q, p, r, p, q, r, -1.0);
+                acc.add3(rdm_aab, q, p, r, q, p, r, 1.0);
+            }
+        }
+        for (int q : occ_b) {
+            acc.add2(rdm_ab, p, q, p, q, 1.0);
+        }
+    }
+    for (size_t i = 0; i < nb; ++i) {
+        const int p = occ_b[i];
+        acc.add1(rdm_b, p, p, 1.0);
+        if (level < 2)
+            continue;
+        for (size_t j = i + 1; j < nb; ++j) {
+            const int q = occ_b[j];
+            acc.add2(rdm_bb, p, q, p, q, 1.0);
+            acc.add2(rdm_bb, q, p, q, p, 1.0);
+            acc.add2(rdm_bb, p, q, q, p, -1.0);
+            acc.add2(rdm_bb, q, p, p, q, -1.0);
+            if (level < 3)
+                continue;
+            for (size_t k = j + 1; k < nb; ++k) {
+                const int r = occ_b[k];
+                acc.fill_3rdm(rdm_bbb, 1.0, p, q, r, p, q, r, true);
+            }
+            for (int r : occ_a) {
+                acc.add3(rdm_abb, r, p, q, r, p, q, 1.0);
+                acc.add3(rdm_abb, r, p, q, r, q, p, -1.0);
+                acc.add3(rdm_abb, r, q, p, r, p, q, -1.0);
+                acc.add3(rdm_abb, r, q, p, r, q, p, 1.0);
+            }
+        }
+    }
+}
+
+/// Add the contributions of a pair of determinants (I,J) that differ only in the alpha string and
+/// of the transposed pair (J,I). The weights of acc must be set for (I,J).
+void add_alpha_excitation(DynamicRDMAccumulator& acc, const String& Ia, const String& Ja,
+                          const std::vector<int>& occ_b) {
+    const int level = acc.max_rdm_level();
+    const String IJa = Ia ^ Ja;
+    const int ndiff = IJa.count();
+    if (ndiff > 2 * level)
+        return;
+    const auto occ_I = occupied(Ia & IJa);
+    const auto occ_J = occupied(Ja & IJa);
+    if (ndiff == 2) {
+        const int p = occ_I[0];
+        const int q = occ_J[0];
+        const double sign = Ia.slater_sign(p, q);
+        acc.add1_tr(rdm_a, p, q, sign);
+        if (level < 2)
+            return;
+
+        String Iac = Ia;
+        Iac.set_bit(p, false);
+        const auto occ_a = occupied(Iac);
+        for (int m : occ_a) {
+            acc.add2_tr(rdm_aa, p, m, q, m, sign);
+            acc.add2_tr(rdm_aa, m, p, q, m, -sign);
+            acc.add2_tr(rdm_aa, m, p, m, q, sign);
+            acc.add2_tr(rdm_aa, p, m, m, q, -sign);
+            if (level < 3)
+                continue;
+            for (int n : occ_b) {
+                acc.add3_tr(rdm_aab, p, m, n, q, m, n, sign);
+                acc.add3_tr(rdm_aab, p, m, n, m, q, n, -sign);
+                acc.add3_tr(rdm_aab, m, p, n, m, q, n, sign);
+                acc.add3_tr(rdm_aab, m, p, n, q, m, n, -sign);
+            }
+        }
+        for (size_t i = 0, nb = occ_b.size(); i < nb; ++i) {
+            const int n = occ_b[i];
+            acc.add2_tr(rdm_ab, p, n, q, n, sign);
+            if (level < 3)
+                continue;
+            for (size_t j = i + 1; j < nb; ++j) {
+                const int m = occ_b[j];
+                acc.add3_tr(rdm_abb, p, m, n, q, m, n, sign);
+                acc.add3_tr(rdm_abb, p, m, n, q, n, m, -sign);
+                acc.add3_tr(rdm_abb, p, n, m, q, n, m, sign);
+                acc.add3_tr(rdm_abb, p, n, m, q, m, n, -sign);
+            }
+        }
+        if (level < 3)
+            return;
+        for (size_t i = 0, na = occ_a.size(); i < na; ++i) {
+            for (size_t j = i + 1; j < na; ++j) {
+                acc.fill_3rdm(rdm_aaa, sign, p, occ_a[i], occ_a[j], q, occ_a[i], occ_a[j], false);
+            }
+        }
+    } else if (ndiff == 4) {
+        const int p = occ_I[0];
+        const int q = occ_I[1];
+        const int r = occ_J[0];
+        const int s = occ_J[1];
+        const double sign = Ia.slater_sign(p, q) * Ja.slater_sign(r, s);
+        acc.add2_tr(rdm_aa, p, q, r, s, sign);
+        acc.add2_tr(rdm_aa, p, q, s, r, -sign);
+        acc.add2_tr(rdm_aa, q, p, r, s, -sign);
+        acc.add2_tr(rdm_aa, q, p, s, r, sign);
+        if (level < 3)
+            return;
+
+        for (int n : occupied(Ia & Ja)) {
+            acc.fill_3rdm(rdm_aaa, sign, p, q, n, r, s, n, false);
+        }
+        for (int n : occ_b) {
+            acc.add3_tr(rdm_aab, p, q, n, r, s, n, sign);
+            acc.add3_tr(rdm_aab, p, q, n, s, r, n, -sign);
+            acc.add3_tr(rdm_aab, q, p, n, s, r, n, sign);
+            acc.add3_tr(rdm_aab, q, p, n, r, s, n, -sign);
+        }
+    } else if (ndiff == 6) {
+        const int p = occ_I[0];
+        const int q = occ_I[1];
+        const int r = occ_I[2];
+        const int s = occ_J[0];
+        const int t = occ_J[1];
+        const int u = occ_J[2];
+        const double sign =
+            Ia.slater_sign(p, q) * Ia.slater_sign(r) * Ja.slater_sign(s, t) * Ja.slater_sign(u);
+        acc.fill_3rdm(rdm_aaa, sign, p, q, r, s, t, u, false);
+    }
+}
+
+/// Add the contributions of a pair of determinants (I,J) that differ only in the beta string and
+/// of the transposed pair (J,I). The weights of acc must be set for (I,J).
+void add_beta_excitation(DynamicRDMAccumulator& acc, const String& Ib, const String& Jb,
+                         const std::vector<int>& occ_a) {
+    const int level = acc.max_rdm_level();
+    const String IJb = Ib ^ Jb;
+    const int ndiff = IJb.count();
+    if (ndiff > 2 * level)
+        return;
+    const auto occ_I = occupied(Ib & IJb);
+    const auto occ_J = occupied(Jb & IJb);
+    if (ndiff == 2) {
+        const int p = occ_I[0];
+        const int q = occ_J[0];
+        const double sign = Ib.slater_sign(p, q);
+        acc.add1_tr(rdm_b, p, q, sign);
+        if (level < 2)
+            return;
+
+        String Ibc = Ib;
+        Ibc.set_bit(p, false);
+        const auto occ_b = occupied(Ibc);
+        for (int m : occ_b) {
+            acc.add2_tr(rdm_bb, p, m, q, m, sign);
+            acc.add2_tr(rdm_bb, m, p, q, m, -sign);
+            acc.add2_tr(rdm_bb, m, p, m, q, sign);
+            acc.add2_tr(rdm_bb, p, m, m, q, -sign);
+            if (level < 3)
+                continue;
+            for (int n : occ_a) {
+                acc.add3_tr(rdm_abb, n, p, m, n, q, m, sign);
+                acc.add3_tr(rdm_abb, n, p, m, n, m, q, -sign);
+                acc.add3_tr(rdm_abb, n, m, p, n, m, q, sign);
+                acc.add3_tr(rdm_abb, n, m, p, n, q, m, -sign);
+            }
+        }
+        for (size_t i = 0, na = occ_a.size(); i < na; ++i) {
+            const int n = occ_a[i];
+            acc.add2_tr(rdm_ab, n, p, n, q, sign);
+            if (level < 3)
+                continue;
+            for (size_t j = i + 1; j < na; ++j) {
+                const int m = occ_a[j];
+                acc.add3_tr(rdm_aab, n, m, p, n, m, q, sign);
+                acc.add3_tr(rdm_aab, n, m, p, m, n, q, -sign);
+                acc.add3_tr(rdm_aab, m, n, p, m, n, q, sign);
+                acc.add3_tr(rdm_aab, m, n, p, n, m, q, -sign);
+            }
+        }
+        if (level < 3)
+            return;
+        for (size_t i = 0, nb = occ_b.size(); i < nb; ++i) {
+            for (size_t j = i + 1; j < nb; ++j) {
+                acc.fill_3rdm(rdm_bbb, sign, p, occ_b[j], occ_b[i], q, occ_b[j], occ_b[i], false);
+            }
+        }
+    } else if (ndiff == 4) {
+        const int p = occ_I[0];
+        const int q = occ_I[1];
+        const int r = occ_J[0];
+        const int s = occ_J[1];
+        const double sign = Ib.slater_sign(p, q) * Jb.slater_sign(r, s);
+        acc.add2_tr(rdm_bb, p, q, r, s, sign);
+        acc.add2_tr(rdm_bb, p, q, s, r, -sign);
+        acc.add2_tr(rdm_bb, q, p, r, s, -sign);
+        acc.add2_tr(rdm_bb, q, p, s, r, sign);
+        if (level < 3)
+            return;
+
+        for (int n : occupied(Ib & Jb)) {
+            acc.fill_3rdm(rdm_bbb, sign, p, q, n, r, s, n, false);
+        }
+        for (int n : occ_a) {
+            acc.add3_tr(rdm_abb, n, p, q, n, r, s, sign);
+            acc.add3_tr(rdm_abb, n, p, q, n, s, r, -sign);
+            acc.add3_tr(rdm_abb, n, q, p, n, s, r, sign);
+            acc.add3_tr(rdm_abb, n, q, p, n, r, s, -sign);
+        }
+    } else if (ndiff == 6) {
+        const int p = occ_I[0];
+        const int q = occ_I[1];
+        const int r = occ_I[2];
+        const int s = occ_J[0];
+        const int t = occ_J[1];
+        const int u = occ_J[2];
+        const double sign =
+            Ib.slater_sign(p, q) * Ib.slater_sign(r) * Jb.slater_sign(s, t) * Jb.slater_sign(u);
+        acc.fill_3rdm(rdm_bbb, sign, p, q, r, s, t, u, false);
+    }
+}
+
+/// Add the contributions of all pairs of determinants with alpha strings Ia (range_I) and Ja
+/// (range_J) that differ in both the alpha and beta strings
+void add_alpha_beta_excitations(DynamicRDMAccumulator& acc, const String& Ia, const String& Ja,
+                                const std::pair<size_t, size_t>& range_I,
+                                const std::pair<size_t, size_t>& range_J,
+                                const std::vector<Determinant>& sorted_dets,
+                                const std::vector<double>& C, size_t nroots) {
+    const int level = acc.max_rdm_level();
+    const String IJa = Ia ^ Ja;
+    const int ndiff = IJa.count();
+    if ((ndiff != 2) and (ndiff != 4))
+        return;
+    // double alpha excitations only contribute to the 3-RDMs
+    if ((ndiff == 4) and (level < 3))
+        return;
+    const auto occ_Ia = occupied(Ia & IJa);
+    const auto occ_Ja = occupied(Ja & IJa);
+
+    if (ndiff == 2) {
+        const int p = occ_Ia[0];
+        const int s = occ_Ja[0];
+        const double sign_ps = Ia.slater_sign(p, s);
+        const double sign_IJ = Ia.slater_sign(p) * Ja.slater_sign(s);
+        String Iac = Ia;
+        Iac.set_bit(p, false);
+        const auto occ_a = occupied(Iac);
+        for (size_t I = range_I.first; I < range_I.second; ++I) {
+            const String Ib = sorted_dets[I].get_beta_bits();
+            for (size_t J = range_J.first; J < range_J.second; ++J) {
+                const String Jb = sorted_dets[J].get_beta_bits();
+                const String IJb = Ib ^ Jb;
+                const int nbdiff = IJb.count();
+                if (nbdiff == 2) {
+                    acc.set_weights(&C[I * nroots], &C[J * nroots]);
+                    const int q = (Ib & IJb).find_first_one();
+                    const int r = (Jb & IJb).find_first_one();
+                    const double sign = sign_ps * Ib.slater_sign(q, r);
+                    acc.add2(rdm_ab, p, q, s, r, sign);
+                    if (level < 3)
+                        continue;
+                    for (int n : occ_a) {
+                        acc.add3(rdm_aab, p, n, q, s, n, r, sign);
+                        acc.add3(rdm_aab, n, p, q, s, n, r, -sign);
+                        acc.add3(rdm_aab, n, p, q, n, s, r, sign);
+                        acc.add3(rdm_aab, p, n, q, n, s, r, -sign);
                     }
-                    auto Iac = Ia;
-                    for (size_t nda = 0; nda < na_; ++nda) {
-                        uint64_t n = Iac.find_first_one();
-
-                        tprdm_abb[n * norb5_ + p * norb4_ + q * norb3_ + n * norb2_ + r * norb_ +
-                                  s] += value;
-                        tprdm_abb[n * norb5_ + p * norb4_ + q * norb3_ + n * norb2_ + s * norb_ +
-                                  r] -= value;
-                        tprdm_abb[n * norb5_ + q * norb4_ + p * norb3_ + n * norb2_ + s * norb_ +
-                                  r] += value;
-                        tprdm_abb[n * norb5_ + q * norb4_ + p * norb3_ + n * norb2_ + r * norb_ +
-                                  s] -= value;
-
-                        tprdm_abb[n * norb5_ + r * norb4_ + s * norb3_ + n * norb2_ + p * norb_ +
-                                  q] += value;
-                        tprdm_abb[n * norb5_ + r * norb4_ + s * norb3_ + n * norb2_ + q * norb_ +
-                                  p] -= value;
-                        tprdm_abb[n * norb5_ + s * norb4_ + r * norb3_ + n * norb2_ + q * norb_ +
-                                  p] += value;
-                        tprdm_abb[n * norb5_ + s * norb4_ + r * norb3_ + n * norb2_ + p * norb_ +
-                                  q] -= value;
-
-                        Iac.clear_first_one();
+                    String Ibc = Ib;
+                    Ibc.set_bit(q, false);
+                    for (int n : occupied(Ibc)) {
+                        acc.add3(rdm_abb, p, q, n, s, r, n, sign);
+                        acc.add3(rdm_abb, p, q, n, s, n, r, -sign);
+                        acc.add3(rdm_abb, p, n, q, s, n, r, sign);
+                        acc.add3(rdm_abb, p, n, q, s, r, n, -sign);
                     }
-                } else if (ndiff == 6) {
-                    auto Ib_sub = Ib & IJb;
-                    uint64_t p = Ib_sub.find_first_one();
-                    Ib_sub.clear_first_one();
-                    uint64_t q = Ib_sub.find_first_one();
-                    Ib_sub.clear_first_one();
-                    uint64_t r = Ib_sub.find_first_one();
-
-                    auto Jb_sub = Jb & IJb;
-                    uint64_t s = Jb_sub.find_first_one();
-                    Jb_sub.clear_first_one();
-                    uint64_t t = Jb_sub.find_first_one();
-                    Jb_sub.clear_first_one();
-                    uint64_t u = Jb_sub.find_first_one();
-                    double Csq = CI * evecs_->get(a_sorted_string_list_.add(J), root2_);
-                    double el = Csq * Ib.slater_sign(p, q) * Ib.slater_sign(r) *
-                                Jb.slater_sign(s, t) * Jb.slater_sign(u);
-                    fill_3rdm(tprdm_bbb, el, p, q, r, s, t, u, false);
+                } else if ((nbdiff == 4) and (level >= 3)) {
+                    acc.set_weights(&C[I * nroots], &C[J * nroots]);
+                    const auto occ_Ib = occupied(Ib & IJb);
+                    const auto occ_Jb = occupied(Jb & IJb);
+                    const int q = occ_Ib[0];
+                    const int r = occ_Ib[1];
+                    const int t = occ_Jb[0];
+                    const int u = occ_Jb[1];
+                    const double sign = sign_IJ * Ib.slater_sign(q, r) * Jb.slater_sign(t, u);
+                    acc.add3(rdm_abb, p, q, r, s, t, u, sign);
+                    acc.add3(rdm_abb, p, q, r, s, u, t, -sign);
+                    acc.add3(rdm_abb, p, r, q, s, u, t, sign);
+                    acc.add3(rdm_abb, p, r, q, s, t, u, -sign);
                 }
             }
         }
+    } else {
+        const int p = occ_Ia[0];
+        const int q = occ_Ia[1];
+        const int s = occ_Ja[0];
+        const int t = occ_Ja[1];
+        const double sign_IJ = Ia.slater_sign(p, q) * Ja.slater_sign(s, t);
+        for (size_t I = range_I.first; I < range_I.second; ++I) {
+            const String Ib = sorted_dets[I].get_beta_bits();
+            for (size_t J = range_J.first; J < range_J.second; ++J) {
+                const String Jb = sorted_dets[J].get_beta_bits();
+                const String IJb = Ib ^ Jb;
+                if (IJb.count() != 2)
+                    continue;
+                acc.set_weights(&C[I * nroots], &C[J * nroots]);
+                const int r = (Ib & IJb).find_first_one();
+                const int u = (Jb & IJb).find_first_one();
+                const double sign = sign_IJ * Ib.slater_sign(r) * Jb.slater_sign(u);
+                acc.add3(rdm_aab, p, q, r, s, t, u, sign);
+                acc.add3(rdm_aab, p, q, r, t, s, u, -sign);
+                acc.add3(rdm_aab, q, p, r, s, t, u, -sign);
+                acc.add3(rdm_aab, q, p, r, t, s, u, sign);
+            }
+        }
     }
-    outfile->Printf("\n all beta takes %1.6f", bbb.get());
-    make_ab(a_sorted_string_list_, sorted_astr, sorted_a_dets, tprdm_ab, tprdm_aab, tprdm_abb);
 }
-//*- Alpha/Beta  -*//
-void CI_RDMS::make_ab(SortedStringList a_sorted_string_list_,
-                      const std::vector<String>& sorted_astr,
-                      const std::vector<Determinant>& sorted_a_dets, std::vector<double>& tprdm_ab,
-                      std::vector<double>& tprdm_aab, std::vector<double>& tprdm_abb) {
-    local_timer mix;
-    double d2 = 0.0;
-    double d4 = 0.0;
-    for (auto& detIa : sorted_astr) {
-        const auto& range_I = a_sorted_string_list_.range(detIa);
-        String detIJa_common;
-        String Ib;
-        String Jb;
-        String IJb;
-        for (auto& detJa : sorted_astr) {
-            detIJa_common = detIa ^ detJa;
-            int ndiff = detIJa_common.count();
-            if (ndiff == 2) {
-                local_timer t2;
-                auto Ia_d = detIa & detIJa_common;
-                uint64_t p = Ia_d.find_first_one();
-                auto Ja_d = detJa & detIJa_common;
-                uint64_t s = Ja_d.find_first_one();
-
-                const auto& range_J = a_sorted_string_list_.range(detJa);
-                size_t first_I = range_I.first;
-                size_t last_I = range_I.second;
-                size_t first_J = range_J.first;
-                size_t last_J = range_J.second;
-                double sign_Ips = detIa.slater_sign(p, s);
-                double sign_IJ = detIa.slater_sign(p) * detJa.slater_sign(s);
-                for (size_t I = first_I; I < last_I; ++I) {
-                    Ib = sorted_a_dets[I].get_beta_bits();
-                    double CI = evecs_->get(a_sorted_string_list_.add(I), root1_);
-                    for (size_t J = first_J; J < last_J; ++J) {
-                        Jb = sorted_a_dets[J].get_beta_bits();
-                        IJb = Ib ^ Jb;
-                        int nbdiff = IJb.count();
-                        if (nbdiff == 2) {
-                            double Csq = CI * evecs_->get(a_sorted_string_list_.add(J), root2_);
-                            auto Ib_sub = Ib & IJb;
-                            uint64_t q = Ib_sub.find_first_one();
-                            auto Jb_sub = Jb & IJb;
-                            uint64_t r = Jb_sub.find_first_one();
-
-                            double value =
-                                Csq * sign_Ips * Ib.slater_sign(q, r); // * ui64_slater_sign(Jb,r);
-                            tprdm_ab[p * norb3_ + q * norb2_ + s * norb_ + r] += value;
-
-                            auto Iac(detIa);
-                            Iac ^= Ia_d;
-                            for (size_t d = 1; d < na_; ++d) {
-                                uint64_t n = Iac.find_first_one();
-                                tprdm_aab[p * norb5_ + n * norb4_ + q * norb3_ + s * norb2_ +
-                                          n * norb_ + r] += value;
-                                tprdm_aab[n * norb5_ + p * norb4_ + q * norb3_ + s * norb2_ +
-                                          n * norb_ + r] -= value;
-                                tprdm_aab[n * norb5_ + p * norb4_ + q * norb3_ + n * norb2_ +
-                                          s * norb_ + r] += value;
-                                tprdm_aab[p * norb5_ + n * norb4_ + q * norb3_ + n * norb2_ +
-                                          s * norb_ + r] -= value;
-
-                                Iac.clear_first_one();
-                            }
-                            auto Ibc(Ib);
-                            Ibc ^= Ib_sub;
-                            for (size_t d = 1; d < nb_; ++d) {
-                                uint64_t n = Ibc.find_first_one();
-                                tprdm_abb[p * norb5_ + q * norb4_ + n * norb3_ + s * norb2_ +
-                                          r * norb_ + n] += value;
-                                tprdm_abb[p * norb5_ + q * norb4_ + n * norb3_ + s * norb2_ +
-                                          n * norb_ + r] -= value;
-                                tprdm_abb[p * norb5_ + n * norb4_ + q * norb3_ + s * norb2_ +
-                                          n * norb_ + r] += value;
-                                tprdm_abb[p * norb5_ + n * norb4_ + q * norb3_ + s * norb2_ +
-                                          r * norb_ + n] -= value;
-
-                                Ibc.clear_first_one();
-                            }
-                        } else if (nbdiff == 4) {
-                            double Csq = CI * evecs_->get(a_sorted_string_list_.add(J), root2_);
-                            auto Ib_sub = Ib & IJb;
-                            uint64_t q = Ib_sub.find_first_one();
-                            Ib_sub.clear_first_one();
-                            uint64_t r = Ib_sub.find_first_one();
-
-                            auto Jb_sub = Jb & IJb;
-                            uint64_t t = Jb_sub.find_first_one();
-                            Jb_sub.clear_first_one();
-                            uint64_t u = Jb_sub.find_first_one();
-
-                            double value = Csq * sign_IJ *
-                                           Ib.slater_sign(q, r) * // ui64_slater_sign(Ib,r) *
-                                           Jb.slater_sign(t, u);  // * ui64_slater_sign(Jb,u);
-                            tprdm_abb[p * norb5_ + q * norb4_ + r * norb3_ + s * norb2_ +
-                                      t * norb_ + u] += value;
-                            tprdm_abb[p * norb5_ + q * norb4_ + r * norb3_ + s * norb2_ +
-                                      u * norb_ + t] -= value;
-                            tprdm_abb[p * norb5_ + r * norb4_ + q * norb3_ + s * norb2_ +
-                                      u * norb_ + t] += value;
-                            tprdm_abb[p * norb5_ + r * norb4_ + q * norb3_ + s * norb2_ +
-                                      t * norb_ + u] -= value;
-                        }
-                    }
+
+/// Gather the CI coefficients of the roots in the order of a sorted string list, storing the
+/// coefficients of each determinant contiguously
+std::vector<double> sorted_coefficients(const SortedStringList& list, size_t ndets,
+                                        const psi::Matrix& evecs,
+                                        const std::vector<size_t>& roots) {
+    const size_t nroots = roots.size();
+    std::vector<double> C(ndets * nroots);
+    for (size_t I = 0; I < ndets; ++I) {
+        const size_t add_I = list.add(I);
+        for (size_t k = 0; k < nroots; ++k) {
+            C[I * nroots + k] = evecs.get(add_I, roots[k]);
+        }
+    }
+    return C;
+}
+} // namespace
+
+void CI_RDMS::compute_rdms_dynamic(std::vector<double>& oprdm_a, std::vector<double>& oprdm_b,
+                                   std::vector<double>& tprdm_aa, std::vector<double>& tprdm_ab,
+                                   std::vector<double>& tprdm_bb, std::vector<double>& tprdm_aaa,
+                                   std::vector<double>& tprdm_aab, std::vector<double>& tprdm_abb,
+                                   std::vector<double>& tprdm_bbb) {
+    auto rdms = compute_rdms_dynamic({std::make_pair(size_t(root1_), size_t(root2_))}, 3);
+    auto& rdm = rdms[0];
+    oprdm_a = std::move(rdm[rdm_a]);
+    oprdm_b = std::move(rdm[rdm_b]);
+    tprdm_aa = std::move(rdm[rdm_aa]);
+    tprdm_ab = std::move(rdm[rdm_ab]);
+    tprdm_bb = std::move(rdm[rdm_bb]);
+    tprdm_aaa = std::move(rdm[rdm_aaa]);
+    tprdm_aab = std::move(rdm[rdm_aab]);
+    tprdm_abb = std::move(rdm[rdm_abb]);
+    tprdm_bbb = std::move(rdm[rdm_bbb]);
+}
+
+std::vector<std::vector<std::vector<double>>>
+CI_RDMS::compute_rdms_dynamic(const std::vector<std::pair<size_t, size_t>>& root_pairs,
+                              int max_rdm_level) {
+    if (max_rdm_level > 3 || max_rdm_level < 1) {
+        throw std::runtime_error("Invalid max_rdm_level, required 1 <= max_rdm_level <= 3.");
+    }
+    local_timer total;
+
+    // map the roots to a contiguous range so that only the coefficients we need are gathered
+    std::vector<size_t> roots;
+    for (const auto& [r1, r2] : root_pairs) {
+        roots.push_back(r1);
+        roots.push_back(r2);
+    }
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    const size_t nroots = roots.size();
+    auto root_index = [&](size_t r) {
+        return std::lower_bound(roots.begin(), roots.end(), r) - roots.begin();
+    };
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (const auto& [r1, r2] : root_pairs) {
+        pairs.emplace_back(root_index(r1), root_index(r2));
+    }
+    const size_t npairs = pairs.size();
+    const size_t ncomponents = num_components(max_rdm_level);
+    const size_t nprivate = std::min(ncomponents, size_t(rdm_aaa));
+
+    SortedStringList a_sorted_string_list(norb_, wfn_, DetSpinType::Alpha);
+    SortedStringList b_sorted_string_list(norb_, wfn_, DetSpinType::Beta);
+    const auto& sorted_astr = a_sorted_string_list.sorted_half_dets();
+    const auto& sorted_bstr = b_sorted_string_list.sorted_half_dets();
+    const auto& sorted_a_dets = a_sorted_string_list.sorted_dets();
+    const auto& sorted_b_dets = b_sorted_string_list.sorted_dets();
+    const size_t num_astr = sorted_astr.size();
+    const size_t num_bstr = sorted_bstr.size();
+
+    const auto Ca = sorted_coefficients(a_sorted_string_list, dim_space_, *evecs_, roots);
+    const auto Cb = sorted_coefficients(b_sorted_string_list, dim_space_, *evecs_, roots);
+
+    // the 3-RDMs are shared by all threads
+    std::vector<std::vector<double>> shared(ncomponents - nprivate);
+    for (size_t c = nprivate; c < ncomponents; ++c) {
+        shared[c - nprivate].assign(component_size(c, norb_) * npairs, 0.0);
+    }
+
+    // each thread accumulates the 1- and 2-RDMs into its own buffers, so we limit the number of
+    // threads to keep these buffers within half of the available memory
+    size_t acc_size = 0;
+    for (size_t c = 0; c < nprivate; ++c) {
+        acc_size += component_size(c, norb_) * npairs;
+    }
+    const size_t mem_threads =
+        psi::Process::environment.get_memory() / (2 * sizeof(double) * acc_size);
+    const int nthreads =
+        std::max(1, std::min(omp_get_max_threads(), static_cast<int>(mem_threads)));
+
+    std::vector<std::unique_ptr<DynamicRDMAccumulator>> accumulators(nthreads);
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        const int thread = omp_get_thread_num();
+        accumulators[thread] =
+            std::make_unique<DynamicRDMAccumulator>(norb_, pairs, max_rdm_level, shared);
+        auto& acc = *accumulators[thread];
+
+        //*-  Diagonal Contributions  -*//
+#pragma omp for schedule(dynamic, 64) nowait
+        for (size_t I = 0; I < dim_space_; ++I) {
+            acc.set_weights(&Cb[I * nroots], &Cb[I * nroots]);
+            add_diagonal(acc, occupied(sorted_b_dets[I].get_alfa_bits()),
+                         occupied(sorted_b_dets[I].get_beta_bits()));
+        }
+
+        //-* All Alpha RDMs *-//
+        // loop through all beta strings and pairs of determinants (I,J) with J > I and the same
+        // beta string, (J,I) is added as the transpose of (I,J)
+#pragma omp for schedule(dynamic) nowait
+        for (size_t bstr = 0; bstr < num_bstr; ++bstr) {
+            const String& Ib = sorted_bstr[bstr];
+            const auto occ_b = occupied(Ib);
+            const auto& range_I = b_sorted_string_list.range(Ib);
+            for (size_t I = range_I.first; I < range_I.second; ++I) {
+                const String Ia = sorted_b_dets[I].get_alfa_bits();
+                for (size_t J = I + 1; J < range_I.second; ++J) {
+                    acc.set_weights(&Cb[I * nroots], &Cb[J * nroots]);
+                    add_alpha_excitation(acc, Ia, sorted_b_dets[J].get_alfa_bits(), occ_b);
                 }
-                d2 += t2.get();
-            } else if (ndiff == 4) {
-                local_timer t4;
-                // Get aa-aa part of aab 3rdm
-                auto Ia_sub = detIa & detIJa_common;
-                uint64_t p = Ia_sub.find_first_one();
-                Ia_sub.clear_first_one();
-                uint64_t q = Ia_sub.find_first_one();
-
-                auto Ja_sub = detJa & detIJa_common;
-                uint64_t s = Ja_sub.find_first_one();
-                Ja_sub.clear_first_one();
-                uint64_t t = Ja_sub.find_first_one();
-
-                const auto& range_J = a_sorted_string_list_.range(detJa);
-                size_t first_I = range_I.first;
-                size_t last_I = range_I.second;
-                size_t first_J = range_J.first;
-                size_t last_J = range_J.second;
-
-                // double sign = ui64_slater_sign(detIa,p,q) * ui64_slater_sign(detJa,s,t);
-                double sign = detIa.slater_sign(p, q) * // ui64_slater_sign(detIa,q) *
-                              detJa.slater_sign(s, t);  // ui64_slater_sign(detJa,t);
-
-                // Now the b-b part
-                for (size_t I = first_I; I < last_I; ++I) {
-                    Ib = sorted_a_dets[I].get_beta_bits();
-                    double CI = evecs_->get(a_sorted_string_list_.add(I), root1_);
-                    for (size_t J = first_J; J < last_J; ++J) {
-                        Jb = sorted_a_dets[J].get_beta_bits();
-                        IJb = Ib ^ Jb;
-                        int nbdiff = IJb.count();
-                        if (nbdiff == 2) {
-                            double Csq = CI * evecs_->get(a_sorted_string_list_.add(J), root2_);
-                            auto Ib_sub = Ib & IJb;
-                            uint64_t r = Ib_sub.find_first_one();
-                            auto Jb_sub = Jb & IJb;
-                            uint64_t u = Jb_sub.find_first_one();
-                            double el = Csq * sign * Ib.slater_sign(r) * Jb.slater_sign(u);
-
-                            tprdm_aab[p * norb5_ + q * norb4_ + r * norb3_ + s * norb2_ +
-                                      t * norb_ + u] += el;
-                            tprdm_aab[p * norb5_ + q * norb4_ + r * norb3_ + t * norb2_ +
-                                      s * norb_ + u] -= el;
-                            tprdm_aab[q * norb5_ + p * norb4_ + r * norb3_ + s * norb2_ +
-                                      t * norb_ + u] -= el;
-                            tprdm_aab[q * norb5_ + p * norb4_ + r * norb3_ + t * norb2_ +
-                                      s * norb_ + u] += el;
-                        }
+            }
+        }
+
+        //- All Beta RDMs -//
+        // loop through all alpha strings and pairs of determinants (I,J) with J > I and the same
+        // alpha string, (J,I) is added as the transpose of (I,J)
+#pragma omp for schedule(dynamic) nowait
+        for (size_t astr = 0; astr < num_astr; ++astr) {
+            const String& Ia = sorted_astr[astr];
+            const auto occ_a = occupied(Ia);
+            const auto& range_I = a_sorted_string_list.range(Ia);
+            for (size_t I = range_I.first; I < range_I.second; ++I) {
+                const String Ib = sorted_a_dets[I].get_beta_bits();
+                for (size_t J = I + 1; J < range_I.second; ++J) {
+                    acc.set_weights(&Ca[I * nroots], &Ca[J * nroots]);
+                    add_beta_excitation(acc, Ib, sorted_a_dets[J].get_beta_bits(), occ_a);
+                }
+            }
+        }
+
+        //*- Alpha/Beta  -*//
+        // only the 2- and 3-RDMs receive contributions from these pairs
+        if (max_rdm_level >= 2) {
+#pragma omp for schedule(dynamic)
+            for (size_t astr = 0; astr < num_astr; ++astr) {
+                const String& Ia = sorted_astr[astr];
+                const auto& range_I = a_sorted_string_list.range(Ia);
+                for (const String& Ja : sorted_astr) {
+                    add_alpha_beta_excitations(acc, Ia, Ja, range_I,
+                                               a_sorted_string_list.range(Ja), sorted_a_dets, Ca,
+                                               nroots);
+                }
+            }
+        }
+    }
+
+    // reduce the thread buffers and unpack the pairs
+    std::vector<std::vector<std::vector<double>>> rdms(
+        npairs, std::vector<std::vector<double>>(ncomponents));
+    for (size_t c = 0; c < ncomponents; ++c) {
+        const size_t size = component_size(c, norb_);
+        for (size_t n = 0; n < npairs; ++n) {
+            rdms[n][c].assign(size, 0.0);
+        }
+        if (c < nprivate) {
+#pragma omp parallel for num_threads(nthreads)
+            for (size_t idx = 0; idx < size; ++idx) {
+                for (const auto& acc : accumulators) {
+                    const double* x = acc->buffer(c).data() + idx * npairs;
+                    for (size_t n = 0; n < npairs; ++n) {
+                        rdms[n][c][idx] += x[n];
                     }
                 }
-                d4 += t4.get();
             }
+        } else {
+            const double* x = shared[c - nprivate].data();
+#pragma omp parallel for num_threads(nthreads)
+            for (size_t idx = 0; idx < size; ++idx) {
+                for (size_t n = 0; n < npairs; ++n) {
+                    rdms[n][c][idx] = x[idx * npairs + n];
+                }
+            }
+            // release the shared buffer before unpacking the next component
+            std::vector<double>().swap(shared[c - nprivate]);
         }
     }
-    outfile->Printf("\n  2dif: %1.6f  \n  4dif: %1.6f", d2, d4);
-    outfile->Printf("\n all alpha/beta takes %1.6f", mix.get());
+
+    if (print_) {
+        outfile->Printf("\n  Dynamic RDMs (up to level %d) for %zu pair(s) of roots computed with "
+                        "%d thread(s) in %1.6f s",
+                        max_rdm_level, npairs, nthreads, total.get());
+    }
+    return rdms;
 }
 
 void CI_RDMS::fill_3rdm(std::vector<double>& tprdm, double el, int p, int q, int r, int s, int t,
@@ -28,6 +28,7 @@
 
 #ifdef HAVE_CHEMPS2
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
@@ -137,6 +138,7 @@ void DMRGSolver::set_options(std::shared_ptr<ForteOptions> options) {
     dmrg_noise_prefactors_ = options->get_double_list("DMRG_SWEEP_NOISE_PREFAC");
     dmrg_davidson_rtol_ = options->get_double_list("DMRG_SWEEP_DVDSON_RTOL");
     dmrg_print_corr_ = options->get_bool("DMRG_PRINT_CORR");
+    dmrg_restart_ = options->get_bool("DMRG_RESTART");
 
     // sanity check
     auto nstates = dmrg_sweep_states_.size();
@@ -174,6 +176,20 @@ void DMRGSolver::set_options(std::shared_ptr<ForteOptions> options) {
     }
 }
 
+void DMRGSolver::make_conv_scheme(bool restart) {
+    // when restarting from a converged MPS, the bond dimension is already at its final value and
+    // the ramp-up instructions can be skipped
+    auto n_sweep_states = static_cast<int>(dmrg_sweep_states_.size());
+    int first = restart ? n_sweep_states - 1 : 0;
+
+    conv_scheme_ = std::make_unique<CheMPS2::ConvergenceScheme>(n_sweep_states - first);
+    for (int cnt = first; cnt < n_sweep_states; cnt++) {
+        conv_scheme_->set_instruction(cnt - first, dmrg_sweep_states_[cnt],
+                                      dmrg_sweep_e_convergence_[cnt], dmrg_sweep_max_sweeps_[cnt],
+                                      dmrg_noise_prefactors_[cnt], dmrg_davidson_rtol_[cnt]);
+    }
+}
+
 double DMRGSolver::compute_energy() {
     timer t("DMRG Solver Compute Energy");
 
@@ -184,16 +200,16 @@ double DMRGSolver::compute_energy() {
     cout_buffer = std::cout.rdbuf(capturing.rdbuf());
 
     timer t_init("DMRG Initialization");
-    auto n_sweep_states = static_cast<int>(dmrg_sweep_states_.size());
     CheMPS2::Initialize::Init();
 
+    // Restart from the MPS of the previous call (e.g., the previous MCSCF macroiteration).
+    // CheMPS2 does not expose the environment tensors nor a way to rotate the MPS, so the MPS
+    // written in the previous orbital basis is reloaded as a guess, which is accurate for the
+    // small orbital rotations of late macroiterations.
+    bool restart = dmrg_restart_ and mps_available_;
+
     // Create a CheMPS2::ConvergenceSchem
-    conv_scheme_ = std::make_unique<CheMPS2::ConvergenceScheme>(n_sweep_states);
-    for (int cnt = 0; cnt < n_sweep_states; cnt++) {
-        conv_scheme_->set_instruction(cnt, dmrg_sweep_states_[cnt], dmrg_sweep_e_convergence_[cnt],
-                                      dmrg_sweep_max_sweeps_[cnt], dmrg_noise_prefactors_[cnt],
-                                      dmrg_davidson_rtol_[cnt]);
-    }
+    make_conv_scheme(restart);
 
     // Create the CheMPS2::Hamiltonian
     auto actv_irreps = mo_space_info_->symmetry("ACTIVE");
@@ -233,6 +249,10 @@ double DMRGSolver::compute_energy() {
             fs::create_directory(mps_files_path_);
         std::cout << "MPS files will be dumped to " << mps_files_path_ << '\n';
     }
+    if (restart) {
+        move_mps_files(false);
+        std::cout << "Restarting from the MPS files of the previous DMRG calculation\n";
+    }
     if (read_wfn_guess_) {
         // try to read current path, then try to read mps_files_path_ (i.e., copy to cwd)
         for (const std::string& name : mps_files_) {
@@ -246,6 +266,13 @@ double DMRGSolver::compute_energy() {
     auto solver = std::make_shared<CheMPS2::DMRG>(prob.get(), conv_scheme_.get(), true, tmp_path_);
     energies_.clear();
 
+    // if RDMs were requested before, compute them from the converged MPS of each root here
+    // instead of reloading the MPS in a separate solver
+    sf_rdms_.clear();
+    bool compute_rdms = dmrg_restart_ and rdm_level_ > 0;
+    bool do_3rdm = compute_rdms and rdm_level_ > 2;
+    bool disk_3rdm = mo_space_info_->size("ACTIVE") >= 30;
+
     timer t_compt("DMRG Energy");
     for (size_t root = 0; root < nroot_; ++root) {
         if (root > 0)
@@ -254,9 +281,12 @@ double DMRGSolver::compute_energy() {
         timer t_root("DMRG Energy Root " + std::to_string(root));
         energies_.push_back(solver->Solve());
         t_root.stop();
-        if (dmrg_print_corr_) {
-            solver->calc_rdms_and_correlations(false, false); // need RDMs
-            solver->getCorrelations()->Print();
+        if (compute_rdms or dmrg_print_corr_) {
+            solver->calc_rdms_and_correlations(do_3rdm, disk_3rdm);
+            if (compute_rdms)
+                sf_rdms_.push_back(copy_rdms(solver, rdm_level_));
+            if (dmrg_print_corr_)
+                solver->getCorrelations()->Print();
         }
         if (root == 0 and nroot_ > 1) {
             solver->activateExcitations(static_cast<int>(nroot_ - 1));
@@ -279,6 +309,7 @@ double DMRGSolver::compute_energy() {
 
     // move MPS files from CWD to the folder (to prevent load problems of CheMPS2)
     move_mps_files(true);
+    mps_available_ = true;
 
     // Push to psi4 environment
     double energy = energies_[root_];
@@ -295,16 +326,6 @@ DMRGSolver::rdms(const std::vector<std::pair<size_t, size_t>>& root_list, int ma
     if (max_rdm_level < 1)
         return std::vector<std::shared_ptr<RDMs>>(root_list.size());
 
-    // make sure the MPS files are available
-    move_mps_files(false);
-    for (const std::string& name : mps_files_) {
-        if (not fs::exists(name)) {
-            outfile->Printf("\n  File does not exist: %s", name.c_str());
-            outfile->Printf("\n  Please first run DMRGSolver::compute_energy!");
-            throw std::runtime_error("Please first run DMRGSolver::compute_energy!");
-        }
-    }
-
     // check root list
     std::unordered_set<size_t> roots;
     for (const auto& pair : root_list) {
@@ -319,6 +340,27 @@ DMRGSolver::rdms(const std::vector<std::pair<size_t, size_t>>& root_list, int ma
         roots.insert(root1);
     }
 
+    // RDMs computed together with the energy
+    rdm_level_ = std::max(rdm_level_, max_rdm_level);
+    if ((sf_rdms_.size() == nroot_) and
+        (sf_rdms_[0].size() >= static_cast<size_t>(max_rdm_level))) {
+        std::vector<std::shared_ptr<RDMs>> rdms;
+        for (const auto& [root1, _] : root_list) {
+            rdms.push_back(fill_current_rdms(sf_rdms_[root1], max_rdm_level, rdm_type));
+        }
+        return rdms;
+    }
+
+    // make sure the MPS files are available
+    move_mps_files(false);
+    for (const std::string& name : mps_files_) {
+        if (not fs::exists(name)) {
+            outfile->Printf("\n  File does not exist: %s", name.c_str());
+            outfile->Printf("\n  Please first run DMRGSolver::compute_energy!");
+            throw std::runtime_error("Please first run DMRGSolver::compute_energy!");
+        }
+    }
+
     std::vector<std::shared_ptr<RDMs>> rdms;
     bool do_3rdm = max_rdm_level > 2;
     bool disk_3rdm = mo_space_info_->size("ACTIVE") >= 30;
@@ -346,7 +388,8 @@ DMRGSolver::rdms(const std::vector<std::pair<size_t, size_t>>& root_list, int ma
         if (roots.find(root) != roots.end()) {
             timer t_root("DMRG RDMs Root " + std::to_string(root));
             solver->calc_rdms_and_correlations(do_3rdm, disk_3rdm);
-            rdms.push_back(fill_current_rdms(solver, max_rdm_level, rdm_type));
+            rdms.push_back(fill_current_rdms(copy_rdms(solver, max_rdm_level), max_rdm_level,
+                                             rdm_type));
         }
         if (root == 0 and nroot_ > 1) {
             solver->activateExcitations(static_cast<int>(nroot_ - 1));
@@ -373,15 +416,8 @@ DMRGSolver::rdms(const std::vector<std::pair<size_t, size_t>>& root_list, int ma
     return rdms;
 }
 
-std::shared_ptr<RDMs> DMRGSolver::fill_current_rdms(std::shared_ptr<CheMPS2::DMRG> solver,
-                                                    const int max_rdm_level, RDMsType rdm_type) {
-    if (max_rdm_level == 0) {
-        if (rdm_type == RDMsType::spin_free)
-            return std::make_shared<RDMsSpinFree>();
-        else
-            return std::make_shared<RDMsSpinDependent>();
-    }
-
+std::vector<ambit::Tensor> DMRGSolver::copy_rdms(std::shared_ptr<CheMPS2::DMRG> solver,
+                                                 const int max_rdm_level) {
     std::vector<size_t> dim2(2, nactv_);
     std::vector<size_t> dim4(4, nactv_);
     auto g1 = ambit::Tensor::build(ambit::CoreTensor, "DMRG G1", dim2);
@@ -390,12 +426,29 @@ std::shared_ptr<RDMs> DMRGSolver::fill_current_rdms(std::shared_ptr<CheMPS2::DMR
     CheMPS2::CASSCF::copy2DMover(solver->get2DM(), nactv_, g2.data().data());
     CheMPS2::CASSCF::setDMRG1DM(nelecs_actv_, nactv_, g1.data().data(), g2.data().data());
 
-    ambit::Tensor g3;
     if (max_rdm_level > 2) {
         std::vector<size_t> dim6(6, nactv_);
-        g3 = ambit::Tensor::build(ambit::CoreTensor, "DMRG G3", dim6);
+        auto g3 = ambit::Tensor::build(ambit::CoreTensor, "DMRG G3", dim6);
         solver->get3DM()->fill_ham_index(1.0, false, g3.data().data(), 0, nactv_);
+        return {g1, g2, g3};
     }
+    return {g1, g2};
+}
+
+std::shared_ptr<RDMs> DMRGSolver::fill_current_rdms(const std::vector<ambit::Tensor>& sf_rdms,
+                                                    const int max_rdm_level, RDMsType rdm_type) {
+    if (max_rdm_level == 0) {
+        if (rdm_type == RDMsType::spin_free)
+            return std::make_shared<RDMsSpinFree>();
+        else
+            return std::make_shared<RDMsSpinDependent>();
+    }
+
+    const auto& g1 = sf_rdms[0];
+    const auto& g2 = sf_rdms[1];
+    ambit::Tensor g3;
+    if (max_rdm_level > 2)
+        g3 = sf_rdms[2];
 
     if (rdm_type == RDMsType::spin_free) {
         if (max_rdm_level == 1)
@@ -122,6 +122,15 @@ class DMRGSolver : public ActiveSpaceMethod {
     std::vector<double> dmrg_davidson_rtol_;
     /// Whether or not to print the correlation functions after the DMRG calculation
     bool dmrg_print_corr_;
+    /// Restart from the MPS of the previous call running only the last sweep instruction
+    bool dmrg_restart_;
+
+    /// True if the MPS of a previous call to compute_energy is available on disk
+    bool mps_available_ = false;
+    /// The max RDM level requested so far, used to compute the RDMs together with the energy
+    int rdm_level_ = 0;
+    /// The spin-free RDMs (G1, G2, [G3]) of each root computed right after the sweeps
+    std::vector<std::vector<ambit::Tensor>> sf_rdms_;
 
     /// The convergence scheme of CheMPS2
     std::unique_ptr<CheMPS2::ConvergenceScheme> conv_scheme_;
@@ -140,8 +149,15 @@ class DMRGSolver : public ActiveSpaceMethod {
     /// Setup some internal variable
     void startup();
 
-    /// Return the RDMs for the current state
-    std::shared_ptr<RDMs> fill_current_rdms(std::shared_ptr<CheMPS2::DMRG> solver,
+    /// Build the convergence scheme, only the last instruction if restart is true
+    void make_conv_scheme(bool restart);
+
+    /// Return the spin-free RDMs (G1, G2, [G3]) of the current root of the solver
+    std::vector<ambit::Tensor> copy_rdms(std::shared_ptr<CheMPS2::DMRG> solver,
+                                         const int max_rdm_level);
+
+    /// Return the RDMs built from the spin-free RDMs (G1, G2, [G3])
+    std::shared_ptr<RDMs> fill_current_rdms(const std::vector<ambit::Tensor>& sf_rdms,
                                             const int max_rdm_level, RDMsType rdm_type);
 };
 } // namespace forte
@@ -42,6 +42,7 @@
 
 #include "integrals/active_space_integrals.h"
 
+#include "helpers/disk_io.h"
 #include "helpers/printing.h"
 
 #include "external_active_space_method.h"
@@ -59,6 +60,16 @@ auto read_json_file() {
     return j;
 }
 
+/// Read a block of the RDMs from the .npy file listed under key in the json header.
+/// Returns false if the header does not contain the key.
+bool read_npy_block(const json& j, const std::string& key, ambit::Tensor& T) {
+    if (not j.contains(key))
+        return false;
+    const std::string filename = j[key]["file"];
+    read_npy_array(filename, T.dims(), T.data().data());
+    return true;
+}
+
 ExternalActiveSpaceMethod::ExternalActiveSpaceMethod(StateInfo state, size_t nroot,
                                                      std::shared_ptr<MOSpaceInfo> mo_space_info,
                                                      std::shared_ptr<ActiveSpaceIntegrals> as_ints)
@@ -82,12 +93,54 @@ double ExternalActiveSpaceMethod::compute_energy() {
 
     double energy = j["energy"]["data"];
 
-    // Read 1-DM
-    std::vector<std::tuple<int, int, double>> gamma1 = j["gamma1"]["data"];
-
     g1a_ = ambit::Tensor::build(ambit::CoreTensor, "g1a", std::vector<size_t>(2, nactv_));
     g1b_ = ambit::Tensor::build(ambit::CoreTensor, "g1b", std::vector<size_t>(2, nactv_));
 
+    // These must be allocated otherwise the code crashes
+    g2aa_ = ambit::Tensor::build(ambit::CoreTensor, "g2aa", std::vector<size_t>(4, nactv_));
+    g2ab_ = ambit::Tensor::build(ambit::CoreTensor, "g2ab", std::vector<size_t>(4, nactv_));
+    g2bb_ = ambit::Tensor::build(ambit::CoreTensor, "g2bb", std::vector<size_t>(4, nactv_));
+    g3aaa_ = ambit::Tensor::build(ambit::CoreTensor, "g3aaa", std::vector<size_t>(6, nactv_));
+    g3aab_ = ambit::Tensor::build(ambit::CoreTensor, "g3aab", std::vector<size_t>(6, nactv_));
+    g3abb_ = ambit::Tensor::build(ambit::CoreTensor, "g3abb", std::vector<size_t>(6, nactv_));
+    g3bbb_ = ambit::Tensor::build(ambit::CoreTensor, "g3bbb", std::vector<size_t>(6, nactv_));
+
+    // the RDMs are stored either in the json file or as .npy arrays listed in the json header
+    if (j.contains("format") and j["format"]["data"] == "npy") {
+        read_npy_rdms(j);
+    } else {
+        read_json_rdms(j);
+    }
+
+    // Read reference energy
+    energies_.push_back(energy);
+
+    psi::Process::environment.globals["CURRENT ENERGY"] = energy;
+    psi::Process::environment.globals["FCI ENERGY"] = energy;
+
+    return energy;
+}
+
+void ExternalActiveSpaceMethod::read_npy_rdms(const json& j) {
+    // The RDMs are stored as dense spin-blocked arrays in C order, with the same index
+    // conventions as the json tuples (e.g., g2ab[p][q][r][s] = <p_a^ q_b^ s_b r_a>)
+    if (not(read_npy_block(j, "g1a", g1a_) and read_npy_block(j, "g1b", g1b_))) {
+        throw std::runtime_error("The header in rdms.json does not contain the 1-RDM");
+    }
+    if (not(read_npy_block(j, "g2aa", g2aa_) and read_npy_block(j, "g2ab", g2ab_) and
+            read_npy_block(j, "g2bb", g2bb_))) {
+        psi::outfile->Printf("\nThe json file does not contain data for the 2-RDM");
+    }
+    if (not(read_npy_block(j, "g3aaa", g3aaa_) and read_npy_block(j, "g3aab", g3aab_) and
+            read_npy_block(j, "g3abb", g3abb_) and read_npy_block(j, "g3bbb", g3bbb_))) {
+        psi::outfile->Printf("\nThe json file does not contain data for the 3-RDM");
+    }
+}
+
+void ExternalActiveSpaceMethod::read_json_rdms(const json& j) {
+    // Read 1-DM
+    std::vector<std::tuple<int, int, double>> gamma1 = j["gamma1"]["data"];
+
     // loop over all elements in gamma1 and extract the data for the alpha and beta 1-RDMs
     for (const auto& [i, j, val] : gamma1) {
         const size_t spin_case_i = i % 2 == 0;
@@ -104,11 +157,6 @@ double ExternalActiveSpaceMethod::compute_energy() {
         }
     }
 
-    // These must be allocated otherwise the code crashes
-    g2aa_ = ambit::Tensor::build(ambit::CoreTensor, "g2aa", std::vector<size_t>(4, nactv_));
-    g2ab_ = ambit::Tensor::build(ambit::CoreTensor, "g2ab", std::vector<size_t>(4, nactv_));
-    g2bb_ = ambit::Tensor::build(ambit::CoreTensor, "g2bb", std::vector<size_t>(4, nactv_));
-
     // Read 2-DM
     if (j.contains("gamma2")) {
         std::vector<std::tuple<int, int, int, int, double>> gamma2 = j["gamma2"]["data"];
@@ -139,12 +187,6 @@ double ExternalActiveSpaceMethod::compute_energy() {
         psi::outfile->Printf("\nThe json file does not contain data for the 2-RDM");
     }
 
-    // These must be allocated otherwise the code crashes
-    g3aaa_ = ambit::Tensor::build(ambit::CoreTensor, "g3aaa", std::vector<size_t>(6, nactv_));
-    g3aab_ = ambit::Tensor::build(ambit::CoreTensor, "g3aab", std::vector<size_t>(6, nactv_));
-    g3abb_ = ambit::Tensor::build(ambit::CoreTensor, "g3abb", std::vector<size_t>(6, nactv_));
-    g3bbb_ = ambit::Tensor::build(ambit::CoreTensor, "g3bbb", std::vector<size_t>(6, nactv_));
-
     // Read 3-DM
     if (j.contains("gamma3")) {
         // the data is stored as a vector of tuples
@@ -187,14 +229,6 @@ double ExternalActiveSpaceMethod::compute_energy() {
     } else {
         psi::outfile->Printf("\nThe json file does not contain data for the 3-RDM");
     }
-
-    // Read reference energy
-    energies_.push_back(energy);
-
-    psi::Process::environment.globals["CURRENT ENERGY"] = energy;
-    psi::Process::environment.globals["FCI ENERGY"] = energy;
-
-    return energy;
 }
 
 std::vector<std::shared_ptr<RDMs>> ExternalActiveSpaceMethod::rdms(
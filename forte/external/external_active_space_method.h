@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include "lib/json/json.hpp"
+
 #include "base_classes/active_space_method.h"
 
 namespace forte {
@@ -103,6 +105,11 @@ class ExternalActiveSpaceMethod : public ActiveSpaceMethod {
     ambit::Tensor g3abb_;
     /// The beta-beta-beta 3-RDM
     ambit::Tensor g3bbb_;
+
+    /// Read the RDMs stored as lists of (i,j,...,value) tuples in the json file
+    void read_json_rdms(const nlohmann::json& j);
+    /// Read the RDMs stored as dense .npy arrays listed in the json header
+    void read_npy_rdms(const nlohmann::json& j);
 };
 
 } // namespace forte
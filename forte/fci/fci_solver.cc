@@ -82,6 +82,8 @@ void FCISolver::set_test_rdms(bool value) { test_rdms_ = value; }
 
 void FCISolver::set_print_no(bool value) { print_no_ = value; }
 
+void FCISolver::set_string_lists_max_memory(size_t value) { string_lists_max_memory_ = value; }
+
 void FCISolver::copy_state_into_fci_vector(int root, std::shared_ptr<FCIVector> C) {
     // grab a row of the eigenvector matrix and put it into the FCIVector
     std::shared_ptr<psi::Vector> psi_vector;
@@ -102,42 +104,46 @@ std::shared_ptr<FCIStringLists> FCISolver::lists() { return lists_; }
 int FCISolver::symmetry() { return symmetry_; }
 
 void FCISolver::startup() {
-    // Create the string lists
-
+    // The string lists and the spin adapter do not depend on the integrals. When warm starting
+    // (e.g. during the DSRG reference relaxation) we reuse the ones built in the previous call
+    if (not(warm_start_ and lists_)) {
+        // Create the string lists
 #if USE_GAS_LISTS
-    std::vector<int> gas_size;
-    std::vector<int> gas_min;
-    std::vector<int> gas_max;
-    for (size_t gas_count = 0; gas_count < 6; gas_count++) {
-        std::string space = "GAS" + std::to_string(gas_count + 1);
-        int orbital_maximum = mo_space_info_->size(space);
-        gas_size.push_back(orbital_maximum);
-    }
-    for (auto n : state_.gas_min()) {
-        gas_min.push_back(n);
-    }
-    for (auto n : state_.gas_max()) {
-        gas_max.push_back(n);
-    }
-    lists_ = std::make_shared<FCIStringLists>(mo_space_info_, na_, nb_, print_, gas_size, gas_min,
-                                              gas_max);
+        std::vector<int> gas_size;
+        std::vector<int> gas_min;
+        std::vector<int> gas_max;
+        for (size_t gas_count = 0; gas_count < 6; gas_count++) {
+            std::string space = "GAS" + std::to_string(gas_count + 1);
+            int orbital_maximum = mo_space_info_->size(space);
+            gas_size.push_back(orbital_maximum);
+        }
+        for (auto n : state_.gas_min()) {
+            gas_min.push_back(n);
+        }
+        for (auto n : state_.gas_max()) {
+            gas_max.push_back(n);
+        }
+        lists_ = std::make_shared<FCIStringLists>(mo_space_info_, na_, nb_, print_, gas_size,
+                                                  gas_min, gas_max);
 #else
-    lists_ = std::make_shared<FCIStringLists>(active_dim_, core_mo_, active_mo_, na_, nb_, print_);
+        lists_ = std::make_shared<FCIStringLists>(active_dim_, core_mo_, active_mo_, na_, nb_,
+                                                  print_, string_lists_max_memory_);
 #endif
 
-    nfci_dets_ = 0;
-    for (int h = 0; h < nirrep_; ++h) {
-        size_t nastr = lists_->alfa_address()->strpcls(h);
-        size_t nbstr = lists_->beta_address()->strpcls(h ^ symmetry_);
-        nfci_dets_ += nastr * nbstr;
-    }
+        nfci_dets_ = 0;
+        for (int h = 0; h < nirrep_; ++h) {
+            size_t nastr = lists_->alfa_address()->strpcls(h);
+            size_t nbstr = lists_->beta_address()->strpcls(h ^ symmetry_);
+            nfci_dets_ += nastr * nbstr;
+        }
 
-    // Create the spin adapter
-    if (spin_adapt_) {
-        spin_adapter_ = std::make_shared<SpinAdapter>(state().multiplicity() - 1,
-                                                      state().twice_ms(), lists_->ncmo());
-        dets_ = lists_->make_determinants(symmetry_);
-        spin_adapter_->prepare_couplings(dets_);
+        // Create the spin adapter
+        if (spin_adapt_) {
+            spin_adapter_ = std::make_shared<SpinAdapter>(state().multiplicity() - 1,
+                                                          state().twice_ms(), lists_->ncmo());
+            dets_ = lists_->make_determinants(symmetry_);
+            spin_adapter_->prepare_couplings(dets_);
+        }
     }
 
     if (print_ >= PrintLevel::Default) {
@@ -159,6 +165,9 @@ void FCISolver::set_options(std::shared_ptr<ForteOptions> options) {
     set_spin_adapt(options->get_bool("CI_SPIN_ADAPT"));
     set_spin_adapt_full_preconditioner(options->get_bool("CI_SPIN_ADAPT_FULL_PRECONDITIONER"));
     set_test_rdms(options->get_bool("FCI_TEST_RDMS"));
+    // the option is given in MB
+    set_string_lists_max_memory(static_cast<size_t>(options->get_int("FCI_LISTS_MAX_MEMORY")) *
+                                1024 * 1024);
 
     set_root(options->get_int("ROOT"));
 
@@ -227,8 +236,9 @@ double FCISolver::compute_energy() {
             dl_solver_->add_guesses(guesses);
         }
     } else {
+        // for small spaces we usually redo the initial guess, unless we are warm starting
         bool use_initial_guess = (num_guess_states * ndets_per_guess_ >= det_size);
-        if (first_run or use_initial_guess) {
+        if (first_run or (use_initial_guess and not warm_start_)) {
             dl_solver_->reset();
             auto [guesses, bad_roots] = initial_guess_det(Hdiag_vec, num_guess_states, as_ints_);
             dl_solver_->add_guesses(guesses);
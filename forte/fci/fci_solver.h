@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include "base_classes/active_space_method.h"
 #include "psi4/libmints/dimension.h"
 #include "fci_string_lists.h"
@@ -112,6 +114,9 @@ class FCISolver : public ActiveSpaceMethod {
     /// Print the Natural Orbitals
     void set_print_no(bool value);
 
+    /// Set the maximum memory (in bytes) used to store each of the VVOO and 3-hole string lists
+    void set_string_lists_max_memory(size_t value);
+
     /// Return eigen vectors (n_DL_guesses x ndets)
     std::shared_ptr<psi::Matrix> evecs();
 
@@ -179,6 +184,9 @@ class FCISolver : public ActiveSpaceMethod {
     bool test_rdms_ = false;
     /// Print the NO from the 1-RDM
     bool print_no_ = false;
+    /// The maximum memory (in bytes) used to store each of the VVOO and 3-hole string lists.
+    /// Lists that exceed this value are generated on the fly
+    size_t string_lists_max_memory_ = std::numeric_limits<size_t>::max();
     /// Spin adapt the FCI wave function?
     bool spin_adapt_ = false;
     /// Use the full preconditioner for spin adaptation?
@@ -44,181 +44,199 @@
 
 namespace forte {
 
-std::vector<H1StringSubstitution>& FCIStringLists::get_alfa_1h_list(int h_I, size_t add_I,
-                                                                    int h_J) {
-    std::tuple<int, size_t, int> I_tuple(h_I, add_I, h_J);
-    return alfa_1h_list[I_tuple];
+StringSubstitutionRange<H1StringSubstitution>
+FCIStringLists::get_alfa_1h_list(int h_I, size_t add_I, int h_J) {
+    std::call_once(alfa_1h_flag_,
+                   [&]() { make_1h_list(alfa_address_, alfa_address_1h_, alfa_1h_list); });
+    return alfa_1h_list[hole_key(alfa_address_1h_, h_I, add_I, h_J)];
 }
 
-std::vector<H1StringSubstitution>& FCIStringLists::get_beta_1h_list(int h_I, size_t add_I,
-                                                                    int h_J) {
-    std::tuple<int, size_t, int> I_tuple(h_I, add_I, h_J);
-    return beta_1h_list[I_tuple];
+StringSubstitutionRange<H1StringSubstitution>
+FCIStringLists::get_beta_1h_list(int h_I, size_t add_I, int h_J) {
+    std::call_once(beta_1h_flag_,
+                   [&]() { make_1h_list(beta_address_, beta_address_1h_, beta_1h_list); });
+    return beta_1h_list[hole_key(beta_address_1h_, h_I, add_I, h_J)];
 }
 
+/**
+ * Generate the lists of strings I connected to the (N-1)-electron strings J by
+ * a_p I = sgn J. The lists of each string J are generated by adding one electron to J,
+ * so that different strings J can be processed in parallel.
+ */
 void FCIStringLists::make_1h_list(std::shared_ptr<FCIStringAddress> addresser,
-                                  std::shared_ptr<FCIStringAddress> addresser_1h, H1List& list) {
-    int n = addresser->nbits();
-    int k = addresser->nones();
-    String I, J;
-    if ((k >= 0) and (k <= n)) { // check that (n > 0) makes sense.
-        for (size_t h_I = 0; h_I < nirrep_; ++h_I) {
-            // Generate the strings 1111100000
-            //                      { k }{n-k}
-            for (int i = 0; i < n - k; ++i)
-                I[i] = false; // 0
-            for (int i = std::max(0, n - k); i < n; ++i)
-                I[i] = true; // 1
-            do {
-                if (string_class_->symmetry(I) == h_I) {
-                    size_t add_I = addresser->add(I);
-                    for (size_t p = 0; p < ncmo_; ++p) {
-                        if (I[p]) {
-                            J = I;
-                            J[p] = false;
-                            short sign = J.slater_sign(p);
-
-                            int h_J = addresser_1h->sym(J);
-                            size_t add_J = addresser_1h->add(J);
-
-                            std::tuple<int, size_t, int> I_tuple(h_J, add_J, h_I);
-                            list[I_tuple].push_back(H1StringSubstitution(sign, p, add_I));
-                        }
-                    }
-                }
-            } while (std::next_permutation(I.begin(), I.begin() + n));
+                                  std::shared_ptr<FCIStringAddress> addresser_1h,
+                                  FlatStringList<H1StringSubstitution>& list) {
+    if (addresser_1h == nullptr)
+        return;
+    const auto strings_1h = make_fci_strings(ncmo_, addresser_1h->nones());
+    std::vector<size_t> offset(nirrep_ + 1, 0);
+    for (size_t h = 0; h < nirrep_; ++h) {
+        offset[h + 1] = offset[h] + strings_1h[h].size();
+    }
+
+    std::vector<std::vector<H1StringSubstitution>> lists(offset[nirrep_] * nirrep_);
+    const int64_t nJ = offset[nirrep_];
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t n = 0; n < nJ; ++n) {
+        size_t h_J = 0;
+        while (static_cast<size_t>(n) >= offset[h_J + 1])
+            h_J++;
+        const String& J = strings_1h[h_J][n - offset[h_J]];
+        for (size_t p = 0; p < ncmo_; ++p) {
+            if (not J[p]) {
+                String I = J;
+                I[p] = true;
+                short sign = J.slater_sign(p);
+                size_t h_I = addresser->sym(I);
+                lists[n * nirrep_ + h_I].push_back(
+                    H1StringSubstitution(sign, p, addresser->add(I)));
+            }
         }
-    } // End loop over h
+    }
+    list.assign(lists);
 }
 
-std::vector<H2StringSubstitution>& FCIStringLists::get_alfa_2h_list(int h_I, size_t add_I,
-                                                                    int h_J) {
-    std::tuple<int, size_t, int> I_tuple(h_I, add_I, h_J);
-    return alfa_2h_list[I_tuple];
+StringSubstitutionRange<H2StringSubstitution>
+FCIStringLists::get_alfa_2h_list(int h_I, size_t add_I, int h_J) {
+    std::call_once(alfa_2h_flag_,
+                   [&]() { make_2h_list(alfa_address_, alfa_address_2h_, alfa_2h_list); });
+    return alfa_2h_list[hole_key(alfa_address_2h_, h_I, add_I, h_J)];
 }
 
-std::vector<H2StringSubstitution>& FCIStringLists::get_beta_2h_list(int h_I, size_t add_I,
-                                                                    int h_J) {
-    std::tuple<int, size_t, int> I_tuple(h_I, add_I, h_J);
-    return beta_2h_list[I_tuple];
+StringSubstitutionRange<H2StringSubstitution>
+FCIStringLists::get_beta_2h_list(int h_I, size_t add_I, int h_J) {
+    std::call_once(beta_2h_flag_,
+                   [&]() { make_2h_list(beta_address_, beta_address_2h_, beta_2h_list); });
+    return beta_2h_list[hole_key(beta_address_2h_, h_I, add_I, h_J)];
 }
 
+/**
+ * Generate the lists of strings I connected to the (N-2)-electron strings J by
+ * a_p a_q I = sgn J. The lists of each string J are generated by adding two electrons to J,
+ * so that different strings J can be processed in parallel.
+ */
 void FCIStringLists::make_2h_list(std::shared_ptr<FCIStringAddress> addresser,
-                                  std::shared_ptr<FCIStringAddress> addresser_2h, H2List& list) {
-    int n = addresser->nbits();
-    int k = addresser->nones();
-    String I, J;
+                                  std::shared_ptr<FCIStringAddress> addresser_2h,
+                                  FlatStringList<H2StringSubstitution>& list) {
+    if (addresser_2h == nullptr)
+        return;
+    const auto strings_2h = make_fci_strings(ncmo_, addresser_2h->nones());
+    std::vector<size_t> offset(nirrep_ + 1, 0);
+    for (size_t h = 0; h < nirrep_; ++h) {
+        offset[h + 1] = offset[h] + strings_2h[h].size();
+    }
 
-    if ((k >= 0) and (k <= n)) { // check that (n > 0) makes sense.
-        for (size_t h_I = 0; h_I < nirrep_; ++h_I) {
-            // Generate the strings 1111100000
-            //                      { k }{n-k}
-            for (int i = 0; i < n - k; ++i)
-                I[i] = false; // 0
-            for (int i = std::max(0, n - k); i < n; ++i)
-                I[i] = true; // 1
-            do {
-                if (string_class_->symmetry(I) == h_I) {
+    std::vector<std::vector<H2StringSubstitution>> lists(offset[nirrep_] * nirrep_);
+    const int64_t nJ = offset[nirrep_];
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t n = 0; n < nJ; ++n) {
+        size_t h_J = 0;
+        while (static_cast<size_t>(n) >= offset[h_J + 1])
+            h_J++;
+        const String& J = strings_2h[h_J][n - offset[h_J]];
+        for (size_t q = 0; q < ncmo_; ++q) {
+            for (size_t p = q + 1; p < ncmo_; ++p) {
+                if ((not J[q]) and (not J[p])) {
+                    String I = J;
+                    I[q] = true;
+                    I[p] = true;
+                    // the sign of a_p a_q I depends only on the electrons of J below p and q
+                    short sign = J.slater_sign(p) * J.slater_sign(q);
+                    size_t h_I = addresser->sym(I);
                     size_t add_I = addresser->add(I);
-                    for (size_t q = 0; q < ncmo_; ++q) {
-                        for (size_t p = q + 1; p < ncmo_; ++p) {
-                            if (I[q] and I[p]) {
-                                J = I;
-                                J[q] = false;
-                                short q_sign = J.slater_sign(q);
-                                J[p] = false;
-                                short p_sign = J.slater_sign(p);
-
-                                short sign = p_sign * q_sign;
-
-                                int h_J = addresser_2h->sym(J);
-                                size_t add_J = addresser_2h->add(J);
-
-                                std::tuple<int, size_t, int> I_tuple(h_J, add_J, h_I);
-                                list[I_tuple].push_back(H2StringSubstitution(sign, p, q, add_I));
-                                list[I_tuple].push_back(H2StringSubstitution(-sign, q, p, add_I));
-                            }
-                        }
-                    }
+                    auto& J_list = lists[n * nirrep_ + h_I];
+                    J_list.push_back(H2StringSubstitution(sign, p, q, add_I));
+                    J_list.push_back(H2StringSubstitution(-sign, q, p, add_I));
                 }
-            } while (std::next_permutation(I.begin(), I.begin() + n));
+            }
         }
-    } // End loop over h
+    }
+    list.assign(lists);
 }
 
-std::vector<H3StringSubstitution>& FCIStringLists::get_alfa_3h_list(int h_I, size_t add_I,
-                                                                    int h_J) {
-    std::tuple<int, size_t, int> I_tuple(h_I, add_I, h_J);
-    return alfa_3h_list[I_tuple];
+StringSubstitutionRange<H3StringSubstitution>
+FCIStringLists::get_alfa_3h_list(int h_I, size_t add_I, int h_J,
+                                 std::vector<H3StringSubstitution>& buffer) {
+    if (alfa_h3_on_the_fly_) {
+        buffer.clear();
+        make_3h(alfa_address_, alfa_3h_strings_[h_I][add_I], h_J, buffer);
+        return {buffer.data(), buffer.data() + buffer.size()};
+    }
+    std::call_once(alfa_3h_flag_,
+                   [&]() { make_3h_list(alfa_address_, alfa_3h_strings_, alfa_3h_list); });
+    return alfa_3h_list[hole_key(alfa_address_3h_, h_I, add_I, h_J)];
 }
 
-std::vector<H3StringSubstitution>& FCIStringLists::get_beta_3h_list(int h_I, size_t add_I,
-                                                                    int h_J) {
-    std::tuple<int, size_t, int> I_tuple(h_I, add_I, h_J);
-    return beta_3h_list[I_tuple];
+StringSubstitutionRange<H3StringSubstitution>
+FCIStringLists::get_beta_3h_list(int h_I, size_t add_I, int h_J,
+                                 std::vector<H3StringSubstitution>& buffer) {
+    if (beta_h3_on_the_fly_) {
+        buffer.clear();
+        make_3h(beta_address_, beta_3h_strings_[h_I][add_I], h_J, buffer);
+        return {buffer.data(), buffer.data() + buffer.size()};
+    }
+    std::call_once(beta_3h_flag_,
+                   [&]() { make_3h_list(beta_address_, beta_3h_strings_, beta_3h_list); });
+    return beta_3h_list[hole_key(beta_address_3h_, h_I, add_I, h_J)];
 }
 
 /**
- * Generate all the pairs of strings I,J connected
- * by a^{+}_p a_q
- * that is: J = ± a^{+}_p a_q I. p and q are
- * absolute indices and I belongs to the irrep h.
+ * Generate the lists of strings I connected to the (N-3)-electron strings J by
+ * a_p a_q a_r I = sgn J. The lists of each string J are generated by adding three electrons
+ * to J, so that different strings J can be processed in parallel.
  */
 void FCIStringLists::make_3h_list(std::shared_ptr<FCIStringAddress> addresser,
-                                  std::shared_ptr<FCIStringAddress> addresser_3h, H3List& list) {
-    int n = addresser->nbits();
-    int k = addresser->nones();
-    String I, J;
+                                  const StringList& strings_3h,
+                                  FlatStringList<H3StringSubstitution>& list) {
+    if (strings_3h.empty())
+        return;
+    std::vector<size_t> offset(nirrep_ + 1, 0);
+    for (size_t h = 0; h < nirrep_; ++h) {
+        offset[h + 1] = offset[h] + strings_3h[h].size();
+    }
 
-    if ((k >= 0) and (k <= n)) { // check that (n > 0) makes sense.
+    std::vector<std::vector<H3StringSubstitution>> lists(offset[nirrep_] * nirrep_);
+    const int64_t nJ = offset[nirrep_];
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t n = 0; n < nJ; ++n) {
+        size_t h_J = 0;
+        while (static_cast<size_t>(n) >= offset[h_J + 1])
+            h_J++;
+        const String& J = strings_3h[h_J][n - offset[h_J]];
         for (size_t h_I = 0; h_I < nirrep_; ++h_I) {
-            // Generate the strings 1111100000
-            //                      { k }{n-k}
-            for (int i = 0; i < n - k; ++i)
-                I[i] = false; // 0
-            for (int i = std::max(0, n - k); i < n; ++i)
-                I[i] = true; // 1
-            do {
-                if (string_class_->symmetry(I) == h_I) {
-                    size_t add_I = addresser->add(I);
+            make_3h(addresser, J, h_I, lists[n * nirrep_ + h_I]);
+        }
+    }
+    list.assign(lists);
+}
 
-                    // apply a_r I
-                    for (size_t r = 0; r < ncmo_; ++r) {
-                        for (size_t q = r + 1; q < ncmo_; ++q) {
-                            for (size_t p = q + 1; p < ncmo_; ++p) {
-                                if (I[r] and I[q] and I[p]) {
-                                    J = I;
-                                    J[r] = false;
-                                    short r_sign = J.slater_sign(r);
-                                    J[q] = false;
-                                    short q_sign = J.slater_sign(q);
-                                    J[p] = false;
-                                    short p_sign = J.slater_sign(p);
-                                    short sign = p_sign * q_sign * r_sign;
-
-                                    int h_J = addresser_3h->sym(J);
-                                    size_t add_J = addresser_3h->add(J);
-
-                                    std::tuple<int, size_t, int> I_tuple(h_J, add_J, h_I);
-                                    list[I_tuple].push_back(
-                                        H3StringSubstitution(+sign, p, q, r, add_I));
-                                    list[I_tuple].push_back(
-                                        H3StringSubstitution(-sign, p, r, q, add_I));
-                                    list[I_tuple].push_back(
-                                        H3StringSubstitution(-sign, q, p, r, add_I));
-                                    list[I_tuple].push_back(
-                                        H3StringSubstitution(+sign, q, r, p, add_I));
-                                    list[I_tuple].push_back(
-                                        H3StringSubstitution(-sign, r, q, p, add_I));
-                                    list[I_tuple].push_back(
-                                        H3StringSubstitution(+sign, r, p, q, add_I));
-                                }
-                            }
-                        }
-                    }
+void FCIStringLists::make_3h(std::shared_ptr<FCIStringAddress> addresser, const String& J,
+                             int h_I, std::vector<H3StringSubstitution>& list) const {
+    // the symmetry of I is the product of the symmetry of J and that of the orbitals p, q, r
+    const int h_J = J.symmetry(cmo_sym_);
+    for (size_t r = 0; r < ncmo_; ++r) {
+        for (size_t q = r + 1; q < ncmo_; ++q) {
+            for (size_t p = q + 1; p < ncmo_; ++p) {
+                if ((h_J ^ cmo_sym_[p] ^ cmo_sym_[q] ^ cmo_sym_[r]) != h_I)
+                    continue;
+                if ((not J[r]) and (not J[q]) and (not J[p])) {
+                    String I = J;
+                    I[r] = true;
+                    I[q] = true;
+                    I[p] = true;
+                    // the sign of a_p a_q a_r I depends only on the electrons of J below
+                    // p, q, and r
+                    short sign = J.slater_sign(p) * J.slater_sign(q) * J.slater_sign(r);
+                    size_t add_I = addresser->add(I);
+                    list.push_back(H3StringSubstitution(+sign, p, q, r, add_I));
+                    list.push_back(H3StringSubstitution(-sign, p, r, q, add_I));
+                    list.push_back(H3StringSubstitution(-sign, q, p, r, add_I));
+                    list.push_back(H3StringSubstitution(+sign, q, r, p, add_I));
+                    list.push_back(H3StringSubstitution(-sign, r, q, p, add_I));
+                    list.push_back(H3StringSubstitution(+sign, r, p, q, add_I));
                 }
-            } while (std::next_permutation(I.begin(), I.begin() + n));
-        } // End loop over h
+            }
+        }
     }
 }
 } // namespace forte
@@ -27,6 +27,7 @@
  */
 
 #include <algorithm>
+#include <limits>
 #include <numeric>
 
 #include "psi4/psi4-dec.h"
@@ -44,9 +45,9 @@ namespace forte {
 
 FCIStringLists::FCIStringLists(psi::Dimension cmopi, std::vector<size_t> core_mo,
                                std::vector<size_t> cmo_to_mo, size_t na, size_t nb,
-                               PrintLevel print)
+                               PrintLevel print, size_t max_memory)
     : nirrep_(cmopi.n()), ncmo_(cmopi.sum()), cmopi_(cmopi), cmo_to_mo_(cmo_to_mo),
-      fomo_to_mo_(core_mo), na_(na), nb_(nb), print_(print) {
+      fomo_to_mo_(core_mo), na_(na), nb_(nb), print_(print), max_memory_(max_memory) {
     startup();
 }
 
@@ -100,12 +101,12 @@ void FCIStringLists::startup() {
     }
 
     if (na_ >= 3) {
-        auto alfa_3h_strings = make_fci_strings(ncmo_, na_ - 3);
-        alfa_address_3h_ = std::make_shared<FCIStringAddress>(ncmo_, na_ - 3, alfa_3h_strings);
+        alfa_3h_strings_ = make_fci_strings(ncmo_, na_ - 3);
+        alfa_address_3h_ = std::make_shared<FCIStringAddress>(ncmo_, na_ - 3, alfa_3h_strings_);
     }
     if (nb_ >= 3) {
-        auto beta_3h_strings = make_fci_strings(ncmo_, nb_ - 3);
-        beta_address_3h_ = std::make_shared<FCIStringAddress>(ncmo_, nb_ - 3, beta_3h_strings);
+        beta_3h_strings_ = make_fci_strings(ncmo_, nb_ - 3);
+        beta_address_3h_ = std::make_shared<FCIStringAddress>(ncmo_, nb_ - 3, beta_3h_strings_);
     }
 
     // local_timers
@@ -113,10 +114,6 @@ void FCIStringLists::startup() {
     double vo_list_timer = 0.0;
     double nn_list_timer = 0.0;
     double oo_list_timer = 0.0;
-    double h1_list_timer = 0.0;
-    double h2_list_timer = 0.0;
-    double h3_list_timer = 0.0;
-    double vovo_list_timer = 0.0;
     double vvoo_list_timer = 0.0;
 
     {
@@ -154,33 +151,25 @@ void FCIStringLists::startup() {
         make_oo_list(beta_address_, beta_oo_list);
         oo_list_timer += t.get();
     }
+
+    // Lists that exceed the memory budget are generated on the fly
+    alfa_vvoo_on_the_fly_ = vvoo_list_memory(alfa_address_) > max_memory_;
+    beta_vvoo_on_the_fly_ = vvoo_list_memory(beta_address_) > max_memory_;
+    alfa_h3_on_the_fly_ = h3_list_memory(alfa_address_) > max_memory_;
+    beta_h3_on_the_fly_ = h3_list_memory(beta_address_) > max_memory_;
+
     {
         local_timer t;
-        make_1h_list(alfa_address_, alfa_address_1h_, alfa_1h_list);
-        make_1h_list(beta_address_, beta_address_1h_, beta_1h_list);
-        h1_list_timer += t.get();
-    }
-    {
-        local_timer t;
-        make_2h_list(alfa_address_, alfa_address_2h_, alfa_2h_list);
-        make_2h_list(beta_address_, beta_address_2h_, beta_2h_list);
-        h2_list_timer += t.get();
-    }
-    {
-        local_timer t;
-        make_3h_list(alfa_address_, alfa_address_3h_, alfa_3h_list);
-        make_3h_list(beta_address_, beta_address_3h_, beta_3h_list);
-        h3_list_timer += t.get();
-    }
-    {
-        local_timer t;
-        make_vvoo_list(alfa_address_, alfa_vvoo_list);
-        make_vvoo_list(beta_address_, beta_vvoo_list);
+        if (not alfa_vvoo_on_the_fly_)
+            make_vvoo_list(alfa_address_, alfa_vvoo_list);
+        if (not beta_vvoo_on_the_fly_)
+            make_vvoo_list(beta_address_, beta_vvoo_list);
         vvoo_list_timer += t.get();
     }
+    // The 1-, 2-, and 3-hole lists are only needed to compute RDMs and are built on first use
 
-    double total_time = str_list_timer + nn_list_timer + vo_list_timer + oo_list_timer +
-                        vvoo_list_timer + vovo_list_timer;
+    double total_time =
+        str_list_timer + nn_list_timer + vo_list_timer + oo_list_timer + vvoo_list_timer;
 
     if (print_ >= PrintLevel::Default) {
         table_printer printer;
@@ -188,15 +177,16 @@ void FCIStringLists::startup() {
                               {"number of beta electrons", nb_},
                               {"number of alpha strings", nas_},
                               {"number of beta strings", nbs_}});
+        printer.add_bool_data({{"alpha VVOO lists generated on the fly", alfa_vvoo_on_the_fly_},
+                               {"beta VVOO lists generated on the fly", beta_vvoo_on_the_fly_},
+                               {"alpha 3-hole lists generated on the fly", alfa_h3_on_the_fly_},
+                               {"beta 3-hole lists generated on the fly", beta_h3_on_the_fly_}});
         if (print_ >= PrintLevel::Verbose) {
             printer.add_timing_data({{"timing for strings", str_list_timer},
                                      {"timing for NN strings", nn_list_timer},
                                      {"timing for VO strings", vo_list_timer},
                                      {"timing for OO strings", oo_list_timer},
                                      {"timing for VVOO strings", vvoo_list_timer},
-                                     {"timing for 1-hole strings", h1_list_timer},
-                                     {"timing for 2-hole strings", h2_list_timer},
-                                     {"timing for 3-hole strings", h3_list_timer},
                                      {"total timing", total_time}});
         }
 
@@ -210,6 +200,7 @@ void FCIStringLists::startup() {
  * these are stored as pair<int,int> in pair_list[pq_sym][pairpi]
  */
 void FCIStringLists::make_pair_list(PairList& list) {
+    pair_index_.assign(ncmo_ * ncmo_, -1);
     // Loop over irreps of the pair pq
     for (size_t pq_sym = 0; pq_sym < nirrep_; ++pq_sym) {
         list.push_back(std::vector<std::pair<int, int>>(0));
@@ -220,13 +211,69 @@ void FCIStringLists::make_pair_list(PairList& list) {
                 for (int q_rel = 0; q_rel < cmopi_[q_sym]; ++q_rel) {
                     int p_abs = p_rel + cmopi_offset_[p_sym];
                     int q_abs = q_rel + cmopi_offset_[q_sym];
-                    if (p_abs > q_abs)
+                    if (p_abs > q_abs) {
+                        pair_index_[p_abs * ncmo_ + q_abs] = list[pq_sym].size();
                         list[pq_sym].push_back(std::make_pair(p_abs, q_abs));
+                    }
                 }
             }
         }
         pairpi_.push_back(list[pq_sym].size());
     }
+
+    // offsets used to index the OO and VVOO lists
+    pair_offset_.assign(nirrep_ + 1, 0);
+    vvoo_offset_.assign(nirrep_ + 1, 0);
+    for (size_t h = 0; h < nirrep_; ++h) {
+        pair_offset_[h + 1] = pair_offset_[h] + pairpi_[h];
+        vvoo_offset_[h + 1] = vvoo_offset_[h] + static_cast<size_t>(pairpi_[h]) * pairpi_[h];
+    }
+}
+
+size_t FCIStringLists::vvoo_key(size_t p, size_t q, size_t r, size_t s, int h) const {
+    const int pq_sym = cmo_sym_[p] ^ cmo_sym_[q];
+    const int pq = pair_index_[p * ncmo_ + q];
+    const int rs = pair_index_[r * ncmo_ + s];
+    if ((pq < 0) or (rs < 0) or (pq_sym != (cmo_sym_[r] ^ cmo_sym_[s])))
+        return std::numeric_limits<size_t>::max();
+    return (vvoo_offset_[pq_sym] + pq * pairpi_[pq_sym] + rs) * nirrep_ + h;
+}
+
+size_t FCIStringLists::vvoo_list_memory(std::shared_ptr<FCIStringAddress> address) const {
+    // Each string I with k electrons contributes at most one element for each occupied pair
+    // (r > s) and each pair (p > q) of orbitals unoccupied in I after removing r and s
+    const size_t k = address->nones();
+    if (k < 2)
+        return 0;
+    size_t nstr = 0;
+    for (size_t h = 0; h < nirrep_; ++h) {
+        nstr += address->strpcls(h);
+    }
+    const size_t m = ncmo_ - k + 2;
+    const size_t npairs = (k * (k - 1) / 2) * (m * (m - 1) / 2);
+    return nstr * npairs * sizeof(StringSubstitution);
+}
+
+size_t FCIStringLists::h3_list_memory(std::shared_ptr<FCIStringAddress> address) const {
+    // Each string I with k electrons contributes six elements for each occupied triplet
+    const size_t k = address->nones();
+    if (k < 3)
+        return 0;
+    size_t nstr = 0;
+    for (size_t h = 0; h < nirrep_; ++h) {
+        nstr += address->strpcls(h);
+    }
+    const size_t ntriplets = k * (k - 1) * (k - 2) / 6;
+    return nstr * 6 * ntriplets * sizeof(H3StringSubstitution);
+}
+
+size_t FCIStringLists::hole_key(const std::shared_ptr<FCIStringAddress>& address, int h_J,
+                                size_t add_J, int h_I) const {
+    size_t offset = 0;
+    for (int h = 0; h < h_J; ++h) {
+        offset += address->strpcls(h);
+    }
+    return (offset + add_J) * nirrep_ + h_I;
 }
 
 void FCIStringLists::make_strings(std::shared_ptr<FCIStringAddress> addresser, StringList& list) {
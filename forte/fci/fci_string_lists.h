@@ -30,7 +30,9 @@
 
 #include "psi4/libmints/dimension.h"
 
+#include <limits>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <utility>
 
@@ -60,8 +62,11 @@ class FCIStringLists {
     /// @param na number of alpha electrons
     /// @param nb number of beta electrons
     /// @param print print level
+    /// @param max_memory the maximum memory (in bytes) used to store each of the VVOO and 3-hole
+    /// lists. Lists that exceed this value are not stored and are generated on the fly
     FCIStringLists(psi::Dimension cmopi, std::vector<size_t> core_mo, std::vector<size_t> cmo_to_mo,
-                   size_t na, size_t nb, PrintLevel print);
+                   size_t na, size_t nb, PrintLevel print,
+                   size_t max_memory = std::numeric_limits<size_t>::max());
 
     ~FCIStringLists() {}
 
@@ -128,25 +133,54 @@ class FCIStringLists {
     /// @return the list of determinants with a given symmetry
     std::vector<Determinant> make_determinants(int symmetry) const;
 
-    std::vector<StringSubstitution>& get_alfa_vo_list(size_t p, size_t q, int h);
-    std::vector<StringSubstitution>& get_beta_vo_list(size_t p, size_t q, int h);
-
-    std::vector<H1StringSubstitution>& get_alfa_1h_list(int h_I, size_t add_I, int h_J);
-    std::vector<H1StringSubstitution>& get_beta_1h_list(int h_I, size_t add_I, int h_J);
-
-    std::vector<H2StringSubstitution>& get_alfa_2h_list(int h_I, size_t add_I, int h_J);
-    std::vector<H2StringSubstitution>& get_beta_2h_list(int h_I, size_t add_I, int h_J);
-
-    std::vector<H3StringSubstitution>& get_alfa_3h_list(int h_I, size_t add_I, int h_J);
-    std::vector<H3StringSubstitution>& get_beta_3h_list(int h_I, size_t add_I, int h_J);
-
-    std::vector<StringSubstitution>& get_alfa_oo_list(int pq_sym, size_t pq, int h);
-    std::vector<StringSubstitution>& get_beta_oo_list(int pq_sym, size_t pq, int h);
-
-    std::vector<StringSubstitution>& get_alfa_vvoo_list(size_t p, size_t q, size_t r, size_t s,
-                                                        int h);
-    std::vector<StringSubstitution>& get_beta_vvoo_list(size_t p, size_t q, size_t r, size_t s,
-                                                        int h);
+    /// @return the list of strings connected by J = ± a^{+}_p a_q I, where I belongs to irrep h
+    StringSubstitutionRange<StringSubstitution> get_alfa_vo_list(size_t p, size_t q, int h) const;
+    StringSubstitutionRange<StringSubstitution> get_beta_vo_list(size_t p, size_t q, int h) const;
+
+    /// @return the list of strings I of irrep h_J connected to the (N-1)-electron string with
+    /// address add_I in irrep h_I by a_p I = ± J. The list is built on first use
+    StringSubstitutionRange<H1StringSubstitution> get_alfa_1h_list(int h_I, size_t add_I,
+                                                                   int h_J);
+    StringSubstitutionRange<H1StringSubstitution> get_beta_1h_list(int h_I, size_t add_I,
+                                                                   int h_J);
+
+    /// @return the list of strings I of irrep h_J connected to the (N-2)-electron string with
+    /// address add_I in irrep h_I by a_p a_q I = ± J. The list is built on first use
+    StringSubstitutionRange<H2StringSubstitution> get_alfa_2h_list(int h_I, size_t add_I,
+                                                                   int h_J);
+    StringSubstitutionRange<H2StringSubstitution> get_beta_2h_list(int h_I, size_t add_I,
+                                                                   int h_J);
+
+    /// @return the list of strings I of irrep h_J connected to the (N-3)-electron string with
+    /// address add_I in irrep h_I by a_p a_q a_r I = ± J. The list is built on first use.
+    /// If the 3-hole lists are generated on the fly, the list is stored in buffer and the range
+    /// returned is valid until buffer is modified
+    StringSubstitutionRange<H3StringSubstitution>
+    get_alfa_3h_list(int h_I, size_t add_I, int h_J, std::vector<H3StringSubstitution>& buffer);
+    StringSubstitutionRange<H3StringSubstitution>
+    get_beta_3h_list(int h_I, size_t add_I, int h_J, std::vector<H3StringSubstitution>& buffer);
+
+    /// @return the list of strings connected by a^{+}_p a^{+}_q a_q a_p, where pq is the relative
+    /// index of a pair of symmetry pq_sym and I belongs to irrep h
+    StringSubstitutionRange<StringSubstitution> get_alfa_oo_list(int pq_sym, size_t pq,
+                                                                 int h) const;
+    StringSubstitutionRange<StringSubstitution> get_beta_oo_list(int pq_sym, size_t pq,
+                                                                 int h) const;
+
+    /// @return the list of strings connected by a^{+}_p a^{+}_q a_s a_r (p > q, r > s), where I
+    /// belongs to irrep h. If the VVOO lists are generated on the fly, the list is stored in
+    /// buffer and the range returned is valid until buffer is modified
+    StringSubstitutionRange<StringSubstitution>
+    get_alfa_vvoo_list(size_t p, size_t q, size_t r, size_t s, int h,
+                       std::vector<StringSubstitution>& buffer) const;
+    StringSubstitutionRange<StringSubstitution>
+    get_beta_vvoo_list(size_t p, size_t q, size_t r, size_t s, int h,
+                       std::vector<StringSubstitution>& buffer) const;
+
+    /// @return true if the alpha or beta VVOO lists are generated on the fly
+    bool vvoo_on_the_fly() const { return alfa_vvoo_on_the_fly_ or beta_vvoo_on_the_fly_; }
+    /// @return true if the alpha or beta 3-hole lists are generated on the fly
+    bool h3_on_the_fly() const { return alfa_h3_on_the_fly_ or beta_h3_on_the_fly_; }
 
     Pair get_pair_list(int h, int n) const { return pair_list_[h][n]; }
 
@@ -179,8 +213,22 @@ class FCIStringLists {
     std::vector<int> pairpi_;
     /// The offset array for pairpi
     std::vector<int> pair_offset_;
+    /// The relative index of the pair (p,q) with p > q in its irrep (-1 if p <= q)
+    std::vector<int> pair_index_;
+    /// The offset of the (pq,rs) pairs of each irrep in the VVOO lists
+    std::vector<size_t> vvoo_offset_;
     /// The print level
     PrintLevel print_ = PrintLevel::Default;
+    /// The maximum memory (in bytes) used to store each of the alpha/beta VVOO and 3-hole lists
+    size_t max_memory_;
+    /// Generate the alpha VVOO lists on the fly?
+    bool alfa_vvoo_on_the_fly_ = false;
+    /// Generate the beta VVOO lists on the fly?
+    bool beta_vvoo_on_the_fly_ = false;
+    /// Generate the alpha 3-hole lists on the fly?
+    bool alfa_h3_on_the_fly_ = false;
+    /// Generate the beta 3-hole lists on the fly?
+    bool beta_h3_on_the_fly_ = false;
 
     // String lists
     std::shared_ptr<FCIStringClass> string_class_;
@@ -188,26 +236,37 @@ class FCIStringLists {
     StringList alfa_strings_;
     /// The beta strings stored by irrep and address
     StringList beta_strings_;
+    /// The alpha strings with N - 3 electrons stored by irrep and address
+    StringList alfa_3h_strings_;
+    /// The beta strings with N - 3 electrons stored by irrep and address
+    StringList beta_3h_strings_;
     /// The pair string list
     PairList pair_list_;
-    /// The VO string lists
-    VOList alfa_vo_list;
-    VOList beta_vo_list;
-    /// The OO string lists
-    OOList alfa_oo_list;
-    OOList beta_oo_list;
-    /// The VVOO string lists
-    VVOOList alfa_vvoo_list;
-    VVOOList beta_vvoo_list;
-    /// The 1-hole lists
-    H1List alfa_1h_list;
-    H1List beta_1h_list;
-    /// The 2-hole lists
-    H2List alfa_2h_list;
-    H2List beta_2h_list;
-    /// The 3-hole lists
-    H3List alfa_3h_list;
-    H3List beta_3h_list;
+    /// The VO string lists indexed by vo_key(p, q, h)
+    FlatStringList<StringSubstitution> alfa_vo_list;
+    FlatStringList<StringSubstitution> beta_vo_list;
+    /// The OO string lists indexed by oo_key(pq_sym, pq, h)
+    FlatStringList<StringSubstitution> alfa_oo_list;
+    FlatStringList<StringSubstitution> beta_oo_list;
+    /// The VVOO string lists indexed by vvoo_key(p, q, r, s, h)
+    FlatStringList<StringSubstitution> alfa_vvoo_list;
+    FlatStringList<StringSubstitution> beta_vvoo_list;
+    /// The 1-hole lists indexed by hole_key(address_1h, h_J, add_J, h_I)
+    FlatStringList<H1StringSubstitution> alfa_1h_list;
+    FlatStringList<H1StringSubstitution> beta_1h_list;
+    /// The 2-hole lists indexed by hole_key(address_2h, h_J, add_J, h_I)
+    FlatStringList<H2StringSubstitution> alfa_2h_list;
+    FlatStringList<H2StringSubstitution> beta_2h_list;
+    /// The 3-hole lists indexed by hole_key(address_3h, h_J, add_J, h_I)
+    FlatStringList<H3StringSubstitution> alfa_3h_list;
+    FlatStringList<H3StringSubstitution> beta_3h_list;
+    /// Flags used to build the hole lists only once and on demand
+    std::once_flag alfa_1h_flag_;
+    std::once_flag beta_1h_flag_;
+    std::once_flag alfa_2h_flag_;
+    std::once_flag beta_2h_flag_;
+    std::once_flag alfa_3h_flag_;
+    std::once_flag beta_3h_flag_;
 
     /// Addressers
     /// The alpha string address
@@ -242,31 +301,67 @@ class FCIStringLists {
     /// Make the pair list
     void make_pair_list(PairList& list);
 
+    /// @return the index of the VO list for the orbitals (p,q) and strings of irrep h
+    size_t vo_key(size_t p, size_t q, int h) const { return (p * ncmo_ + q) * nirrep_ + h; }
+    /// @return the index of the OO list for the pair pq of symmetry pq_sym and strings of irrep h
+    size_t oo_key(int pq_sym, size_t pq, int h) const {
+        return (pair_offset_[pq_sym] + pq) * nirrep_ + h;
+    }
+    /// @return the index of the VVOO list for the orbitals (p,q,r,s) and strings of irrep h.
+    /// Returns an out-of-range index for symmetry-forbidden or non-canonical (p <= q, r <= s)
+    /// orbital indices
+    size_t vvoo_key(size_t p, size_t q, size_t r, size_t s, int h) const;
+    /// @return the index of the hole list for the string with address add_J in irrep h_J of the
+    /// hole space described by address and strings of irrep h_I
+    size_t hole_key(const std::shared_ptr<FCIStringAddress>& address, int h_J, size_t add_J,
+                    int h_I) const;
+
     /// Make the VO list
-    void make_vo_list(std::shared_ptr<FCIStringAddress> graph, VOList& list);
-    void make_vo(std::shared_ptr<FCIStringAddress> graph, VOList& list, int p, int q);
+    void make_vo_list(std::shared_ptr<FCIStringAddress> graph,
+                      FlatStringList<StringSubstitution>& list);
+    void make_vo(std::shared_ptr<FCIStringAddress> graph,
+                 std::vector<std::vector<StringSubstitution>>& lists, int p, int q);
 
     /// @brief Make the list of strings connected by a^{+}_p a^{+}_q a_q a_p
-    void make_oo_list(std::shared_ptr<FCIStringAddress> graph, OOList& list);
+    void make_oo_list(std::shared_ptr<FCIStringAddress> graph,
+                      FlatStringList<StringSubstitution>& list);
 
     /// @brief Make the list of strings connected by a^{+}_p a^{+}_q a_q a_p
     /// @param pq_sym symmetry of the pq pair
     /// @param pq relative pair index of the pq pair
-    void make_oo(std::shared_ptr<FCIStringAddress> address, OOList& list, int pq_sym, size_t pq);
+    void make_oo(std::shared_ptr<FCIStringAddress> address,
+                 std::vector<std::vector<StringSubstitution>>& lists, int pq_sym, size_t pq);
 
     /// Make 1-hole lists (I -> a_p I = sgn J)
     void make_1h_list(std::shared_ptr<FCIStringAddress> graph,
-                      std::shared_ptr<FCIStringAddress> graph_1h, H1List& list);
+                      std::shared_ptr<FCIStringAddress> graph_1h,
+                      FlatStringList<H1StringSubstitution>& list);
     /// Make 2-hole lists (I -> a_p a_q I = sgn J)
     void make_2h_list(std::shared_ptr<FCIStringAddress> graph,
-                      std::shared_ptr<FCIStringAddress> graph_2h, H2List& list);
+                      std::shared_ptr<FCIStringAddress> graph_2h,
+                      FlatStringList<H2StringSubstitution>& list);
     /// Make 3-hole lists (I -> a_p a_q a_r I = sgn J)
-    void make_3h_list(std::shared_ptr<FCIStringAddress> graph,
-                      std::shared_ptr<FCIStringAddress> graph_3h, H3List& list);
+    void make_3h_list(std::shared_ptr<FCIStringAddress> graph, const StringList& strings_3h,
+                      FlatStringList<H3StringSubstitution>& list);
+    /// Append to list the substitutions a_p a_q a_r I = sgn J for all the strings I of irrep h_I
+    void make_3h(std::shared_ptr<FCIStringAddress> graph, const String& J, int h_I,
+                 std::vector<H3StringSubstitution>& list) const;
+    /// @return the memory (in bytes) required to store the 3-hole lists for a string graph
+    size_t h3_list_memory(std::shared_ptr<FCIStringAddress> graph) const;
 
     /// Make the VVOO list
-    void make_vvoo_list(std::shared_ptr<FCIStringAddress> graph, VVOOList& list);
-    void make_vvoo(std::shared_ptr<FCIStringAddress> graph, VVOOList& list, int p, int q, int r,
+    void make_vvoo_list(std::shared_ptr<FCIStringAddress> graph,
+                        FlatStringList<StringSubstitution>& list);
+    void make_vvoo(std::shared_ptr<FCIStringAddress> graph,
+                   std::vector<std::vector<StringSubstitution>>& lists, int p, int q, int r,
                    int s);
+    /// Generate the VVOO list for (p,q,r,s) by applying a^{+}_p a^{+}_q a_s a_r to the strings
+    /// of one irrep
+    void make_vvoo_on_the_fly(std::shared_ptr<FCIStringAddress> graph,
+                              const std::vector<String>& strings, size_t p, size_t q, size_t r,
+                              size_t s, std::vector<StringSubstitution>& list) const;
+    /// @return an estimate (upper bound) of the memory (in bytes) required to store the VVOO
+    /// lists for a string graph
+    size_t vvoo_list_memory(std::shared_ptr<FCIStringAddress> graph) const;
 };
 } // namespace forte
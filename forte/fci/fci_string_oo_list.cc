@@ -40,9 +40,9 @@ namespace forte {
  * @param pq     relative PAIRINDEX of the pq pair
  * @param h      symmetry of the I strings in the list
  */
-std::vector<StringSubstitution>& FCIStringLists::get_alfa_oo_list(int pq_sym, size_t pq, int h) {
-    std::tuple<int, size_t, int> pq_pair(pq_sym, pq, h);
-    return alfa_oo_list[pq_pair];
+StringSubstitutionRange<StringSubstitution>
+FCIStringLists::get_alfa_oo_list(int pq_sym, size_t pq, int h) const {
+    return alfa_oo_list[oo_key(pq_sym, pq, h)];
 }
 
 /**
@@ -51,22 +51,29 @@ std::vector<StringSubstitution>& FCIStringLists::get_alfa_oo_list(int pq_sym, si
  * @param pq     relative PAIRINDEX of the pq pair
  * @param h      symmetry of the I strings in the list
  */
-std::vector<StringSubstitution>& FCIStringLists::get_beta_oo_list(int pq_sym, size_t pq, int h) {
-    std::tuple<int, size_t, int> pq_pair(pq_sym, pq, h);
-    return beta_oo_list[pq_pair];
+StringSubstitutionRange<StringSubstitution>
+FCIStringLists::get_beta_oo_list(int pq_sym, size_t pq, int h) const {
+    return beta_oo_list[oo_key(pq_sym, pq, h)];
 }
 
-void FCIStringLists::make_oo_list(std::shared_ptr<FCIStringAddress> addresser, OOList& list) {
-    // Loop over irreps of the pair pq
-    for (size_t pq_sym = 0; pq_sym < nirrep_; ++pq_sym) {
-        size_t max_pq = pairpi_[pq_sym];
-        for (size_t pq = 0; pq < max_pq; ++pq) {
-            make_oo(addresser, list, pq_sym, pq);
-        }
+void FCIStringLists::make_oo_list(std::shared_ptr<FCIStringAddress> addresser,
+                                  FlatStringList<StringSubstitution>& list) {
+    const int npairs = pair_offset_[nirrep_];
+    std::vector<std::vector<StringSubstitution>> lists(npairs * nirrep_);
+    // Each pair writes only to its own lists, so the pairs can be processed in parallel
+#pragma omp parallel for schedule(dynamic)
+    for (int n = 0; n < npairs; ++n) {
+        // find the symmetry and relative index of the pair
+        int pq_sym = 0;
+        while (n >= pair_offset_[pq_sym + 1])
+            pq_sym++;
+        make_oo(addresser, lists, pq_sym, n - pair_offset_[pq_sym]);
     }
+    list.assign(lists);
 }
 
-void FCIStringLists::make_oo(std::shared_ptr<FCIStringAddress> addresser, OOList& list, int pq_sym,
+void FCIStringLists::make_oo(std::shared_ptr<FCIStringAddress> addresser,
+                             std::vector<std::vector<StringSubstitution>>& lists, int pq_sym,
                              size_t pq) {
     int k = addresser->nones() - 2;
     if (k >= 0) {
@@ -78,8 +85,7 @@ void FCIStringLists::make_oo(std::shared_ptr<FCIStringAddress> addresser, OOList
         auto b_begin = b.begin();
         auto b_end = b.begin() + n;
         for (size_t h = 0; h < nirrep_; ++h) {
-            // Create the key to the map
-            std::tuple<int, size_t, int> pq_pair(pq_sym, pq, h);
+            auto& list = lists[oo_key(pq_sym, pq, h)];
 
             // Generate the strings 1111100000
             //                      { k }{n-k}
@@ -107,8 +113,7 @@ void FCIStringLists::make_oo(std::shared_ptr<FCIStringAddress> addresser, OOList
                 J[q] = true;
                 // Add the sting only of irrep(I) is h
                 if (string_class_->symmetry(I) == h)
-                    list[pq_pair].push_back(
-                        StringSubstitution(1.0, addresser->add(I), addresser->add(J)));
+                    list.push_back(StringSubstitution(1.0, addresser->add(I), addresser->add(J)));
             } while (std::next_permutation(b_begin, b_end));
         } // End loop over h
     }
@@ -51,8 +51,9 @@ namespace forte {
  * that is: J = ± a^{+}_p a_q I. p and q are absolute indices and I belongs to
  * the irrep h.
  */
-std::vector<StringSubstitution>& FCIStringLists::get_alfa_vo_list(size_t p, size_t q, int h) {
-    return alfa_vo_list[std::make_tuple(p, q, h)];
+StringSubstitutionRange<StringSubstitution> FCIStringLists::get_alfa_vo_list(size_t p, size_t q,
+                                                                             int h) const {
+    return alfa_vo_list[vo_key(p, q, h)];
 }
 
 /**
@@ -61,25 +62,21 @@ std::vector<StringSubstitution>& FCIStringLists::get_alfa_vo_list(size_t p, size
  * that is: J = ± a^{+}_p a_q I. p and q are absolute indices and I belongs to
  * the irrep h.
  */
-std::vector<StringSubstitution>& FCIStringLists::get_beta_vo_list(size_t p, size_t q, int h) {
-    return beta_vo_list[std::make_tuple(p, q, h)];
+StringSubstitutionRange<StringSubstitution> FCIStringLists::get_beta_vo_list(size_t p, size_t q,
+                                                                             int h) const {
+    return beta_vo_list[vo_key(p, q, h)];
 }
 
-void FCIStringLists::make_vo_list(std::shared_ptr<FCIStringAddress> addresser, VOList& list) {
-    // Loop over irreps of the pair pq
-    for (size_t pq_sym = 0; pq_sym < nirrep_; ++pq_sym) {
-        // Loop over irreps of p
-        for (size_t p_sym = 0; p_sym < nirrep_; ++p_sym) {
-            int q_sym = pq_sym ^ p_sym;
-            for (int p_rel = 0; p_rel < cmopi_[p_sym]; ++p_rel) {
-                for (int q_rel = 0; q_rel < cmopi_[q_sym]; ++q_rel) {
-                    int p_abs = p_rel + cmopi_offset_[p_sym];
-                    int q_abs = q_rel + cmopi_offset_[q_sym];
-                    make_vo(addresser, list, p_abs, q_abs);
-                }
-            }
-        }
+void FCIStringLists::make_vo_list(std::shared_ptr<FCIStringAddress> addresser,
+                                  FlatStringList<StringSubstitution>& list) {
+    std::vector<std::vector<StringSubstitution>> lists(ncmo_ * ncmo_ * nirrep_);
+    // Each (p,q) pair writes only to its own lists, so the pairs can be processed in parallel
+    const int npq = static_cast<int>(ncmo_ * ncmo_);
+#pragma omp parallel for schedule(dynamic)
+    for (int pq = 0; pq < npq; ++pq) {
+        make_vo(addresser, lists, pq / ncmo_, pq % ncmo_);
     }
+    list.assign(lists);
 }
 
 /**
@@ -87,8 +84,8 @@ void FCIStringLists::make_vo_list(std::shared_ptr<FCIStringAddress> addresser, V
  * that is: J = ± a^{+}_p a_q I. p and q are absolute indices and I belongs to
  * the irrep h.
  */
-void FCIStringLists::make_vo(std::shared_ptr<FCIStringAddress> addresser, VOList& list, int p,
-                             int q) {
+void FCIStringLists::make_vo(std::shared_ptr<FCIStringAddress> addresser,
+                             std::vector<std::vector<StringSubstitution>>& lists, int p, int q) {
     int n = addresser->nbits() - 1 - (p == q ? 0 : 1);
     int k = addresser->nones() - 1;
     std::vector<int8_t> b(n); // vector<int8_t> is fast to generate the permutations
@@ -97,8 +94,7 @@ void FCIStringLists::make_vo(std::shared_ptr<FCIStringAddress> addresser, VOList
     auto b_end = b.begin() + n;
     if ((k >= 0) and (k <= n)) { // check that (n > 0) makes sense.
         for (size_t h = 0; h < nirrep_; ++h) {
-            // Create the key to the map
-            std::tuple<size_t, size_t, int> pq_pair(p, q, h);
+            auto& list = lists[vo_key(p, q, h)];
 
             // Generate the strings 1111100000
             //                      { k }{n-k}
@@ -131,8 +127,7 @@ void FCIStringLists::make_vo(std::shared_ptr<FCIStringAddress> addresser, VOList
 
                 // Add the string only of irrep(I) is h
                 if (string_class_->symmetry(I) == h)
-                    list[pq_pair].push_back(
-                        StringSubstitution(sign, addresser->add(I), addresser->add(J)));
+                    list.push_back(StringSubstitution(sign, addresser->add(I), addresser->add(J)));
             } while (std::next_permutation(b_begin, b_end));
 
         } // End loop over h
@@ -27,6 +27,8 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <limits>
 
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -38,55 +40,66 @@
 namespace forte {
 
 /**
+ * Returns the list of alfa strings connected by a^{+}_p a^{+}_q a_s a_r (p > q, r > s)
  */
-std::vector<StringSubstitution>& FCIStringLists::get_alfa_vvoo_list(size_t p, size_t q, size_t r,
-                                                                    size_t s, int h) {
-    std::tuple<size_t, size_t, size_t, size_t, int> pqrs_pair(p, q, r, s, h);
-    return alfa_vvoo_list[pqrs_pair];
+StringSubstitutionRange<StringSubstitution>
+FCIStringLists::get_alfa_vvoo_list(size_t p, size_t q, size_t r, size_t s, int h,
+                                   std::vector<StringSubstitution>& buffer) const {
+    const size_t key = vvoo_key(p, q, r, s, h);
+    if (alfa_vvoo_on_the_fly_) {
+        buffer.clear();
+        if (key != std::numeric_limits<size_t>::max())
+            make_vvoo_on_the_fly(alfa_address_, alfa_strings_[h], p, q, r, s, buffer);
+        return {buffer.data(), buffer.data() + buffer.size()};
+    }
+    return alfa_vvoo_list[key];
 }
 
 /**
+ * Returns the list of beta strings connected by a^{+}_p a^{+}_q a_s a_r (p > q, r > s)
  */
-std::vector<StringSubstitution>& FCIStringLists::get_beta_vvoo_list(size_t p, size_t q, size_t r,
-                                                                    size_t s, int h) {
-    std::tuple<size_t, size_t, size_t, size_t, int> pqrs_pair(p, q, r, s, h);
-    return beta_vvoo_list[pqrs_pair];
+StringSubstitutionRange<StringSubstitution>
+FCIStringLists::get_beta_vvoo_list(size_t p, size_t q, size_t r, size_t s, int h,
+                                   std::vector<StringSubstitution>& buffer) const {
+    const size_t key = vvoo_key(p, q, r, s, h);
+    if (beta_vvoo_on_the_fly_) {
+        buffer.clear();
+        if (key != std::numeric_limits<size_t>::max())
+            make_vvoo_on_the_fly(beta_address_, beta_strings_[h], p, q, r, s, buffer);
+        return {buffer.data(), buffer.data() + buffer.size()};
+    }
+    return beta_vvoo_list[key];
 }
 
-void FCIStringLists::make_vvoo_list(std::shared_ptr<FCIStringAddress> addresser, VVOOList& list) {
-    // Loop over irreps of the pair pq
+void FCIStringLists::make_vvoo_list(std::shared_ptr<FCIStringAddress> addresser,
+                                    FlatStringList<StringSubstitution>& list) {
+    // Collect the (p,q,r,s) quadruplets with (p > q) and (r > s) and pq and rs of the same irrep
+    std::vector<std::array<int, 4>> pqrs_list;
     for (size_t pq_sym = 0; pq_sym < nirrep_; ++pq_sym) {
-        int rs_sym = pq_sym;
-        // Loop over irreps of p,r
-        for (size_t p_sym = 0; p_sym < nirrep_; ++p_sym) {
-            int q_sym = pq_sym ^ p_sym;
-            for (size_t r_sym = 0; r_sym < nirrep_; ++r_sym) {
-                size_t s_sym = rs_sym ^ r_sym;
-                for (int p_rel = 0; p_rel < cmopi_[p_sym]; ++p_rel) {
-                    for (int q_rel = 0; q_rel < cmopi_[q_sym]; ++q_rel) {
-                        for (int r_rel = 0; r_rel < cmopi_[r_sym]; ++r_rel) {
-                            for (int s_rel = 0; s_rel < cmopi_[s_sym]; ++s_rel) {
-                                int p_abs = p_rel + cmopi_offset_[p_sym];
-                                int q_abs = q_rel + cmopi_offset_[q_sym];
-                                int r_abs = r_rel + cmopi_offset_[r_sym];
-                                int s_abs = s_rel + cmopi_offset_[s_sym];
-                                if ((p_abs > q_abs) && (r_abs > s_abs)) {
-                                    // Avoid
-                                    if (not((p_abs == r_abs) and (q_abs == s_abs))) {
-                                        make_vvoo(addresser, list, p_abs, q_abs, r_abs, s_abs);
-                                    }
-                                }
-                            }
-                        }
-                    }
+        for (const auto& [p_abs, q_abs] : pair_list_[pq_sym]) {
+            for (const auto& [r_abs, s_abs] : pair_list_[pq_sym]) {
+                // Avoid
+                if (not((p_abs == r_abs) and (q_abs == s_abs))) {
+                    pqrs_list.push_back({p_abs, q_abs, r_abs, s_abs});
                 }
             }
         }
     }
+
+    std::vector<std::vector<StringSubstitution>> lists(vvoo_offset_[nirrep_] * nirrep_);
+    // Each quadruplet writes only to its own lists, so they can be processed in parallel
+    const int npqrs = static_cast<int>(pqrs_list.size());
+#pragma omp parallel for schedule(dynamic)
+    for (int n = 0; n < npqrs; ++n) {
+        const auto& [p, q, r, s] = pqrs_list[n];
+        make_vvoo(addresser, lists, p, q, r, s);
+    }
+    list.assign(lists);
 }
 
-void FCIStringLists::make_vvoo(std::shared_ptr<FCIStringAddress> addresser, VVOOList& list, int p,
-                               int q, int r, int s) {
+void FCIStringLists::make_vvoo(std::shared_ptr<FCIStringAddress> addresser,
+                               std::vector<std::vector<StringSubstitution>>& lists, int p, int q,
+                               int r, int s) {
     // Sort pqrs
     int a[4];
     a[0] = s;
@@ -125,8 +138,7 @@ void FCIStringLists::make_vvoo(std::shared_ptr<FCIStringAddress> addresser, VVOO
         String I, J;
 
         for (size_t h = 0; h < nirrep_; ++h) {
-            // Create the key to the map
-            std::tuple<size_t, size_t, size_t, size_t, int> pqrs_pair(p, q, r, s, h);
+            auto& list = lists[vvoo_key(p, q, r, s, h)];
 
             // Generate the strings 1111100000
             //                      { k }{n-k}
@@ -176,7 +188,7 @@ void FCIStringLists::make_vvoo(std::shared_ptr<FCIStringAddress> addresser, VVOO
                         if (!J[p]) { // p = 0
                             J[p] = true;
                             sign *= J.slater_sign(p);
-                            list[pqrs_pair].push_back(
+                            list.push_back(
                                 StringSubstitution(sign, addresser->add(I), addresser->add(J)));
                         }
                     }
@@ -186,4 +198,41 @@ void FCIStringLists::make_vvoo(std::shared_ptr<FCIStringAddress> addresser, VVOO
     }
 }
 
+/**
+ * Generate the list of strings connected by a^{+}_p a^{+}_q a_s a_r by applying the operator to
+ * each string I of one irrep and looking up the address of J in the string graph.
+ * This is equivalent to make_vvoo() but does not require storing the lists.
+ */
+void FCIStringLists::make_vvoo_on_the_fly(std::shared_ptr<FCIStringAddress> addresser,
+                                          const std::vector<String>& strings, size_t p, size_t q,
+                                          size_t r, size_t s,
+                                          std::vector<StringSubstitution>& list) const {
+    // The diagonal terms are stored in the OO list
+    if ((p == r) and (q == s))
+        return;
+    const size_t nstr = strings.size();
+    for (size_t add_I = 0; add_I < nstr; ++add_I) {
+        const String& I = strings[add_I];
+        if (I[r] and I[s]) {
+            String J = I;
+            short sign = 1;
+            // Apply a^{+}_p a^{+}_q a_s a_r to I
+            for (size_t i = s; i < r; ++i)
+                if (J[i])
+                    sign *= -1;
+            J[r] = false;
+            J[s] = false;
+            if (!J[q]) { // q = 0
+                J[q] = true;
+                sign *= J.slater_sign(q);
+                if (!J[p]) { // p = 0
+                    J[p] = true;
+                    sign *= J.slater_sign(p);
+                    list.push_back(StringSubstitution(sign, add_I, addresser->add(J)));
+                }
+            }
+        }
+    }
+}
+
 } // namespace forte
@@ -127,6 +127,8 @@ void FCIVector::H2_aaaa2(FCIVector& result, std::shared_ptr<ActiveSpaceIntegrals
     // Notation
     // h_Ia - symmetry of alpha strings
     // h_Ib - symmetry of beta strings
+    // workspace used when the VVOO lists are generated on the fly
+    std::vector<StringSubstitution> vvoo_buffer;
     for (int h_Ia = 0; h_Ia < nirrep_; ++h_Ia) {
         int h_Ib = h_Ia ^ symmetry_;
         if (detpi_[h_Ia] > 0) {
@@ -166,21 +168,23 @@ void FCIVector::H2_aaaa2(FCIVector& result, std::shared_ptr<ActiveSpaceIntegrals
                                                      : fci_ints->tei_bb(p_abs, q_abs, r_abs, s_abs);
 
                         {
-                            const auto& VVOO_list =
-                                alfa ? lists_->get_alfa_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ia)
-                                     : lists_->get_beta_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ib);
+                            const auto VVOO_list =
+                                alfa ? lists_->get_alfa_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ia,
+                                                                  vvoo_buffer)
+                                     : lists_->get_beta_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ib,
+                                                                  vvoo_buffer);
                             for (const auto& [sign, I, J] : VVOO_list) {
                                 C_DAXPY(maxL, sign * integral, Cr[I], 1, Cl[J], 1);
                             }
-                            {
-                                const auto& VVOO_list =
-                                    alfa ? lists_->get_alfa_vvoo_list(r_abs, s_abs, p_abs, q_abs,
-                                                                      h_Ia)
-                                         : lists_->get_beta_vvoo_list(r_abs, s_abs, p_abs, q_abs,
-                                                                      h_Ib);
-                                for (const auto& [sign, I, J] : VVOO_list) {
-                                    C_DAXPY(maxL, sign * integral, Cr[I], 1, Cl[J], 1);
-                                }
+                        }
+                        {
+                            const auto VVOO_list =
+                                alfa ? lists_->get_alfa_vvoo_list(r_abs, s_abs, p_abs, q_abs, h_Ia,
+                                                                  vvoo_buffer)
+                                     : lists_->get_beta_vvoo_list(r_abs, s_abs, p_abs, q_abs, h_Ib,
+                                                                  vvoo_buffer);
+                            for (const auto& [sign, I, J] : VVOO_list) {
+                                C_DAXPY(maxL, sign * integral, Cr[I], 1, Cl[J], 1);
                             }
                         }
                     }
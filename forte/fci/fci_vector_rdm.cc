@@ -222,6 +222,8 @@ ambit::Tensor FCIVector::compute_2rdm_aa_same_irrep(FCIVector& C_left, FCIVector
         return rdm;
 
     auto& rdm_data = rdm.data();
+    // workspace used when the VVOO lists are generated on the fly
+    std::vector<StringSubstitution> vvoo_buffer;
 
     // Notation
     // h_Ia - symmetry of alpha strings
@@ -242,7 +244,7 @@ ambit::Tensor FCIVector::compute_2rdm_aa_same_irrep(FCIVector& C_left, FCIVector
                 for (size_t pq = 0; pq < max_pq; ++pq) {
                     const auto& [p_abs, q_abs] = lists->get_pair_list(pq_sym, pq);
 
-                    std::vector<StringSubstitution>& OO =
+                    const auto& OO =
                         alfa ? lists->get_alfa_oo_list(pq_sym, pq, h_Ia)
                              : lists->get_beta_oo_list(pq_sym, pq, h_Ib);
 
@@ -265,9 +267,11 @@ ambit::Tensor FCIVector::compute_2rdm_aa_same_irrep(FCIVector& C_left, FCIVector
                     for (size_t rs = 0; rs < pq; ++rs) {
                         const auto& [r_abs, s_abs] = lists->get_pair_list(pq_sym, rs);
 
-                        const auto& VVOO =
-                            alfa ? lists->get_alfa_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ia)
-                                 : lists->get_beta_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ib);
+                        const auto VVOO =
+                            alfa ? lists->get_alfa_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ia,
+                                                             vvoo_buffer)
+                                 : lists->get_beta_vvoo_list(p_abs, q_abs, r_abs, s_abs, h_Ib,
+                                                             vvoo_buffer);
 
                         double rdm_element = 0.0;
                         for (const auto& [sign, I, J] : VVOO) {
@@ -410,6 +414,8 @@ ambit::Tensor FCIVector::compute_3rdm_aaa_same_irrep(FCIVector& C_left, FCIVecto
         return rdm;
 
     auto& rdm_data = rdm.data();
+    // workspace used when the 3-hole lists are generated on the fly
+    std::vector<H3StringSubstitution> h3_buffer;
 
     for (int h_K = 0; h_K < nirrep; ++h_K) {
         size_t maxK =
@@ -425,9 +431,8 @@ ambit::Tensor FCIVector::compute_3rdm_aaa_same_irrep(FCIVector& C_left, FCIVecto
             size_t maxL = alfa ? beta_address->strpcls(h_Ib) : alfa_address->strpcls(h_Ia);
             if (maxL > 0) {
                 for (size_t K = 0; K < maxK; ++K) {
-                    std::vector<H3StringSubstitution>& Klist =
-                        alfa ? lists->get_alfa_3h_list(h_K, K, h_Ia)
-                             : lists->get_beta_3h_list(h_K, K, h_Ib);
+                    const auto Klist = alfa ? lists->get_alfa_3h_list(h_K, K, h_Ia, h3_buffer)
+                                            : lists->get_beta_3h_list(h_K, K, h_Ib, h3_buffer);
                     for (const auto& [sign_K, p, q, r, I] : Klist) {
                         for (const auto& [sign_L, s, t, u, J] : Klist) {
                             rdm_data[six_index(p, q, r, s, t, u, ncmo)] +=
@@ -463,15 +468,11 @@ ambit::Tensor FCIVector::compute_3rdm_aab_same_irrep(FCIVector& C_left, FCIVecto
                     int h_Nb = h_Ja ^ symmetry;
                     double** C_J_p = C_left.C(h_Ja)->pointer();
                     for (size_t K = 0; K < maxK; ++K) {
-                        std::vector<H2StringSubstitution>& Ilist =
-                            lists->get_alfa_2h_list(h_K, K, h_Ia);
-                        std::vector<H2StringSubstitution>& Jlist =
-                            lists->get_alfa_2h_list(h_K, K, h_Ja);
+                        const auto Ilist = lists->get_alfa_2h_list(h_K, K, h_Ia);
+                        const auto Jlist = lists->get_alfa_2h_list(h_K, K, h_Ja);
                         for (size_t L = 0; L < maxL; ++L) {
-                            std::vector<H1StringSubstitution>& Mlist =
-                                lists->get_beta_1h_list(h_L, L, h_Mb);
-                            std::vector<H1StringSubstitution>& Nlist =
-                                lists->get_beta_1h_list(h_L, L, h_Nb);
+                            const auto Mlist = lists->get_beta_1h_list(h_L, L, h_Mb);
+                            const auto Nlist = lists->get_beta_1h_list(h_L, L, h_Nb);
                             for (const auto& Iel : Ilist) {
                                 size_t q = Iel.p;
                                 size_t p = Iel.q;
@@ -524,15 +525,11 @@ ambit::Tensor FCIVector::compute_3rdm_abb_same_irrep(FCIVector& C_left, FCIVecto
                     int h_Nb = h_Ja ^ symmetry;
                     double** C_J_p = C_left.C(h_Ja)->pointer();
                     for (size_t K = 0; K < maxK; ++K) {
-                        std::vector<H1StringSubstitution>& Ilist =
-                            lists->get_alfa_1h_list(h_K, K, h_Ia);
-                        std::vector<H1StringSubstitution>& Jlist =
-                            lists->get_alfa_1h_list(h_K, K, h_Ja);
+                        const auto Ilist = lists->get_alfa_1h_list(h_K, K, h_Ia);
+                        const auto Jlist = lists->get_alfa_1h_list(h_K, K, h_Ja);
                         for (size_t L = 0; L < maxL; ++L) {
-                            std::vector<H2StringSubstitution>& Mlist =
-                                lists->get_beta_2h_list(h_L, L, h_Mb);
-                            std::vector<H2StringSubstitution>& Nlist =
-                                lists->get_beta_2h_list(h_L, L, h_Nb);
+                            const auto Mlist = lists->get_beta_2h_list(h_L, L, h_Mb);
+                            const auto Nlist = lists->get_beta_2h_list(h_L, L, h_Nb);
                             for (size_t Iel = 0; Iel < Ilist.size(); Iel++) {
                                 size_t p = Ilist[Iel].p;
                                 size_t I = Ilist[Iel].J;
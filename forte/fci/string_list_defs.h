@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <utility>
@@ -74,6 +75,59 @@ struct H3StringSubstitution {
         : sign(sign_), p(p_), q(q_), r(r_), J(J_) {}
 };
 
+/// A read-only view of a contiguous range of string substitutions
+template <typename T> class StringSubstitutionRange {
+  public:
+    StringSubstitutionRange(const T* begin, const T* end) : begin_(begin), end_(end) {}
+    const T* begin() const { return begin_; }
+    const T* end() const { return end_; }
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    const T& operator[](size_t n) const { return begin_[n]; }
+
+  private:
+    const T* begin_;
+    const T* end_;
+};
+
+/// A collection of string substitution lists addressed by an integer key. All the elements are
+/// stored in a single contiguous buffer and the list of a key is located via an offset array.
+/// The lists are first built independently for each key (e.g., in parallel) and then packed.
+template <typename T> class FlatStringList {
+  public:
+    /// Pack the lists into the contiguous buffer. The input lists are released in the process
+    void assign(std::vector<std::vector<T>>& lists) {
+        offsets_.assign(lists.size() + 1, 0);
+        for (size_t key = 0; key < lists.size(); ++key) {
+            offsets_[key + 1] = offsets_[key] + lists[key].size();
+        }
+        data_.clear();
+        data_.reserve(offsets_.back());
+        for (auto& list : lists) {
+            for (const auto& el : list) {
+                data_.push_back(el);
+            }
+            std::vector<T>().swap(list);
+        }
+    }
+    /// @return the number of keys
+    size_t nkeys() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    /// @return the total number of substitutions stored
+    size_t size() const { return data_.size(); }
+    /// @return the list of substitutions for a given key (empty if the key is out of range)
+    StringSubstitutionRange<T> operator[](size_t key) const {
+        if (key >= nkeys())
+            return {nullptr, nullptr};
+        return {data_.data() + offsets_[key], data_.data() + offsets_[key + 1]};
+    }
+
+  private:
+    /// The offset of the list of each key (size = number of keys + 1)
+    std::vector<size_t> offsets_;
+    /// The substitutions of all the lists stored contiguously
+    std::vector<T> data_;
+};
+
 using StringList = std::vector<std::vector<String>>;
 
 /// Maps the integers (p,q,h) to list of strings connected by a^{+}_p a_q, where the string
@@ -0,0 +1,315 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2024 by its authors (see COPYING, COPYING.LESSER,
+ * AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <numeric>
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+
+#include "helpers/diis_store.h"
+
+namespace forte {
+
+DIISStore::DIISStore(const std::string& file_prefix, int max_vec, bool compress)
+    : file_prefix_(file_prefix), max_vec_(std::max(1, max_vec)), compress_(compress),
+      B_(max_vec_ * max_vec_, 0.0), file_bytes_(max_vec_, 0) {}
+
+DIISStore::~DIISStore() {
+    try {
+        reset_subspace();
+    } catch (...) {
+        // never throw from the destructor, the files are left in scratch
+    }
+}
+
+void DIISStore::add_entry(ambit::BlockedTensor& R1, ambit::BlockedTensor& R2,
+                          ambit::BlockedTensor& T1, ambit::BlockedTensor& T2) {
+    wait_writes();
+
+    auto R = flatten_blocked_tensors(R1, R2);
+    if (nvec_ == 0) {
+        size_ = R.size();
+    } else if (R.size() != size_) {
+        throw psi::PSIEXCEPTION("DIISStore: inconsistent size of the error vectors.");
+    }
+
+    // append to the subspace or replace the vector with the largest error
+    int slot = nvec_;
+    if (nvec_ == max_vec_) {
+        slot = 0;
+        for (int i = 1; i < nvec_; ++i) {
+            if (B_[i * max_vec_ + i] > B_[slot * max_vec_ + slot])
+                slot = i;
+        }
+    }
+
+    // overlaps with the stored error vectors
+    std::vector<int> slots;
+    for (int i = 0; i < nvec_; ++i) {
+        if (i != slot)
+            slots.push_back(i);
+    }
+    stream(slots, true, [&](int j, const std::vector<double>& Rj) {
+        double value = std::inner_product(R.begin(), R.end(), Rj.begin(), 0.0);
+        B_[slot * max_vec_ + j] = value;
+        B_[j * max_vec_ + slot] = value;
+    });
+    B_[slot * max_vec_ + slot] = std::inner_product(R.begin(), R.end(), R.begin(), 0.0);
+    if (slot == nvec_)
+        nvec_ += 1;
+
+    // the writes overlap with the next amplitude update
+    file_bytes_[slot] = 0;
+    write_async(slot, true, std::move(R));
+    write_async(slot, false, flatten_blocked_tensors(T1, T2));
+}
+
+bool DIISStore::extrapolate(ambit::BlockedTensor& T1, ambit::BlockedTensor& T2) {
+    wait_writes();
+    if (nvec_ == 0)
+        return false;
+
+    // solve the DIIS equations [B -1; -1 0] [c; lambda] = [0; -1], B scaled for stability
+    const int n = nvec_ + 1;
+    double scale = 0.0;
+    for (int i = 0; i < nvec_; ++i) {
+        scale = std::max(scale, B_[i * max_vec_ + i]);
+    }
+    scale = scale > 0.0 ? 1.0 / scale : 1.0;
+
+    std::vector<double> A(n * n, 0.0), c(n, 0.0);
+    for (int i = 0; i < nvec_; ++i) {
+        for (int j = 0; j < nvec_; ++j) {
+            A[i * n + j] = B_[i * max_vec_ + j] * scale;
+        }
+        A[i * n + nvec_] = -1.0;
+        A[nvec_ * n + i] = -1.0;
+    }
+    c[nvec_] = -1.0;
+    std::vector<int> ipiv(n);
+    if (psi::C_DGESV(n, 1, A.data(), n, ipiv.data(), c.data(), n) != 0)
+        return false;
+
+    // T = sum_i c_i T_i
+    std::vector<double> T(size_, 0.0);
+    std::vector<int> slots(nvec_);
+    std::iota(slots.begin(), slots.end(), 0);
+    stream(slots, false, [&](int i, const std::vector<double>& Ti) {
+        const double ci = c[i];
+        std::transform(T.begin(), T.end(), Ti.begin(), T.begin(),
+                       [ci](double x, double y) { return x + ci * y; });
+    });
+    unflatten_blocked_tensors(T, T1, T2);
+    return true;
+}
+
+void DIISStore::reset_subspace() {
+    wait_writes();
+    for (int i = 0; i < nvec_; ++i) {
+        std::remove(filename(i, true).c_str());
+        std::remove(filename(i, false).c_str());
+    }
+    nvec_ = 0;
+    std::fill(B_.begin(), B_.end(), 0.0);
+    std::fill(file_bytes_.begin(), file_bytes_.end(), 0);
+}
+
+size_t DIISStore::disk_usage() const {
+    return std::accumulate(file_bytes_.begin(), file_bytes_.end(), size_t(0));
+}
+
+std::string DIISStore::filename(int slot, bool error) const {
+    return file_prefix_ + ".diis." + std::to_string(slot) + (error ? ".err" : ".amp");
+}
+
+void DIISStore::write_async(int slot, bool error, std::vector<double>&& data) {
+    auto name = filename(slot, error);
+    auto write = [name, compress = compress_, data = std::move(data)]() {
+        std::vector<uint64_t> code;
+        const char* ptr = reinterpret_cast<const char*>(data.data());
+        uint64_t nwords = data.size();
+        if (compress) {
+            code = compress_zero_runs(data);
+            ptr = reinterpret_cast<const char*>(code.data());
+            nwords = code.size();
+        }
+        std::ofstream out(name, std::ios_base::binary | std::ios_base::trunc);
+        out.write(reinterpret_cast<const char*>(&nwords), sizeof(uint64_t));
+        out.write(ptr, nwords * sizeof(uint64_t));
+        if (not out.good()) {
+            throw psi::PSIEXCEPTION("DIISStore: error when writing " + name);
+        }
+        return (nwords + 1) * sizeof(uint64_t);
+    };
+    writes_.emplace_back(slot, std::async(std::launch::async, std::move(write)));
+}
+
+void DIISStore::wait_writes() {
+    // collect all the writes before reporting the first error
+    std::exception_ptr error = nullptr;
+    for (auto& [slot, future] : writes_) {
+        try {
+            file_bytes_[slot] += future.get();
+        } catch (...) {
+            if (not error)
+                error = std::current_exception();
+        }
+    }
+    writes_.clear();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+std::vector<double> DIISStore::read(int slot, bool error) const {
+    auto name = filename(slot, error);
+    std::ifstream in(name, std::ios_base::binary);
+    if (not in.good()) {
+        throw psi::PSIEXCEPTION("DIISStore: file " + name + " does not exist.");
+    }
+    uint64_t nwords = 0;
+    in.read(reinterpret_cast<char*>(&nwords), sizeof(uint64_t));
+
+    std::vector<double> data(size_);
+    if (compress_) {
+        std::vector<uint64_t> code(nwords);
+        in.read(reinterpret_cast<char*>(code.data()), nwords * sizeof(uint64_t));
+        decompress_zero_runs(code, data);
+    } else {
+        if (nwords != size_) {
+            throw psi::PSIEXCEPTION("DIISStore: inconsistent size of the vector in " + name);
+        }
+        in.read(reinterpret_cast<char*>(data.data()), nwords * sizeof(double));
+    }
+    if (not in.good()) {
+        throw psi::PSIEXCEPTION("DIISStore: error when reading " + name);
+    }
+    return data;
+}
+
+void DIISStore::stream(const std::vector<int>& slots, bool error,
+                       const std::function<void(int, const std::vector<double>&)>& f) const {
+    if (slots.empty())
+        return;
+    auto read_slot = [this, error](int slot) { return read(slot, error); };
+    auto next = std::async(std::launch::async, read_slot, slots[0]);
+    for (size_t k = 0, nslots = slots.size(); k < nslots; ++k) {
+        auto current = next.get();
+        if (k + 1 < nslots) {
+            next = std::async(std::launch::async, read_slot, slots[k + 1]);
+        }
+        f(slots[k], current);
+    }
+}
+
+std::vector<double> flatten_blocked_tensors(ambit::BlockedTensor& T1, ambit::BlockedTensor& T2) {
+    size_t size = 0;
+    for (auto* T : {&T1, &T2}) {
+        for (const auto& block : T->block_labels()) {
+            size += T->block(block).numel();
+        }
+    }
+    std::vector<double> out;
+    out.reserve(size);
+    for (auto* T : {&T1, &T2}) {
+        for (const auto& block : T->block_labels()) {
+            const auto& data = T->block(block).data();
+            out.insert(out.end(), data.begin(), data.end());
+        }
+    }
+    return out;
+}
+
+void unflatten_blocked_tensors(const std::vector<double>& data, ambit::BlockedTensor& T1,
+                               ambit::BlockedTensor& T2) {
+    size_t offset = 0;
+    for (auto* T : {&T1, &T2}) {
+        for (const auto& block : T->block_labels()) {
+            auto& block_data = T->block(block).data();
+            if (offset + block_data.size() > data.size()) {
+                throw psi::PSIEXCEPTION("The vector is too short to fill the blocked tensors.");
+            }
+            std::copy_n(data.begin() + offset, block_data.size(), block_data.begin());
+            offset += block_data.size();
+        }
+    }
+    if (offset != data.size()) {
+        throw psi::PSIEXCEPTION("The vector is too long to fill the blocked tensors.");
+    }
+}
+
+std::vector<uint64_t> compress_zero_runs(const std::vector<double>& data) {
+    const size_t n = data.size();
+    auto is_zero = [&](size_t i) { return std::bit_cast<uint64_t>(data[i]) == 0; };
+
+    std::vector<uint64_t> code;
+    size_t i = 0;
+    while (i < n) {
+        size_t z = i;
+        while (z < n and is_zero(z))
+            ++z;
+        // a literal run ends at two consecutive zeros, isolated zeros are stored as literals
+        size_t l = z;
+        while (l < n and not(is_zero(l) and (l + 1 == n or is_zero(l + 1))))
+            ++l;
+        code.push_back(z - i);
+        code.push_back(l - z);
+        for (size_t k = z; k < l; ++k) {
+            code.push_back(std::bit_cast<uint64_t>(data[k]));
+        }
+        i = l;
+    }
+    return code;
+}
+
+void decompress_zero_runs(const std::vector<uint64_t>& code, std::vector<double>& data) {
+    const size_t n = data.size(), ncode = code.size();
+    size_t i = 0, k = 0;
+    while (k + 1 < ncode) {
+        const uint64_t nzero = code[k], nliteral = code[k + 1];
+        k += 2;
+        if (i + nzero + nliteral > n or k + nliteral > ncode) {
+            throw psi::PSIEXCEPTION("Corrupted zero run-length encoded vector.");
+        }
+        std::fill_n(data.begin() + i, nzero, 0.0);
+        i += nzero;
+        for (uint64_t m = 0; m < nliteral; ++m) {
+            data[i++] = std::bit_cast<double>(code[k++]);
+        }
+    }
+    if (i != n or k != ncode) {
+        throw psi::PSIEXCEPTION("Corrupted zero run-length encoded vector.");
+    }
+}
+
+} // namespace forte
@@ -0,0 +1,124 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2024 by its authors (see COPYING, COPYING.LESSER,
+ * AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "ambit/blocked_tensor.h"
+
+namespace forte {
+
+/**
+ * @brief A DIIS subspace for BlockedTensor amplitudes that keeps only the B matrix in memory
+ *
+ * The amplitude and error vectors are flattened (in the order of the block labels) and written
+ * to scratch files in the background, optionally compressed with a lossless run-length encoding
+ * of the zero elements. New overlaps and the extrapolated amplitudes are computed by streaming
+ * the stored vectors one at a time, while the next one is read ahead.
+ *
+ * When the subspace is full, the vector with the largest error norm is replaced.
+ */
+class DIISStore {
+  public:
+    /// @brief Class constructor
+    /// @param file_prefix the prefix of the scratch files (including the path)
+    /// @param max_vec the maximum number of vectors in the subspace
+    /// @param compress compress the vectors written to disk
+    DIISStore(const std::string& file_prefix, int max_vec, bool compress = false);
+
+    /// Wait for the pending writes and delete the scratch files
+    ~DIISStore();
+
+    /// Return the number of vectors in the subspace
+    int subspace_size() const { return nvec_; }
+
+    /// @brief Add the amplitudes T1, T2 and the corresponding errors R1, R2 to the subspace
+    void add_entry(ambit::BlockedTensor& R1, ambit::BlockedTensor& R2, ambit::BlockedTensor& T1,
+                   ambit::BlockedTensor& T2);
+
+    /// @brief Overwrite T1 and T2 with the DIIS extrapolated amplitudes
+    /// @return false if the DIIS equations are singular (T1 and T2 are left untouched)
+    bool extrapolate(ambit::BlockedTensor& T1, ambit::BlockedTensor& T2);
+
+    /// Remove all vectors and delete the scratch files
+    void reset_subspace();
+
+    /// Return the number of bytes written to disk for the current subspace
+    size_t disk_usage() const;
+
+  private:
+    /// The prefix of the scratch files
+    std::string file_prefix_;
+    /// The maximum number of vectors
+    int max_vec_;
+    /// Compress the vectors written to disk
+    bool compress_;
+    /// The number of vectors in the subspace
+    int nvec_ = 0;
+    /// The number of elements of the amplitude (error) vectors
+    size_t size_ = 0;
+    /// The error overlap matrix B(i,j) = <R_i|R_j> (max_vec x max_vec)
+    std::vector<double> B_;
+    /// The number of bytes of the files of each slot
+    std::vector<size_t> file_bytes_;
+    /// The pending writes (slot, number of bytes written)
+    std::vector<std::pair<int, std::future<size_t>>> writes_;
+
+    /// Return the name of the file of the amplitudes (or errors) stored in a slot
+    std::string filename(int slot, bool error) const;
+    /// Start writing a vector to disk in the background
+    void write_async(int slot, bool error, std::vector<double>&& data);
+    /// Wait for all the pending writes to complete
+    void wait_writes();
+    /// Read a vector from disk
+    std::vector<double> read(int slot, bool error) const;
+    /// Read the vectors of slots one at a time (reading the next one ahead) and call f(slot, data)
+    void stream(const std::vector<int>& slots, bool error,
+                const std::function<void(int, const std::vector<double>&)>& f) const;
+};
+
+/// Copy the blocks of T1 and T2 to a vector in the order of their labels
+std::vector<double> flatten_blocked_tensors(ambit::BlockedTensor& T1, ambit::BlockedTensor& T2);
+
+/// Copy the data of a vector to the blocks of T1 and T2 in the order of their labels
+void unflatten_blocked_tensors(const std::vector<double>& data, ambit::BlockedTensor& T1,
+                               ambit::BlockedTensor& T2);
+
+/// Encode the runs of (bitwise) zero doubles of a vector as (n_zero, n_literal, literals...)
+std::vector<uint64_t> compress_zero_runs(const std::vector<double>& data);
+
+/// Decode a vector encoded by compress_zero_runs
+void decompress_zero_runs(const std::vector<uint64_t>& code, std::vector<double>& data);
+
+} // namespace forte
@@ -26,9 +26,13 @@
  * @END LICENSE
  */
 
+#include <bit>
+#include <cstdint>
 #include <numeric>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <sstream>
 #include <sys/stat.h>
 
 #include "psi4/psi4-dec.h"
@@ -266,4 +270,74 @@ void dump_occupations(const std::string& filename,
 //        perror(msg.c_str());
 //    }
 //}
+void read_npy_array(const std::string& filename, const std::vector<size_t>& shape, double* data) {
+    static_assert(std::endian::native == std::endian::little,
+                  "read_npy_array assumes a little-endian architecture");
+
+    std::ifstream in(filename.c_str(), std::ios_base::binary);
+    if (!in.good()) {
+        std::string error = "File " + filename + " does not exist.";
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+
+    // the file starts with the magic string "\x93NUMPY" followed by the version number
+    char magic[8];
+    in.read(magic, 8);
+    if (!in.good() or std::string(magic + 1, 5) != "NUMPY" or
+        static_cast<unsigned char>(magic[0]) != 0x93) {
+        std::string error = "File " + filename + " is not in the .npy format.";
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+
+    // the length of the header is stored as a 2-byte (version 1.0) or 4-byte (version >= 2.0)
+    // little-endian integer
+    const int major_version = magic[6];
+    uint32_t header_len = 0;
+    if (major_version == 1) {
+        uint16_t len;
+        in.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
+        header_len = len;
+    } else {
+        in.read(reinterpret_cast<char*>(&header_len), sizeof(uint32_t));
+    }
+    std::string header(header_len, ' ');
+    in.read(header.data(), header_len);
+
+    // the header is a Python dictionary literal, e.g.,
+    // {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+    if (header.find("'descr': '<f8'") == std::string::npos) {
+        std::string error = "File " + filename + " does not contain little-endian doubles.";
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+    if (header.find("'fortran_order': False") == std::string::npos) {
+        std::string error = "File " + filename + " is not stored in C order.";
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+    std::vector<size_t> file_shape;
+    const size_t shape_begin = header.find('(', header.find("'shape'"));
+    const size_t shape_end = header.find(')', shape_begin);
+    if (shape_begin == std::string::npos or shape_end == std::string::npos) {
+        std::string error = "Could not read the shape of the array in " + filename;
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+    std::stringstream ss(header.substr(shape_begin + 1, shape_end - shape_begin - 1));
+    for (std::string dim; std::getline(ss, dim, ',');) {
+        if (dim.find_first_of("0123456789") != std::string::npos) {
+            file_shape.push_back(std::stoul(dim));
+        }
+    }
+    if (file_shape != shape) {
+        std::string error = "The shape of the array in " + filename + " does not match.";
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+
+    // read the data in one block
+    const size_t n = std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<>());
+    in.read(reinterpret_cast<char*>(data), n * sizeof(double));
+    if (static_cast<size_t>(in.gcount()) != n * sizeof(double)) {
+        std::string error = "File " + filename + " is truncated.";
+        throw psi::PSIEXCEPTION(error.c_str());
+    }
+}
+
 } // namespace forte
@@ -82,6 +82,15 @@ void write_psi_matrix(const std::string& filename, const psi::Matrix& mat, bool
 /// @param mat The Psi4 Matrix to be filled
 void read_psi_matrix(const std::string& filename, psi::Matrix& mat);
 
+/// @brief Read a dense array stored in the NumPy .npy format
+///
+/// The array must contain little-endian doubles ('<f8') stored in C order. The header is checked
+/// against the expected shape and the data is then read in a single block into the buffer.
+/// @param filename The file name
+/// @param shape The expected shape of the array
+/// @param data A buffer that can hold the product of the dimensions in shape
+void read_npy_array(const std::string& filename, const std::vector<size_t>& shape, double* data);
+
 ///**
 // * @brief Save a BlockedTensor to file
 // * @param BT The BlockedTensor to be dumped to files
@@ -78,6 +78,8 @@ template <class Key, class Hash = std::hash<Key>> class HashVector {
     /*- Modifiers -*/
     void clear();
     size_t add(const Key& key);
+    // append keys that are distinct and not stored yet (not checked), hashing them in parallel
+    void append_unique(const std::vector<Key>& keys);
     void erase_by_key(const Key& key);
     void erase_by_index(size_t index);
     void erase_by_key(std::vector<Key> keys);
@@ -347,6 +349,26 @@ template <class Key, class Hash> size_t HashVector<Key, Hash>::add(const Key& ke
     return current_size - 1;
 }
 
+template <class Key, class Hash>
+void HashVector<Key, Hash>::append_unique(const std::vector<Key>& keys) {
+    const size_t nkeys = keys.size();
+    const size_t offset = current_size;
+    this->reserve(offset + nkeys);
+    this->vec.resize(offset + nkeys);
+    std::vector<size_t> bucket_index(nkeys);
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < nkeys; ++i) {
+        this->vec[offset + i] = {keys[i], npos};
+        bucket_index[i] = Hash()(keys[i]) % num_bucket;
+    }
+    // prepend each key to the chain of its bucket
+    for (size_t i = 0; i < nkeys; ++i) {
+        this->vec[offset + i].next = this->begin_index[bucket_index[i]];
+        this->begin_index[bucket_index[i]] = offset + i;
+    }
+    current_size += nkeys;
+}
+
 template <class Key, class Hash> void HashVector<Key, Hash>::erase_by_key(const Key& key) {
     size_t key_bucket_index, key_pre_index, key_index;
     std::tie(key_bucket_index, key_pre_index, key_index) = find_detail_by_key(key);
@@ -319,5 +319,10 @@ void CholeskyIntegrals::set_tei(size_t, size_t, size_t, size_t, double, bool, bo
     throw psi::PSIEXCEPTION("Don't use DF/CD if you use set_tei");
 }
 
+bool CholeskyIntegrals::rotate_tei(std::shared_ptr<psi::Matrix> U) {
+    rotate_three_index(ThreeIntegral_, U);
+    return true;
+}
+
 size_t CholeskyIntegrals::nthree() const { return nthree_; }
 } // namespace forte
@@ -98,6 +98,7 @@ class CholeskyIntegrals : public Psi4Integrals {
 
     void gather_integrals() override;
     void resort_integrals_after_freezing() override;
+    bool rotate_tei(std::shared_ptr<psi::Matrix> U) override;
 };
 
 } // namespace forte
@@ -294,6 +294,11 @@ void DFIntegrals::resort_integrals_after_freezing() {
     }
 }
 
+bool DFIntegrals::rotate_tei(std::shared_ptr<psi::Matrix> U) {
+    rotate_three_index(ThreeIntegral_, U);
+    return true;
+}
+
 size_t DFIntegrals::nthree() const { return nthree_; }
 
 } // namespace forte
@@ -33,6 +33,7 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libqt/qt.h"
 
 #include "helpers/blockedtensorfactory.h"
 #include "base_classes/forte_options.h"
@@ -497,6 +498,118 @@ void ForteIntegrals::rotate_orbitals(std::shared_ptr<psi::Matrix> Ua,
     update_orbitals(Ca_rotated, Cb_rotated, re_transform);
 }
 
+bool ForteIntegrals::rotate_integrals(std::shared_ptr<psi::Matrix> Ua,
+                                      std::shared_ptr<psi::Matrix> Ub) {
+    local_timer t;
+
+    // in-place rotation requires up-to-date restricted integrals
+    auto dU = Ua->clone();
+    dU->subtract(Ub);
+    bool in_place = ints_consistent_ and
+                    (spin_restriction_ == IntegralSpinRestriction::Restricted) and
+                    (dU->absmax() < 1.0e-12);
+
+    // the rotation in the full and correlated MO basis (Pitzer order)
+    std::vector<size_t> mo_to_cmo(nmo_, nmo_);
+    for (size_t p = 0; p < ncmo_; ++p) {
+        mo_to_cmo[cmotomo_[p]] = p;
+    }
+    auto U = std::make_shared<psi::Matrix>("U", nmo_, nmo_);
+    auto Uc = std::make_shared<psi::Matrix>("U correlated", ncmo_, ncmo_);
+    for (int h = 0, offset = 0; h < nirrep_; ++h) {
+        for (int p = 0; p < nmopi_[h]; ++p) {
+            for (int q = 0; q < nmopi_[h]; ++q) {
+                const double u = Ua->get(h, p, q);
+                U->set(p + offset, q + offset, u);
+                const size_t pc = mo_to_cmo[p + offset];
+                const size_t qc = mo_to_cmo[q + offset];
+                if ((pc < ncmo_) and (qc < ncmo_)) {
+                    Uc->set(pc, qc, u);
+                } else if (((pc < ncmo_) or (qc < ncmo_)) and (std::fabs(u) > 1.0e-12)) {
+                    // mixing frozen and correlated orbitals changes the frozen-core operator
+                    in_place = false;
+                }
+            }
+        }
+        offset += nmopi_[h];
+    }
+
+    if (not(in_place and rotate_tei(Uc))) {
+        rotate_orbitals(Ua, Ub);
+        return false;
+    }
+
+    // update the orbitals, the integrals are now consistent with them
+    update_orbitals(psi::linalg::doublet(Ca_, Ua), psi::linalg::doublet(Cb_, Ub), false);
+    ints_consistent_ = true;
+
+    // M <- U^T M U for a square matrix stored as a vector
+    auto rotate_matrix = [](std::vector<double>& M, std::shared_ptr<psi::Matrix> T) {
+        const size_t n = T->rowspi(0);
+        auto Mmat = std::make_shared<psi::Matrix>("M", n, n);
+        std::copy(M.begin(), M.end(), Mmat->pointer()[0]);
+        Mmat->transform(T);
+        std::copy(Mmat->pointer()[0], Mmat->pointer()[0] + n * n, M.begin());
+    };
+
+    // the frozen-core operator and energy are invariant since frozen orbitals are not mixed
+    rotate_matrix(full_one_electron_integrals_a_, U);
+    rotate_matrix(full_one_electron_integrals_b_, U);
+    rotate_matrix(one_electron_integrals_a_, Uc);
+    rotate_matrix(one_electron_integrals_b_, Uc);
+    if (OneBody_symm_) {
+        OneBody_symm_->transform(Ua);
+    }
+    if (fock_a_) {
+        fock_a_->transform(Ua);
+        if (fock_b_ and (fock_b_ != fock_a_)) {
+            fock_b_->transform(Ub);
+        }
+    }
+
+    if (print_) {
+        print_timing("rotating integrals in place", t.get());
+    }
+    return true;
+}
+
+bool ForteIntegrals::rotate_tei(std::shared_ptr<psi::Matrix>) { return false; }
+
+void ForteIntegrals::rotate_three_index(std::shared_ptr<psi::Matrix> B,
+                                        std::shared_ptr<psi::Matrix> U) {
+    const size_t n = U->rowspi(0);
+    const size_t nthree = B->colspi(0);
+    const size_t block_size = n * nthree;
+    double* Bp = B->pointer()[0];
+    double* Up = U->pointer()[0];
+
+    // the two indices are rotated one at a time on blocks of size n x nthree, so each thread
+    // only needs one block of scratch space
+#pragma omp parallel
+    {
+        std::vector<double> buffer(block_size);
+
+        // B_pq^Q <- sum_s B_ps^Q U_sq (the rows of a given p are contiguous)
+#pragma omp for schedule(static)
+        for (size_t p = 0; p < n; ++p) {
+            double* Bp_block = Bp + p * block_size;
+            std::copy(Bp_block, Bp_block + block_size, buffer.begin());
+            C_DGEMM('T', 'N', n, nthree, n, 1.0, Up, n, buffer.data(), nthree, 0.0, Bp_block,
+                    nthree);
+        }
+
+        // B_pq^Q <- sum_r U_rp B_rq^Q (the rows of a given q are strided by n * nthree)
+#pragma omp for schedule(static)
+        for (size_t q = 0; q < n; ++q) {
+            for (size_t r = 0; r < n; ++r) {
+                std::copy_n(Bp + (r * n + q) * nthree, nthree, buffer.begin() + r * nthree);
+            }
+            C_DGEMM('T', 'N', n, nthree, n, 1.0, Up, n, buffer.data(), nthree, 0.0,
+                    Bp + q * nthree, block_size);
+        }
+    }
+}
+
 // The following functions throw an error by default
 
 void ForteIntegrals::update_orbitals(std::shared_ptr<psi::Matrix>, std::shared_ptr<psi::Matrix>,
@@ -353,6 +353,15 @@ class ForteIntegrals {
     void rotate_orbitals(std::shared_ptr<psi::Matrix> Ua, std::shared_ptr<psi::Matrix> Ub,
                          bool re_transform = true);
 
+    /// Rotate the MO coefficients and apply the same rotation to the stored integrals (one-body
+    /// integrals, Fock matrices, and two-electron integrals) without re-transforming them.
+    /// This falls back to rotate_orbitals if the two-electron integrals cannot be rotated in
+    /// place, if Ua != Ub, or if the rotation mixes frozen and correlated orbitals.
+    /// @param Ua the alpha unitary transformation matrix
+    /// @param Ub the beta unitary transformation matrix
+    /// @return true if the integrals were rotated in place
+    bool rotate_integrals(std::shared_ptr<psi::Matrix> Ua, std::shared_ptr<psi::Matrix> Ub);
+
     /// Copy these MO coeffs to class variables, update psi::Wavefunction, and re-transform
     /// integrals
     /// @param Ca the alpha MO coefficients
@@ -578,6 +587,16 @@ class ForteIntegrals {
     /// Remove the doubly occupied and virtual orbitals and resort the rest so
     /// that we are left only with ncmo = nmo - nfzc - nfzv
     virtual void resort_integrals_after_freezing() = 0;
+
+    /// Rotate the two-electron integrals of the correlated orbitals in place
+    /// @param U the (ncmo x ncmo) unitary transformation of the correlated orbitals
+    /// @return false if this is not supported (the integrals are then left unchanged)
+    virtual bool rotate_tei(std::shared_ptr<psi::Matrix> U);
+
+    /// Rotate three-index integrals B[p * n + q][Q] in place, B_pq^Q <- sum_rs U_rp U_sq B_rs^Q
+    /// @param B the three-index integrals stored as a (n * n) x nthree matrix
+    /// @param U the (n x n) unitary transformation
+    static void rotate_three_index(std::shared_ptr<psi::Matrix> B, std::shared_ptr<psi::Matrix> U);
 };
 
 /**
@@ -26,7 +26,8 @@
  * @END LICENSE
  */
 
-#ifdef HAVE_GA
+#include <algorithm>
+#include <cstring>
 
 #include "psi4/psi4-dec.h"
 #include "psi4/psifiles.h"
@@ -38,7 +39,10 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/sieve.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
+#include "helpers/printing.h"
 #include "helpers/timer.h"
 
 #include "psi4/libfock/jk.h"
@@ -51,20 +55,56 @@
 #include <macdecls.h>
 #endif
 
+using namespace psi;
+
 namespace forte {
 
 ParallelDFMO::ParallelDFMO(std::shared_ptr<psi::BasisSet> primary,
                            std::shared_ptr<psi::BasisSet> auxiliary)
     : primary_(primary), auxiliary_(auxiliary) {
     memory_ = psi::Process::environment.get_memory();
+#ifdef HAVE_GA
+    distributed_ = true;
+    memory_ /= GA_Nnodes();
+#else
+    distributed_ = false;
+#endif
 }
+
+void ParallelDFMO::set_distributed(bool distributed) {
+#ifndef HAVE_GA
+    if (distributed)
+        throw psi::PSIEXCEPTION("ParallelDFMO: distributed mode requires Global Arrays");
+#endif
+    distributed_ = distributed;
+}
+
 void ParallelDFMO::compute_integrals() {
     local_timer compute_integrals_time;
     timer_on("DFMO: transform_integrals()");
     transform_integrals();
-    printf("\n P%d compute_integrals_time: %8.6f ", GA_Nodeid(), compute_integrals_time.get());
+    int my_rank = 0;
+#ifdef HAVE_GA
+    if (distributed_)
+        my_rank = GA_Nodeid();
+#endif
+    if (print_ >= PrintLevel::Debug) {
+        outfile->Printf("\n  P%d compute_integrals took %8.6f s.", my_rank,
+                        compute_integrals_time.get());
+    }
     timer_off("DFMO: transform_integrals()");
 }
+
+std::pair<int, int> ParallelDFMO::process_shells(int proc, int nproc) const {
+    /// Have first proc be from 0 to shell_per_process
+    /// Last proc is shell_per_process * my_rank to naux
+    int nshell = auxiliary_->nshell();
+    int shell_per_process = nshell / nproc;
+    int shell_start = shell_per_process * proc;
+    int shell_end = (proc != nproc - 1) ? shell_per_process * (proc + 1) : nshell;
+    return {shell_start, shell_end};
+}
+
 void ParallelDFMO::transform_integrals() {
     // > Sizing < //
 
@@ -72,6 +112,9 @@ void ParallelDFMO::transform_integrals() {
     int naux = auxiliary_->nbf();
     nmo_ = Ca_->colspi()[0];
 
+    size_t nso2 = nso * (size_t)nso;
+    size_t nmo2 = nmo_ * nmo_;
+
     // > Threading < //
 
     int nthread = 1;
@@ -79,108 +122,98 @@ void ParallelDFMO::transform_integrals() {
     nthread = omp_get_max_threads();
 #endif
 
-    // > Maximum orbital sizes < //
+    /// MPI Environment
+    int my_rank = 0;
+    int num_proc = 1;
+#ifdef HAVE_GA
+    if (distributed_) {
+        my_rank = GA_Nodeid();
+        num_proc = GA_Nnodes();
+    }
+#endif
+    auto [shell_start, shell_end] = process_shells(my_rank, num_proc);
 
-    size_t max1 = nmo_;
-    size_t max12 = max1 * max1;
+    // > Memory requirements (in doubles) < //
 
-    // > Row requirements < //
+    size_t max_doubles = memory_ / sizeof(double);
+    // (A|mi) buffer for each thread
+    size_t fixed = nthread * nso * nmo_;
+    // (Q|pq) kept by this process in threaded mode
+    if (not distributed_) {
+        fixed += naux * nmo2;
+    }
+    if (fixed >= max_doubles) {
+        throw psi::PSIEXCEPTION("Out of memory in ParallelDFMO.");
+    }
 
-    unsigned long int per_row = 0L;
-    // (Q|mn)
-    per_row += nso * (unsigned long int)nso;
-    // (Q|mi)
-    per_row += max1 * (unsigned long int)nso;
-    // (Q|ia)
-    per_row += max12;
+    // double-buffered (A|mn) and the (A|pq) buffer streamed to the GA
+    size_t per_row = 2 * nso2 + (distributed_ ? nmo2 : 0);
+    size_t max_rows = (max_doubles - fixed) / per_row;
+    if (max_rows < static_cast<size_t>(auxiliary_->max_function_per_shell())) {
+        throw psi::PSIEXCEPTION("Out of memory in ParallelDFMO.");
+    }
 
-    // > Maximum number of rows < //
+    // > Batches of auxiliary shells < //
 
-    unsigned long int max_rows = (memory_ / per_row);
-    // max_rows = 3L * auxiliary_->max_function_per_shell(); // Debug
-    if (max_rows < auxiliary_->max_function_per_shell()) {
-        throw psi::PSIEXCEPTION("Out of memory in DFERI.");
+    std::vector<std::pair<int, int>> batches;
+    for (int P = shell_start; P < shell_end;) {
+        int Pstop = P;
+        size_t rows = 0;
+        while (Pstop < shell_end and rows + auxiliary_->shell(Pstop).nfunction() <= max_rows) {
+            rows += auxiliary_->shell(Pstop).nfunction();
+            Pstop++;
+        }
+        batches.emplace_back(P, Pstop);
+        P = Pstop;
     }
-    max_rows = (max_rows > auxiliary_->nbf() ? auxiliary_->nbf() : max_rows);
-    int shell_per_process = 0;
-    int shell_start = -1;
-    int shell_end = -1;
-    /// MPI Environment
-    int my_rank = GA_Nodeid();
-    int num_proc = GA_Nnodes();
-
-    if (auxiliary_->nbf() == max_rows) {
-        shell_per_process = auxiliary_->nshell() / num_proc;
-    } else {
-        throw psi::PSIEXCEPTION("Have not implemented memory bound df integrals");
+    auto function_start = [&](int P) {
+        return P == auxiliary_->nshell() ? auxiliary_->nbf()
+                                         : auxiliary_->shell(P).function_index();
+    };
+    size_t max_batch_rows = 0;
+    for (const auto& [Pstart, Pstop] : batches) {
+        size_t rows = function_start(Pstop) - function_start(Pstart);
+        max_batch_rows = std::max(max_batch_rows, rows);
     }
-    /// Have first proc be from 0 to shell_per_process
-    /// Last proc is shell_per_process * my_rank to naux
-    if (my_rank != (num_proc - 1)) {
-        shell_start = shell_per_process * my_rank;
-        shell_end = shell_per_process * (my_rank + 1);
-    } else {
-        shell_start = shell_per_process * my_rank;
-        shell_end = (auxiliary_->nshell() % num_proc == 0 ? shell_per_process * (my_rank + 1)
-                                                          : auxiliary_->nshell());
+    if (print_ >= PrintLevel::Debug) {
+        outfile->Printf("\n  P%d auxiliary shells: %d - %d in %zu batches (max %zu functions)",
+                        my_rank, shell_start, shell_end, batches.size(), max_batch_rows);
     }
 
-    // printf("\n P%d shell_per_process: %d shell_start:%d  shell_end:%d",
-    // my_rank, shell_per_process, shell_start, shell_end);
-    // > Shell block assignments < //
-
-    // int fcount = auxiliary_->shell(0).nfunction();
-    // std::vector<int> shell_starts(auxiliary_->nshell() + 1, 0);
-    // shell_starts[0] = 0;
-    // for (int Q = 1; Q < auxiliary_->nshell(); Q++) {
-    //    if (fcount + auxiliary_->shell(Q).nfunction() > max_rows) {
-    //        shell_starts[Q] = Q;
-    //        fcount = auxiliary_->shell(Q).nfunction();
-    //    } else {
-    //        fcount += auxiliary_->shell(Q).nfunction();
-    //    }
-    //}
-    // shell_starts.push_back(auxiliary_->nshell());
-
-    int function_start = auxiliary_->shell(shell_start).function_index();
-    int function_end =
-        (shell_end == auxiliary_->nshell() ? auxiliary_->nbf()
-                                           : auxiliary_->shell(shell_end).function_index());
-    int dims[2];
-    int chunk[2];
-    dims[0] = naux;
-    dims[1] = nso * nso;
-    chunk[0] = GA_Nnodes();
-    chunk[1] = 1;
-    int map[GA_Nnodes() + 1];
-    for (int iproc = 0; iproc < GA_Nnodes(); iproc++) {
-        int shell_start = 0;
-        int shell_end = 0;
-        if (iproc != (num_proc - 1)) {
-            shell_start = shell_per_process * iproc;
-            shell_end = shell_per_process * (iproc + 1);
-        } else {
-            shell_start = shell_per_process * iproc;
-            shell_end = (auxiliary_->nshell() % num_proc == 0 ? shell_per_process * (iproc + 1)
-                                                              : auxiliary_->nshell());
+    // > Storage of the (A|pq) integrals < //
+
+#ifdef HAVE_GA
+    int Aia_ga = 0;
+    if (distributed_) {
+        int dims[2];
+        int chunk[2];
+        dims[0] = naux;
+        dims[1] = nmo2;
+        chunk[0] = num_proc;
+        chunk[1] = 1;
+        std::vector<int> map(num_proc + 1, 0);
+        for (int iproc = 0; iproc < num_proc; iproc++) {
+            auto [iproc_start, iproc_end] = process_shells(iproc, num_proc);
+            map[iproc] = function_start(iproc_start);
+            if (print_ >= PrintLevel::Debug) {
+                outfile->Printf("\n  P%d shell_start: %d shell_end: %d function_start: "
+                                "%d function_end: %d",
+                                iproc, iproc_start, iproc_end, function_start(iproc_start),
+                                function_start(iproc_end));
+            }
+        }
+        Aia_ga = NGA_Create_irreg(C_DBL, 2, dims, (char*)"Aia_temp", chunk, map.data());
+        if (not Aia_ga) {
+            throw psi::PSIEXCEPTION("GA failed on creating Aia_ga");
+        }
+        GA_Q_PQ_ = GA_Duplicate(Aia_ga, (char*)"(Q|pq)");
+        if (not GA_Q_PQ_) {
+            throw psi::PSIEXCEPTION("GA failed on creating GA_Q_PQ");
         }
-        int function_start = auxiliary_->shell(shell_start).function_index();
-        int function_end =
-            (shell_end == auxiliary_->nshell() ? auxiliary_->nbf()
-                                               : auxiliary_->shell(shell_end).function_index());
-        map[iproc] = function_start;
-        outfile->Printf("\n  P%d shell_start: %d shell_end: %d function_start: "
-                        "%d function_end: %d",
-                        iproc, shell_start, shell_end, function_start, function_end);
-    }
-    map[GA_Nnodes()] = 0;
-    int Aia_ga = NGA_Create_irreg(C_DBL, 2, dims, (char*)"Aia_temp", chunk, map);
-    if (not Aia_ga) {
-        throw psi::PSIEXCEPTION("GA failed on creating Aia_ga");
     }
-    GA_Q_PQ_ = GA_Duplicate(Aia_ga, (char*)"(Q|pq)");
-    if (not GA_Q_PQ_) {
-        throw psi::PSIEXCEPTION("GA failed on creating GA_Q_PQ");
+#endif
+    if (not distributed_) {
+        Q_PQ_local_ = std::make_shared<psi::Matrix>("(Q|pq)", naux, nmo2);
     }
 
     // => ERI Objects <= //
@@ -201,42 +234,20 @@ void ParallelDFMO::transform_integrals() {
     // => Temporary Tensors <= //
 
     // > Three-index buffers < //
-    auto Amn = std::make_shared<psi::Matrix>("(A|mn)", max_rows, nso * (unsigned long int)nso);
-    auto Ami = std::make_shared<psi::Matrix>("(A|mi)", max_rows, nso * (unsigned long int)max1);
-    auto Aia = std::make_shared<psi::Matrix>("(A|ia)", naux, max12);
-    double** Amnp = Amn->pointer();
-    double** Amip = Ami->pointer();
-    double** Aiap = Aia->pointer();
+    std::vector<std::vector<double>> Amn(2, std::vector<double>(max_batch_rows * nso2));
+    std::vector<std::vector<double>> Ami(nthread, std::vector<double>(nso * nmo_));
+    std::vector<double> Aia(distributed_ ? max_batch_rows * nmo2 : 0);
 
     // > C-matrix weirdness < //
 
     double** Cp = Ca_->pointer();
     int lda = nmo_;
 
-    //// ==> Master Loop <== //
-
-    int Aia_begin[2];
-    int Aia_end[2];
-    /// SIMD
-    /// shell_start represents the start of shells for this processor
-    /// shell_end represents the end of shells for this processor
-    /// NOTE:  This code will have terrible load balance (shells do not
-    /// correspond to equal number of functions
-    local_timer compute_Aia;
-    {
-        int Pstart = shell_start;
-        int Pstop = shell_end;
-        int nPshell = Pstop - Pstart;
-        int pstart = auxiliary_->shell(Pstart).function_index();
-        int pstop = (Pstop == auxiliary_->nshell() ? auxiliary_->nbf()
-                                                   : auxiliary_->shell(Pstop).function_index());
-        int rows = pstop - pstart;
-
-        // > (Q|mn) ERIs < //
-
-        ::memset((void*)Amnp[0], '\0', sizeof(double) * rows * nso * nso);
-
-#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    // (A|mn) integrals of the shells [Pstart, Pstop), called within a parallel region
+    auto compute_ao_batch = [&](int Pstart, int Pstop, double* Amnp) {
+        int pstart = function_start(Pstart);
+        long int nPshell = Pstop - Pstart;
+#pragma omp for schedule(dynamic) nowait
         for (long int PMN = 0L; PMN < nPshell * nshell_pairs; PMN++) {
 
             int thread = 0;
@@ -262,85 +273,134 @@ void ParallelDFMO::transform_integrals() {
             const double* buffer = eri[thread]->buffer();
 
             for (int p = 0; p < np; p++) {
+                double* Ap = Amnp + (p + op - pstart) * nso2;
                 for (int m = 0; m < nm; m++) {
                     for (int n = 0; n < nn; n++) {
-                        Amnp[p + op - pstart][(m + om) * nso + (n + on)] =
-                            Amnp[p + op - pstart][(n + on) * nso + (m + om)] = (*buffer++);
+                        Ap[(m + om) * nso + (n + on)] = Ap[(n + on) * nso + (m + om)] =
+                            (*buffer++);
                     }
                 }
             }
         }
+    };
 
-        // for (int ind1 = 0; ind1 < tasks.size(); ind1++) {
-
-        //    std::string space1 = pair_spaces_[tasks[ind1][0]].first;
-        //    int start1 = spaces_[space1].first;
-        //    int end1   = spaces_[space1].second;
-        //    int n1      = end1 - start1;
-        //    double* C1p = &Cp[0][start1];
-        int start1 = 0;
-        int end1 = nmo_;
-        int n1 = end1 - start1;
-        double* C1p = &Cp[0][start1];
-
-        C_DGEMM('N', 'N', rows * nso, n1, nso, 1.0, Amnp[0], nso, C1p, lda, 0.0, Amip[0], n1);
-
-        // for (int ind2 = 0; ind2 < tasks[ind1].size(); ind2++) {
-        // std::string space2 = pair_spaces_[tasks[ind1][ind2]].second;
-        // int start2 = spaces_[space2].first;
-        // int end2   = spaces_[space2].second;
-        // int n2      = end2 - start2;
-        // double* C2p = &Cp[0][start2];
-        int n2 = nmo_;
-        double* C2p = &Cp[0][0];
-
-        size_t n12 = n1 * (size_t)n2;
-        size_t no1 = nso * (size_t)n1;
-
-        // std::string name = tasks[ind1][ind2];
-        bool transpose12 = false;
-
-        if (transpose12) {
-#pragma omp parallel for num_threads(nthread)
-            for (int Q = 0; Q < rows; Q++) {
-                C_DGEMM('T', 'N', n2, n1, nso, 1.0, C2p, lda, Amip[0] + Q * no1, n1, 0.0,
-                        Aiap[0] + Q * n12, n1);
+    //// ==> Master Loop <== //
+
+    /// NOTE:  Shells do not correspond to equal number of functions, so the load balance
+    /// between processes is not perfect
+    local_timer compute_Aia;
+    if (not batches.empty()) {
+        size_t rows0 = function_start(batches[0].second) - function_start(batches[0].first);
+        std::memset(Amn[0].data(), 0, sizeof(double) * rows0 * nso2);
+#pragma omp parallel num_threads(nthread)
+        compute_ao_batch(batches[0].first, batches[0].second, Amn[0].data());
+    }
+
+    for (size_t b = 0, nbatch = batches.size(); b < nbatch; ++b) {
+        int pstart = function_start(batches[b].first);
+        int pstop = function_start(batches[b].second);
+        int rows = pstop - pstart;
+
+        double* Amnp = Amn[b % 2].data();
+        double* Aiap = distributed_ ? Aia.data() : Q_PQ_local_->pointer()[pstart];
+
+        bool has_next = b + 1 < nbatch;
+        if (has_next) {
+            size_t next_rows =
+                function_start(batches[b + 1].second) - function_start(batches[b + 1].first);
+            std::memset(Amn[(b + 1) % 2].data(), 0, sizeof(double) * next_rows * nso2);
+        }
+
+#pragma omp parallel num_threads(nthread)
+        {
+            // generate the (A|mn) integrals of the next batch, threads that are done move on to
+            // the transformation of the current batch
+            if (has_next) {
+                compute_ao_batch(batches[b + 1].first, batches[b + 1].second,
+                                 Amn[(b + 1) % 2].data());
             }
-        } else {
-#pragma omp parallel for num_threads(nthread)
+
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            double* Amip = Ami[thread].data();
+
+            // (A|mi) = sum_n (A|mn) C_ni, (A|pq) = sum_m C_mp (A|mq)
+#pragma omp for schedule(dynamic) nowait
             for (int Q = 0; Q < rows; Q++) {
-                C_DGEMM('T', 'N', n1, n2, nso, 1.0, Amip[0] + Q * no1, n1, C2p, lda, 0.0,
-                        Aiap[0] + Q * n12, n2);
+                C_DGEMM('N', 'N', nso, nmo_, nso, 1.0, Amnp + Q * nso2, nso, Cp[0], lda, 0.0,
+                        Amip, nmo_);
+                C_DGEMM('T', 'N', nmo_, nmo_, nso, 1.0, Cp[0], lda, Amip, nmo_, 0.0,
+                        Aiap + Q * nmo2, nmo_);
             }
         }
 
-        // Amn->print();
-        // Ami->print();
-        // Aia->print();
+        // stream the batch to the distributed tensor
+#ifdef HAVE_GA
+        if (distributed_) {
+            int Aia_begin[2] = {pstart, 0};
+            int Aia_end[2] = {pstop - 1, static_cast<int>(nmo2) - 1};
+            int ld = nmo2;
+            NGA_Put(Aia_ga, Aia_begin, Aia_end, Aiap, &ld);
+        }
+#endif
+    }
+    if (print_ >= PrintLevel::Debug) {
+        outfile->Printf("\n  P%d Aia took %8.6f s.", my_rank, compute_Aia.get());
+    }
 
-        // std::shared_ptr<Tensor> A = ints_[name + "_temp"];
-        // FILE* fh = A->file_pointer();
-        // fwrite(Aiap[0],sizeof(double),rows*n12,fh);
-        int ld = nmo_ * nmo_;
+    Amn.clear();
+    Ami.clear();
+    Aia.clear();
 
-        NGA_Distribution(Aia_ga, GA_Nodeid(), Aia_begin, Aia_end);
-        NGA_Put(Aia_ga, Aia_begin, Aia_end, Aiap[0], &(ld));
-        //}
-        //}
+    if (not distributed_) {
+        local_timer fit_time;
+        fit_local(max_doubles - fixed);
+        if (print_ >= PrintLevel::Debug) {
+            outfile->Printf("\n  P%d J^(-1/2) fitting took %8.6f s.", my_rank, fit_time.get());
+        }
+        return;
     }
-    printf("\n  P%d Aia took %8.6f s.", GA_Nodeid(), compute_Aia.get());
 
+#ifdef HAVE_GA
     local_timer J_one_half_time;
     J_one_half();
-    printf("\n  P%d J^({-1/2}} took %8.6f s.", GA_Nodeid(), J_one_half_time.get());
+    if (print_ >= PrintLevel::Debug) {
+        outfile->Printf("\n  P%d J^(-1/2) took %8.6f s.", my_rank, J_one_half_time.get());
+    }
 
     local_timer GA_DGEMM;
-    GA_Dgemm('T', 'N', naux, nmo_ * nmo_, naux, 1.0, GA_J_onehalf_, Aia_ga, 0.0, GA_Q_PQ_);
-    printf("\n  P%d DGEMM took %8.6f s.", GA_Nodeid(), GA_DGEMM.get());
+    GA_Dgemm('T', 'N', naux, nmo2, naux, 1.0, GA_J_onehalf_, Aia_ga, 0.0, GA_Q_PQ_);
+    if (print_ >= PrintLevel::Debug) {
+        outfile->Printf("\n  P%d DGEMM took %8.6f s.", my_rank, GA_DGEMM.get());
+    }
     GA_Destroy(GA_J_onehalf_);
     GA_Destroy(Aia_ga);
+#endif
 }
-void ParallelDFMO::J_one_half() {
+
+void ParallelDFMO::fit_local(size_t max_doubles) {
+    // (Q|pq) = sum_A (Q|A)^{-1/2} (A|pq), done in place over blocks of pq columns
+    int naux = auxiliary_->nbf();
+    size_t nmo2 = nmo_ * nmo_;
+    auto J = J_one_half_local();
+
+    size_t ncol = std::max(size_t(1), std::min(nmo2, max_doubles / naux));
+    std::vector<double> block(naux * ncol);
+    double** Qp = Q_PQ_local_->pointer();
+
+    for (size_t col = 0; col < nmo2; col += ncol) {
+        size_t n = std::min(ncol, nmo2 - col);
+        for (int A = 0; A < naux; ++A) {
+            std::copy_n(Qp[A] + col, n, block.data() + A * n);
+        }
+        C_DGEMM('N', 'N', naux, n, naux, 1.0, J->pointer()[0], naux, block.data(), n, 0.0,
+                Qp[0] + col, nmo2);
+    }
+}
+
+std::shared_ptr<psi::Matrix> ParallelDFMO::J_one_half_local() {
     // Everybody likes them some inverse square root metric, eh?
 
     int nthread = 1;
@@ -353,78 +413,82 @@ void ParallelDFMO::J_one_half() {
     auto J = std::make_shared<psi::Matrix>("J", naux, naux);
     double** Jp = J->pointer();
 
-    int dims[2];
-    int chunk[2];
-    dims[0] = naux;
-    dims[1] = naux;
-    chunk[0] = -1;
-    chunk[1] = naux;
-    GA_J_onehalf_ = NGA_Create(C_DBL, 2, dims, (char*)"J_1/2", chunk);
-    if (not GA_J_onehalf_)
-        throw psi::PSIEXCEPTION("Failure in creating J_^(-1/2) in GA");
+    std::shared_ptr<IntegralFactory> Jfactory(
+        new IntegralFactory(auxiliary_, psi::BasisSet::zero_ao_basis_set(), auxiliary_,
+                            psi::BasisSet::zero_ao_basis_set()));
+    std::vector<std::shared_ptr<TwoBodyAOInt>> Jeri;
+    for (int thread = 0; thread < nthread; thread++) {
+        Jeri.push_back(std::shared_ptr<TwoBodyAOInt>(Jfactory->eri()));
+    }
 
-    // if(GA_Nodeid() == 0)
-    {
-        std::shared_ptr<IntegralFactory> Jfactory(
-            new IntegralFactory(auxiliary_, psi::BasisSet::zero_ao_basis_set(), auxiliary_,
-                                psi::BasisSet::zero_ao_basis_set()));
-        std::vector<std::shared_ptr<TwoBodyAOInt>> Jeri;
-        for (int thread = 0; thread < nthread; thread++) {
-            Jeri.push_back(std::shared_ptr<TwoBodyAOInt>(Jfactory->eri()));
+    std::vector<std::pair<int, int>> Jpairs;
+    for (int M = 0; M < auxiliary_->nshell(); M++) {
+        for (int N = 0; N <= M; N++) {
+            Jpairs.push_back(std::pair<int, int>(M, N));
         }
-
-        std::vector<std::pair<int, int>> Jpairs;
-        for (int M = 0; M < auxiliary_->nshell(); M++) {
-            for (int N = 0; N <= M; N++) {
-                Jpairs.push_back(std::pair<int, int>(M, N));
-            }
-        }
-        long int num_Jpairs = Jpairs.size();
+    }
+    long int num_Jpairs = Jpairs.size();
 
 #pragma omp parallel for schedule(dynamic) num_threads(nthread)
-        for (long int PQ = 0L; PQ < num_Jpairs; PQ++) {
+    for (long int PQ = 0L; PQ < num_Jpairs; PQ++) {
 
-            int thread = 0;
+        int thread = 0;
 #ifdef _OPENMP
-            thread = omp_get_thread_num();
+        thread = omp_get_thread_num();
 #endif
 
-            std::pair<int, int> pair = Jpairs[PQ];
-            int P = pair.first;
-            int Q = pair.second;
+        std::pair<int, int> pair = Jpairs[PQ];
+        int P = pair.first;
+        int Q = pair.second;
 
-            Jeri[thread]->compute_shell(P, 0, Q, 0);
+        Jeri[thread]->compute_shell(P, 0, Q, 0);
 
-            int np = auxiliary_->shell(P).nfunction();
-            int op = auxiliary_->shell(P).function_index();
-            int nq = auxiliary_->shell(Q).nfunction();
-            int oq = auxiliary_->shell(Q).function_index();
+        int np = auxiliary_->shell(P).nfunction();
+        int op = auxiliary_->shell(P).function_index();
+        int nq = auxiliary_->shell(Q).nfunction();
+        int oq = auxiliary_->shell(Q).function_index();
 
-            const double* buffer = Jeri[thread]->buffer();
+        const double* buffer = Jeri[thread]->buffer();
 
-            for (int p = 0; p < np; p++) {
-                for (int q = 0; q < nq; q++) {
-                    Jp[p + op][q + oq] = Jp[q + oq][p + op] = (*buffer++);
-                }
-            }
-        }
-        Jfactory.reset();
-        Jeri.clear();
-
-        // > Invert J < //
-
-        J->power(-1.0 / 2.0, 1e-10);
-        if (GA_Nodeid() == 0) {
-            for (int me = 0; me < GA_Nnodes(); me++) {
-                int begin_offset[2];
-                int end_offset[2];
-                NGA_Distribution(GA_J_onehalf_, me, begin_offset, end_offset);
-                int offset = begin_offset[0];
-                NGA_Put(GA_J_onehalf_, begin_offset, end_offset, J->pointer()[offset], &naux);
+        for (int p = 0; p < np; p++) {
+            for (int q = 0; q < nq; q++) {
+                Jp[p + op][q + oq] = Jp[q + oq][p + op] = (*buffer++);
             }
         }
     }
+    Jfactory.reset();
+    Jeri.clear();
+
+    // > Invert J < //
+
+    J->power(-1.0 / 2.0, 1e-10);
+    return J;
 }
-} // namespace forte
 
+void ParallelDFMO::J_one_half() {
+#ifdef HAVE_GA
+    int naux = auxiliary_->nbf();
+
+    int dims[2];
+    int chunk[2];
+    dims[0] = naux;
+    dims[1] = naux;
+    chunk[0] = -1;
+    chunk[1] = naux;
+    GA_J_onehalf_ = NGA_Create(C_DBL, 2, dims, (char*)"J_1/2", chunk);
+    if (not GA_J_onehalf_)
+        throw psi::PSIEXCEPTION("Failure in creating J_^(-1/2) in GA");
+
+    auto J = J_one_half_local();
+    if (GA_Nodeid() == 0) {
+        for (int me = 0; me < GA_Nnodes(); me++) {
+            int begin_offset[2];
+            int end_offset[2];
+            NGA_Distribution(GA_J_onehalf_, me, begin_offset, end_offset);
+            int offset = begin_offset[0];
+            NGA_Put(GA_J_onehalf_, begin_offset, end_offset, J->pointer()[offset], &naux);
+        }
+    }
 #endif
+}
+} // namespace forte
@@ -28,35 +28,74 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "psi4/libmints/basisset.h"
 #include "psi4/psi4-dec.h"
 
+#include "helpers/printing.h"
+
+namespace psi {
+class Matrix;
+}
+
 namespace forte {
 
+/**
+ * @brief Compute the fitted MO three-index integrals (Q|pq) = sum_A (Q|A)^{-1/2} (A|pq)
+ *
+ * The auxiliary shells assigned to a process are split into batches that fit in memory.
+ * The AO integrals (A|mn) of the next batch are generated while the current batch is
+ * transformed to the MO basis (double buffering), and each transformed batch is streamed into
+ * the final storage:
+ *   - distributed mode: a Global Array (requires GA), rows distributed over the processes
+ *   - threaded mode: a psi::Matrix held by this process, all batches computed with OpenMP
+ */
 class ParallelDFMO {
   public:
     ParallelDFMO(std::shared_ptr<psi::BasisSet> primary, std::shared_ptr<psi::BasisSet> auxiliary);
     void set_C(std::shared_ptr<psi::Matrix> C) { Ca_ = C; }
+    /// Store the integrals in a Global Array (true) or in this process (false)
+    void set_distributed(bool distributed);
+    /// Set the memory (in bytes) available to this process
+    void set_memory(size_t memory) { memory_ = memory; }
+    /// Set the print level (timings and batching are printed at the debug level)
+    void set_print(PrintLevel level) { print_ = level; }
     void compute_integrals();
+    /// The GA handle of the (Q|pq) integrals (distributed mode)
     int Q_PQ() { return GA_Q_PQ_; }
+    /// The (Q|pq) integrals stored as a naux x (nmo * nmo) matrix (threaded mode)
+    std::shared_ptr<psi::Matrix> Q_PQ_local() { return Q_PQ_local_; }
 
   protected:
     std::shared_ptr<psi::Matrix> Ca_;
-    /// (A | Q)^{-1/2}
+    /// (A | Q)^{-1/2} distributed over the processes
     void J_one_half();
-    /// Compute (A|mn) integrals (distribute via mn indices)
+    /// (A | Q)^{-1/2} computed in this process
+    std::shared_ptr<psi::Matrix> J_one_half_local();
+    /// Compute (A|mn) integrals in batches of auxiliary shells and transform them to (A|pq)
     void transform_integrals();
-    /// (A | pq) (A | Q)^{-1/2}
+    /// Return the range of auxiliary shells [start, end) assigned to a process
+    std::pair<int, int> process_shells(int proc, int nproc) const;
+    /// Fit the (A|pq) integrals held by this process with (A | Q)^{-1/2}, in place
+    void fit_local(size_t max_doubles);
 
     std::shared_ptr<psi::BasisSet> primary_;
     std::shared_ptr<psi::BasisSet> auxiliary_;
 
+    /// Use Global Arrays to store the integrals
+    bool distributed_;
+
     /// Distributed DF (Q | pq) integrals
-    int GA_Q_PQ_;
+    int GA_Q_PQ_ = 0;
     /// GA for J^{-1/2}
-    int GA_J_onehalf_;
+    int GA_J_onehalf_ = 0;
+    /// DF (Q | pq) integrals held by this process
+    std::shared_ptr<psi::Matrix> Q_PQ_local_;
 
     size_t memory_;
     size_t nmo_;
+    PrintLevel print_ = PrintLevel::Default;
 };
 } // namespace forte
@@ -66,6 +66,16 @@ class MolecularModel(Model):
         self._corr_aux_basis = corr_aux_basis
         self.symmetry = Symmetry(molecule.molecule.point_group().symbol().capitalize())
 
+    def __getstate__(self):
+        # Symmetry cannot be pickled, it is rebuilt from the molecule
+        state = self.__dict__.copy()
+        del state['symmetry']
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self.symmetry = Symmetry(self._molecule.molecule.point_group().symbol().capitalize())
+
     def __repr__(self):
         """
         return a string representation of this object
@@ -35,7 +35,9 @@ class ActiveSpaceSolver(Module):
         )
 
         if self.solver_type == "EXTERNAL":
-            write_external_active_space_file(data.as_ints, state_map, data.mo_space_info, "as_ints.json")
+            write_external_active_space_file(
+                data.as_ints, state_map, data.mo_space_info, "as_ints.json", data.options.get_str("EXTERNAL_FORMAT")
+            )
             msg = "External solver: save active space integrals to as_ints.json"
             print(msg)
             print_out(msg)
@@ -5,7 +5,8 @@ from psi4 import geometry
 
 from .module import Module
 from forte.data import ForteData
-from forte.core import clean_options
+from forte.core import clean_options, flog
+from forte.cache import Cache, make_cache
 from forte._forte import SCFInfo
 
 
@@ -22,6 +23,7 @@ class HF(Module):
     docc: List[int] = None
     socc: List[int] = None
     output_file: str = "output.dat"
+    cache: object = None
 
     def __post_init__(self):
         """
@@ -29,8 +31,30 @@ class HF(Module):
         ----------
         solver_type: str
             The type of the active space solver.
+        cache: None, bool, str, or Cache
+            The cache used to store the HF wave function (see ``forte.cache.make_cache``)
         """
         super().__init__()
+        self.cache = make_cache(self.cache)
+
+    def _cache_key(self, molecule, state, options) -> str:
+        """
+        Return a key that identifies the HF computation on this molecule and state.
+
+        The key includes every option passed to psi4 (basis, reference, SCF_TYPE, convergence,
+        occupations,...), the geometry, charge, and multiplicity, and the psi4 version.
+        """
+        import psi4
+
+        return Cache.key(
+            "HF",
+            psi4.__version__,
+            molecule.save_string_xyz(),
+            molecule.molecular_charge(),
+            molecule.multiplicity(),
+            [state.na(), state.nb(), state.multiplicity(), state.twice_ms(), state.irrep()],
+            options,
+        )
 
     def _run(self, data: ForteData) -> ForteData:
         """Run a Hartree-Fock computation"""
@@ -97,10 +121,23 @@ class HF(Module):
         # # pre hf callback
         # self._cbh.call("pre hf", self)
 
-        # run scf and return the energy and a wavefunction object
-        # flog("info", "HF: calling psi4.energy().")
-        energy, psi_wfn = psi4.energy("scf", molecule=molecule, return_wfn=True)
-        # flog("info", "HF: psi4.energy() done")
+        # look for the wave function in the cache
+        payload = None
+        if self.cache is not None:
+            key = self._cache_key(molecule, state, full_options)
+            payload = self.cache.load(key)
+
+        if payload is not None:
+            flog("info", "HF: wave function read from the cache")
+            energy = payload["energy"]
+            psi_wfn = psi4.core.Wavefunction.from_file(payload["wfn"])
+        else:
+            # run scf and return the energy and a wavefunction object
+            # flog("info", "HF: calling psi4.energy().")
+            energy, psi_wfn = psi4.energy("scf", molecule=molecule, return_wfn=True)
+            # flog("info", "HF: psi4.energy() done")
+            if self.cache is not None:
+                self.cache.store(key, {"energy": energy, "wfn": psi_wfn.to_file()})
 
         # check symmetry
         # flog("info", "HF: checking symmetry of the HF solution")
@@ -1,4 +1,5 @@
 from pathlib import Path
+import psi4
 from psi4 import geometry
 
 
@@ -22,6 +23,14 @@ class Molecule:
         """
         self._molecule = molecule
 
+    def __getstate__(self):
+        # psi4.core.Molecule is pickled via its dictionary representation
+        return {'molecule': None if self._molecule is None else self._molecule.to_dict()}
+
+    def __setstate__(self, state):
+        molecule = state['molecule']
+        self._molecule = None if molecule is None else psi4.core.Molecule.from_dict(molecule)
+
     def __repr__(self):
         """
         return a string representation of this object
@@ -129,7 +129,7 @@ double SA_MRDSRG::compute_energy_ldsrg2() {
             outfile->Printf("  S");
 
             if ((cycle - diis_start_) % diis_freq_ == 0 and
-                diis_manager_->subspace_size() >= diis_min_vec_) {
+                diis_manager_subspace_size() >= diis_min_vec_) {
                 diis_manager_extrapolate();
                 outfile->Printf("/E");
             }
@@ -199,7 +199,7 @@ void SA_MRDSRG::compute_hbar() {
         Hbar2_["pqrs"] = B_["gpr"] * B_["gqs"];
     } else {
         Hbar2_["pqrs"] = V_["pqrs"];
-        O2_["pqrs"] = Hbar2_["pqrs"];
+        O2_["pqrs"] = V_["pqrs"];
     }
 
     // temporary Hamiltonian used in every iteration
@@ -358,13 +358,14 @@ void SA_MRDSRG::compute_hbar_sequential() {
         Hbar1_["pq"] -= 0.5 * B["gpm"] * B["gnq"] * D1c["mn"];
         Hbar1_["pq"] -= 0.5 * B["gpu"] * B["gvq"] * L1_["uv"];
     } else {
-        Hbar2_["pqrs"] = U1["pt"] * U1["qo"] * V_["t,o,g0,g1"] * U1["r,g0"] * U1["s,g1"];
+        // O2 holds the rotated integrals since Hbar2 may only store the blocks of the residual
+        O2_["pqrs"] = U1["pt"] * U1["qo"] * V_["t,o,g0,g1"] * U1["r,g0"] * U1["s,g1"];
 
-        Hbar1_["pq"] += Hbar2_["pnqm"] * D1c["mn"];
-        Hbar1_["pq"] -= 0.5 * Hbar2_["npqm"] * D1c["mn"];
+        Hbar1_["pq"] += O2_["pnqm"] * D1c["mn"];
+        Hbar1_["pq"] -= 0.5 * O2_["npqm"] * D1c["mn"];
 
-        Hbar1_["pq"] += Hbar2_["pvqu"] * L1_["uv"];
-        Hbar1_["pq"] -= 0.5 * Hbar2_["vpqu"] * L1_["uv"];
+        Hbar1_["pq"] += O2_["pvqu"] * L1_["uv"];
+        Hbar1_["pq"] -= 0.5 * O2_["vpqu"] * L1_["uv"];
     }
 
     // compute fully contracted term from T1
@@ -377,7 +378,7 @@ void SA_MRDSRG::compute_hbar_sequential() {
     if (eri_df_) {
         Hbar0_ += 0.5 * B["gux"] * B["gvy"] * L2_["xyuv"];
     } else {
-        Hbar0_ += 0.5 * Hbar2_["uvxy"] * L2_["xyuv"];
+        Hbar0_ += 0.5 * O2_["uvxy"] * L2_["xyuv"];
     }
 
     Hbar0_ += Efrzc_ + Enuc_ - Eref_;
@@ -396,7 +397,7 @@ void SA_MRDSRG::compute_hbar_sequential() {
     if (eri_df_) {
         Hbar2_["pqrs"] = B["gpr"] * B["gqs"];
     } else {
-        O2_["pqrs"] = Hbar2_["pqrs"];
+        Hbar2_["pqrs"] = O2_["pqrs"];
     }
 
     // iteration variables
@@ -577,17 +578,17 @@ void SA_MRDSRG::setup_ldsrg2_tensors() {
         Hbar1_ = BTF_->build(tensor_type_, "Hbar1", {"hp"});
         Hbar2_ = BTF_->build(tensor_type_, "Hbar2", {"hhpp"});
     } else {
-        if (nivo_) {
-            // Generate blocks for Hbar2_, O2_ and C2_
-            std::vector<std::string> blocks_exclude_V3 = nivo_labels();
-            Hbar2_ = BTF_->build(tensor_type_, "Hbar2", blocks_exclude_V3);
-            O2_ = BTF_->build(tensor_type_, "O2", blocks_exclude_V3);
-            C2_ = BTF_->build(tensor_type_, "C2", blocks_exclude_V3);
+        // Generate blocks for Hbar2_, O2_ and C2_
+        std::vector<std::string> blocks2 = nivo_ ? nivo_labels() : std::vector<std::string>{"gggg"};
+
+        // only the hhpp blocks of Hbar2 enter the residual, the energy, and the active Hbar
+        if (batched_comm_) {
+            Hbar2_ = BTF_->build(tensor_type_, "Hbar2", {"hhpp"});
         } else {
-            Hbar2_ = BTF_->build(tensor_type_, "Hbar2", {"gggg"});
-            O2_ = BTF_->build(tensor_type_, "O2", {"gggg"});
-            C2_ = BTF_->build(tensor_type_, "C2", {"gggg"});
+            Hbar2_ = BTF_->build(tensor_type_, "Hbar2", blocks2);
         }
+        O2_ = BTF_->build(tensor_type_, "O2", blocks2);
+        C2_ = BTF_->build(tensor_type_, "C2", blocks2);
 
         Hbar1_ = BTF_->build(tensor_type_, "Hbar1", {"gg"});
         O1_ = BTF_->build(tensor_type_, "O1", {"gg"});
@@ -67,6 +67,8 @@ void SA_MRDSRG::read_options() {
 
     sequential_Hbar_ = foptions_->get_bool("DSRG_HBAR_SEQ");
     nivo_ = foptions_->get_bool("DSRG_NIVO");
+    batched_comm_ = foptions_->get_bool("DSRG_LDSRG2_BATCHED");
+    batch_nvirt_ = foptions_->get_int("DSRG_LDSRG2_BATCH_NVIRT");
 
     rsc_ncomm_ = foptions_->get_int("DSRG_RSC_NCOMM");
     rsc_conv_ = foptions_->get_double("DSRG_RSC_THRESHOLD");
@@ -116,6 +118,7 @@ void SA_MRDSRG::print_options() {
                           {"DIIS start", diis_start_},
                           {"Min DIIS vectors", diis_min_vec_},
                           {"Max DIIS vectors", diis_max_vec_},
+                          {"Max virtuals per commutator batch", batch_nvirt_},
                           {"DIIS extrapolating freq", diis_freq_},
                           {"Number of amplitudes for printing", ntamp_}});
     printer.add_double_data({{"Flow parameter", s_},
@@ -127,6 +130,7 @@ void SA_MRDSRG::print_options() {
     printer.add_bool_data({{"Restart amplitudes", restart_amps_},
                            {"Sequential DSRG transformation", sequential_Hbar_},
                            {"Omit blocks of >= 3 virtual indices", nivo_},
+                           {"Batched Hbar and commutators", batched_comm_},
                            {"Read amplitudes from current dir", read_amps_cwd_},
                            {"Write amplitudes to current dir", dump_amps_cwd_}});
 
@@ -134,6 +138,7 @@ void SA_MRDSRG::print_options() {
         {"Correlation level", corrlv_string_},
         {"Integral type", ints_type_},
         {"Source operator", source_},
+        {"DIIS storage", diis_storage_},
         {"Reference relaxation", relax_ref_},
         {"3RDM algorithm", L3_algorithm_},
         {"Core-Virtual source type", ccvv_source_},
@@ -165,10 +170,14 @@ void SA_MRDSRG::check_memory() {
         dsrg_mem_.add_entry("1- and 2-body intermediates", {"gg", "gggg", "hhpp"});
     } else {
         dsrg_mem_.add_entry("1-body Hbar and intermediates", {"gg"}, 3);
+        int n_gggg = batched_comm_ ? 2 : 3;
+        if (batched_comm_) {
+            dsrg_mem_.add_entry("2-body Hbar (hhpp blocks)", {"hhpp"});
+        }
         if (nivo_) {
-            dsrg_mem_.add_entry("2-body Hbar and intermediates", nivo_labels(), 3);
+            dsrg_mem_.add_entry("2-body Hbar and intermediates", nivo_labels(), n_gggg);
         } else {
-            dsrg_mem_.add_entry("2-body Hbar and intermediates", {"gggg"}, 3);
+            dsrg_mem_.add_entry("2-body Hbar and intermediates", {"gggg"}, n_gggg);
         }
 
         if (sequential_Hbar_) {
@@ -181,7 +190,13 @@ void SA_MRDSRG::check_memory() {
     // intermediates used in actual commutator computation
     size_t mem_comm = dsrg_mem_.compute_memory({"hhpp", "ahpp", "hhhp"}) * 2;
     if ((!eri_df_) and (!nivo_)) {
-        mem_comm = std::max(mem_comm, dsrg_mem_.compute_memory({"ppph"}));
+        // the blocks of [H2, T2] -> C2 with three virtual indices are tiled if they do not fit
+        auto mem_ppph = dsrg_mem_.compute_memory({"ppph"});
+        if (batched_comm_ and (static_cast<int64_t>(mem_ppph) >
+                               static_cast<int64_t>(dsrg_mem_.available()))) {
+            mem_ppph -= dsrg_mem_.compute_memory({"vvvh"});
+        }
+        mem_comm = std::max(mem_comm, mem_ppph);
     }
     dsrg_mem_.add_entry("Local intermediates for commutators", mem_comm, false);
 
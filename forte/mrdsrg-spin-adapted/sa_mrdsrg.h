@@ -37,6 +37,8 @@ using namespace ambit;
 
 namespace forte {
 
+class DIISStore;
+
 class SA_MRDSRG : public SADSRG {
   public:
     /**
@@ -178,12 +180,16 @@ class SA_MRDSRG : public SADSRG {
 
     /// Shared pointer of DIISManager object from Psi4
     std::shared_ptr<psi::DIISManager> diis_manager_;
+    /// Shared pointer of the Forte DIIS store that keeps the vectors on disk
+    std::shared_ptr<DIISStore> diis_store_;
     /// Initialize DIISManager
     void diis_manager_init();
     /// Add entry for DIISManager
     void diis_manager_add_entry();
     /// Extrapolate for DIISManager
     void diis_manager_extrapolate();
+    /// Number of vectors in the DIIS subspace
+    int diis_manager_subspace_size();
     /// Clean up for pointers used for DIIS
     void diis_manager_cleanup();
 
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "ambit/blocked_tensor.h"
 
 #include "base_classes/active_space_solver.h"
@@ -149,6 +151,11 @@ class SADSRG : public DynamicCorrelationSolver {
     size_t mem_sys_;
     /// Memory checker and printer
     DSRG_MEM dsrg_mem_;
+    /// Tile the [H2, T2] -> C2 blocks with three virtual indices if they do not fit in memory
+    bool batched_comm_ = false;
+    /// Max number of virtual orbitals per batch of the tiled [H2, T2] -> C2 terms
+    /// (0: determined from the available memory, > 0: always tile)
+    int batch_nvirt_ = 0;
 
     /// Check initial memory
     void check_init_memory();
@@ -395,6 +402,21 @@ class SADSRG : public DynamicCorrelationSolver {
     /// Compute two-body term of commutator [H2, T2], S2[ijab] = 2 * T[ijab] - T[ijba]
     void H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, const double& alpha,
                   BlockedTensor& C2);
+    /// Compute the hole-particle terms of H2_T2_C2 with three virtual indices in batches
+    void H2_T2_C2_PH_batched(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2,
+                             const double& alpha, BlockedTensor& C2);
+    /// Form the hhpv intermediate of the batched hole-particle terms
+    /// X["ijav"] = A["ijav"] (i = core) + 0.5 * L1["iy"] * A["yjav"] (i = active)
+    ///             - 0.5 * L1["xa"] * A["ijxv"] (a = active), A["ijav"] = T["ijav"] or T["ijva"]
+    void PH_batched_intermediate(BlockedTensor& T, bool transpose, BlockedTensor& X);
+    /// Add R["ejfb"] = alpha * H2["aeif"] * X["ijab"] (or H2["aefi"] if exchange) to C2["ejfb"]
+    /// and C2["jebf"] (or C2["jefb"] and C2["ejbf"] if swap) for batches of the virtual index e.
+    /// H2_slice(block, e0, e1) returns the block of H2 with the second index in [e0, e1).
+    void H2_X_C2_tiled(
+        const std::function<ambit::Tensor(const std::string&, size_t, size_t)>& H2_slice,
+        bool exchange, BlockedTensor& X, const double& alpha, bool swap, BlockedTensor& C2);
+    /// Return the number of virtual orbitals per batch of H2_X_C2_tiled
+    size_t tiled_batch_nvirt();
 
     /// Compute zero-body term of commutator [V, T1], V is constructed from B (DF/CD)
     void V_T1_C0_DF(BlockedTensor& B, BlockedTensor& T1, const double& alpha, double& C0);
@@ -416,6 +438,9 @@ class SADSRG : public DynamicCorrelationSolver {
     /// Compute two-body term of commutator [V, T2], exchange of particle-hole contraction
     void V_T2_C2_DF_PH_X(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
                          BlockedTensor& C2);
+    /// Compute the blocks of V_T2_C2_DF_PH_X with three virtual indices in batches
+    void V_T2_C2_DF_PH_X_batched(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
+                                 BlockedTensor& C2);
 
     /// Compute the active part of commutator C1 + C2 = alpha * [H1 + H2, A1 + A2]
     void H_A_Ca(BlockedTensor& H1, BlockedTensor& H2, BlockedTensor& T1, BlockedTensor& T2,
@@ -457,14 +457,26 @@ void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, c
     C2["qpba"] -= 0.5 * alpha * Eta1_["xy"] * T2["yjab"] * H2["pqxj"];
 
     // hole-particle contractions
-    std::vector<std::string> blocks;
+    std::vector<std::string> blocks, blocks_large;
     for (const std::string& block : C2.block_labels()) {
         if (block.substr(1, 1) == virt_label_ or block.substr(3, 1) == core_label_)
             continue;
+        else if (batched_comm_ and std::count(block.begin(), block.end(), virt_label_[0]) > 2)
+            blocks_large.push_back(block);
         else
             blocks.push_back(block);
     }
 
+    // tile the blocks with three virtual indices if their intermediate does not fit or if
+    // requested by the user
+    bool batched = (not blocks_large.empty()) and
+                   ((batch_nvirt_ > 0) or
+                    (static_cast<int64_t>(dsrg_mem_.compute_memory(blocks_large)) >
+                     static_cast<int64_t>(dsrg_mem_.available())));
+    if (not batched) {
+        blocks.insert(blocks.end(), blocks_large.begin(), blocks_large.end());
+    }
+
     auto temp = ambit::BlockedTensor::build(tensor_type_, "temp", blocks);
     temp["qjsb"] += alpha * H2["aqms"] * S2["mjab"];
     temp["qjsb"] -= alpha * H2["aqsm"] * T2["mjab"];
@@ -480,6 +492,8 @@ void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, c
     for (const std::string& block : C2.block_labels()) {
         if (block.substr(0, 1) == virt_label_ or block.substr(3, 1) == core_label_)
             continue;
+        else if (batched and std::count(block.begin(), block.end(), virt_label_[0]) > 2)
+            continue;
         else
             blocks.push_back(block);
     }
@@ -492,12 +506,142 @@ void SADSRG::H2_T2_C2(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2, c
     C2["jqsb"] += temp["jqsb"];
     C2["qjbs"] += temp["jqsb"];
 
+    if (batched) {
+        H2_T2_C2_PH_batched(H2, T2, S2, alpha, C2);
+    }
+
     if (print_ > 3) {
         outfile->Printf("\n    Time for [H2, T2] -> C2 : %12.3f", timer.get());
     }
     dsrg_time_.add("222", timer.get());
 }
 
+void SADSRG::H2_T2_C2_PH_batched(BlockedTensor& H2, BlockedTensor& T2, BlockedTensor& S2,
+                                 const double& alpha, BlockedTensor& C2) {
+    // Hole-particle contractions of H2_T2_C2 for the blocks with three virtual indices.
+    // These are accumulated directly into C2 for batches of the virtual index e.
+    auto H2_slice = [&](const std::string& block, size_t e0, size_t e1) {
+        auto H = H2.block(block);
+        const auto& dims = H.dims();
+        const size_t n0 = dims[0], n1 = dims[1], n23 = dims[2] * dims[3], ne = e1 - e0;
+        auto Y = ambit::Tensor::build(tensor_type_, "H2 slice", {n0, ne, dims[2], dims[3]});
+        const auto& Hdata = H.data();
+        auto& Ydata = Y.data();
+        for (size_t p = 0; p < n0; ++p) {
+            std::copy(Hdata.begin() + (p * n1 + e0) * n23, Hdata.begin() + (p * n1 + e1) * n23,
+                      Ydata.begin() + p * ne * n23);
+        }
+        return Y;
+    };
+
+    auto X = ambit::BlockedTensor::build(tensor_type_, "X", {"hhpv"});
+
+    // C2["qjsb"] and C2["jqbs"] with q, s, b virtual
+    PH_batched_intermediate(S2, false, X);
+    H2_X_C2_tiled(H2_slice, false, X, alpha, false, C2);
+
+    PH_batched_intermediate(T2, false, X);
+    H2_X_C2_tiled(H2_slice, true, X, -alpha, false, C2);
+
+    // C2["jqsb"] and C2["qjbs"] with q, s, b virtual
+    PH_batched_intermediate(T2, true, X);
+    H2_X_C2_tiled(H2_slice, true, X, -alpha, true, C2);
+}
+
+void SADSRG::PH_batched_intermediate(BlockedTensor& T, bool transpose, BlockedTensor& X) {
+    X.zero();
+    if (transpose) {
+        X["m,j,a,v0"] = T["m,j,v0,a"];
+        X["x,j,a,v0"] += 0.5 * L1_["x,y"] * T["y,j,v0,a"];
+        X["i,j,y,v0"] -= 0.5 * L1_["x,y"] * T["i,j,v0,x"];
+    } else {
+        X["m,j,a,v0"] = T["m,j,a,v0"];
+        X["x,j,a,v0"] += 0.5 * L1_["x,y"] * T["y,j,a,v0"];
+        X["i,j,y,v0"] -= 0.5 * L1_["x,y"] * T["i,j,x,v0"];
+    }
+}
+
+size_t SADSRG::tiled_batch_nvirt() {
+    const size_t nv = virt_mos_.size();
+    if (batch_nvirt_ > 0)
+        return std::min(nv, static_cast<size_t>(batch_nvirt_));
+
+    // per virtual index: the H2 slice, the result, and the copies made by the contraction
+    const size_t nh = core_mos_.size() + actv_mos_.size();
+    const size_t mem_per_virt = 4 * nh * nv * nv * sizeof(double);
+    const size_t nbatch = dsrg_mem_.available() / std::max(mem_per_virt, size_t(1));
+    return std::max(size_t(1), std::min(nv, nbatch));
+}
+
+void SADSRG::H2_X_C2_tiled(
+    const std::function<ambit::Tensor(const std::string&, size_t, size_t)>& H2_slice,
+    bool exchange, BlockedTensor& X, const double& alpha, bool swap, BlockedTensor& C2) {
+    const size_t nv = virt_mos_.size();
+    if (nv == 0)
+        return;
+    const size_t batch_size = tiled_batch_nvirt();
+    if (print_ > 3) {
+        outfile->Printf("\n    Tiled [H2, T2] -> C2 with %zu virtuals per batch", batch_size);
+    }
+
+    const std::string& v = virt_label_;
+    const std::vector<std::string> holes{core_label_, actv_label_};
+    const std::vector<std::string> particles{actv_label_, virt_label_};
+
+    for (size_t e0 = 0; e0 < nv; e0 += batch_size) {
+        const size_t e1 = std::min(nv, e0 + batch_size);
+        const size_t ne = e1 - e0;
+
+        for (const std::string& j : holes) {
+            const size_t nj = label_to_spacemo_[j[0]].size();
+            if (nj == 0)
+                continue;
+
+            // R["ejfb"] = alpha * H2["aeif"] * X["ijab"] for e in the batch
+            auto R = ambit::Tensor::build(tensor_type_, "R", {ne, nj, nv, nv});
+            for (const std::string& i : holes) {
+                for (const std::string& a : particles) {
+                    if (label_to_spacemo_[i[0]].empty() or label_to_spacemo_[a[0]].empty())
+                        continue;
+                    auto Xb = X.block(i + j + a + v);
+                    if (exchange) {
+                        auto Y = H2_slice(a + v + v + i, e0, e1);
+                        R("e,j,f,b") += alpha * Y("a,e,f,i") * Xb("i,j,a,b");
+                    } else {
+                        auto Y = H2_slice(a + v + i + v, e0, e1);
+                        R("e,j,f,b") += alpha * Y("a,e,i,f") * Xb("i,j,a,b");
+                    }
+                }
+            }
+
+            // add R to the vhvv and hvvv blocks of C2
+            auto C2_vhvv = C2.block(v + j + v + v);
+            auto C2_hvvv = C2.block(j + v + v + v);
+            auto& vhvv = C2_vhvv.data();
+            auto& hvvv = C2_hvvv.data();
+            const auto& Rdata = R.data();
+#pragma omp parallel for
+            for (size_t e = 0; e < ne; ++e) {
+                const size_t ev = e0 + e;
+                for (size_t jj = 0; jj < nj; ++jj) {
+                    for (size_t f = 0; f < nv; ++f) {
+                        for (size_t b = 0; b < nv; ++b) {
+                            const double r = Rdata[((e * nj + jj) * nv + f) * nv + b];
+                            if (swap) {
+                                hvvv[((jj * nv + ev) * nv + f) * nv + b] += r;
+                                vhvv[((ev * nj + jj) * nv + b) * nv + f] += r;
+                            } else {
+                                vhvv[((ev * nj + jj) * nv + f) * nv + b] += r;
+                                hvvv[((jj * nv + ev) * nv + b) * nv + f] += r;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 void SADSRG::V_T1_C0_DF(BlockedTensor& B, BlockedTensor& T1, const double& alpha, double& C0) {
     local_timer timer;
 
@@ -769,6 +913,11 @@ void SADSRG::V_T2_C2_DF_PH_X(BlockedTensor& B, BlockedTensor& T2, const double&
     C2["jqsb"] += temp["jqsb"];
     C2["qjbs"] += temp["jqsb"];
 
+    if (batched_comm_ and !qjsb_large.empty()) {
+        V_T2_C2_DF_PH_X_batched(B, T2, alpha, C2);
+        return;
+    }
+
     if (!qjsb_large.empty()) {
         C2["e,j,f,v0"] -= batched("e", alpha * B["g,a,f"] * B["g,e,m"] * T2["m,j,a,v0"]);
         C2["j,e,v0,f"] -= batched("e", alpha * B["g,a,f"] * B["g,e,m"] * T2["m,j,a,v0"]);
@@ -800,6 +949,38 @@ void SADSRG::V_T2_C2_DF_PH_X(BlockedTensor& B, BlockedTensor& T2, const double&
     }
 }
 
+void SADSRG::V_T2_C2_DF_PH_X_batched(BlockedTensor& B, BlockedTensor& T2, const double& alpha,
+                                     BlockedTensor& C2) {
+    // Blocks of V_T2_C2_DF_PH_X with three virtual indices. For each batch of the virtual index
+    // e, the integrals H2["pers"] = B["gpr"] * B["ges"] are built from the three-index integrals.
+    auto V_slice = [&](const std::string& block, size_t e0, size_t e1) {
+        auto Bpr = B.block(aux_label_ + block.substr(0, 1) + block.substr(2, 1));
+        auto Bes_full = B.block(aux_label_ + block.substr(1, 1) + block.substr(3, 1));
+        const auto& dims = Bes_full.dims();
+        const size_t nQ = dims[0], n1 = dims[1], ns = dims[2], ne = e1 - e0;
+        auto Bes = ambit::Tensor::build(tensor_type_, "B slice", {nQ, ne, ns});
+        const auto& Bdata = Bes_full.data();
+        auto& Bes_data = Bes.data();
+        for (size_t g = 0; g < nQ; ++g) {
+            std::copy(Bdata.begin() + (g * n1 + e0) * ns, Bdata.begin() + (g * n1 + e1) * ns,
+                      Bes_data.begin() + g * ne * ns);
+        }
+        auto Y = ambit::Tensor::build(tensor_type_, "V slice", {Bpr.dim(1), ne, Bpr.dim(2), ns});
+        Y("p,e,r,s") = Bpr("g,p,r") * Bes("g,e,s");
+        return Y;
+    };
+
+    auto X = ambit::BlockedTensor::build(tensor_type_, "X", {"hhpv"});
+
+    // C2["qjsb"] and C2["jqbs"] with q, s, b virtual
+    PH_batched_intermediate(T2, false, X);
+    H2_X_C2_tiled(V_slice, true, X, -alpha, false, C2);
+
+    // C2["jqsb"] and C2["qjbs"] with q, s, b virtual
+    PH_batched_intermediate(T2, true, X);
+    H2_X_C2_tiled(V_slice, true, X, -alpha, true, C2);
+}
+
 void SADSRG::H_A_Ca(BlockedTensor& H1, BlockedTensor& H2, BlockedTensor& T1, BlockedTensor& T2,
                     BlockedTensor& S2, const double& alpha, BlockedTensor& C1, BlockedTensor& C2) {
     // set up G2["pqrs"] = 2 * H2["pqrs"] - H2["pqsr"]
@@ -119,19 +119,25 @@ void DSRG_MRPT2::startup() {
     }
 }
 
+ambit::BlockedTensor DSRG_MRPT2::build_three_index_ints() {
+    BlockedTensor B = BTF_->build(tensor_type_, "B", {"Lph", "LPH"});
+
+    for (const std::string& block : B.block_labels()) {
+        std::vector<size_t> iaux = label_to_spacemo_[block[0]];
+        std::vector<size_t> ip = label_to_spacemo_[block[1]];
+        std::vector<size_t> ih = label_to_spacemo_[block[2]];
+
+        ambit::Tensor Bblock = ints_->three_integral_block(iaux, ip, ih);
+        B.block(block).copy(Bblock);
+    }
+    return B;
+}
+
 void DSRG_MRPT2::build_ints() {
     if (eri_df_) {
         // a simple trick when we cannot store <pq|rs> but can store <ij|ab>
-        BlockedTensor B = BTF_->build(tensor_type_, "B", {"Lph", "LPH"});
-
-        for (const std::string& block : B.block_labels()) {
-            std::vector<size_t> iaux = label_to_spacemo_[block[0]];
-            std::vector<size_t> ip = label_to_spacemo_[block[1]];
-            std::vector<size_t> ih = label_to_spacemo_[block[2]];
-
-            ambit::Tensor Bblock = ints_->three_integral_block(iaux, ip, ih);
-            B.block(block).copy(Bblock);
-        }
+        // B_ is only kept when V_ is rebuilt many times (multi-state computations)
+        BlockedTensor B = B_.block_labels().empty() ? build_three_index_ints() : B_;
 
         V_["abij"] = B["gai"] * B["gbj"];
         V_["abij"] -= B["gaj"] * B["gbi"];
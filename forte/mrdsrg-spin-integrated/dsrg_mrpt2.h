@@ -90,19 +90,9 @@ class DSRG_MRPT2 : public MASTER_DSRG {
     /// Compute the DSRG-MRPT2 energy with relaxed reference (once)
     double compute_energy_relaxed();
 
-    /// Compute the multi-state DSRG-MRPT2 energies
-    double compute_energy_multi_state();
-
-    /// Set CASCI eigen values and eigen vectors for state averaging
-    void set_eigens(
-        const std::vector<std::vector<std::pair<std::shared_ptr<psi::Vector>, double>>>& eigens) {
-        eigens_ = eigens;
-    }
-
-    /// Set determinants in the model space
-    void set_p_spaces(const std::vector<std::vector<forte::Determinant>>& p_spaces) {
-        p_spaces_ = p_spaces;
-    }
+    /// Compute the multi-state (MS or XMS) DSRG-MRPT2 energies
+    /// The reference states are taken from the active space solver
+    double compute_energy_multi_state() override;
 
     //    /// Compute de-normal-ordered amplitudes and return the scalar term
     //    double Tamp_deGNO();
@@ -132,13 +122,10 @@ class DSRG_MRPT2 : public MASTER_DSRG {
     /// Print a summary of the options
     void print_options_summary();
 
-    /// CASCI eigen values and eigen vectors for state averaging
-    std::vector<std::vector<std::pair<std::shared_ptr<psi::Vector>, double>>> eigens_;
-    /// Determinants with different symmetries in the model space
-    std::vector<std::vector<forte::Determinant>> p_spaces_;
-
     /// Fill up two-electron integrals
     void build_ints();
+    /// Build the three-index integrals of the ph blocks (DF or CD only)
+    ambit::BlockedTensor build_three_index_ints();
     /// Fill up density matrix and density cumulants
     void build_density();
     /// Build Fock matrix and diagonal Fock matrix elements
@@ -169,6 +156,8 @@ class DSRG_MRPT2 : public MASTER_DSRG {
     ambit::BlockedTensor F_;
     /// Two-electron integral (bare or renormalized)
     ambit::BlockedTensor V_;
+    /// Three-index integrals kept to rebuild the bare V_ for each state (DF or CD only)
+    ambit::BlockedTensor B_;
     /// Single excitation amplitude
     ambit::BlockedTensor T1_;
     /// Effective single excitation amplitudes resulting from de-normal ordering
@@ -314,7 +303,7 @@ class DSRG_MRPT2 : public MASTER_DSRG {
     void set_preconditioner(std::vector<double>& D);
     void gmres_solver(std::vector<double>& x_new);
     void solve_linear_iter();
-    void z_vector_contraction(std::vector<double>&, std::vector<double>&);
+    void z_vector_contraction(const std::vector<double>&, std::vector<double>&);
     void pre_contract();
     /**
      * Solve the Linear System Ax=b and yield Z using direct methods.
@@ -589,7 +578,7 @@ class DSRG_MRPT2 : public MASTER_DSRG {
     /// Compute MS coupling <M|HT|N>
     double compute_ms_2nd_coupling(const std::string& name);
 
-    /// Rotate RDMs computed by eigens_ (in original basis) to semicanonical basis
+    /// Rotate RDMs computed from the CI vectors (in original basis) to semicanonical basis
     /// so that they are in the same basis as amplitudes (in semicanonical basis)
     void rotate_1rdm(ambit::Tensor& L1a, ambit::Tensor& L1b);
     void rotate_2rdm(ambit::Tensor& L2aa, ambit::Tensor& L2ab, ambit::Tensor& L2bb);
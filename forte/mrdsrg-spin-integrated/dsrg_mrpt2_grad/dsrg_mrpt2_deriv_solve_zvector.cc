@@ -21,7 +21,6 @@ using namespace psi;
 
 namespace forte {
 
-int max_iter = 500;
 double err = 1e-9;
 
 void DSRG_MRPT2::set_zvec_moinfo() {
@@ -689,51 +688,35 @@ double f_norm(const std::vector<double>& v) {
                                      [](double acc, double val) { return acc + val * val; }));
 }
 
-double diff_f_norm(std::vector<double> const& v1, std::vector<double> const& v2) {
-    if (v1.size() != v2.size()) {
-        throw std::invalid_argument("diff_f_norm: Input vectors must have same size.");
-    }
-
-    // compute the inner product of the difference of the two vectors
-    double accum = std::inner_product(v1.begin(), v1.end(), v2.begin(), 0.0, std::plus<>(),
-                                      [](double a, double b) {
-                                          double diff = a - b;
-                                          return diff * diff;
-                                      });
-
-    return std::sqrt(accum);
-}
-
-void DSRG_MRPT2::z_vector_contraction(std::vector<double>& qk_vec, std::vector<double>& y_vec) {
+void DSRG_MRPT2::z_vector_contraction(const std::vector<double>& qk_vec,
+                                      std::vector<double>& y_vec) {
     BlockedTensor qk = BTF_->build(CoreTensor, "vector qk (orbital rotation) in GMRES",
                                    {"vc", "VC", "ca", "CA", "va", "VA", "aa", "AA"}, true);
     auto qk_ci = ambit::Tensor::build(ambit::CoreTensor, "qk (ci) in GMRES", {ndets});
 
     for (const std::string& row : {"vc", "VC", "ca", "CA", "va", "VA", "aa", "AA"}) {
-        int idx1 = block_dim[row];
-        int pre1 = preidx[row];
+        auto& data = qk.block(row).data();
+        const auto pre1 = qk_vec.begin() + preidx[row];
         if (row != "aa" && row != "AA") {
-            qk.block(row).iterate([&](const std::vector<size_t>& i, double& value) {
-                int index = pre1 + i[0] * idx1 + i[1];
-                value = qk_vec.at(index);
-            });
+            // these blocks are stored contiguously (row major) in qk_vec
+            std::copy(pre1, pre1 + data.size(), data.begin());
         } else {
-            qk.block(row).iterate([&](const std::vector<size_t>& i, double& value) {
-                int i0 = i[0] > i[1] ? i[0] : i[1], i1 = i[0] > i[1] ? i[1] : i[0];
-                if (i[0] != i[1]) {
-                    int index = pre1 + i0 * (i0 - 1) / 2 + i1;
-                    value = qk_vec.at(index);
+            // only the u > v elements are stored in qk_vec, the block is symmetric
+            const int n = qk.block(row).dim(0);
+#pragma omp parallel for
+            for (int u = 1; u < n; ++u) {
+                for (int v = 0; v < u; ++v) {
+                    const double value = pre1[u * (u - 1) / 2 + v];
+                    data[u * n + v] = value;
+                    data[v * n + u] = value;
                 }
-            });
+            }
         }
     }
 
-    for (const std::string& row : {"ci"}) {
-        int pre1 = preidx[row];
-        (qk_ci).iterate([&](const std::vector<size_t>& i, double& value) {
-            int index = pre1 + i[0];
-            value = qk_vec.at(index);
-        });
+    {
+        const auto pre1 = qk_vec.begin() + preidx["ci"];
+        std::copy(pre1, pre1 + ndets, qk_ci.data().begin());
     }
 
     BlockedTensor y =
@@ -1239,28 +1222,22 @@ void DSRG_MRPT2::z_vector_contraction(std::vector<double>& qk_vec, std::vector<d
 
     /// Fill the y (y = A * qk) and pass it to the GMRES solver
     for (const std::string& row : {"vc", "ca", "va", "aa"}) {
-        int idx1 = block_dim[row];
-        int pre1 = preidx[row];
+        const auto& data = y.block(row).data();
+        const auto pre1 = y_vec.begin() + preidx[row];
         if (row != "aa") {
-            y.block(row).iterate([&](const std::vector<size_t>& i, double& value) {
-                int index = pre1 + i[0] * idx1 + i[1];
-                y_vec.at(index) = value;
-            });
+            std::copy(data.begin(), data.end(), pre1);
         } else {
-            y.block(row).iterate([&](const std::vector<size_t>& i, double& value) {
-                if (i[0] > i[1]) {
-                    int index = pre1 + i[0] * (i[0] - 1) / 2 + i[1];
-                    y_vec.at(index) = value;
+            const int n = y.block(row).dim(0);
+#pragma omp parallel for
+            for (int u = 1; u < n; ++u) {
+                for (int v = 0; v < u; ++v) {
+                    pre1[u * (u - 1) / 2 + v] = data[u * n + v];
                 }
-            });
+            }
         }
     }
 
-    for (const std::string& row : {"ci"}) {
-        int pre1 = preidx[row];
-        (y_ci).iterate(
-            [&](const std::vector<size_t>& i, double& value) { y_vec.at(pre1 + i[0]) = value; });
-    }
+    std::copy(y_ci.data().begin(), y_ci.data().end(), y_vec.begin() + preidx["ci"]);
 }
 
 void DSRG_MRPT2::set_preconditioner(std::vector<double>& D) {
@@ -1384,98 +1361,129 @@ void DSRG_MRPT2::set_preconditioner(std::vector<double>& D) {
     }
 }
 
+/**
+ * Solve the z-vector equations A x = b with the restarted GMRES(m) algorithm.
+ *
+ * The equations are left-preconditioned with the block Jacobi preconditioner D (orbital
+ * rotations and CI coefficients), i.e., we solve D A x = D b. At most m = DSRG_ZVEC_KRYLOV_DIM
+ * Krylov vectors are kept in memory and the iterations are restarted from the current solution
+ * when the subspace is full. The least-squares problem is solved incrementally via Givens
+ * rotations so that the residual norm is available at each iteration.
+ */
 void DSRG_MRPT2::gmres_solver(std::vector<double>& x_new) {
     outfile->Printf("\n    Solving the linear system ....................... ");
-    int iters;
-    std::vector<double> x_old(dim);
-    x_old = x_new;
-    std::vector<double> r(dim);
-    std::vector<double> q(max_iter * dim, 0.0);
-    std::vector<double> h((max_iter + 1) * max_iter, 0.0);
-    std::vector<double> bh(max_iter + 1, 0.0);
-    // D is a Jacobi preconditioner
-    std::vector<double> D(dim, 1.0);
+    const int krylov_dim = std::max(1, foptions_->get_int("DSRG_ZVEC_KRYLOV_DIM"));
+    const int maxiter = foptions_->get_int("DSRG_ZVEC_MAXITER");
+    const double r_conv = foptions_->get_double("DSRG_ZVEC_R_CONVERGENCE");
 
+    // D is a block Jacobi preconditioner
+    std::vector<double> D(dim, 1.0);
     set_preconditioner(D);
 
     for (size_t i = 0, maxi = b.size(); i < maxi; ++i) {
         b[i] *= D[i];
     }
 
-    z_vector_contraction(x_old, r);
-
-    for (size_t i = 0, maxi = r.size(); i < maxi; ++i) {
-        r[i] = b[i] - D[i] * r[i];
-    }
-
-    bh[0] = f_norm(r);
-
-    for (int j = 0; j < dim; ++j) {
-        // index here : i * dim + j, where i = 0
-        q[j] = r[j] / bh[0];
-    }
-
-    std::vector<double> y_vec(dim, 0.0);
-
-    for (int iter = 0; iter < max_iter; ++iter) {
-        if (diff_f_norm(x_old, x_new) < err && iter > 2) {
+    // The Krylov vectors (stored as rows), the Hessenberg matrix (column major), and the Givens
+    // rotations that bring it to upper triangular form
+    const size_t ldh = krylov_dim + 1;
+    std::vector<double> q(ldh * dim, 0.0);
+    std::vector<double> h(ldh * krylov_dim, 0.0);
+    std::vector<double> cs(krylov_dim, 0.0);
+    std::vector<double> sn(krylov_dim, 0.0);
+    std::vector<double> g(ldh, 0.0);
+    std::vector<double> y(krylov_dim, 0.0);
+    std::vector<double> qk_vec(dim);
+    std::vector<double> w(dim);
+
+    int iters = 0;
+    bool converged = false;
+    double rnorm = 0.0;
+    while (not converged) {
+        // compute the preconditioned residual r = D (b - A x) and store it in q_0
+        z_vector_contraction(x_new, w);
+        for (int i = 0; i < dim; ++i) {
+            w[i] = b[i] - D[i] * w[i];
+        }
+        rnorm = f_norm(w);
+        if (rnorm < r_conv) {
+            converged = true;
             break;
         }
-        iters = iter + 1;
-        x_old = x_new;
-
-        std::vector<double> qk_vec(dim);
-        for (int i = 0; i < dim; ++i) {
-            qk_vec.at(i) = q[iter * dim + i];
+        if (iters >= maxiter) {
+            break;
         }
-
-        z_vector_contraction(qk_vec, y_vec);
-
-        for (size_t i = 0, maxi = y_vec.size(); i < maxi; ++i) {
-            y_vec[i] *= D[i];
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = rnorm;
+        for (int i = 0; i < dim; ++i) {
+            q[i] = w[i] / rnorm;
         }
 
-        for (int i = 0; i < iter + 1; ++i) {
-            h[i + iter * (max_iter + 1)] = C_DDOT(dim, &q[i * dim], 1, &y_vec[0], 1);
-            for (int j = 0; j < dim; ++j) {
-                y_vec[j] -= h[i + iter * (max_iter + 1)] * q[i * dim + j];
+        int m = 0;
+        bool breakdown = false;
+        while ((m < krylov_dim) and (iters < maxiter)) {
+            iters++;
+            double* hm = &h[m * ldh];
+
+            // w = D A q_m
+            std::copy(&q[m * dim], &q[m * dim] + dim, qk_vec.begin());
+            z_vector_contraction(qk_vec, w);
+            for (int i = 0; i < dim; ++i) {
+                w[i] *= D[i];
             }
-        }
-
-        h[(iter + 1) + iter * (max_iter + 1)] = f_norm(y_vec);
-        bool condition =
-            (std::fabs(h[(iter + 1) + iter * (max_iter + 1)]) < 1e-10) || (iter == max_iter - 1);
 
-        std::vector<double> ck(max_iter + 1, 0.0);
-        ck = bh;
-
-        int lwork = 2 * max_iter;
-        std::vector<double> work(lwork);
+            // orthogonalize w against the Krylov vectors (modified Gram-Schmidt)
+            for (int i = 0; i <= m; ++i) {
+                hm[i] = C_DDOT(dim, &q[i * dim], 1, w.data(), 1);
+                C_DAXPY(dim, -hm[i], &q[i * dim], 1, w.data(), 1);
+            }
+            hm[m + 1] = f_norm(w);
+            breakdown = hm[m + 1] < 1.0e-14;
+            if (not breakdown) {
+                for (int i = 0; i < dim; ++i) {
+                    q[(m + 1) * dim + i] = w[i] / hm[m + 1];
+                }
+            }
 
-        std::vector<double> h_sub((iter + 2) * (iter + 1), 0.0);
-        for (int i = 0; i < iter + 2; ++i) {
-            for (int j = 0; j < iter + 1; ++j) {
-                h_sub[i + j * (iter + 2)] = h[i + j * (max_iter + 1)];
+            // apply the previous rotations to the new column and compute a new rotation
+            for (int i = 0; i < m; ++i) {
+                const double temp = cs[i] * hm[i] + sn[i] * hm[i + 1];
+                hm[i + 1] = -sn[i] * hm[i] + cs[i] * hm[i + 1];
+                hm[i] = temp;
             }
+            const double denom = std::hypot(hm[m], hm[m + 1]);
+            cs[m] = denom > 0.0 ? hm[m] / denom : 1.0;
+            sn[m] = denom > 0.0 ? hm[m + 1] / denom : 0.0;
+            hm[m] = denom;
+            hm[m + 1] = 0.0;
+            g[m + 1] = -sn[m] * g[m];
+            g[m] = cs[m] * g[m];
+            m++;
+
+            rnorm = std::fabs(g[m]);
+            if ((rnorm < r_conv) or breakdown)
+                break;
         }
 
-        C_DGELS('n', iter + 2, iter + 1, 1, &h_sub[0], iter + 2, &ck[0], iter + 2, &work[0], lwork);
-
-        if (!condition) {
-            for (int j = 0; j < dim; ++j) {
-                q[(iter + 1) * dim + j] = y_vec[j] / h[(iter + 1) + iter * (max_iter + 1)];
+        // solve the upper triangular system R y = g and update the solution x += Q y
+        for (int i = m - 1; i >= 0; --i) {
+            double value = g[i];
+            for (int j = i + 1; j < m; ++j) {
+                value -= h[i + j * ldh] * y[j];
             }
-            C_DGEMV('t', iter + 2, dim, 1.0, &(q[0]), dim, &(ck[0]), 1, 0, &(x_new[0]), 1);
-        } else if (iter == max_iter - 1) {
-            throw PSIEXCEPTION("GMRES solution is not converged, please change max iteration or "
-                               "error threshold in GMRES.");
-        } else {
-            C_DGEMV('t', max_iter, dim, 1.0, &(q[0]), dim, &(ck[0]), 1, 0, &(x_new[0]), 1);
-            break;
+            y[i] = value / h[i + i * ldh];
         }
+        C_DGEMV('t', m, dim, 1.0, q.data(), dim, y.data(), 1, 1.0, x_new.data(), 1);
+    }
+
+    if (not converged) {
+        throw PSIEXCEPTION("The z-vector equations are not converged (residual = " +
+                           std::to_string(rnorm) +
+                           "). Please increase DSRG_ZVEC_MAXITER or DSRG_ZVEC_KRYLOV_DIM.");
     }
     outfile->Printf("Done");
-    outfile->Printf("\n        Z vector equation was solved in %d iterations", iters);
+    outfile->Printf("\n        Z vector equation was solved in %d iterations (residual = %.3e)",
+                    iters, rnorm);
 }
 
 void DSRG_MRPT2::solve_linear_iter() {
@@ -29,9 +29,11 @@
 #include <iomanip>
 
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include "helpers/timer.h"
 #include "helpers/printing.h"
+#include "base_classes/active_space_solver.h"
 #include "ci_rdm/ci_rdms.h"
 #include "fci/fci_solver.h"
 #include "dsrg_mrpt2.h"
@@ -40,56 +42,54 @@ using namespace psi;
 
 namespace forte {
 
-// double DSRG_MRPT2::compute_energy_multi_state() {
-//    // throw a waring if states with different symmetry
-//    int nentry = eigens_.size();
-//    if (nentry > 1) {
-//        outfile->Printf(
-//            "\n\n  Warning: States with different symmetry are found in the list of AVG_STATES.");
-//        outfile->Printf("\n           Each symmetry will be considered separately here.");
-//    }
-
-//    // get character table
-//    CharacterTable ct = psi::Process::environment.molecule()->point_group()->char_table();
-//    std::vector<std::string> irrep_symbol;
-//    for (int h = 0, nirrep = mo_space_info_->nirrep(); h < nirrep; ++h) {
-//        irrep_symbol.push_back(std::string(ct.gamma(h).symbol()));
-//    }
+double DSRG_MRPT2::compute_energy_multi_state() {
+    if (as_solver_ == nullptr) {
+        throw std::runtime_error("MS/XMS DSRG-MRPT2 requires the active space solver.");
+    }
 
-//    // multi-state calculation
-//    std::vector<std::vector<double>> Edsrg_ms;
+    // throw a waring if states with different symmetry
+    int nentry = state_to_weights_.size();
+    if (nentry > 1) {
+        outfile->Printf(
+            "\n\n  Warning: States with different symmetry are found in the list of AVG_STATES.");
+        outfile->Printf("\n           Each symmetry will be considered separately here.");
+    }
 
-//    if (multi_state_algorithm_.find("SA") != std::string::npos) {
-//        Edsrg_ms = compute_energy_sa();
-//    } else {
-//        Edsrg_ms = compute_energy_xms();
-//    }
+    // the transition 3-RDMs are needed for the couplings even if the 3-cumulant is neglected
+    if (!do_cu3_) {
+        std::vector<size_t> dims(6, actv_mos_.size());
+        L3aaa_ = ambit::Tensor::build(tensor_type_, "L3aaa", dims);
+        L3aab_ = ambit::Tensor::build(tensor_type_, "L3aab", dims);
+        L3abb_ = ambit::Tensor::build(tensor_type_, "L3abb", dims);
+        L3bbb_ = ambit::Tensor::build(tensor_type_, "L3bbb", dims);
+    }
 
-//    // energy summuary
-//    print_h2("Multi-State DSRG-MRPT2 Energy Summary");
+    // multi-state calculation
+    std::vector<std::vector<double>> Edsrg_ms = compute_energy_xms();
 
-//    outfile->Printf("\n    Multi.  Irrep.  No.    DSRG-MRPT2 Energy");
-//    std::string dash(41, '-');
-//    outfile->Printf("\n    %s", dash.c_str());
+    // energy summuary
+    print_h2("Multi-State DSRG-MRPT2 Energy Summary");
 
-//    for (int n = 0, counter = 0; n < nentry; ++n) {
-//        int irrep = (foptions_->psi_options())["AVG_STATE"][n][0].to_integer();
-//        int multi = (foptions_->psi_options())["AVG_STATE"][n][1].to_integer();
-//        int nstates = (foptions_->psi_options())["AVG_STATE"][n][2].to_integer();
+    outfile->Printf("\n    Multi.  Irrep.  No.    DSRG-MRPT2 Energy");
+    std::string dash(41, '-');
+    outfile->Printf("\n    %s", dash.c_str());
 
-//        for (int i = 0; i < nstates; ++i) {
-//            outfile->Printf("\n     %3d     %3s    %2d   %20.12f", multi,
-//                            irrep_symbol[irrep].c_str(), i, Edsrg_ms[n][i]);
-//            psi::Process::environment.globals["ENERGY ROOT " + std::to_string(counter)] =
-//                Edsrg_ms[n][i];
-//            ++counter;
-//        }
-//        outfile->Printf("\n    %s", dash.c_str());
-//    }
+    int n = 0, counter = 0;
+    for (const auto& [state, _] : state_to_weights_) {
+        for (size_t i = 0, nstates = Edsrg_ms[n].size(); i < nstates; ++i) {
+            outfile->Printf("\n     %3d     %3s    %2zu   %20.12f", state.multiplicity(),
+                            state.irrep_label().c_str(), i, Edsrg_ms[n][i]);
+            psi::Process::environment.globals["ENERGY ROOT " + std::to_string(counter)] =
+                Edsrg_ms[n][i];
+            ++counter;
+        }
+        outfile->Printf("\n    %s", dash.c_str());
+        ++n;
+    }
 
-//    psi::Process::environment.globals["CURRENT ENERGY"] = Edsrg_ms[0][0];
-//    return Edsrg_ms[0][0];
-//}
+    psi::Process::environment.globals["CURRENT ENERGY"] = Edsrg_ms[0][0];
+    return Edsrg_ms[0][0];
+}
 
 // std::vector<std::vector<double>> DSRG_MRPT2::compute_energy_sa() {
 //    // compute DSRG-MRPT2 energy using SA densities
@@ -339,53 +339,37 @@ namespace forte {
 //}
 
 std::vector<std::vector<double>> DSRG_MRPT2::compute_energy_xms() {
-    // get irrep symbols
-    std::vector<std::string> irrep_symbol = mo_space_info_->irrep_labels();
-    // multiplicity table
-    std::vector<std::string> multi_label{
-        "Singlet", "Doublet", "Triplet", "Quartet", "Quintet", "Sextet", "Septet", "Octet",
-        "Nonet",   "Decaet",  "11-et",   "12-et",   "13-et",   "14-et",  "15-et",  "16-et",
-        "17-et",   "18-et",   "19-et",   "20-et",   "21-et",   "22-et",  "23-et",  "24-et"};
-
     // prepare FCI integrals (a fake one)
     std::shared_ptr<ActiveSpaceIntegrals> fci_ints =
         std::make_shared<ActiveSpaceIntegrals>(ints_, actv_mos_, actv_mos_sym_, core_mos_);
-    //    ambit::Tensor actv_aa = ints_->aptei_aa_block(aactv_mos_, aactv_mos_,
-    //    aactv_mos_, aactv_mos_);
-    //    ambit::Tensor actv_ab = ints_->aptei_ab_block(aactv_mos_, aactv_mos_,
-    //    aactv_mos_, aactv_mos_);
-    //    ambit::Tensor actv_bb = ints_->aptei_bb_block(aactv_mos_, aactv_mos_,
-    //    aactv_mos_, aactv_mos_);
-    //    fci_ints->set_active_integrals(actv_aa, actv_ab, actv_bb);
-    //    fci_ints->compute_restricted_one_body_operator();
 
     // allocate space for one-electron integrals
     Hoei_ = BTF_->build(tensor_type_, "OEI", spin_cases({"ph", "cc"}));
 
-    // obtain zeroth-order states
-    int nentry = eigens_.size();
-    std::vector<std::vector<double>> Edsrg_ms(nentry, std::vector<double>());
-
-    for (int n = 0; n < nentry; ++n) {
-        py::list avg_state_list = foptions_->get_gen_list("AVG_STATE")[n];
+    // the bare integrals are rebuilt for every state from the same three-index integrals
+    if (eri_df_) {
+        B_ = build_three_index_ints();
+    }
 
-        int irrep = py::cast<int>(avg_state_list[0]);
-        int multi = py::cast<int>(avg_state_list[1]);
+    // obtain zeroth-order states from the active space solver
+    int nentry = state_to_weights_.size();
+    std::vector<std::vector<double>> Edsrg_ms;
 
-        int nstates = eigens_[n].size();
-        std::vector<forte::Determinant> p_space = p_spaces_[n];
+    for (const auto& [state, weights] : state_to_weights_) {
+        int nstates = weights.size();
+        auto [dets, evecs] = as_solver_->state_ci_wfn(state);
+        std::vector<forte::Determinant> p_space = dets.determinants();
 
         // print current status
-        std::stringstream ss;
-        ss << multi_label[multi - 1] << " " << irrep_symbol[irrep];
-        print_h2("Build Effective Hamiltonian (" + ss.str() + ")");
+        std::string state_label = state.multiplicity_label() + " " + state.irrep_label();
+        print_h2("Build Effective Hamiltonian (" + state_label + ")");
         outfile->Printf("\n");
 
         // fill in ci vectors
-        int dim = (eigens_[n][0].first)->dim();
+        int dim = p_space.size();
         auto civecs = std::make_shared<psi::Matrix>("ci vecs", dim, nstates);
         for (int i = 0; i < nstates; ++i) {
-            civecs->set_column(0, i, (eigens_[n][i]).first);
+            civecs->set_column(0, i, evecs->get_column(0, i));
         }
 
         // XMS rotaion if needed
@@ -393,7 +377,7 @@ std::vector<std::vector<double>> DSRG_MRPT2::compute_energy_xms() {
             if (nentry > 1) {
                 // recompute state-averaged density
                 outfile->Printf("\n    Recompute SA density matrix of %s with equal weights.",
-                                ss.str().c_str());
+                                state_label.c_str());
                 Gamma1_.zero();
                 ambit::Tensor L1a = Gamma1_.block("aa");
                 ambit::Tensor L1b = Gamma1_.block("AA");
@@ -422,11 +406,9 @@ std::vector<std::vector<double>> DSRG_MRPT2::compute_energy_xms() {
         }
 
         // prepare Heff
-        auto Heff = std::make_shared<psi::Matrix>(
-            "Heff " + multi_label[multi - 1] + " " + irrep_symbol[irrep], nstates, nstates);
-        auto Heff_sym = std::make_shared<psi::Matrix>(
-            "Heff (Symmetrized) " + multi_label[multi - 1] + " " + irrep_symbol[irrep], nstates,
-            nstates);
+        auto Heff = std::make_shared<psi::Matrix>("Heff " + state_label, nstates, nstates);
+        auto Heff_sym =
+            std::make_shared<psi::Matrix>("Heff (Symmetrized) " + state_label, nstates, nstates);
 
         // loop over states
         for (int M = 0; M < nstates; ++M) {
@@ -467,7 +449,7 @@ std::vector<std::vector<double>> DSRG_MRPT2::compute_energy_xms() {
                 if (N == M) {
                     continue;
                 } else {
-                    // compute transition densities
+                    // compute transition densities, one pair of states at a time
                     compute_rdms(fci_ints, p_space, civecs, M, N);
 
                     // compute coupling of <N|H|M>
@@ -505,11 +487,14 @@ std::vector<std::vector<double>> DSRG_MRPT2::compute_energy_xms() {
         U->eivprint(Ems);
 
         // fill in Edsrg_ms
+        auto& Eentry = Edsrg_ms.emplace_back();
         for (int i = 0; i < nstates; ++i) {
-            Edsrg_ms[n].push_back(Ems->get(i));
+            Eentry.push_back(Ems->get(i));
         }
     }
 
+    B_ = ambit::BlockedTensor();
+
     return Edsrg_ms;
 }
 
@@ -779,10 +764,10 @@ double DSRG_MRPT2::compute_ms_2nd_coupling(const std::string& name) {
     BlockedTensor H3 = BTF_->build(tensor_type_, "Heff3_2nd", spin_cases({"aaaaaa"}));
     H2_T2_C3(V_, T2_, 1.0, H3, true);
 
-    coupling += 1.0 / 36.0 * H3.block("aaaaaa")("uvwxyz") * rdms_->L3aaa()("xyzuvw");
-    coupling += 1.0 / 36.0 * H3.block("AAAAAA")("UVWXYZ") * rdms_->L3bbb()("XYZUVW");
-    coupling += 0.25 * H3.block("aaAaaA")("uvWxyZ") * rdms_->L3aab()("xyZuvW");
-    coupling += 0.25 * H3.block("aAAaAA")("uVWxYZ") * rdms_->L3abb()("xYZuVW");
+    coupling += 1.0 / 36.0 * H3.block("aaaaaa")("uvwxyz") * L3aaa_("xyzuvw");
+    coupling += 1.0 / 36.0 * H3.block("AAAAAA")("UVWXYZ") * L3bbb_("XYZUVW");
+    coupling += 0.25 * H3.block("aaAaaA")("uvWxyZ") * L3aab_("xyZuvW");
+    coupling += 0.25 * H3.block("aAAaAA")("uVWxYZ") * L3abb_("xYZuVW");
 
     outfile->Printf("  Done. Timing %15.6f s", timer.get());
     return coupling;
@@ -882,10 +867,10 @@ void DSRG_MRPT2::compute_cumulants(std::shared_ptr<ActiveSpaceIntegrals> fci_int
 
     // 3 cumulant
     if (do_cu3_) {
-        ambit::Tensor L3aaa = rdms_->L3aaa();
-        ambit::Tensor L3aab = rdms_->L3aab();
-        ambit::Tensor L3abb = rdms_->L3abb();
-        ambit::Tensor L3bbb = rdms_->L3bbb();
+        ambit::Tensor L3aaa = L3aaa_;
+        ambit::Tensor L3aab = L3aab_;
+        ambit::Tensor L3abb = L3abb_;
+        ambit::Tensor L3bbb = L3bbb_;
         ci_rdms.compute_3rdm(L3aaa.data(), L3aab.data(), L3abb.data(), L3bbb.data());
         rotate_3rdm(L3aaa, L3aab, L3abb, L3bbb);
 
@@ -977,10 +962,10 @@ void DSRG_MRPT2::compute_rdms(std::shared_ptr<ActiveSpaceIntegrals> fci_ints,
     rotate_2rdm(L2aa, L2ab, L2bb);
 
     // 3 density
-    ambit::Tensor L3aaa = rdms_->L3aaa();
-    ambit::Tensor L3aab = rdms_->L3aab();
-    ambit::Tensor L3abb = rdms_->L3abb();
-    ambit::Tensor L3bbb = rdms_->L3bbb();
+    ambit::Tensor L3aaa = L3aaa_;
+    ambit::Tensor L3aab = L3aab_;
+    ambit::Tensor L3abb = L3abb_;
+    ambit::Tensor L3bbb = L3bbb_;
     ci_rdms.compute_3rdm(L3aaa.data(), L3aab.data(), L3abb.data(), L3bbb.data());
     rotate_3rdm(L3aaa, L3aab, L3abb, L3bbb);
 }
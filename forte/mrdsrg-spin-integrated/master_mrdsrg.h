@@ -44,6 +44,11 @@ class MASTER_DSRG : public DynamicCorrelationSolver {
         throw std::runtime_error("The analytic gradient code is only implemented for DSRG-MRPT2.");
     }
 
+    /// Compute the multi-state (MS or XMS) energies
+    virtual double compute_energy_multi_state() {
+        throw std::runtime_error("MS and XMS are only implemented for DSRG-MRPT2.");
+    }
+
     /// Compute DSRG transformed Hamiltonian
     virtual std::shared_ptr<ActiveSpaceIntegrals> compute_Heff_actv();
 
@@ -174,6 +174,7 @@ void MRDSRG::print_options() {
         {"Correlation level", corrlv_string_},
         {"Integral type", ints_type_},
         {"Source operator", source_},
+        {"DIIS storage", diis_storage_},
         {"Adaptive DSRG flow type", foptions_->get_str("SMART_DSRG_S")},
         {"Reference relaxation", relax_ref_},
         {"DSRG transformation type", dsrg_trans_type_},
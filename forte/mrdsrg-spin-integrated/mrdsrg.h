@@ -38,6 +38,8 @@ class DIISManager;
 
 namespace forte {
 
+class DIISStore;
+
 class MRDSRG : public MASTER_DSRG {
     friend class MRSRG_ODEInt;
     friend class MRSRG_Print;
@@ -327,12 +329,16 @@ class MRDSRG : public MASTER_DSRG {
 
     /// Shared pointer of DIISManager object from Psi4
     std::shared_ptr<psi::DIISManager> diis_manager_;
+    /// Shared pointer of the Forte DIIS store that keeps the vectors on disk
+    std::shared_ptr<DIISStore> diis_store_;
     /// Initialize DIISManager
     void diis_manager_init();
     /// Add entry for DIISManager
     void diis_manager_add_entry();
     /// Extrapolate for DIISManager
     void diis_manager_extrapolate();
+    /// Number of vectors in the DIIS subspace
+    int diis_manager_subspace_size();
     /// Clean up for pointers used for DIIS
     void diis_manager_cleanup();
 
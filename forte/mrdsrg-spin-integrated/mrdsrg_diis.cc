@@ -27,8 +27,10 @@
  */
 
 #include "psi4/libdiis/diismanager.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
 #include "ambit/blocked_tensor.h"
 
+#include "helpers/diis_store.h"
 #include "mrdsrg.h"
 
 using namespace psi;
@@ -100,6 +102,12 @@ void MRDSRG::return_amp_diis(BlockedTensor& T1, const std::vector<std::string>&
 }
 
 void MRDSRG::diis_manager_init() {
+    if (diis_storage_ != "PSI4") {
+        diis_store_ = std::make_shared<DIISStore>(restart_file_prefix_, diis_max_vec_,
+                                                  diis_storage_ == "DISK_COMPRESSED");
+        return;
+    }
+
     diis_manager_ = std::make_shared<DIISManager>(diis_max_vec_, "MRDSRG DIIS",
                                                   DIISManager::RemovalPolicy::LargestError,
                                                   DIISManager::StoragePolicy::OnDisk);
@@ -109,11 +117,33 @@ void MRDSRG::diis_manager_init() {
     diis_manager_->set_vector_size(T1_, T2_);
 }
 
-void MRDSRG::diis_manager_add_entry() { diis_manager_->add_entry(DT1_, DT2_, T1_, T2_); }
+void MRDSRG::diis_manager_add_entry() {
+    if (diis_store_) {
+        diis_store_->add_entry(DT1_, DT2_, T1_, T2_);
+    } else {
+        diis_manager_->add_entry(DT1_, DT2_, T1_, T2_);
+    }
+}
 
-void MRDSRG::diis_manager_extrapolate() { diis_manager_->extrapolate(T1_, T2_); }
+void MRDSRG::diis_manager_extrapolate() {
+    if (diis_store_) {
+        if (not diis_store_->extrapolate(T1_, T2_)) {
+            outfile->Printf("\n    Warning: singular DIIS equations, skip extrapolation.");
+        }
+    } else {
+        diis_manager_->extrapolate(T1_, T2_);
+    }
+}
+
+int MRDSRG::diis_manager_subspace_size() {
+    return diis_store_ ? diis_store_->subspace_size() : diis_manager_->subspace_size();
+}
 
 void MRDSRG::diis_manager_cleanup() {
+    if (diis_store_) {
+        diis_store_.reset();
+        return;
+    }
     diis_manager_->reset_subspace();
     diis_manager_->delete_diis_file();
 }
@@ -779,7 +779,7 @@ double MRDSRG::compute_energy_ldsrg2() {
             outfile->Printf("  S");
 
             if ((cycle - diis_start_) % diis_freq_ == 0 and
-                diis_manager_->subspace_size() >= diis_min_vec_) {
+                diis_manager_subspace_size() >= diis_min_vec_) {
                 diis_manager_extrapolate();
                 outfile->Printf("/E");
             }
@@ -1062,7 +1062,7 @@ double MRDSRG::compute_energy_ldsrg2_qc() {
             outfile->Printf("  S");
 
             if ((cycle - diis_start_) % diis_freq_ == 0 and
-                diis_manager_->subspace_size() >= diis_min_vec_) {
+                diis_manager_subspace_size() >= diis_min_vec_) {
                 diis_manager_extrapolate();
                 outfile->Printf("/E");
             }
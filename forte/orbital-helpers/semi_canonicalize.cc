@@ -151,7 +151,9 @@ void SemiCanonical::semicanonicalize(std::shared_ptr<RDMs> rdms, const bool& bui
     bool already_semi = check_orbitals(rdms, nat_orb);
     build_transformation_matrices(already_semi);
     if (transform and (not already_semi)) {
-        ints_->rotate_orbitals(Ua_, Ub_);
+        // rotate the stored integrals in place (falls back to a new integral transformation if
+        // the integral class does not support it)
+        ints_->rotate_integrals(Ua_, Ub_);
         rdms->rotate(Ua_t_, Ub_t_);
     }
     if (print_)
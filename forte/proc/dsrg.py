@@ -92,6 +92,9 @@ class ProcedureDSRG:
 
         self.save_relax_energies = options.get_bool("DSRG_DUMP_RELAXED_ENERGIES")
 
+        # warm start the active space solver from the previous CI solution during relaxation
+        self.relax_warm_start = options.get_bool("RELAX_WARM_START")
+
         # Filter out levels for analytic gradients
         if options.get_str("DERTYPE") != "NONE":
             if self.relax_ref != "NONE" or self.solver_type != "DSRG-MRPT2":
@@ -99,8 +102,13 @@ class ProcedureDSRG:
 
         # Filter out some ms-dsrg algorithms
         ms_dsrg_algorithm = options.get_str("DSRG_MULTI_STATE")
-        if self.do_multi_state and ("SA" not in ms_dsrg_algorithm):
-            raise NotImplementedError("MS or XMS is disabled due to the reconstruction.")
+        self.do_ms_xms = self.do_multi_state and ("SA" not in ms_dsrg_algorithm)
+        if self.do_ms_xms:
+            if self.solver_type != "DSRG-MRPT2":
+                raise NotImplementedError("MS or XMS is only available for DSRG-MRPT2.")
+            # the reference states are not relaxed in MS/XMS
+            self.relax_ref = "NONE"
+            self.relax_maxiter = 0
         if ms_dsrg_algorithm == "SA_SUB" and self.relax_ref != "ONCE":
             raise NotImplementedError("SA_SUB only supports relax once at present. Relaxed SA density not implemented.")
         self.multi_state_type = ms_dsrg_algorithm
@@ -206,6 +214,12 @@ class ProcedureDSRG:
         self.make_dsrg_solver()
         self.dsrg_setup()
         psi4.core.print_out(f"\n  =>** Before self.dsrg_solver.compute_energy() **<=\n")
+        if self.do_ms_xms:
+            # MS/XMS: build and diagonalize the effective Hamiltonian of the reference states
+            e_dsrg = self.dsrg_solver.compute_energy_multi_state()
+            self.dsrg_cleanup()
+            psi4.core.set_scalar_variable("CURRENT ENERGY", e_dsrg)
+            return e_dsrg
         e_dsrg = self.dsrg_solver.compute_energy()
         psi4.core.set_scalar_variable("UNRELAXED ENERGY", e_dsrg)
 
@@ -232,7 +246,13 @@ class ProcedureDSRG:
 
             if self.options.get_str("ACTIVE_SPACE_SOLVER") == "EXTERNAL":
                 state_map = forte.to_state_nroots_map(self.state_weights_map)
-                write_external_active_space_file(ints_dressed, state_map, self.mo_space_info, "dsrg_ints.json")
+                write_external_active_space_file(
+                    ints_dressed,
+                    state_map,
+                    self.mo_space_info,
+                    "dsrg_ints.json",
+                    self.options.get_str("EXTERNAL_FORMAT"),
+                )
                 msg = "External solver: save DSRG dressed integrals to dsrg_ints.json"
                 print(msg)
                 psi4.core.print_out(msg)
@@ -253,7 +273,13 @@ class ProcedureDSRG:
 
             if self.do_multi_state and self.options.get_bool("SAVE_SA_DSRG_INTS"):
                 state_map = forte.to_state_nroots_map(self.state_weights_map)
-                write_external_active_space_file(ints_dressed, state_map, self.mo_space_info, "dsrg_ints.json")
+                write_external_active_space_file(
+                    ints_dressed,
+                    state_map,
+                    self.mo_space_info,
+                    "dsrg_ints.json",
+                    self.options.get_str("EXTERNAL_FORMAT"),
+                )
                 msg = "\n\nSave SA-DSRG dressed integrals to dsrg_ints.json\n\n"
                 print(msg)
                 psi4.core.print_out(msg)
@@ -268,6 +294,9 @@ class ProcedureDSRG:
 
             # Call the active space solver using the dressed integrals
             self.active_space_solver.set_active_space_integrals(ints_dressed)
+            # the dressed integrals are expressed in the original basis, so the previous CI vectors
+            # (and all the integral-independent intermediates) are a good starting point
+            self.active_space_solver.set_warm_start(self.relax_warm_start)
             # pass to the active space solver the unitary transformation between the original basis
             # and the current semi-canonical basis
             self.active_space_solver.set_Uactv(self.Ua, self.Ub)
@@ -346,6 +375,7 @@ class ProcedureDSRG:
             e_dsrg = self.dsrg_solver.compute_energy()
 
         self.dsrg_cleanup()
+        self.active_space_solver.set_warm_start(False)
 
         # dump reference relaxation energies to json file
         if self.save_relax_energies:
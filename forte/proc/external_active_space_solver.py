@@ -2,6 +2,7 @@
 # -*- coding: utf-8 -*-
 
 import json
+import os
 import psi4
 import forte
 import numpy as np
@@ -41,7 +42,22 @@ def read_wavefunction(data):
     data.psi_wfn.Cb().copy(C_mat)
 
 
-def write_external_active_space_file(as_ints, state_map, mo_space_info, json_file="forte_ints.json"):
+def write_external_active_space_file(
+    as_ints, state_map, mo_space_info, json_file="forte_ints.json", file_format="JSON"
+):
+    """
+    Write the active space integrals for an external solver
+
+    Parameters
+    ----------
+    json_file: str
+        The name of the json file
+    file_format: str
+        The format of the integrals. With JSON the integrals are stored in json_file as lists of
+        tuples in the spin-orbital basis. With NPY json_file only contains a header and the integrals
+        are stored as dense spin-blocked arrays in NumPy .npy files (e.g., forte_ints_tei_ab.npy),
+        which can be memory mapped with np.load(filename, mmap_mode="r")
+    """
     ndocc = mo_space_info.size("INACTIVE_DOCC")
 
     for state, nroots in state_map.items():
@@ -73,6 +89,10 @@ def write_external_active_space_file(as_ints, state_map, mo_space_info, json_fil
             "description": "scalar energy (sum of nuclear repulsion, frozen core, and scalar contributions",
         }
 
+        if file_format == "NPY":
+            _write_npy_integrals(as_ints, file, json_file)
+            continue
+
         oei_a = [(i * 2, j * 2, as_ints.oei_a(i, j)) for i in range(nmo) for j in range(nmo)]
         oei_b = [(i * 2 + 1, j * 2 + 1, as_ints.oei_b(i, j)) for i in range(nmo) for j in range(nmo)]
 
@@ -101,6 +121,28 @@ def write_external_active_space_file(as_ints, state_map, mo_space_info, json_fil
         # make_hamiltonian(as_ints,state)
 
 
+def _write_npy_integrals(as_ints, file, json_file):
+    """Store the integrals as .npy arrays and write the header to json_file"""
+    prefix = os.path.splitext(json_file)[0]
+
+    file["format"] = {"data": "npy", "description": "integrals stored as dense .npy arrays (C order, <f8)"}
+
+    arrays = {
+        "oei_a": (as_ints.oei_a_array(), "alpha one-electron integrals <p|h|q>"),
+        "oei_b": (as_ints.oei_b_array(), "beta one-electron integrals <p|h|q>"),
+        "tei_aa": (as_ints.tei_aa_array(), "alpha-alpha antisymmetrized two-electron integrals <pq||rs>"),
+        "tei_ab": (as_ints.tei_ab_array(), "alpha-beta two-electron integrals <pq|rs> (p,r alpha; q,s beta)"),
+        "tei_bb": (as_ints.tei_bb_array(), "beta-beta antisymmetrized two-electron integrals <pq||rs>"),
+    }
+    for key, (array, description) in arrays.items():
+        filename = f"{prefix}_{key}.npy"
+        np.save(filename, np.ascontiguousarray(array, dtype="<f8"))
+        file[key] = {"file": filename, "shape": list(array.shape), "description": description}
+
+    with open(json_file, "w+") as f:
+        json.dump(file, f, sort_keys=True, indent=2)
+
+
 def make_hamiltonian(as_ints, state_map):
     import itertools
 
@@ -1,7 +1,7 @@
 # -*- coding: utf-8 -*-
 
 
-active_space_solvers = ["FCI", "GENCI", "ACI", "ASCI", "PCI", "DETCI", "CAS", "DMRG", "EXTERNAL"]
+active_space_solvers = ["FCI", "GENCI", "ACI", "ASCI", "PCI", "DETCI", "CAS", "DMRG", "EXTERNAL", "V2RDM"]
 
 
 def register_forte_options(options):
@@ -31,6 +31,7 @@ def register_forte_options(options):
     register_psi_options(options)
     register_gas_options(options)
     register_dmrg_options(options)
+    register_v2rdm_options(options)
 
 
 def register_driver_options(options):
@@ -109,6 +110,13 @@ def register_driver_options(options):
         "Perform one relaxation step after building the DSRG effective Hamiltonian when using `external` active space solver",
     )
 
+    options.add_str(
+        "EXTERNAL_FORMAT",
+        "JSON",
+        ["JSON", "NPY"],
+        "File format of the integrals written for the `external` active space solver (NPY = json header + .npy arrays)",
+    )
+
     options.add_str(
         "EXT_RELAX_SOLVER",
         "FCI",
@@ -425,9 +433,22 @@ def register_pci_options(options):
 def register_fci_options(options):
     options.set_group("FCI")
     options.add_bool("FCI_TEST_RDMS", False, "Test the FCI reduced density matrices?")
+    options.add_int(
+        "FCI_LISTS_MAX_MEMORY",
+        1024,
+        "The maximum memory (in MB) used to store each of the alpha and beta VVOO and 3-hole string lists of the"
+        " FCI solver. Lists that exceed this value are not stored and are generated on the fly (not used by GENCI)",
+    )
     options.add_bool("PRINT_NO", False, "Print the NO from the rdm of FCI")
     options.add_bool("CI_SPIN_ADAPT", False, "Spin-adapt the CI wavefunction?")
     options.add_bool("CI_SPIN_ADAPT_FULL_PRECONDITIONER", False, "Use full preconditioner for spin-adapted CI?")
+    options.add_bool(
+        "CI_SPIN_ADAPT_CSF_SIGMA",
+        False,
+        "Compute the sigma vector directly in the CSF basis by contracting the integrals with CSF coupling"
+        " coefficients precomputed for each pair of configurations, without storing the Hamiltonian"
+        " (spin-adapted selected CI/DETCI only)",
+    )
 
 
 def register_sci_options(options):
@@ -628,7 +649,10 @@ def register_tdci_options(options):
             "LANCZOS",
             "EXACT_SELECT",
             "RK4_SELECT",
+            "RK4_LIST",
             "RK4_SELECT_LIST",
+            "LANCZOS_LIST",
+            "LANCZOS_SELECT_LIST",
             "ALL",
         ],
         "Type of propagator",
@@ -646,6 +670,10 @@ def register_tdci_options(options):
 
     options.add_int("TDCI_KRYLOV_DIM", 5, "Dimension of Krylov subspace for Lanczos method")
 
+    options.add_double(
+        "TDCI_KRYLOV_CONVERGENCE", 1e-10, "Error threshold of a time step for the LANCZOS_LIST propagators"
+    )
+
     options.add_double("TDCI_ETA_P", 1e-12, "Path filtering threshold for P space")
 
     options.add_double("TDCI_ETA_PQ", 1e-12, "Path filtering threshold for Q space")
@@ -754,6 +782,16 @@ def register_dsrg_options(options):
 
     options.add_int("DSRG_MAXITER", 50, "Max iterations for nonperturbative" " MR-DSRG amplitudes update")
 
+    options.add_int(
+        "DSRG_ZVEC_KRYLOV_DIM", 30, "Max number of Krylov vectors before restarting the DSRG-MRPT2 z-vector solver"
+    )
+
+    options.add_int("DSRG_ZVEC_MAXITER", 500, "Max iterations for solving the DSRG-MRPT2 z-vector equations")
+
+    options.add_double(
+        "DSRG_ZVEC_R_CONVERGENCE", 1.0e-10, "Residual convergence criterion for the DSRG-MRPT2 z-vector equations"
+    )
+
     options.add_double("R_CONVERGENCE", 1.0e-6, "Residue convergence criteria for amplitudes")
 
     options.add_str("RELAX_REF", "NONE", ["NONE", "ONCE", "TWICE", "ITERATE"], "Relax the reference for MR-DSRG")
@@ -762,6 +800,13 @@ def register_dsrg_options(options):
 
     options.add_double("RELAX_E_CONVERGENCE", 1.0e-8, "The energy relaxation convergence criterion")
 
+    options.add_bool(
+        "RELAX_WARM_START",
+        True,
+        "Warm start the active space solver from the previous CI solution during reference relaxation"
+        " (reuse string lists and determinant spaces, and use the previous CI vectors as guess)",
+    )
+
     options.add_bool(
         "DSRG_DUMP_RELAXED_ENERGIES", False, "Dump the energies after each reference relaxation step to JSON."
     )
@@ -880,6 +925,19 @@ def register_dsrg_options(options):
 
     options.add_bool("DSRG_NIVO", False, "NIVO approximation: Omit tensor blocks with >= 3 virtual indices if true")
 
+    options.add_bool(
+        "DSRG_LDSRG2_BATCHED",
+        False,
+        "Keep only hhpp blocks of LDSRG(2) Hbar2; tile [H2, T2] blocks with 3 virtuals if short of memory",
+    )
+
+    options.add_int(
+        "DSRG_LDSRG2_BATCH_NVIRT",
+        0,
+        "Max virtuals per batch of the tiled [H2, T2] blocks of DSRG_LDSRG2_BATCHED (0: from DSRG_MEM;"
+        " > 0: always tile, for debugging)",
+    )
+
     options.add_bool("PRINT_1BODY_EVALS", False, "Print eigenvalues of 1-body effective H")
 
     options.add_bool("DSRG_MRPT3_BATCHED", False, "Force running the DSRG-MRPT3 code using the batched algorithm")
@@ -896,6 +954,13 @@ def register_dsrg_options(options):
 
     options.add_int("DSRG_DIIS_MAX_VEC", 8, "Maximum size of DIIS vectors")
 
+    options.add_str(
+        "DSRG_DIIS_STORAGE",
+        "PSI4",
+        ["PSI4", "DISK", "DISK_COMPRESSED"],
+        "Storage of DSRG DIIS vectors: Psi4 DIISManager or Forte store keeping only the B matrix in memory",
+    )
+
     options.add_bool("DSRG_RESTART_AMPS", True, "Restart DSRG amplitudes from a previous step")
 
     options.add_bool("DSRG_READ_AMPS", False, "Read initial amplitudes from the current directory")
@@ -1062,8 +1127,32 @@ def register_casscf_options(options):
         "Ways to compute the orthogonal transformation U from orbital rotation R",
     )
 
+    options.add_bool(
+        "CASSCF_INCREMENTAL_TEI",
+        False,
+        "Update the (pu|xy) integrals by rotating those of the last full transformation when the orbital step is small",
+    )
+    options.add_double(
+        "CASSCF_INCREMENTAL_TEI_THRESHOLD",
+        1.0e-4,
+        "Max norm of the active-inactive orbital rotation (since the last full transformation) for incremental updates",
+    )
+    options.add_int(
+        "CASSCF_INCREMENTAL_TEI_MAXITER", 10, "Max number of incremental updates between full integral transformations"
+    )
+
     options.add_str(
-        "ORB_ROTATION_ALGORITHM", "DIAGONAL", ["DIAGONAL", "AUGMENTED_HESSIAN"], "Orbital rotation algorithm"
+        "ORB_ROTATION_ALGORITHM",
+        "DIAGONAL",
+        ["DIAGONAL", "AUGMENTED_HESSIAN"],
+        "Orbital rotation algorithm (DIAGONAL: L-BFGS micro iterations, AUGMENTED_HESSIAN: second-order trust region)",
+    )
+    options.add_int(
+        "CASSCF_AH_MAXITER", 20, "Max number of Davidson iterations to solve the augmented Hessian equations"
+    )
+    options.add_double("CASSCF_AH_TRUST_RADIUS", 0.4, "Initial trust radius for the augmented Hessian steps")
+    options.add_bool(
+        "CASSCF_AH_CI_COUPLING", True, "Include the CI-orbital coupling in the augmented Hessian (DETCI solver only)"
     )
 
     options.add_bool("CASSCF_DO_DIIS", True, "Use DIIS in CASSCF orbital optimization")
@@ -1183,6 +1272,29 @@ def register_dmrg_options(options):
     options.add_bool(
         "DMRG_PRINT_CORR", False, "Whether or not to print the correlation functions after the DMRG calculation"
     )
+    options.add_bool(
+        "DMRG_RESTART",
+        True,
+        "Restart repeated DMRG calculations (e.g., MCSCF macroiterations) from the previous MPS,"
+        " running only the last sweep instruction and computing the RDMs along with the energy",
+    )
+
+
+def register_v2rdm_options(options):
+    options.set_group("V2RDM")
+    options.add_str(
+        "WRITE_DENSITY_TYPE",
+        "NONE",
+        ["NONE", "DENSITY", "CUMULANT"],
+        "Write the v2RDM densities or cumulants to text files",
+    )
+    options.add_bool("AVG_DENS_SPIN", False, "Average the alpha and beta densities read from v2RDM-CASSCF")
+    options.add_bool(
+        "V2RDM_CACHE_RDMS",
+        False,
+        "Cache the active-space RDMs read from v2RDM-CASSCF in v2rdm_rdms.bin and reuse them in later runs"
+        " (the cache is rebuilt when the v2RDM files change)",
+    )
 
 
 #    //////////////////////////////////////////////////////////////
@@ -1326,14 +1438,6 @@ def register_dmrg_options(options):
 #    /*- The density convergence criterion -*/
 #    options.add_double("D_CONVERGENCE", 1.0e-8)
 
-#    //////////////////////////////////////////////////////////////
-#    ///         OPTIONS FOR THE V2RDM INTERFACE
-#    //////////////////////////////////////////////////////////////
-#    /*- Write Density Matrices or Cumulants to File -*/
-#    options.add_str("WRITE_DENSITY_TYPE", "NONE", "NONE DENSITY CUMULANT")
-#    /*- Average densities of different spins in V2RDM -*/
-#    options.add_bool("AVG_DENS_SPIN", False)
-
 #    //////////////////////////////////////////////////////////////
 #    ///              OPTIONS FOR THE MR-DSRG MODULE
 #    //////////////////////////////////////////////////////////////
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
@@ -77,10 +78,16 @@ double DETCI::compute_energy() {
     print_h2("General Determinant-Based CI Solver");
 
     // build determinants
-    build_determinant_space();
+    // when warm starting we keep the determinant space and use the previous solution as guess
+    const bool restart = warm_start_ and (p_space_.size() > 0) and (evecs_ != nullptr);
+    if (restart) {
+        set_guess_from_previous_solution();
+    } else {
+        build_determinant_space();
+    }
 
     // diagonalize Hamiltonian
-    diagonalize_hamiltonian();
+    diagonalize_hamiltonian(restart);
 
     // compute 1RDMs
     compute_1rdms();
@@ -101,21 +108,24 @@ double DETCI::compute_energy() {
 }
 
 void DETCI::build_determinant_space() {
-    std::vector<Determinant> dets;
-
     CI_Reference ci_ref(scf_info_, options_, mo_space_info_, as_ints_, multiplicity_, twice_ms_,
                         wfn_irrep_, state_);
     if (actv_space_type_ == "GAS") {
-        ci_ref.build_gas_reference(dets);
-    } else if (actv_space_type_ == "DOCI") {
-        ci_ref.build_doci_reference(dets);
+        // GAS and CAS spaces are streamed directly into the (preallocated) hash vector
+        ci_ref.build_gas_reference(p_space_);
     } else if (actv_space_type_ == "CAS") {
-        ci_ref.build_cas_reference_full(dets);
+        ci_ref.build_cas_reference_full(p_space_);
     } else {
-        ci_ref.build_ci_reference(dets, !exclude_hf_in_cid_);
+        std::vector<Determinant> dets;
+        if (actv_space_type_ == "DOCI") {
+            ci_ref.build_doci_reference(dets);
+        } else {
+            ci_ref.build_ci_reference(dets, !exclude_hf_in_cid_);
+        }
+        p_space_ = DeterminantHashVec(dets);
     }
 
-    auto size = dets.size();
+    auto size = p_space_.size();
     if (size == 0) {
         outfile->Printf("\n  No determinant found that matches the state requested!");
         outfile->Printf("\n  Please check the input (symmetry, multiplicity, etc.)!");
@@ -126,18 +136,30 @@ void DETCI::build_determinant_space() {
 
     if (print_ >= PrintLevel::Debug) {
         print_h2("Determinants");
-        for (const auto& det : dets) {
+        for (const auto& det : p_space_) {
             outfile->Printf("\n  %s", str(det, nactv_).c_str());
         }
     }
     if (print_ >= PrintLevel::Default) {
         outfile->Printf("\n  Number of determinants (%s): %zu", actv_space_type_.c_str(), size);
     }
+}
 
-    p_space_ = DeterminantHashVec(dets);
+void DETCI::set_guess_from_previous_solution() {
+    initial_guess_.clear();
+    const size_t ndets = p_space_.size();
+    for (size_t n = 0; n < nroot_; ++n) {
+        std::vector<std::pair<size_t, double>> guess;
+        for (size_t I = 0; I < ndets; ++I) {
+            if (const double c = evecs_->get(I, n); std::fabs(c) > 1.0e-12) {
+                guess.emplace_back(I, c);
+            }
+        }
+        initial_guess_.push_back(guess);
+    }
 }
 
-void DETCI::diagonalize_hamiltonian() {
+void DETCI::diagonalize_hamiltonian(bool restart) {
     timer tdiag("Diagonalize CI Hamiltonian");
     energies_ = std::vector<double>(nroot_);
 
@@ -149,7 +171,11 @@ void DETCI::diagonalize_hamiltonian() {
         sigma_vector_type_ = SigmaVectorType::Full;
     }
 
-    sigma_vector_ = make_sigma_vector(p_space_, as_ints_, sigma_max_memory_, sigma_vector_type_);
+    // when restarting, the sigma vector object is reused if only its integrals need to be updated
+    if (not(restart and sigma_vector_ and sigma_vector_->update_integrals(as_ints_))) {
+        sigma_vector_ =
+            make_sigma_vector(p_space_, as_ints_, sigma_max_memory_, sigma_vector_type_);
+    }
     std::tie(evals_, evecs_) =
         solver->diagonalize_hamiltonian(p_space_, sigma_vector_, nroot_, multiplicity_);
 
@@ -800,6 +826,11 @@ void DETCI::generalized_rdms(size_t root, const std::vector<double>& X, ambit::B
 }
 
 void DETCI::generalized_sigma(std::shared_ptr<psi::Vector> x, std::shared_ptr<psi::Vector> sigma) {
+    // the integrals may have been changed after the last diagonalization
+    if (sigma_vector_->as_ints() != as_ints_) {
+        sigma_vector_ =
+            make_sigma_vector(p_space_, as_ints_, sigma_max_memory_, sigma_vector_type_);
+    }
     sigma_vector_->compute_sigma(sigma, x);
 }
 
@@ -74,6 +74,9 @@ class DETCI : public ActiveSpaceMethod {
     /// Return the CI wave functions for current state symmetry
     std::shared_ptr<psi::Matrix> ci_wave_functions() override { return evecs_; }
 
+    /// Return the determinants of the CI wave functions
+    DeterminantHashVec ci_determinants() override { return p_space_; }
+
     /// Set options override
     void set_options(std::shared_ptr<ForteOptions> options) override;
 
@@ -147,7 +150,11 @@ class DETCI : public ActiveSpaceMethod {
     std::vector<std::vector<std::pair<size_t, double>>> projected_roots_;
 
     /// Diagonalize the Hamiltonian
-    void diagonalize_hamiltonian();
+    /// @param restart reuse the determinant space and the sigma vector of the previous call
+    void diagonalize_hamiltonian(bool restart = false);
+
+    /// Use the CI vectors of the previous call to compute_energy() as initial guess
+    void set_guess_from_previous_solution();
     /// Prepare Davidson-Liu solver
     std::shared_ptr<SparseCISolver> prepare_ci_solver();
 
@@ -73,7 +73,8 @@ double TDCI::compute_energy() {
     std::string propagate_type = options_->get_str("TDCI_PROPAGATOR");
 
     if ((propagate_type == "EXACT_SELECT") or (propagate_type == "RK4_SELECT") or
-        (propagate_type == "RK4_LIST") or (propagate_type == "RK4_SELECT_LIST")) {
+        (propagate_type == "RK4_LIST") or (propagate_type == "RK4_SELECT_LIST") or
+        (propagate_type == "LANCZOS_LIST") or (propagate_type == "LANCZOS_SELECT_LIST")) {
 
         build_full_H = false;
     }
@@ -108,9 +109,10 @@ double TDCI::compute_energy() {
     outfile->Printf("\n  Number of cationic determinants: %zu", ann_dets_.size());
 
     // 3. Build the full n-1 Hamiltonian if not screening
-    std::vector<std::string> det_str(nann);
-    SharedMatrix full_aH = std::make_shared<psi::Matrix>("aH", nann, nann);
+    SharedMatrix full_aH;
     if (build_full_H) {
+        std::vector<std::string> det_str(nann);
+        full_aH = std::make_shared<psi::Matrix>("aH", nann, nann);
         for (size_t I = 0; I < nann; ++I) {
             Determinant detI = ann_dets_.get_det(I);
             det_str[I] = str(detI, nact).c_str();
@@ -165,12 +167,12 @@ double TDCI::compute_energy() {
         propagate_taylor2(core_coeffs, full_aH);
     } else if (propagate_type == "RK4") {
         propagate_RK4(core_coeffs, full_aH);
-    } else if (propagate_type == "RK4_LIST") {
+    } else if (propagate_type == "RK4_LIST" or propagate_type == "LANCZOS_LIST") {
         propagate_list(core_coeffs);
     } else if (propagate_type == "LANCZOS") {
         propagate_lanczos(core_coeffs, full_aH);
     } else if (propagate_type == "EXACT_SELECT" or propagate_type == "RK4_SELECT" or
-               propagate_type == "RK4_SELECT_LIST") {
+               propagate_type == "RK4_SELECT_LIST" or propagate_type == "LANCZOS_SELECT_LIST") {
         compute_tdci_select(core_coeffs);
     } else if (propagate_type == "ALL") {
         propagate_exact(core_coeffs, full_aH);
@@ -223,22 +225,26 @@ void TDCI::propagate_list(std::shared_ptr<psi::Vector> C0) {
     op.op_s_lists(ann_dets_);
     op.tp_s_lists(ann_dets_);
 
+    bool lanczos = options_->get_str("TDCI_PROPAGATOR") == "LANCZOS_LIST";
+    std::string prefix = lanczos ? "lanczos_list_" : "rk4_list_";
+    size_t nsubstep = 0;
+
     // Begin the timesteps
     for (int N = 0; N < nstep; ++N) {
 
-        //    if (options_->get_str("TDCI_PROPAGATOR") == "RK4_LIST") {
-        propagate_RK4_list(PQ_coeffs_r, PQ_coeffs_i, ann_dets_, op, dt);
-        //    } else if (options_->get_str("TDCI_PROPAGATOR") == "LANCZOS_LIST") {
-        //        propagate_lanczos_list(PQ_coeffs_r, PQ_coeffs_i, PQ_space, dt);
-        //    }
+        if (lanczos) {
+            nsubstep += propagate_lanczos_list(PQ_coeffs_r, PQ_coeffs_i, ann_dets_, op, dt);
+        } else {
+            propagate_RK4_list(PQ_coeffs_r, PQ_coeffs_i, ann_dets_, op, dt);
+        }
 
         if (std::fabs((time / conv) - round(time / conv)) <= 1e-8) {
             outfile->Printf("\n t = %1.3f as", time / conv);
             if (options_->get_bool("TDCI_PRINT_WFN")) {
                 std::stringstream ss;
                 ss << std::fixed << std::setprecision(3) << time / conv;
-                save_vector(PQ_coeffs_r, "rk4_list_" + ss.str() + "_r.txt");
-                save_vector(PQ_coeffs_i, "rk4_list_" + ss.str() + "_i.txt");
+                save_vector(PQ_coeffs_r, prefix + ss.str() + "_r.txt");
+                save_vector(PQ_coeffs_i, prefix + ss.str() + "_i.txt");
             }
             //  std::vector<double> occ = compute_occupation(ct_r, ct_i, orbs);
             std::vector<double> occ = compute_occupation(ann_dets_, PQ_coeffs_r, PQ_coeffs_i, orbs);
@@ -253,6 +259,9 @@ void TDCI::propagate_list(std::shared_ptr<psi::Vector> C0) {
         save_vector(occupations_[i], "occupations_" + std::to_string(orbs[i]) + ".txt");
     }
 
+    if (lanczos) {
+        outfile->Printf("\n Number of Lanczos substeps: %zu", nsubstep);
+    }
     outfile->Printf("\n Time spent propagating: %1.6f s", t1.get());
 }
 
@@ -1279,6 +1288,14 @@ void TDCI::compute_tdci_select(std::shared_ptr<psi::Vector> C0) {
             op.op_s_lists(PQ_space);
             op.tp_s_lists(PQ_space);
             propagate_RK4_list(PQ_coeffs_r, PQ_coeffs_i, PQ_space, op, dt);
+        } else if (options_->get_str("TDCI_PROPAGATOR") == "LANCZOS_SELECT_LIST") {
+            DeterminantSubstitutionLists op(as_ints_->active_mo_symmetry());
+            op.set_quiet_mode(true);
+
+            op.build_strings(PQ_space);
+            op.op_s_lists(PQ_space);
+            op.tp_s_lists(PQ_space);
+            propagate_lanczos_list(PQ_coeffs_r, PQ_coeffs_i, PQ_space, op, dt);
         }
 
         //        outfile->Printf("\n  propagate: %1.6f", prop.get());
@@ -1987,6 +2004,140 @@ void TDCI::propagate_RK4_list(std::vector<double>& PQ_coeffs_r, std::vector<doub
     // outfile->Printf("\n  Time spent propagating (RK4): %1.6f", total.get());
 }
 
+namespace {
+/// Compute y = exp(-i T tau) e1 for the real symmetric tridiagonal Lanczos matrix T
+void krylov_exponential(const std::vector<double>& alpha, const std::vector<double>& beta,
+                        size_t m, double tau, std::vector<double>& y_r, std::vector<double>& y_i) {
+    auto T = std::make_shared<psi::Matrix>("T", m, m);
+    for (size_t k = 0; k < m; ++k) {
+        T->set(k, k, alpha[k]);
+        if (k + 1 < m) {
+            T->set(k, k + 1, beta[k]);
+            T->set(k + 1, k, beta[k]);
+        }
+    }
+    auto evecs = std::make_shared<psi::Matrix>("evecs", m, m);
+    auto evals = std::make_shared<psi::Vector>("evals", m);
+    T->diagonalize(evecs, evals);
+
+    y_r.assign(m, 0.0);
+    y_i.assign(m, 0.0);
+    for (size_t l = 0; l < m; ++l) {
+        double phase = evals->get(l) * tau;
+        double c0 = evecs->get(0, l);
+        for (size_t k = 0; k < m; ++k) {
+            double v = evecs->get(k, l) * c0;
+            y_r[k] += v * std::cos(phase);
+            y_i[k] -= v * std::sin(phase);
+        }
+    }
+}
+} // namespace
+
+size_t TDCI::propagate_lanczos_list(std::vector<double>& PQ_coeffs_r,
+                                    std::vector<double>& PQ_coeffs_i, DeterminantHashVec& PQ_space,
+                                    DeterminantSubstitutionLists& op, double dt) {
+    const size_t npq = PQ_space.size();
+    const size_t max_dim = std::max(options_->get_int("TDCI_KRYLOV_DIM"), 2);
+    const double econv = options_->get_double("TDCI_KRYLOV_CONVERGENCE");
+
+    // Since H is real and symmetric, all the Lanczos coefficients are real and only the real part
+    // of the Hermitian products <x|y> is needed
+    auto dot = [npq](const std::vector<double>& xr, const std::vector<double>& xi,
+                     const std::vector<double>& yr, const std::vector<double>& yi) {
+        double value = 0.0;
+#pragma omp parallel for reduction(+ : value)
+        for (size_t I = 0; I < npq; ++I) {
+            value += xr[I] * yr[I] + xi[I] * yi[I];
+        }
+        return value;
+    };
+    auto axpy = [npq](double a, const std::vector<double>& xr, const std::vector<double>& xi,
+                      std::vector<double>& yr, std::vector<double>& yi) {
+#pragma omp parallel for
+        for (size_t I = 0; I < npq; ++I) {
+            yr[I] += a * xr[I];
+            yi[I] += a * xi[I];
+        }
+    };
+
+    std::vector<std::vector<double>> Q_r(max_dim, std::vector<double>(npq));
+    std::vector<std::vector<double>> Q_i(max_dim, std::vector<double>(npq));
+    std::vector<double> w_r(npq), w_i(npq);
+    std::vector<double> alpha, beta, y_r, y_i;
+
+    size_t nsubstep = 0;
+    double t_left = dt;
+    while (t_left > 1.0e-12 * dt) {
+        // q0 = c / |c|
+        double norm = std::sqrt(dot(PQ_coeffs_r, PQ_coeffs_i, PQ_coeffs_r, PQ_coeffs_i));
+#pragma omp parallel for
+        for (size_t I = 0; I < npq; ++I) {
+            Q_r[0][I] = PQ_coeffs_r[I] / norm;
+            Q_i[0][I] = PQ_coeffs_i[I] / norm;
+        }
+
+        // Build the Krylov space until the error of the step over t_left is below threshold
+        alpha.clear();
+        beta.clear();
+        double tau = t_left;
+        double error = 0.0;
+        size_t m = 0;
+        for (size_t j = 0; j < max_dim; ++j) {
+            std::fill(w_r.begin(), w_r.end(), 0.0);
+            std::fill(w_i.begin(), w_i.end(), 0.0);
+            complex_sigma_build(w_r, w_i, Q_r[j], Q_i[j], PQ_space, op);
+
+            alpha.push_back(dot(Q_r[j], Q_i[j], w_r, w_i));
+
+            // full reorthogonalization against the Krylov vectors
+            for (size_t i = 0; i <= j; ++i) {
+                axpy(-dot(Q_r[i], Q_i[i], w_r, w_i), Q_r[i], Q_i[i], w_r, w_i);
+            }
+            beta.push_back(std::sqrt(dot(w_r, w_i, w_r, w_i)));
+            m = j + 1;
+
+            // a posteriori error estimate: beta_m |<e_m|exp(-i T tau)|e_1>|
+            krylov_exponential(alpha, beta, m, tau, y_r, y_i);
+            error = beta[j] * std::sqrt(y_r[j] * y_r[j] + y_i[j] * y_i[j]);
+            if (error < econv) {
+                break;
+            }
+
+            if (j + 1 < max_dim) {
+#pragma omp parallel for
+                for (size_t I = 0; I < npq; ++I) {
+                    Q_r[j + 1][I] = w_r[I] / beta[j];
+                    Q_i[j + 1][I] = w_i[I] / beta[j];
+                }
+            }
+        }
+
+        // The Krylov space is not large enough for t_left, shorten the step
+        for (int n = 0; error >= econv and n < 60; ++n) {
+            tau *= 0.5;
+            krylov_exponential(alpha, beta, m, tau, y_r, y_i);
+            error = beta[m - 1] * std::sqrt(y_r[m - 1] * y_r[m - 1] + y_i[m - 1] * y_i[m - 1]);
+        }
+
+        // c(t + tau) = |c| Q exp(-i T tau) e1
+#pragma omp parallel for
+        for (size_t I = 0; I < npq; ++I) {
+            double cr = 0.0, ci = 0.0;
+            for (size_t k = 0; k < m; ++k) {
+                cr += y_r[k] * Q_r[k][I] - y_i[k] * Q_i[k][I];
+                ci += y_r[k] * Q_i[k][I] + y_i[k] * Q_r[k][I];
+            }
+            PQ_coeffs_r[I] = norm * cr;
+            PQ_coeffs_i[I] = norm * ci;
+        }
+
+        t_left -= tau;
+        nsubstep++;
+    }
+    return nsubstep;
+}
+
 void TDCI::complex_sigma_build(std::vector<double>& sigma_r, std::vector<double>& sigma_i,
                                std::vector<double>& c_r, std::vector<double>& c_i,
                                DeterminantHashVec& dethash, DeterminantSubstitutionLists& op) {
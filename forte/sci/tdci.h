@@ -133,6 +133,15 @@ class TDCI {
     void propagate_RK4_list(std::vector<double>& PQ_coeffs_r, std::vector<double>& PQ_coeffs_i,
                             DeterminantHashVec& PQ_space, DeterminantSubstitutionLists& op,
                             double dt);
+
+    /// Propagate by dt with the short-iterative Lanczos method using the coupling lists.
+    /// The Hamiltonian is never stored: each Krylov vector requires one complex sigma build.
+    /// The Krylov space is grown up to TDCI_KRYLOV_DIM vectors until the estimated error of the
+    /// step is below TDCI_KRYLOV_CONVERGENCE, otherwise dt is split into shorter substeps.
+    /// @return the number of substeps used
+    size_t propagate_lanczos_list(std::vector<double>& PQ_coeffs_r,
+                                  std::vector<double>& PQ_coeffs_i, DeterminantHashVec& PQ_space,
+                                  DeterminantSubstitutionLists& op, double dt);
     // The core state determinant space
     DeterminantHashVec core_dets_;
     DeterminantHashVec ann_dets_;
@@ -1,7 +1,7 @@
 from .hf import HF
 from .active_space_solver import ActiveSpaceSolver
 from .spin_analysis import SpinAnalysis
-from .solver import Solver
+from .solver import Solver, run_graph
 from .factory import solver_factory
 from .input import Input
 from .callback_handler import CallbackHandler
\ No newline at end of file
@@ -1,10 +1,14 @@
+import copy
+
 from forte.core import flog
+from forte.cache import Cache
 
 from forte.solvers.solver import Feature, Solver
 from forte import ForteOptions
 from forte import to_state_nroots_map
 from forte import forte_options
 from forte import make_active_space_ints, make_active_space_solver
+from forte import RDMsType
 
 
 class ActiveSpaceSolver(Solver):
@@ -45,6 +49,7 @@ class ActiveSpaceSolver(Solver):
         r_convergence=1.0e-6,
         options=None,
         cbh=None,
+        cache=None,
     ):
         """
         Initialize an ActiveSpaceSolver object
@@ -77,6 +82,8 @@ class ActiveSpaceSolver(Solver):
             Additional options passed to control the active space solver
         cbh: CallbackHandler
             A callback object used to inject code into the HF class
+        cache: None, bool, str, or Cache
+            The cache used to store the state energies
         """
         # initialize the base class
         super().__init__(
@@ -85,8 +92,9 @@ class ActiveSpaceSolver(Solver):
             provides=[Feature.MODEL, Feature.ORBITALS, Feature.RDMS],
             options=options,
             cbh=cbh,
+            cache=cache,
         )
-        self._data = self.input_nodes[0].data
+        self._data = copy.copy(self.input_nodes[0].data)
 
         # parse the states parameter
         self._states = self._parse_states(states)
@@ -96,6 +104,15 @@ class ActiveSpaceSolver(Solver):
         self._mo_space_info_map = {} if mo_spaces is None else mo_spaces
         self._e_convergence = e_convergence
         self._r_convergence = r_convergence
+        self._active_space_solver = None
+
+    def __getstate__(self):
+        # the C++ solver and integrals are rebuilt when this solver is run or restored
+        state = super().__getstate__()
+        state["_active_space_solver"] = None
+        for attr in ["ints", "as_ints"]:
+            state.pop(attr, None)
+        return state
 
     def __repr__(self):
         """
@@ -117,27 +134,107 @@ class ActiveSpaceSolver(Solver):
     def r_convergence(self):
         return self._r_convergence
 
-    def _run(self):
-        """Run an active space solver computation"""
+    @property
+    def active_space_solver(self):
+        """
+        Return the ActiveSpaceSolver object.
 
-        # compute the guess orbitals
-        if not self.input_nodes[0].executed:
-            flog("info", "ActiveSpaceSolver: MOs not available in mo_solver. Calling mo_solver run()")
-            self.input_nodes[0].run()
-        else:
-            flog("info", "ActiveSpaceSolver: MOs read from mo_solver object")
+        If the energies were read from the cache, the solver is built and run only when
+        it is first requested (e.g., by a node that needs the RDMs).
+        """
+        if self._active_space_solver is None and self.executed:
+            flog("info", "ActiveSpaceSolver: building active space solver object requested by another node")
+            self._compute_energy()
+        return self._active_space_solver
 
-        # make the state_map
-        state_map = to_state_nroots_map(self._states)
+    def _full_options(self):
+        """Return the options passed to the active space solver"""
+        options = {"E_CONVERGENCE": self.e_convergence, "R_CONVERGENCE": self.r_convergence}
+        # values from self._options (user specified) replace those from options
+        return {**options, **self._options}
+
+    def _key_parameters(self):
+        states = [[self._state_key(state), weights] for state, weights in self._states.items()]
+        # the global Forte options (defaults and user-set values) also affect the result
+        global_options = {name: entry["value"] for name, entry in forte_options.dict().items()}
+        return [self._type, states, self._mo_space_info_map, self._full_options(), global_options]
+
+    def _add_cached_results(self):
+        """Add the active space integrals, the averaged RDMs, and the CI vectors to the results"""
+        as_ints = self.as_ints
+        ints = {
+            "nuclear_repulsion_energy": as_ints.nuclear_repulsion_energy(),
+            "frozen_core_energy": as_ints.frozen_core_energy(),
+            "scalar_energy": as_ints.scalar_energy(),
+            "oei_a": as_ints.oei_a_array(),
+            "oei_b": as_ints.oei_b_array(),
+            "tei_aa": as_ints.tei_aa_array(),
+            "tei_ab": as_ints.tei_ab_array(),
+            "tei_bb": as_ints.tei_bb_array(),
+        }
+        self._results.add("active space integrals", ints, "Active space integrals", "Eh")
+
+        rdms = self._active_space_solver.compute_average_rdms(self._states, 2, RDMsType.spin_dependent)
+        rdms_arrays = {
+            "g1a": rdms.g1a(),
+            "g1b": rdms.g1b(),
+            "g2aa": rdms.g2aa(),
+            "g2ab": rdms.g2ab(),
+            "g2bb": rdms.g2bb(),
+        }
+        self._results.add("active space rdms", rdms_arrays, "State-averaged 1- and 2-RDMs", "")
+
+        try:
+            ci_vectors = {state: wfn.to_array() for state, wfn in self._active_space_solver.state_ci_wfn_map().items()}
+        except RuntimeError:
+            flog("info", f"ActiveSpaceSolver: CI vectors are not available for {self._type}")
+            ci_vectors = {}
+        self._results.add("ci vectors", ci_vectors, "CI vectors", "")
+
+    def _cache_payload(self):
+        # StateInfo objects cannot be pickled, so we store the per-state data using the state keys
+        def to_keys(state_map):
+            return {Cache.key(self._state_key(state)): value for state, value in state_map.items()}
+
+        energies = self.value("active space energy")
+        return {
+            "active space energy": to_keys({state: list(e) for state, e in energies.items()}),
+            "active space integrals": self.value("active space integrals"),
+            "active space rdms": self.value("active space rdms"),
+            "ci vectors": to_keys(self.value("ci vectors")),
+        }
+
+    def _restore(self, payload):
+        def from_keys(key_map):
+            keys = {state: Cache.key(self._state_key(state)) for state in self._states}
+            return {state: key_map[key] for state, key in keys.items() if key in key_map}
+
+        state_energies_list = from_keys(payload["active space energy"])
+
+        self._prepare()
+        flog("info", f"ActiveSpaceSolver: active space energy = {state_energies_list} (from cache)")
+        self._results.add("active space energy", state_energies_list, "Active space energy", "Eh")
+        self._results.add("active space integrals", payload["active space integrals"], "Active space integrals", "Eh")
+        self._results.add("active space rdms", payload["active space rdms"], "State-averaged 1- and 2-RDMs", "")
+        self._results.add("ci vectors", from_keys(payload["ci vectors"]), "CI vectors", "")
+        self._active_space_solver = None
+        return True
+
+    def _prepare(self):
+        """Copy the input data and build the MOSpaceInfo object"""
+        # work on a copy of the input data so that solvers that share the same orbitals do not interfere
+        self._data = copy.copy(self.input_nodes[0].data)
 
         # make the mo_space_info object
         self.make_mo_space_info(self._mo_space_info_map)
 
-        # prepare the options
-        options = {"E_CONVERGENCE": self.e_convergence, "R_CONVERGENCE": self.r_convergence}
+    def _compute_energy(self):
+        """Build the integrals and the active space solver, then compute the energy"""
+        # make the state_map
+        state_map = to_state_nroots_map(self._states)
 
-        # values from self._options (user specified) replace those from options
-        full_options = {**options, **self._options}
+        # prepare the options
+        full_options = self._full_options()
 
         flog("info", "ActiveSpaceSolver: adding options")
         local_options = ForteOptions(forte_options)
@@ -159,8 +256,27 @@ class ActiveSpaceSolver(Solver):
         flog("info", "ActiveSpaceSolver: calling compute_energy() on active space solver object")
         state_energies_list = self._active_space_solver.compute_energy()
         flog("info", "ActiveSpaceSolver: compute_energy() done")
+        return state_energies_list
+
+    def _run(self):
+        """Run an active space solver computation"""
+
+        # compute the guess orbitals
+        if not self.input_nodes[0].executed:
+            flog("info", "ActiveSpaceSolver: MOs not available in mo_solver. Calling mo_solver run()")
+            self.input_nodes[0].run()
+        else:
+            flog("info", "ActiveSpaceSolver: MOs read from mo_solver object")
+
+        self._prepare()
+
+        state_energies_list = self._compute_energy()
 
         flog("info", f"ActiveSpaceSolver: active space energy = {state_energies_list}")
         self._results.add("active space energy", state_energies_list, "Active space energy", "Eh")
 
+        # the integrals, RDMs, and CI vectors are stored in the cache together with the energies
+        if self.cache is not None:
+            self._add_cached_results()
+
         return self
@@ -5,8 +5,13 @@ from forte.basis import Basis
 from forte.solvers.input import Input
 
 
-def solver_factory(molecule, basis, int_type=None, scf_aux_basis=None, corr_aux_basis=None):
-    """A factory to build a basic solver object"""
+def solver_factory(molecule, basis, int_type=None, scf_aux_basis=None, corr_aux_basis=None, cache=None):
+    """
+    A factory to build a basic solver object
+
+    Passing ``cache`` (True, a directory name, or a ``forte.cache.Cache`` object)
+    enables caching of the output of all the solvers built on top of this object.
+    """
     flog('info', 'Calling solver factory')
 
     # TODO: generalize to other type of models (e.g. if molecule/basis are not provided)
@@ -22,7 +27,7 @@ def solver_factory(molecule, basis, int_type=None, scf_aux_basis=None, corr_aux_
         corr_aux_basis = Basis(corr_aux_basis)
 
     # create an empty solver and pass the model in
-    solver = Input()
+    solver = Input(cache=cache)
     solver.data.model = MolecularModel(
         molecule=molecule, int_type=int_type, basis=basis, scf_aux_basis=scf_aux_basis, corr_aux_basis=corr_aux_basis
     )
@@ -1,3 +1,5 @@
+import copy
+
 from forte.core import flog
 
 from forte.solvers.solver import Feature, Solver
@@ -19,7 +21,8 @@ class HF(Solver):
         docc=None,
         socc=None,
         options=None,
-        cbh=None
+        cbh=None,
+        cache=None
     ):
         """
         initialize a HF object
@@ -44,6 +47,8 @@ class HF(Solver):
             Additional options passed to control psi4
         cbh: CallbackHandler
             A callback object used to inject code into the HF class
+        cache: None, bool, str, or Cache
+            The cache used to store the HF wave function
         """
         # initialize common objects
         super().__init__(
@@ -51,9 +56,11 @@ class HF(Solver):
             needs=[Feature.MODEL],
             provides=[Feature.MODEL, Feature.ORBITALS],
             options=options,
-            cbh=cbh
+            cbh=cbh,
+            cache=cache
         )
-        self._data = self.input_nodes[0].data
+        # work on a copy of the input data so that HF computations on the same model do not interfere
+        self._data = copy.copy(self.input_nodes[0].data)
         self._state = state
         self._restricted = restricted
         self._e_convergence = e_convergence
@@ -125,21 +132,32 @@ class HF(Solver):
                 '\nPass the docc and socc options to converge to a solution with the correct symmetry.'
             )
 
-    def _run(self):
-        """Run a Hartree-Fock computation"""
+    def _key_parameters(self):
         import psi4
 
-        # reset psi4's options to avoid pollution
-        psi4.core.clean_options()
+        # the psi4 options include the basis, reference, SCF_TYPE, convergence, and occupations
+        return [psi4.__version__, self._state_key(self.state), self.charge, self.multiplicity, self._psi4_options()]
 
-        # currently limited to molecules
-        if not isinstance(self.data.model, MolecularModel):
-            raise RuntimeError('HF.energy() is implemented only for MolecularModel objects')
+    def _cache_payload(self):
+        # psi4 serializes the wave function (orbitals, energies, densities,...) to a dictionary of numpy arrays
+        return {'energy': self.value('hf energy'), 'wfn': self.data.psi_wfn.to_file()}
+
+    def _restore(self, payload):
+        import psi4
 
         molecule = self.data.model.molecule
         molecule.set_molecular_charge(self.charge)
         molecule.set_multiplicity(self.multiplicity)
+        psi_wfn = psi4.core.Wavefunction.from_file(payload['wfn'])
 
+        flog('info', f'HF: hf energy = {payload["energy"]} (from cache)')
+        self._results.add('hf energy', payload['energy'], 'Hartree-Fock energy', 'Eh')
+        self.data.psi_wfn = psi_wfn
+        self.data.scf_info = SCFInfo(psi_wfn)
+        return True
+
+    def _psi4_options(self):
+        """Return the options passed to psi4"""
         # prepare options for psi4
         scf_type_dict = {
             'CONVENTIONAL': 'PK',
@@ -174,7 +192,24 @@ class HF(Solver):
         if self.data.model.scf_aux_basis is not None:
             options['DF_BASIS_SCF'] = self.data.model.scf_aux_basis
 
-        full_options = {**options, **self._options}
+        return {**options, **self._options}
+
+    def _run(self):
+        """Run a Hartree-Fock computation"""
+        import psi4
+
+        # reset psi4's options to avoid pollution
+        psi4.core.clean_options()
+
+        # currently limited to molecules
+        if not isinstance(self.data.model, MolecularModel):
+            raise RuntimeError('HF.energy() is implemented only for MolecularModel objects')
+
+        molecule = self.data.model.molecule
+        molecule.set_molecular_charge(self.charge)
+        molecule.set_multiplicity(self.multiplicity)
+
+        full_options = self._psi4_options()
 
         # set the options
         psi4.set_options(full_options)
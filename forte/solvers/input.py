@@ -1,5 +1,6 @@
 from forte.solvers.solver import Feature, Node
 from forte.data import ForteData
+from forte.cache import make_cache
 
 
 class Input(Node):
@@ -11,13 +12,29 @@ class Input(Node):
     an object from a class derived from the Model class.
     """
 
-    def __init__(self):
+    def __init__(self, cache=None):
+        """
+        Parameters
+        ----------
+        cache: None, bool, str, or Cache
+            the cache used by the solvers that take this node as input (see ``forte.cache.make_cache``)
+        """
         super().__init__(input_nodes=None, needs=[], provides=[Feature.MODEL])
         self._data = ForteData()
+        self._cache = make_cache(cache)
 
     def _run(self):
         pass
 
+    @property
+    def cache(self):
+        return self._cache
+
+    def _key_parameters(self):
+        """The output of this node is determined by the model"""
+        model = self.data.model
+        return [repr(model), getattr(model, "scf_aux_basis", None), getattr(model, "corr_aux_basis", None)]
+
     def state(self, *args, **kwargs):
         """Provide access to the ``state`` function of the current model"""
         return self.data.model.state(*args, **kwargs)
@@ -1,7 +1,14 @@
+import os
+import pickle
+import subprocess
+import sys
+import tempfile
 from abc import abstractmethod
+from concurrent.futures import ThreadPoolExecutor
 from enum import Enum, auto
 
 from forte import StateInfo
+from forte.cache import Cache, make_cache
 from forte.core import flog, increase_log_depth
 from forte.solvers.callback_handler import CallbackHandler
 from forte.data import ForteData
@@ -91,6 +98,37 @@ class Node:
                 graph += input.computational_graph()
         return graph
 
+    def _key_parameters(self):
+        """
+        Return the parameters that determine the output of this node.
+
+        Derived classes should return all the quantities (options, states, convergence thresholds,...)
+        that affect their output. The default implementation makes every node unique.
+        """
+        return id(self)
+
+    def __getstate__(self):
+        """
+        Return the state used to pickle this node.
+
+        Only the model is kept from the data. The other objects (integrals, wave functions,...) are
+        rebuilt when the node is run again or restored from the cache.
+        """
+        state = self.__dict__.copy()
+        state["_data"] = ForteData(model=self._data.model)
+        return state
+
+    def content_key(self):
+        """
+        Return a hash key that identifies the output of this node.
+
+        The key combines the type of this node, its parameters, and the keys of its input nodes,
+        so two nodes that perform the same computation on the same input share the same key.
+        """
+        return Cache.key(
+            type(self).__name__, self._key_parameters(), [input.content_key() for input in self.input_nodes]
+        )
+
 
 class Solver(Node):
     """
@@ -111,7 +149,7 @@ class Solver(Node):
     and a results object.
     """
 
-    def __init__(self, needs, provides, input_nodes=None, options=None, cbh=None):
+    def __init__(self, needs, provides, input_nodes=None, options=None, cbh=None, cache=None):
         """
         Parameters
         ----------
@@ -125,11 +163,18 @@ class Solver(Node):
             a dictionary of options to pass to the forte modules
         cbh: CallbackHandler
             a callback handler object
+        cache: None, bool, str, or Cache
+            the cache used to store the output of this solver (see ``forte.cache.make_cache``).
+            If not specified, the cache of the first input node is used.
         """
         super().__init__(needs, provides, input_nodes)
 
         self._options = {} if options is None else options
         self._cbh = CallbackHandler() if cbh is None else cbh
+        self._cache = make_cache(cache)
+        if self._cache is None and len(self.input_nodes) > 0:
+            self._cache = self.input_nodes[0].cache
+        self._from_cache = False
         self._executed = False
         self._results = Results()
         # the default psi4 output file
@@ -152,8 +197,12 @@ class Solver(Node):
         # log call to run()
         flog("info", f"{type(self).__name__}: calling run()")
 
+        # try to restore the output of this solver from the cache, otherwise
         # call derived class implementation of _run()
-        self._run()
+        self._from_cache = self._restore_from_cache()
+        if not self._from_cache:
+            self._run()
+            self._store_to_cache()
 
         # log end of run()
         flog("info", f"{type(self).__name__}: run() finished executing")
@@ -163,11 +212,62 @@ class Solver(Node):
 
         return self.data
 
+    def __getstate__(self):
+        # a pickled solver has to be run again (or restored from the cache)
+        state = super().__getstate__()
+        state["_results"] = Results()
+        state["_executed"] = False
+        state["_from_cache"] = False
+        return state
+
     @abstractmethod
     def _run():
         """The actual run function implemented by each method"""
         pass
 
+    def _cache_payload(self):
+        """
+        Return a dictionary of picklable objects that fully describes the output of this solver
+        or None if the output of this solver cannot be cached.
+        """
+        return None
+
+    def _restore(self, payload):
+        """
+        Restore the output of this solver from a payload produced by ``_cache_payload()``.
+
+        Return
+        ------
+            True if the output was restored, False otherwise
+        """
+        return False
+
+    def _cacheable(self):
+        """Can the output of this solver be stored in its cache?"""
+        return self._cache is not None and type(self)._cache_payload is not Solver._cache_payload
+
+    def _restore_from_cache(self):
+        if self._cache is None:
+            return False
+        payload = self._cache.load(self.content_key())
+        if payload is None:
+            return False
+        # make sure that the inputs are available before restoring this node
+        for input in self.input_nodes:
+            if isinstance(input, Solver) and not input.executed:
+                input.run()
+        restored = self._restore(payload)
+        if restored:
+            flog("info", f"{type(self).__name__}: output restored from {self._cache}")
+        return restored
+
+    def _store_to_cache(self):
+        if self._cache is None:
+            return
+        payload = self._cache_payload()
+        if payload is not None:
+            self._cache.store(self.content_key(), payload)
+
     @property
     def results(self):
         return self._results
@@ -176,6 +276,15 @@ class Solver(Node):
     def executed(self):
         return self._executed
 
+    @property
+    def from_cache(self):
+        """Was the output of the last call to run() read from the cache?"""
+        return self._from_cache
+
+    @property
+    def cache(self):
+        return self._cache
+
     @property
     def psi_wfn(self):
         return self.data.psi_wfn
@@ -234,6 +343,19 @@ class Solver(Node):
     def state(self, *args, **kwargs):
         return self.data.model.state(*args, **kwargs)
 
+    @staticmethod
+    def _state_key(state):
+        """Return a tuple that identifies a StateInfo object (used to build cache keys)"""
+        return (
+            state.na(),
+            state.nb(),
+            state.multiplicity(),
+            state.twice_ms(),
+            state.irrep(),
+            list(state.gas_min()),
+            list(state.gas_max()),
+        )
+
     def _parse_states(self, states):
         """
         This function converts the input of a user into the standard
@@ -299,3 +421,143 @@ class Solver(Node):
         options.get_options_from_psi4(psi4_options)
 
         return options
+
+
+def run_graph(nodes, nprocs=1):
+    """
+    Run a computational graph.
+
+    The graph is formed by the nodes in ``nodes`` and all their (direct and indirect) inputs.
+    Each solver runs after all its input solvers. Solvers that were already executed (or whose
+    output is found in the cache) are not run again.
+
+    The solvers whose inputs have all been executed do not depend on each other. When ``nprocs`` > 1,
+    those that have a cache run concurrently, each in a separate python process (see
+    ``run_in_processes``). Threads cannot be used because psi4 and the Forte C++ solvers keep global
+    state (options, output file, psi4 variables) and do not release the GIL.
+
+    Parameters
+    ----------
+    nodes: Node or list(Node)
+        the final node(s) of the graph
+    nprocs: int
+        the maximum number of solvers that run concurrently
+
+    Return
+    ------
+        the list of final nodes
+    """
+    nodes = nodes if isinstance(nodes, list) else [nodes]
+
+    # sort the solvers so that each one comes after its inputs (avoid duplicates)
+    order = []
+    visited = set()
+
+    def visit(node):
+        if id(node) in visited:
+            return
+        visited.add(id(node))
+        for input in node.input_nodes:
+            visit(input)
+        if isinstance(node, Solver):
+            order.append(node)
+
+    for node in nodes:
+        visit(node)
+
+    pending = [solver for solver in order if not solver.executed]
+    flog("info", f"run_graph: running {len(pending)} solvers")
+    while len(pending) > 0:
+        ready = [
+            solver
+            for solver in pending
+            if all(input.executed for input in solver.input_nodes if isinstance(input, Solver))
+        ]
+        if nprocs > 1:
+            run_in_processes([solver for solver in ready if solver._cacheable()], nprocs)
+        # the output of the solvers run in other processes is read from the cache
+        for solver in ready:
+            if not solver.executed:
+                solver.run()
+        pending = [solver for solver in pending if not solver.executed]
+
+    return nodes
+
+
+def run_in_processes(solvers, nprocs):
+    """
+    Run independent solvers concurrently in separate python processes.
+
+    Each solver is pickled (together with its input nodes) and run by a new python process, which
+    stores the output in the cache of the solver. The threads and memory available to psi4 are
+    split evenly among the processes, and each process writes to its own output file (the name of
+    the output file followed by the first characters of the cache key of the solver).
+    Solvers that cannot be pickled are skipped. Nothing is read back here: calling ``run()`` on the
+    solvers restores their output from the cache, or runs them in this process if a process failed.
+
+    Parameters
+    ----------
+    solvers: list(Solver)
+        the solvers to run, all of them with a cache
+    nprocs: int
+        the maximum number of processes that run at the same time
+    """
+    import psi4
+
+    if len(solvers) < 2:
+        return
+    nworkers = min(nprocs, len(solvers))
+    settings = {
+        "nthreads": max(1, psi4.core.get_num_threads() // nworkers),
+        "memory": psi4.get_memory() // nworkers,
+        "forte_options": forte.forte_options.dict(),
+    }
+    # the child processes must find the same modules as this one
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(path for path in sys.path if path))
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        commands = []
+        for k, solver in enumerate(solvers):
+            stem, ext = os.path.splitext(solver.output_file)
+            job = {**settings, "solver": solver, "output_file": f"{stem}.{solver.content_key()[:8]}{ext}"}
+            filename = os.path.join(tmpdir, f"solver_{k}.pkl")
+            try:
+                with open(filename, "wb") as f:
+                    pickle.dump(job, f, protocol=pickle.HIGHEST_PROTOCOL)
+            except (pickle.PicklingError, TypeError, AttributeError) as e:
+                flog("warning", f"run_graph: cannot pickle {type(solver).__name__} ({e}), running it in this process")
+                continue
+            code = "import sys; from forte.solvers.solver import run_pickled_solver; run_pickled_solver(sys.argv[1])"
+            commands.append((type(solver).__name__, [sys.executable, "-c", code, filename]))
+
+        flog("info", f"run_graph: running {len(commands)} solvers in {nworkers} processes")
+
+        def run_command(name, command):
+            process = subprocess.run(command, env=env, capture_output=True, text=True)
+            if process.returncode != 0:
+                flog("warning", f"run_graph: the process running {name} failed\n{process.stderr}")
+
+        # the threads only wait for the processes
+        with ThreadPoolExecutor(max_workers=nworkers) as executor:
+            for future in [executor.submit(run_command, name, command) for name, command in commands]:
+                future.result()
+
+
+def run_pickled_solver(filename):
+    """
+    Run a solver pickled by ``run_in_processes``. This function is called in a new python process.
+
+    Parameters
+    ----------
+    filename: str
+        the name of the file with the pickled solver and the psi4/Forte settings
+    """
+    import psi4
+
+    with open(filename, "rb") as f:
+        job = pickle.load(f)
+    psi4.core.set_output_file(job["output_file"], False)
+    psi4.set_num_threads(job["nthreads"])
+    psi4.set_memory(job["memory"])
+    forte.forte_options.set_dict(job["forte_options"])
+    job["solver"].run()
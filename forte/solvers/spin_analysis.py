@@ -52,14 +52,17 @@ class SpinAnalysis(Solver):
         else:
             flog('info', f'{__class__.__name__}: MOs read from mo_solver object')
 
+        # the input solver may have replaced its data object when it was executed
+        self._data = self.input_nodes[0].data
+        active_space_solver = self.input_nodes[0].active_space_solver
+
         # prepare the options
         flog('info', 'ActiveSpaceSolver: adding options')
         local_options = ForteOptions(forte_options)
         local_options.set_from_dict(self._options)
 
         flog('info', f'{__class__.__name__}: preparing the 1- and 2-body reduced density matrices')
-        rdms = self.input_nodes[0]._active_space_solver.compute_average_rdms(self.input_nodes[0]._states, 2,
-                                                                             RDMsType.spin_dependent)
+        rdms = active_space_solver.compute_average_rdms(self.input_nodes[0]._states, 2, RDMsType.spin_dependent)
         perform_spin_analysis(rdms, local_options, self.mo_space_info, self.as_ints)
 
         return self
@@ -45,6 +45,31 @@ using namespace psi;
 
 namespace forte {
 
+namespace {
+/// Convert nirrep of vector of occupations to nirrep of vector of strings
+std::vector<std::vector<String>>
+to_strings(const std::vector<std::vector<std::vector<bool>>>& occ_strings) {
+    std::vector<std::vector<String>> out(occ_strings.size());
+    for (size_t h = 0, nirrep = occ_strings.size(); h < nirrep; ++h) {
+        out[h].assign(occ_strings[h].begin(), occ_strings[h].end());
+    }
+    return out;
+}
+
+/// Store all the products of alpha and beta strings in dets (alpha major)
+void build_string_product(const std::vector<String>& a_strings,
+                          const std::vector<String>& b_strings, Determinant* dets) {
+    const size_t na = a_strings.size();
+    const size_t nb = b_strings.size();
+#pragma omp parallel for schedule(static)
+    for (size_t a = 0; a < na; ++a) {
+        for (size_t b = 0; b < nb; ++b) {
+            dets[a * nb + b] = Determinant(a_strings[a], b_strings[b]);
+        }
+    }
+}
+} // namespace
+
 CI_Reference::CI_Reference(std::shared_ptr<SCFInfo> scf_info, std::shared_ptr<ForteOptions> options,
                            std::shared_ptr<MOSpaceInfo> mo_space_info,
                            std::shared_ptr<ActiveSpaceIntegrals> fci_ints, int multiplicity,
@@ -508,22 +533,49 @@ void CI_Reference::build_cas_reference(std::vector<Determinant>& ref_space) {
 
 void CI_Reference::build_cas_reference_full(std::vector<Determinant>& ref_space) {
     ref_space.clear();
+    ref_space.reserve(cas_reference_size());
 
     // build alpha and beta strings
-    auto a_strings = build_occ_string(nact_, nalpha_, mo_symmetry_);
-    auto b_strings = build_occ_string(nact_, nbeta_, mo_symmetry_);
+    auto a_strings = to_strings(build_occ_string(nact_, nalpha_, mo_symmetry_));
+    auto b_strings = to_strings(build_occ_string(nact_, nbeta_, mo_symmetry_));
 
     // construct determinants
     for (int ha = 0; ha != nirrep_; ++ha) {
         int hb = ha ^ root_sym_;
-        for (size_t a = 0, a_size = a_strings[ha].size(); a < a_size; ++a) {
-            for (size_t b = 0, b_size = b_strings[hb].size(); b < b_size; ++b) {
-                ref_space.emplace_back(a_strings[ha][a], b_strings[hb][b]);
-            }
-        }
+        size_t offset = ref_space.size();
+        ref_space.resize(offset + a_strings[ha].size() * b_strings[hb].size());
+        build_string_product(a_strings[ha], b_strings[hb], ref_space.data() + offset);
     }
 }
 
+void CI_Reference::build_cas_reference_full(DeterminantHashVec& ref_space) {
+    ref_space.clear();
+    ref_space.reserve(cas_reference_size());
+
+    // build alpha and beta strings
+    auto a_strings = to_strings(build_occ_string(nact_, nalpha_, mo_symmetry_));
+    auto b_strings = to_strings(build_occ_string(nact_, nbeta_, mo_symmetry_));
+
+    // construct determinants one irrep block at a time, the blocks are disjoint
+    std::vector<Determinant> block;
+    for (int ha = 0; ha != nirrep_; ++ha) {
+        int hb = ha ^ root_sym_;
+        block.resize(a_strings[ha].size() * b_strings[hb].size());
+        build_string_product(a_strings[ha], b_strings[hb], block.data());
+        ref_space.append_unique(block);
+    }
+}
+
+size_t CI_Reference::cas_reference_size() {
+    auto na = count_occ_string(nact_, nalpha_, mo_symmetry_);
+    auto nb = count_occ_string(nact_, nbeta_, mo_symmetry_);
+    size_t ndets = 0;
+    for (int h = 0; h < nirrep_; ++h) {
+        ndets += na[h] * nb[h ^ root_sym_];
+    }
+    return ndets;
+}
+
 std::vector<std::vector<std::vector<bool>>>
 CI_Reference::build_occ_string(size_t norb, size_t nele, const std::vector<int>& symmetry) {
     if (nele > norb) {
@@ -548,6 +600,26 @@ CI_Reference::build_occ_string(size_t norb, size_t nele, const std::vector<int>&
     return out;
 }
 
+std::vector<size_t> CI_Reference::count_occ_string(size_t norb, size_t nele,
+                                                   const std::vector<int>& symmetry) {
+    if (nele > norb) {
+        throw psi::PSIEXCEPTION("Invalid number of electron / orbital to count occ string.");
+    }
+
+    // count[k][h]: number of ways to place k electrons in the orbitals visited so far such that
+    // the product of their irreps is h
+    std::vector<std::vector<size_t>> count(nele + 1, std::vector<size_t>(nirrep_, 0));
+    count[0][0] = 1;
+    for (size_t p = 0; p < norb; ++p) {
+        for (size_t k = std::min(nele, p + 1); k > 0; --k) {
+            for (int h = 0; h < nirrep_; ++h) {
+                count[k][h ^ symmetry[p]] += count[k - 1][h];
+            }
+        }
+    }
+    return count[nele];
+}
+
 std::vector<std::vector<std::vector<bool>>>
 CI_Reference::build_occ_string_subspace(size_t norb, size_t nele, const std::vector<int>& symmetry,
                                         size_t sub_orb, std::vector<size_t> eps_idx) {
@@ -878,7 +950,88 @@ void CI_Reference::build_gas_reference(std::vector<Determinant>& ref_space) {
     get_gas_occupation();
 
     ref_space.clear();
+    ref_space.reserve(count_gas_determinants());
+
+    for_each_gas_block([&](const std::vector<String>& a_strings,
+                           const std::vector<String>& b_strings) {
+        size_t offset = ref_space.size();
+        ref_space.resize(offset + a_strings.size() * b_strings.size());
+        build_string_product(a_strings, b_strings, ref_space.data() + offset);
+    });
+}
+
+void CI_Reference::build_gas_reference(DeterminantHashVec& ref_space) {
+    print_gas_scf_epsilon();
+    get_gas_occupation();
+
+    ref_space.clear();
+    ref_space.reserve(count_gas_determinants());
+
+    // the determinants of a block are built and hashed in parallel. Blocks differ in GAS
+    // occupation or irrep, so no determinant is generated twice and the lookup is skipped
+    std::vector<Determinant> block;
+    for_each_gas_block([&](const std::vector<String>& a_strings,
+                           const std::vector<String>& b_strings) {
+        block.resize(a_strings.size() * b_strings.size());
+        build_string_product(a_strings, b_strings, block.data());
+        ref_space.append_unique(block);
+    });
+}
+
+size_t CI_Reference::gas_reference_size() {
+    if (gas_electrons_.empty()) {
+        get_gas_occupation();
+    }
+    return count_gas_determinants();
+}
 
+size_t CI_Reference::count_gas_determinants() {
+    // number of strings per irrep for given GAS n/electron
+    std::map<std::pair<int, int>, std::vector<size_t>> gasn_nele_to_count;
+
+    // couple the strings of one GAS to the strings of the previous ones
+    auto couple = [&](std::vector<size_t>& n, const std::vector<size_t>& n_gas) {
+        std::vector<size_t> out(nirrep_, 0);
+        for (int h1 = 0; h1 < nirrep_; ++h1) {
+            for (int h2 = 0; h2 < nirrep_; ++h2) {
+                out[h1 ^ h2] += n[h1] * n_gas[h2];
+            }
+        }
+        n = out;
+    };
+
+    size_t ndets = 0;
+    for (const auto& config : gas_electrons_) {
+        // number of alpha and beta strings per irrep
+        std::vector<size_t> na(nirrep_, 0), nb(nirrep_, 0);
+        na[0] = nb[0] = 1;
+
+        for (int gas = 0; gas < 6; ++gas) {
+            auto space_name = "GAS" + std::to_string(gas + 1);
+            auto norb = mo_space_info_->size(space_name);
+            if (norb == 0)
+                continue;
+            auto sym = mo_space_info_->symmetry(space_name);
+
+            for (int nele : {config[2 * gas], config[2 * gas + 1]}) {
+                std::pair<int, int> key{gas, nele};
+                if (gasn_nele_to_count.find(key) == gasn_nele_to_count.end()) {
+                    gasn_nele_to_count[key] = count_occ_string(norb, nele, sym);
+                }
+            }
+            couple(na, gasn_nele_to_count[{gas, config[2 * gas]}]);
+            couple(nb, gasn_nele_to_count[{gas, config[2 * gas + 1]}]);
+        }
+
+        for (int h = 0; h < nirrep_; ++h) {
+            ndets += na[h] * nb[h ^ root_sym_];
+        }
+    }
+    return ndets;
+}
+
+void CI_Reference::for_each_gas_block(
+    const std::function<void(const std::vector<String>&, const std::vector<String>&)>& block) {
     // relative indices within the active orbitals
     std::vector<std::vector<size_t>> rel_gas_mos;
 
@@ -913,6 +1066,7 @@ void CI_Reference::build_gas_reference(std::vector<Determinant>& ref_space) {
     outfile->Printf("\n    ---------------------------------");
 
     timer timer_gas("Build GAS determinants");
+    size_t ndets = 0;
     for (size_t config = 0, size = gas_electrons_.size(); config < size; ++config) {
         local_timer lt;
         outfile->Printf("\n    %6d", config + 1);
@@ -943,8 +1097,8 @@ void CI_Reference::build_gas_reference(std::vector<Determinant>& ref_space) {
             b_tmp.push_back(gasn_config_to_occ_string[b_key]);
         }
 
-        // alpha and beta strings (nirrep of vector of occupations)
-        std::vector<std::vector<std::vector<bool>>> a_strings(nirrep_), b_strings(nirrep_);
+        // alpha and beta strings (nirrep of vector of strings)
+        std::vector<std::vector<String>> a_strings(nirrep_), b_strings(nirrep_);
 
         // loop over symmetry product
         for (const auto& sym : sym_product) {
@@ -960,37 +1114,30 @@ void CI_Reference::build_gas_reference(std::vector<Determinant>& ref_space) {
 
             // alpha
             auto strings_irrep = build_gas_occ_string(a, rel_gas_mos);
-            std::move(strings_irrep.begin(), strings_irrep.end(),
-                      std::back_inserter(a_strings[irrep]));
+            a_strings[irrep].insert(a_strings[irrep].end(), strings_irrep.begin(),
+                                    strings_irrep.end());
 
             // beta
             strings_irrep = build_gas_occ_string(b, rel_gas_mos);
-            std::move(strings_irrep.begin(), strings_irrep.end(),
-                      std::back_inserter(b_strings[irrep]));
+            b_strings[irrep].insert(b_strings[irrep].end(), strings_irrep.begin(),
+                                    strings_irrep.end());
         }
 
-        // combine alpha and beta strings to form determinant
+        // pass the blocks of determinants of this configuration
         size_t n = 0;
         for (int ha = 0; ha < nirrep_; ++ha) {
             int hb = root_sym_ ^ ha;
-            for (const auto& a : a_strings[ha]) {
-                for (const auto& b : b_strings[hb]) {
-                    ref_space.emplace_back(a, b);
-                    n++;
-                }
-            }
+            n += a_strings[ha].size() * b_strings[hb].size();
+            block(a_strings[ha], b_strings[hb]);
         }
+        ndets += n;
 
         outfile->Printf("  %14zu  %9.3e", n, lt.get());
     }
 
     outfile->Printf("\n    ---------------------------------");
-    outfile->Printf("\n    Total:  %14zu  %9.3e", ref_space.size(), timer_gas.stop());
+    outfile->Printf("\n    Total:  %14zu  %9.3e", ndets, timer_gas.stop());
     outfile->Printf("\n    ---------------------------------");
-    //    print_h2("GAS Determinants");
-    //    for (const auto& det : ref_space) {
-    //        outfile->Printf("\n    %s", str(det, nact_).c_str());
-    //    }
 }
 
 std::vector<std::tuple<double, int, int>> CI_Reference::sym_labeled_orbitals(std::string type) {
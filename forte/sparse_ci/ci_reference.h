@@ -28,8 +28,11 @@
 
 #pragma once
 
+#include <functional>
+
 #include "integrals/active_space_integrals.h"
 #include "sparse_ci/determinant.h"
+#include "sparse_ci/determinant_hashvector.h"
 #include "base_classes/mo_space_info.h"
 #include "base_classes/scf_info.h"
 #include "base_classes/state_info.h"
@@ -125,6 +128,20 @@ class CI_Reference {
     build_gas_occ_string(const std::vector<std::vector<std::vector<bool>>>& gas_strings,
                          const std::vector<std::vector<size_t>>& rel_mos);
 
+    /// Count the occupation strings for a given number of electrons and orbitals
+    /// @return nirrep of number of strings
+    std::vector<size_t> count_occ_string(size_t norb, size_t nele,
+                                         const std::vector<int>& symmetry);
+
+    /// Count the determinants of all GAS configurations in gas_electrons_
+    size_t count_gas_determinants();
+
+    /// Enumerate the GAS determinants in blocks of fixed GAS occupation and irrep
+    /// @param block called with the alpha and beta strings of each block, the determinants of
+    ///        a block being all products of one alpha and one beta string
+    void for_each_gas_block(
+        const std::function<void(const std::vector<String>&, const std::vector<String>&)>& block);
+
   public:
     /// Default constructor
     CI_Reference(std::shared_ptr<SCFInfo> scf_info, std::shared_ptr<ForteOptions> options,
@@ -144,6 +161,12 @@ class CI_Reference {
     /// Build the complete CAS reference
     void build_cas_reference_full(std::vector<Determinant>& ref_space);
 
+    /// Build the complete CAS reference directly into a hash vector
+    void build_cas_reference_full(DeterminantHashVec& ref_space);
+
+    /// Return the number of determinants in the complete CAS reference
+    size_t cas_reference_size();
+
     /// Build the doubly occupied CI reference
     void build_doci_reference(std::vector<Determinant>& ref_space);
 
@@ -153,6 +176,12 @@ class CI_Reference {
     /// Build the complete GAS reference
     void build_gas_reference(std::vector<Determinant>& ref_space);
 
+    /// Build the complete GAS reference directly into a hash vector
+    void build_gas_reference(DeterminantHashVec& ref_space);
+
+    /// Return the number of determinants in the complete GAS reference
+    size_t gas_reference_size();
+
     /// Build single lowest energy state
     void build_gas_single(std::vector<Determinant>& ref_space);
 
@@ -198,10 +198,12 @@ void SpinAdapter::prepare_couplings(const std::vector<Determinant>& dets) {
     local_timer t2;
     ncsf_ = 0;
     ncoupling_ = 0;
-    for (const auto& conf : confs_) {
-        if (conf.count_socc() >= twoS_) {
-            conf_to_csfs(conf, det_hash);
+    conf_to_csf_bounds_.assign(confs_.size() + 1, 0);
+    for (size_t I = 0, maxI = confs_.size(); I < maxI; ++I) {
+        if (confs_[I].count_socc() >= twoS_) {
+            conf_to_csfs(confs_[I], det_hash);
         }
+        conf_to_csf_bounds_[I + 1] = ncsf_;
     }
     psi::outfile->Printf("    Timing for finding the CSFs:           %10.4f\n", t2.get());
 
@@ -247,6 +249,22 @@ void SpinAdapter::conf_to_csfs(const Configuration& conf, DeterminantHashVec& de
     }
 }
 
+std::vector<std::pair<size_t, double>> SpinAdapter::conf_dets(size_t I) const {
+    const auto first = conf_begin(I);
+    if (first == conf_end(I))
+        return {};
+    const auto N = confs_[I].count_socc();
+    std::vector<std::pair<size_t, double>> dets(N_to_det_occupations_[N].size(), {0, 0.0});
+    // the couplings of this configuration are stored in the same order as N_to_overlaps_[N]
+    size_t k = csf_to_det_bounds_[first];
+    for (const auto& [i, j, o] : N_to_overlaps_[N]) {
+        const auto& [det_idx, coeff] = csf_to_det_coeff_[k++];
+        if (det_idx < ndet_)
+            dets[j] = {det_idx, std::copysign(1.0, coeff * o)};
+    }
+    return dets;
+}
+
 auto SpinAdapter::make_spin_couplings(int N, int twoS) -> std::vector<String> {
     if (N == 0)
         return std::vector<String>(1, String());
@@ -106,6 +106,37 @@ class SpinAdapter {
     /// @brief Return the number of determinants
     size_t ndet() const;
 
+    /// @brief Return the number of configurations
+    size_t nconf() const { return confs_.size(); }
+
+    /// @brief Return the configurations (sorted) spanned by the determinants
+    const std::vector<Configuration>& configurations() const { return confs_; }
+
+    /// @brief Return the index of the first CSF of the I-th configuration
+    /// The CSFs of a configuration are stored contiguously in [conf_begin(I), conf_end(I))
+    size_t conf_begin(size_t I) const { return conf_to_csf_bounds_[I]; }
+
+    /// @brief Return the index past the last CSF of the I-th configuration
+    size_t conf_end(size_t I) const { return conf_to_csf_bounds_[I + 1]; }
+    /// @brief Return the number of spin couplings (CSFs) of a configuration with N unpaired
+    /// electrons
+    size_t nspin_couplings(int N) const { return N_to_noverlaps_[N].size(); }
+    /// @brief Return the number of determinant occupations for N unpaired electrons
+    size_t ndet_occupations(int N) const { return N_to_det_occupations_[N].size(); }
+    /// @brief Return the determinant occupations for N unpaired electrons. Bit k is the spin of
+    /// the k-th unpaired electron (up = alpha = 0, down = beta = 1)
+    const std::vector<String>& det_occupations(int N) const { return N_to_det_occupations_[N]; }
+    /// @brief Return the non-zero overlaps between the spin couplings and the determinant
+    /// occupations for N unpaired electrons stored as (coupling i, occupation j, <CSF_i|D_j>)
+    const std::vector<std::tuple<size_t, size_t, double>>& spin_coupling_overlaps(int N) const {
+        return N_to_overlaps_[N];
+    }
+    /// @brief Return the determinants spanned by the I-th configuration
+    /// @return a vector of (determinant index, phase) with one entry per determinant occupation
+    /// of spin_coupling_overlaps(N). The coefficient of the j-th determinant in the i-th CSF is
+    /// phase_j * <CSF_i|D_j>. Occupations that do not contribute to any CSF have phase 0.
+    std::vector<std::pair<size_t, double>> conf_dets(size_t I) const;
+
     /// @brief An const interator for the expansion coefficients of a CSF in the determinant
     /// basis
     class const_iterator {
@@ -201,6 +232,8 @@ class SpinAdapter {
     std::vector<std::pair<size_t, double>> csf_to_det_coeff_;
     /// @brief A vector used to store the configurations
     std::vector<Configuration> confs_;
+    /// @brief A vector with the index of the first CSF of each configuration
+    std::vector<size_t> conf_to_csf_bounds_;
 
     /// @bried A vector with the number of CSFs with a given number of unpaired electrons (N)
     std::vector<size_t> N_ncsf_;
@@ -67,8 +67,14 @@ std::vector<std::pair<Determinant, size_t>> DeterminantHashVec::determinant_inde
 
 size_t DeterminantHashVec::size() const { return wfn_.size(); }
 
+void DeterminantHashVec::reserve(size_t count) { wfn_.reserve(count); }
+
 size_t DeterminantHashVec::add(const Determinant& det) { return wfn_.add(det); }
 
+void DeterminantHashVec::append_unique(const std::vector<Determinant>& dets) {
+    wfn_.append_unique(dets);
+}
+
 const Determinant& DeterminantHashVec::get_det(const size_t value) const {
     // Iterate through map to find the right one
     // Possibly a faster way to do this?
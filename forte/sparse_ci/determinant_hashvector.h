@@ -75,9 +75,15 @@ class DeterminantHashVec {
     /// Add a determinant and return its address
     size_t add(const Determinant& det);
 
+    /// Append determinants that are all distinct and not in the hash yet (this is not checked)
+    void append_unique(const std::vector<Determinant>& dets);
+
     /// Return the number of determinants
     size_t size() const;
 
+    /// Reserve space for count determinants
+    void reserve(size_t count);
+
     // Clear hash
     void clear();
 
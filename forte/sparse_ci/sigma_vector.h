@@ -72,6 +72,13 @@ class SigmaVector {
     add_bad_roots(std::vector<std::vector<std::pair<size_t, double>>>& /*bad_states*/) {}
     virtual double compute_spin(const std::vector<double>& c) = 0;
 
+    /// Replace the integrals (e.g. with a dressed Hamiltonian) and update the diagonal, keeping
+    /// all the integral-independent intermediates (e.g. the substitution lists)
+    /// @return false if this algorithm caches integral-dependent quantities and must be rebuilt
+    virtual bool update_integrals(std::shared_ptr<ActiveSpaceIntegrals> /*fci_ints*/) {
+        return false;
+    }
+
     /// Compute the contribution to sigma due to 1-body operator
     /// sigma_{I} <- factor * sum_{pq} h_{pq} sum_{J} b_{J} <I|p^+ q|J>
     /// h_{pq} = h1a[p * nactv + q]
@@ -0,0 +1,613 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2024 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libmints/vector.h"
+
+#include "helpers/timer.h"
+#include "integrals/active_space_integrals.h"
+
+#include "ci_spin_adaptation.h"
+#include "sigma_vector_csf.h"
+
+namespace forte {
+
+namespace {
+/// Return the occupation (0, 1, or 2) of orbital p
+int occupation(const Configuration& conf, int p) {
+    return conf.is_docc(p) ? 2 : (conf.is_socc(p) ? 1 : 0);
+}
+
+/// Apply a+_k (create = true) or a_k (create = false) to a determinant stored as a string of spin
+/// orbitals and return the sign, or zero if the result vanishes
+double apply_operator(uint64_t& det, int k, bool create) {
+    const uint64_t bit = uint64_t(1) << k;
+    if (((det & bit) != 0) == create)
+        return 0.0;
+    det ^= bit;
+    return std::popcount(det & (bit - 1)) % 2 == 0 ? 1.0 : -1.0;
+}
+
+/// Compute y += alpha T x, where T is a (nrow x ncol) matrix stored by rows
+void add_table_product(double alpha, const std::vector<double>& T, size_t nrow, size_t ncol,
+                       const double* x, double* y) {
+    for (size_t i = 0; i < nrow; ++i) {
+        const double* T_i = &T[i * ncol];
+        double value = 0.0;
+        for (size_t j = 0; j < ncol; ++j) {
+            value += T_i[j] * x[j];
+        }
+        y[i] += alpha * value;
+    }
+}
+} // namespace
+
+SigmaVectorCSF::SigmaVectorCSF(std::shared_ptr<SpinAdapter> spin_adapter,
+                               const std::vector<Determinant>& dets,
+                               std::shared_ptr<ActiveSpaceIntegrals> fci_ints)
+    : spin_adapter_(spin_adapter), dets_(dets), fci_ints_(fci_ints),
+      size_(spin_adapter->ncsf()) {
+    psi::outfile->Printf("\n\n  ==> CSF Sigma Vector <==\n\n");
+
+    local_timer t1;
+    const auto pattern_keys = build_connectivity();
+    psi::outfile->Printf("    Timing for the connectivity:           %10.4f\n", t1.get());
+
+    local_timer t2;
+    build_coupling_tables(pattern_keys);
+    psi::outfile->Printf("    Timing for the coupling tables:        %10.4f\n", t2.get());
+
+    local_timer t3;
+    build_diagonal();
+    psi::outfile->Printf("    Timing for the diagonal:               %10.4f\n", t3.get());
+
+    psi::outfile->Printf("    Number of configurations:              %10zu\n",
+                         spin_adapter_->nconf());
+    psi::outfile->Printf("    Number of CSFs:                        %10zu\n", size_);
+    psi::outfile->Printf("    Number of connected configurations:    %10zu\n", num_connections());
+    psi::outfile->Printf("    Number of coupling patterns:           %10zu\n", num_patterns());
+}
+
+size_t SigmaVectorCSF::num_connections() const {
+    size_t n = 0;
+    for (const auto& connections : connections_) {
+        n += connections.size();
+    }
+    return n;
+}
+
+void SigmaVectorCSF::add_bad_roots(
+    const std::vector<std::vector<std::pair<size_t, double>>>& bad_states) {
+    // transform the bad states to the CSF basis: b_i = sum_a U_N(i,a) phase_a c_a
+    const auto& confs = spin_adapter_->configurations();
+    bad_states_.clear();
+    std::vector<double> c(dets_.size());
+    for (const auto& bad_state : bad_states) {
+        std::fill(c.begin(), c.end(), 0.0);
+        for (const auto& [idx, value] : bad_state) {
+            c[idx] = value;
+        }
+        auto& b = bad_states_.emplace_back(size_, 0.0);
+        for (size_t I = 0, nconf = confs.size(); I < nconf; ++I) {
+            const size_t first = spin_adapter_->conf_begin(I);
+            if (first == spin_adapter_->conf_end(I))
+                continue;
+            const auto dets_I = spin_adapter_->conf_dets(I);
+            const int N = confs[I].count_socc();
+            for (const auto& [i, a, o] : spin_adapter_->spin_coupling_overlaps(N)) {
+                const auto& [idx, phase] = dets_I[a];
+                if (phase != 0.0)
+                    b[first + i] += o * phase * c[idx];
+            }
+        }
+    }
+}
+
+double SigmaVectorCSF::two_electron_integral(int p, int q, int r, int s) const {
+    // (pq|rs) = <pr|qs>
+    return fci_ints_->tei_ab(p, r, q, s);
+}
+
+void SigmaVectorCSF::pattern_orbitals(const Configuration& I, const Configuration& J,
+                                      std::vector<int>& orbs) const {
+    orbs.clear();
+    for (int p = 0, norb = static_cast<int>(fci_ints_->nmo()); p < norb; ++p) {
+        if (I.is_socc(p) or J.is_socc(p) or (I.is_docc(p) != J.is_docc(p)))
+            orbs.push_back(p);
+    }
+}
+
+double SigmaVectorCSF::one_electron_part(const Configuration& I, const Configuration& J) const {
+    const int norb = static_cast<int>(fci_ints_->nmo());
+
+    // find the orbitals where I has more (plus) and fewer (minus) electrons than J
+    std::vector<int> plus, minus;
+    for (int p = 0; p < norb; ++p) {
+        const int d = occupation(I, p) - occupation(J, p);
+        plus.insert(plus.end(), std::max(d, 0), p);
+        minus.insert(minus.end(), std::max(-d, 0), p);
+    }
+
+    // double excitations
+    if (plus.size() > 1)
+        return 0.0;
+
+    // I = J: energy of the doubly occupied orbitals and one-electron energy of the singly
+    // occupied ones
+    if (plus.empty()) {
+        std::vector<int> docc, socc;
+        for (int p = 0; p < norb; ++p) {
+            if (I.is_docc(p))
+                docc.push_back(p);
+            if (I.is_socc(p))
+                socc.push_back(p);
+        }
+        double value = 0.0;
+        for (size_t k = 0; k < docc.size(); ++k) {
+            const int d = docc[k];
+            value += 2.0 * fci_ints_->oei_a(d, d) + two_electron_integral(d, d, d, d);
+            for (size_t l = 0; l < k; ++l) {
+                const int e = docc[l];
+                value += 4.0 * two_electron_integral(d, d, e, e) -
+                         2.0 * two_electron_integral(d, e, e, d);
+            }
+            for (int s : socc) {
+                value +=
+                    2.0 * two_electron_integral(d, d, s, s) - two_electron_integral(d, s, s, d);
+            }
+        }
+        for (int s : socc) {
+            value += fci_ints_->oei_a(s, s);
+        }
+        return value;
+    }
+
+    // I = E_pq J: h_pq plus the interaction with the doubly occupied orbitals not in the pattern
+    const int p = plus[0];
+    const int q = minus[0];
+    double value = fci_ints_->oei_a(p, q);
+    for (int r = 0; r < norb; ++r) {
+        if (I.is_docc(r) and J.is_docc(r)) {
+            value += 2.0 * two_electron_integral(p, q, r, r) - two_electron_integral(p, r, r, q);
+        }
+    }
+    return value;
+}
+
+void SigmaVectorCSF::compute_sigma(std::span<const double> b, std::span<double> sigma) const {
+    // project out the bad states
+    std::vector<double> b_proj;
+    if (not bad_states_.empty()) {
+        b_proj.assign(b.begin(), b.end());
+        for (const auto& bad_state : bad_states_) {
+            const double overlap =
+                std::inner_product(bad_state.begin(), bad_state.end(), b_proj.begin(), 0.0);
+            for (size_t i = 0; i < size_; ++i) {
+                b_proj[i] -= overlap * bad_state[i];
+            }
+        }
+        b = b_proj;
+    }
+
+    const auto& confs = spin_adapter_->configurations();
+    const size_t nconf = confs.size();
+
+    // sigma_I = sum_J [f_IJ S_IJ + sum_t (pq|rs)_t T_IJ,t] b_J
+#pragma omp parallel
+    {
+        std::vector<int> orbs;
+#pragma omp for schedule(dynamic)
+        for (size_t I = 0; I < nconf; ++I) {
+            const size_t first = spin_adapter_->conf_begin(I);
+            const size_t ncsf = spin_adapter_->conf_end(I) - first;
+            if (ncsf == 0)
+                continue;
+            double* sigma_I = &sigma[first];
+            std::fill(sigma_I, sigma_I + ncsf, 0.0);
+
+            for (const auto& [J, n, f] : connections_[I]) {
+                const auto& pattern = patterns_[n];
+                const double* b_J = &b[spin_adapter_->conf_begin(J)];
+                if (f != 0.0)
+                    add_table_product(f, pattern.scalar_table, ncsf, pattern.nket, b_J, sigma_I);
+                if (pattern.integrals.empty())
+                    continue;
+                pattern_orbitals(confs[I], confs[J], orbs);
+                for (size_t t = 0, nt = pattern.integrals.size(); t < nt; ++t) {
+                    const auto& [p, q, r, s] = pattern.integrals[t];
+                    const double V = two_electron_integral(orbs[p], orbs[q], orbs[r], orbs[s]);
+                    add_table_product(V, pattern.tables[t], ncsf, pattern.nket, b_J, sigma_I);
+                }
+            }
+        }
+    }
+}
+
+void SigmaVectorCSF::get_diagonal(psi::Vector& diag) const {
+    for (size_t i = 0; i < size_; ++i) {
+        diag.set(i, diag_[i]);
+    }
+}
+
+std::vector<std::string> SigmaVectorCSF::build_connectivity() {
+    const auto& confs = spin_adapter_->configurations();
+    const size_t nconf = confs.size();
+    const int norb = static_cast<int>(fci_ints_->nmo());
+    connections_.assign(nconf, {});
+    if (nconf == 0)
+        return {};
+
+    auto has_csfs = [&](size_t I) {
+        return spin_adapter_->conf_begin(I) != spin_adapter_->conf_end(I);
+    };
+
+    std::vector<std::vector<size_t>> connected(nconf);
+    if (2 * confs[0].count_docc() + confs[0].count_socc() < 2) {
+        // with fewer than two electrons every configuration is connected to all the others
+        std::vector<size_t> all;
+        for (size_t I = 0; I < nconf; ++I) {
+            if (has_csfs(I))
+                all.push_back(I);
+        }
+        for (size_t I : all) {
+            connected[I] = all;
+        }
+    } else {
+        // Two configurations with the same number of electrons differ by at most two electrons
+        // if and only if they give the same configuration after removing two electrons from each.
+        // Here we group the configurations according to their two-hole configurations.
+        auto two_hole_configurations = [&](const Configuration& conf) {
+            std::vector<Configuration> holes;
+            for (int p = 0; p < norb; ++p) {
+                if (conf.is_empt(p))
+                    continue;
+                Configuration conf_p(conf);
+                conf_p.set_occ(p, conf.is_docc(p) ? 1 : 0);
+                for (int q = p; q < norb; ++q) {
+                    if (conf_p.is_empt(q))
+                        continue;
+                    Configuration conf_pq(conf_p);
+                    conf_pq.set_occ(q, conf_p.is_docc(q) ? 1 : 0);
+                    holes.push_back(conf_pq);
+                }
+            }
+            return holes;
+        };
+
+        std::unordered_map<Configuration, std::vector<size_t>, Configuration::Hash> groups;
+        for (size_t I = 0; I < nconf; ++I) {
+            if (not has_csfs(I))
+                continue;
+            for (const auto& hole : two_hole_configurations(confs[I])) {
+                groups[hole].push_back(I);
+            }
+        }
+
+#pragma omp parallel for schedule(dynamic, 16)
+        for (size_t I = 0; I < nconf; ++I) {
+            if (not has_csfs(I))
+                continue;
+            auto& connected_I = connected[I];
+            for (const auto& hole : two_hole_configurations(confs[I])) {
+                const auto& group = groups.at(hole);
+                connected_I.insert(connected_I.end(), group.begin(), group.end());
+            }
+            std::sort(connected_I.begin(), connected_I.end());
+            connected_I.erase(std::unique(connected_I.begin(), connected_I.end()),
+                              connected_I.end());
+        }
+    }
+
+    // The pattern of (I, J) is labeled by the occupations (3 n_J + n_I) of its orbitals
+    std::vector<std::vector<std::string>> keys(nconf);
+#pragma omp parallel
+    {
+        std::vector<int> orbs;
+#pragma omp for schedule(dynamic, 16)
+        for (size_t I = 0; I < nconf; ++I) {
+            for (size_t J : connected[I]) {
+                pattern_orbitals(confs[I], confs[J], orbs);
+                std::string key;
+                for (int p : orbs) {
+                    key.push_back(
+                        static_cast<char>(3 * occupation(confs[J], p) + occupation(confs[I], p)));
+                }
+                keys[I].push_back(std::move(key));
+                connections_[I].push_back({J, 0, one_electron_part(confs[I], confs[J])});
+            }
+            std::vector<size_t>().swap(connected[I]);
+        }
+    }
+
+    // number the patterns
+    std::vector<std::string> pattern_keys;
+    std::unordered_map<std::string, size_t> pattern_index;
+    for (size_t I = 0; I < nconf; ++I) {
+        for (size_t k = 0, maxk = keys[I].size(); k < maxk; ++k) {
+            const auto [it, inserted] = pattern_index.try_emplace(keys[I][k], pattern_keys.size());
+            if (inserted)
+                pattern_keys.push_back(keys[I][k]);
+            connections_[I][k].pattern = it->second;
+        }
+    }
+    return pattern_keys;
+}
+
+void SigmaVectorCSF::build_coupling_tables(const std::vector<std::string>& pattern_keys) {
+    const size_t npatterns = pattern_keys.size();
+    patterns_.assign(npatterns, {});
+    if (npatterns == 0)
+        return;
+
+    // the spin orbitals of a pattern are stored in a 64-bit word
+    for (const auto& key : pattern_keys) {
+        if (key.size() > 32) {
+            throw std::runtime_error("SigmaVectorCSF: the configurations have too many unpaired "
+                                     "electrons to use the CSF sigma vector.");
+        }
+    }
+
+    // store the spin-coupling coefficients as a dense (ncsf x ndet) matrix for each N and the
+    // index of each determinant occupation
+    const int norb = static_cast<int>(fci_ints_->nmo());
+    std::vector<std::vector<double>> spin_couplings(norb + 1);
+    std::vector<std::unordered_map<uint64_t, size_t>> occupation_index(norb + 1);
+    for (int N = 0; N <= std::min(norb, 32); ++N) {
+        const auto& occupations = spin_adapter_->det_occupations(N);
+        const size_t ndet = occupations.size();
+        spin_couplings[N].assign(spin_adapter_->nspin_couplings(N) * ndet, 0.0);
+        for (const auto& [i, a, o] : spin_adapter_->spin_coupling_overlaps(N)) {
+            spin_couplings[N][i * ndet + a] = o;
+        }
+        for (size_t a = 0; a < ndet; ++a) {
+            uint64_t spins = 0;
+            for (int k = 0; k < N; ++k) {
+                if (occupations[a].get_bit(k))
+                    spins |= uint64_t(1) << k;
+            }
+            occupation_index[N][spins] = a;
+        }
+    }
+
+    // The SpinAdapter creates the unpaired electrons on top of the closed-shell determinant,
+    // while the tables below are computed with the spin orbitals ordered as (0a, 0b, 1a, 1b, ...).
+    // The two orderings differ by the sign (-1)^(n(n-1)/2), where n is the number of doubly
+    // occupied orbitals.
+    const int nel = dets_[0].count_alfa() + dets_[0].count_beta();
+    auto csf_sign = [nel](int N) {
+        const int ndocc = (nel - N) / 2;
+        return (ndocc * (ndocc - 1) / 2) % 2 == 0 ? 1.0 : -1.0;
+    };
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t n = 0; n < npatterns; ++n) {
+        const auto& key = pattern_keys[n];
+        const int M = static_cast<int>(key.size());
+
+        // the occupations of the pattern in J and I and the orbitals that gain (plus) and lose
+        // (minus) electrons going from J to I
+        std::vector<int> occ_J(M), occ_I(M), plus, minus;
+        int N_J = 0;
+        int N_I = 0;
+        for (int t = 0; t < M; ++t) {
+            occ_J[t] = key[t] / 3;
+            occ_I[t] = key[t] % 3;
+            N_J += (occ_J[t] == 1);
+            N_I += (occ_I[t] == 1);
+            const int d = occ_I[t] - occ_J[t];
+            plus.insert(plus.end(), std::max(d, 0), t);
+            minus.insert(minus.end(), std::max(-d, 0), t);
+        }
+
+        const auto& occupations_J = spin_adapter_->det_occupations(N_J);
+        const auto& U_I = spin_couplings[N_I];
+        const auto& U_J = spin_couplings[N_J];
+        const size_t ndet_I = spin_adapter_->ndet_occupations(N_I);
+        const size_t ndet_J = occupations_J.size();
+        const size_t ncsf_I = spin_adapter_->nspin_couplings(N_I);
+        const size_t ncsf_J = spin_adapter_->nspin_couplings(N_J);
+        const double sign = csf_sign(N_I) * csf_sign(N_J);
+
+        // the determinants of J
+        std::vector<uint64_t> dets_J(ndet_J, 0);
+        for (size_t b = 0; b < ndet_J; ++b) {
+            for (int t = 0, k = 0; t < M; ++t) {
+                if (occ_J[t] == 2) {
+                    dets_J[b] |= uint64_t(3) << (2 * t);
+                } else if (occ_J[t] == 1) {
+                    dets_J[b] |= uint64_t(1) << (2 * t + occupations_J[b].get_bit(k));
+                    k++;
+                }
+            }
+        }
+
+        // return the index of a determinant of I
+        auto index_I = [&](uint64_t det) {
+            uint64_t spins = 0;
+            for (int t = 0, k = 0; t < M; ++t) {
+                if (occ_I[t] == 1) {
+                    if ((det >> (2 * t + 1)) & 1)
+                        spins |= uint64_t(1) << k;
+                    k++;
+                }
+            }
+            return occupation_index[N_I].at(spins);
+        };
+
+        // transform a list of determinant couplings (a, b, <a|O|b>) to the CSF basis
+        using couplings_t = std::vector<std::tuple<size_t, size_t, double>>;
+        auto csf_table = [&](const couplings_t& couplings) {
+            std::vector<double> temp(ndet_I * ncsf_J, 0.0);
+            for (const auto& [a, b, value] : couplings) {
+                for (size_t j = 0; j < ncsf_J; ++j) {
+                    temp[a * ncsf_J + j] += value * U_J[j * ndet_J + b];
+                }
+            }
+            std::vector<double> table(ncsf_I * ncsf_J, 0.0);
+            for (size_t i = 0; i < ncsf_I; ++i) {
+                for (size_t a = 0; a < ndet_I; ++a) {
+                    const double u = sign * U_I[i * ndet_I + a];
+                    if (u == 0.0)
+                        continue;
+                    for (size_t j = 0; j < ncsf_J; ++j) {
+                        table[i * ncsf_J + j] += u * temp[a * ncsf_J + j];
+                    }
+                }
+            }
+            return table;
+        };
+
+        auto& pattern = patterns_[n];
+        pattern.nbra = ncsf_I;
+        pattern.nket = ncsf_J;
+
+        // the table S_IJ and the terms e_pqrs that couple J to I
+        std::set<std::array<int, 4>> terms;
+        if (plus.empty()) {
+            pattern.scalar_table.assign(ncsf_I * ncsf_J, 0.0);
+            for (size_t i = 0; i < ncsf_I; ++i) {
+                pattern.scalar_table[i * ncsf_J + i] = 1.0;
+            }
+            for (int p = 0; p < M; ++p) {
+                for (int r = 0; r < M; ++r) {
+                    terms.insert({p, p, r, r});
+                    terms.insert({p, r, r, p});
+                }
+            }
+        } else if (plus.size() == 1) {
+            const int p = plus[0];
+            const int q = minus[0];
+            couplings_t couplings;
+            for (size_t b = 0; b < ndet_J; ++b) {
+                for (int x = 0; x < 2; ++x) {
+                    uint64_t det = dets_J[b];
+                    double value = apply_operator(det, 2 * q + x, false);
+                    value *= apply_operator(det, 2 * p + x, true);
+                    if (value != 0.0)
+                        couplings.emplace_back(index_I(det), b, value);
+                }
+            }
+            pattern.scalar_table = csf_table(couplings);
+            for (int r = 0; r < M; ++r) {
+                terms.insert({p, q, r, r});
+                terms.insert({r, r, p, q});
+                terms.insert({p, r, r, q});
+                terms.insert({r, q, p, r});
+            }
+        } else {
+            for (int k = 0; k < 2; ++k) {
+                for (int l = 0; l < 2; ++l) {
+                    terms.insert({plus[k], minus[l], plus[1 - k], minus[1 - l]});
+                }
+            }
+        }
+
+        // accumulate the couplings 1/2 <a|e_pqrs|b> of the terms with the same integral (pq|rs)
+        std::map<std::array<int, 4>, couplings_t> integral_couplings;
+        for (const auto& [p, q, r, s] : terms) {
+            const auto pq = std::minmax(p, q);
+            const auto rs = std::minmax(r, s);
+            const auto [first, second] = std::minmax(pq, rs);
+            auto& couplings = integral_couplings[{first.first, first.second, second.first,
+                                                  second.second}];
+            for (size_t b = 0; b < ndet_J; ++b) {
+                for (int x = 0; x < 2; ++x) {
+                    for (int y = 0; y < 2; ++y) {
+                        uint64_t det = dets_J[b];
+                        double value = apply_operator(det, 2 * q + x, false);
+                        if (value == 0.0)
+                            continue;
+                        value *= apply_operator(det, 2 * s + y, false);
+                        if (value == 0.0)
+                            continue;
+                        value *= apply_operator(det, 2 * r + y, true);
+                        if (value == 0.0)
+                            continue;
+                        value *= apply_operator(det, 2 * p + x, true);
+                        if (value != 0.0)
+                            couplings.emplace_back(index_I(det), b, 0.5 * value);
+                    }
+                }
+            }
+        }
+
+        for (const auto& [integral, couplings] : integral_couplings) {
+            auto table = csf_table(couplings);
+            const bool nonzero = std::any_of(table.begin(), table.end(),
+                                             [](double x) { return std::fabs(x) > 1.0e-12; });
+            if (nonzero) {
+                pattern.integrals.push_back(integral);
+                pattern.tables.push_back(std::move(table));
+            }
+        }
+    }
+}
+
+void SigmaVectorCSF::build_diagonal() {
+    const auto& confs = spin_adapter_->configurations();
+    const size_t nconf = confs.size();
+    diag_.assign(size_, 0.0);
+
+    // H(i,i) = f_II + sum_t (pq|rs)_t T_II,t(i,i)
+#pragma omp parallel
+    {
+        std::vector<int> orbs;
+#pragma omp for schedule(dynamic, 16)
+        for (size_t I = 0; I < nconf; ++I) {
+            const size_t first = spin_adapter_->conf_begin(I);
+            const size_t ncsf = spin_adapter_->conf_end(I) - first;
+            for (const auto& [J, n, f] : connections_[I]) {
+                if (J != I)
+                    continue;
+                const auto& pattern = patterns_[n];
+                pattern_orbitals(confs[I], confs[I], orbs);
+                for (size_t i = 0; i < ncsf; ++i) {
+                    double value = f * pattern.scalar_table[i * ncsf + i];
+                    for (size_t t = 0, nt = pattern.integrals.size(); t < nt; ++t) {
+                        const auto& [p, q, r, s] = pattern.integrals[t];
+                        value += two_electron_integral(orbs[p], orbs[q], orbs[r], orbs[s]) *
+                                 pattern.tables[t][i * ncsf + i];
+                    }
+                    diag_[first + i] = value;
+                }
+            }
+        }
+    }
+}
+
+} // namespace forte
@@ -0,0 +1,168 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Forte: an open-source plugin to Psi4 (https://github.com/psi4/psi4)
+ * that implements a variety of quantum chemistry methods for strongly
+ * correlated electrons.
+ *
+ * Copyright (c) 2012-2024 by its authors (see COPYING, COPYING.LESSER, AUTHORS).
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ *
+ * @END LICENSE
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "sparse_ci/determinant.h"
+
+namespace psi {
+class Vector;
+}
+
+namespace forte {
+
+class ActiveSpaceIntegrals;
+class SpinAdapter;
+
+/// @brief A class to compute the sigma vector directly in the CSF basis
+///
+/// The sigma vector is computed one configuration at a time without storing the Hamiltonian and
+/// without going through the determinant basis. We write the Hamiltonian in terms of the
+/// spin-free operators E_pq = sum_x a+_px a_qx and e_pqrs = sum_xy a+_px a+_ry a_sy a_qx, where x
+/// and y are spin labels
+///
+///     H = sum_pq h_pq E_pq + 1/2 sum_pqrs (pq|rs) e_pqrs
+///
+/// The block of H between the CSFs of two configurations I and J that differ by at most two
+/// electrons is then
+///
+///     H_IJ = f_IJ S_IJ + sum_t (pq|rs)_t T_IJ,t
+///
+/// The coupling tables S_IJ and T_IJ,t depend only on the pattern of the pair (I, J), that is, on
+/// the occupations of the orbitals that are singly occupied in I or J or that differ between I
+/// and J. The doubly occupied and empty orbitals not in the pattern only contribute to the
+/// one-electron part f_IJ:
+/// - I = J: S_IJ = 1 and f_IJ is the energy of the doubly occupied orbitals, their interaction
+///   with the singly occupied ones, and the one-electron energy of the singly occupied ones.
+/// - I = E_pq J: S_IJ = <I|E_pq|J> and f_IJ = h_pq + sum_r [2 (pq|rr) - (pr|rq)], where r runs
+///   over the doubly occupied orbitals not in the pattern.
+/// - double excitations: f_IJ = 0.
+/// The tables are computed once for each pattern (from the spin couplings of the SpinAdapter) and
+/// are shared by all the pairs of configurations with the same pattern, so that a sigma build
+/// only contracts them with the integrals.
+///
+/// This assumes a spin-free Hamiltonian (restricted orbitals) and a spin-complete determinant
+/// space. Bad states (e.g. roots to which the solution must be orthogonal) are transformed to the
+/// CSF basis and projected out of the trial vectors.
+///
+/// Note that the matrix elements do not include the nuclear repulsion and scalar energies.
+class SigmaVectorCSF {
+  public:
+    /// @brief Class constructor
+    /// @param spin_adapter a SpinAdapter object prepared for the determinants in dets
+    /// @param dets the determinant basis (sorted according to their address)
+    /// @param fci_ints the active space integrals
+    SigmaVectorCSF(std::shared_ptr<SpinAdapter> spin_adapter, const std::vector<Determinant>& dets,
+                   std::shared_ptr<ActiveSpaceIntegrals> fci_ints);
+
+    /// @brief Return the number of CSFs
+    size_t size() const { return size_; }
+
+    /// @brief Return the number of pairs of connected configurations
+    size_t num_connections() const;
+
+    /// @brief Return the number of distinct coupling patterns
+    size_t num_patterns() const { return patterns_.size(); }
+
+    /// @brief Set the states to project out of the trial vectors
+    /// @param bad_states a list of vectors stored as (determinant index, coefficient)
+    void add_bad_roots(const std::vector<std::vector<std::pair<size_t, double>>>& bad_states);
+
+    /// @brief Compute sigma = H b in the CSF basis
+    /// @param b the CSF coefficients
+    /// @param sigma the sigma vector
+    void compute_sigma(std::span<const double> b, std::span<double> sigma) const;
+
+    /// @brief Return the diagonal of the Hamiltonian in the CSF basis
+    /// @param diag a vector of size N_CSF
+    void get_diagonal(psi::Vector& diag) const;
+
+  private:
+    /// The coupling tables of a pattern, stored as dense (nbra x nket) matrices
+    struct CouplingPattern {
+        /// The number of CSFs of the bra (I) and ket (J) configurations
+        size_t nbra = 0;
+        size_t nket = 0;
+        /// The table S_IJ multiplied by the one-electron part f_IJ
+        std::vector<double> scalar_table;
+        /// The position in the pattern of the orbitals (pq|rs) of each two-electron term
+        std::vector<std::array<int, 4>> integrals;
+        /// The tables T_IJ,t of each two-electron term
+        std::vector<std::vector<double>> tables;
+    };
+
+    /// A configuration J connected to a configuration I
+    struct Connection {
+        /// The index of the configuration J
+        size_t J;
+        /// The index of the pattern of (I, J)
+        size_t pattern;
+        /// The one-electron part f_IJ
+        double scalar;
+    };
+
+    /// The spin adapter
+    std::shared_ptr<SpinAdapter> spin_adapter_;
+    /// The determinant basis
+    const std::vector<Determinant>& dets_;
+    /// The active space integrals
+    std::shared_ptr<ActiveSpaceIntegrals> fci_ints_;
+    /// The number of CSFs
+    size_t size_ = 0;
+    /// The coupling tables of each pattern
+    std::vector<CouplingPattern> patterns_;
+    /// The configurations connected to each configuration (including itself)
+    std::vector<std::vector<Connection>> connections_;
+    /// The diagonal of the Hamiltonian in the CSF basis
+    std::vector<double> diag_;
+    /// The states projected out of the trial vectors in the CSF basis
+    std::vector<std::vector<double>> bad_states_;
+
+    /// Find the configurations connected by the Hamiltonian and return the key of each pattern
+    std::vector<std::string> build_connectivity();
+    /// Compute the coupling tables of each pattern
+    void build_coupling_tables(const std::vector<std::string>& pattern_keys);
+    /// Compute the diagonal of the Hamiltonian in the CSF basis
+    void build_diagonal();
+    /// Store in orbs the orbitals of the pattern of (I, J): the orbitals that are singly occupied
+    /// in I or J or whose occupation differs in I and J
+    void pattern_orbitals(const Configuration& I, const Configuration& J,
+                          std::vector<int>& orbs) const;
+    /// Return the one-electron part f_IJ
+    double one_electron_part(const Configuration& I, const Configuration& J) const;
+    /// Return the two-electron integral (pq|rs)
+    double two_electron_integral(int p, int q, int r, int s) const;
+};
+
+} // namespace forte
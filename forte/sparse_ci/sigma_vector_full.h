@@ -47,6 +47,10 @@ class SigmaVectorFull : public SigmaVector {
     void get_diagonal(psi::Vector& diag) override;
     void add_bad_roots(std::vector<std::vector<std::pair<size_t, double>>>& bad_states_) override;
     double compute_spin(const std::vector<double>&) override { return 0.0; }
+    bool update_integrals(std::shared_ptr<ActiveSpaceIntegrals> fci_ints) override {
+        fci_ints_ = fci_ints;
+        return true;
+    }
 };
 
 } // namespace forte
\ No newline at end of file
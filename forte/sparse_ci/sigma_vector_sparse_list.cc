@@ -74,6 +74,16 @@ void SigmaVectorSparseList::add_bad_roots(
     }
 }
 
+bool SigmaVectorSparseList::update_integrals(std::shared_ptr<ActiveSpaceIntegrals> fci_ints) {
+    // the substitution lists depend only on the determinant space, so only the diagonal changes
+    fci_ints_ = fci_ints;
+    const det_hashvec& detmap = space_.wfn_hash();
+    for (size_t I = 0, max_I = detmap.size(); I < max_I; ++I) {
+        diag_[I] = fci_ints_->energy(detmap[I]);
+    }
+    return true;
+}
+
 void SigmaVectorSparseList::get_diagonal(psi::Vector& diag) {
     for (size_t I = 0; I < diag_.size(); ++I) {
         diag.set(I, diag_[I]);
@@ -49,6 +49,7 @@ class SigmaVectorSparseList : public SigmaVector {
     void get_diagonal(psi::Vector& diag) override;
     void add_bad_roots(std::vector<std::vector<std::pair<size_t, double>>>& bad_states_) override;
     double compute_spin(const std::vector<double>& c) override;
+    bool update_integrals(std::shared_ptr<ActiveSpaceIntegrals> fci_ints) override;
 
     std::vector<std::vector<std::pair<size_t, double>>> bad_states_;
 
@@ -44,6 +44,7 @@
 #include "helpers/determinant_helpers.h"
 
 #include "ci_spin_adaptation.h"
+#include "sigma_vector_csf.h"
 #include "sigma_vector_dynamic.h"
 #include "determinant_functions.hpp"
 #include "sparse_initial_guess.h"
@@ -88,6 +89,8 @@ void SparseCISolver::set_spin_adapt_full_preconditioner(bool value) {
     spin_adapt_full_preconditioner_ = value;
 }
 
+void SparseCISolver::set_spin_adapt_csf_sigma(bool value) { spin_adapt_csf_sigma_ = value; }
+
 void SparseCISolver::set_force_diag(bool value) { force_diag_ = value; }
 
 void SparseCISolver::add_bad_states(std::vector<std::vector<std::pair<size_t, double>>>& roots) {
@@ -118,6 +121,7 @@ void SparseCISolver::set_options(std::shared_ptr<ForteOptions> options) {
 
     set_spin_adapt(options->get_bool("CI_SPIN_ADAPT"));
     set_spin_adapt_full_preconditioner(options->get_bool("CI_SPIN_ADAPT_FULL_PRECONDITIONER"));
+    set_spin_adapt_csf_sigma(options->get_bool("CI_SPIN_ADAPT_CSF_SIGMA"));
 }
 
 void SparseCISolver::set_initial_guess(
@@ -486,6 +490,14 @@ bool SparseCISolver::davidson_liu_solver(const DeterminantHashVec& space,
         spin_adapter_->prepare_couplings(dets_);
     }
 
+    // Optionally compute the sigma vector directly in the CSF basis
+    std::shared_ptr<SigmaVectorCSF> csf_sigma_vector;
+    if (spin_adapt_ and spin_adapt_csf_sigma_) {
+        csf_sigma_vector =
+            std::make_shared<SigmaVectorCSF>(spin_adapter_, dets_, sigma_vector->as_ints());
+        csf_sigma_vector->add_bad_roots(bad_states_);
+    }
+
     // Compute the size of the determinant space and the basis used by the Davidson solver
     size_t fci_size = sigma_vector->size();
     size_t basis_size = spin_adapt_ ? spin_adapter_->ncsf() : fci_size;
@@ -519,7 +531,13 @@ bool SparseCISolver::davidson_liu_solver(const DeterminantHashVec& space,
 
     // Form the diagonal of the Hamiltonian and the initial guess
     if (spin_adapt_) {
-        auto Hdiag_vec = form_Hdiag_csf(sigma_vector->as_ints(), spin_adapter_);
+        std::shared_ptr<psi::Vector> Hdiag_vec;
+        if (csf_sigma_vector) {
+            Hdiag_vec = std::make_shared<psi::Vector>(basis_size);
+            csf_sigma_vector->get_diagonal(*Hdiag_vec);
+        } else {
+            Hdiag_vec = form_Hdiag_csf(sigma_vector->as_ints(), spin_adapter_);
+        }
         dl_solver_->add_h_diag(Hdiag_vec);
         auto guesses = initial_guess_csf(Hdiag_vec, num_guess_states, multiplicity);
         dl_solver_->add_guesses(guesses);
@@ -533,8 +551,14 @@ bool SparseCISolver::davidson_liu_solver(const DeterminantHashVec& space,
     }
 
     // Setup the sigma builder
-    auto sigma_builder = [this, &b_basis, &b, &sigma, &sigma_basis,
-                          &sigma_vector](std::span<double> b_span, std::span<double> sigma_span) {
+    auto sigma_builder = [this, &b_basis, &b, &sigma, &sigma_basis, &sigma_vector,
+                          &csf_sigma_vector](std::span<double> b_span,
+                                             std::span<double> sigma_span) {
+        if (csf_sigma_vector) {
+            // Compute sigma directly in the CSF basis
+            csf_sigma_vector->compute_sigma(b_span, sigma_span);
+            return;
+        }
         // copy the b vector
         size_t basis_size = b_span.size();
         for (size_t I = 0; I < basis_size; ++I) {
@@ -106,6 +106,9 @@ class SparseCISolver {
     /// Spin adapt the wave function using a full preconditioner?
     void set_spin_adapt_full_preconditioner(bool value);
 
+    /// Compute the sigma vector directly in the CSF basis when spin adapting?
+    void set_spin_adapt_csf_sigma(bool value);
+
     /// Enable/disable root projection
     void set_root_project(bool value);
 
@@ -210,6 +213,9 @@ class SparseCISolver {
     /// Use the full preconditioner for spin adaptation?
     /// When set to false, it uses an approximate diagonal preconditioner
     bool spin_adapt_full_preconditioner_ = false;
+    /// Build the Hamiltonian in the CSF basis and compute sigma without transforming to the
+    /// determinant basis?
+    bool spin_adapt_csf_sigma_ = false;
     /// Project solutions onto given root?
     bool root_project_ = false;
     /// The energy convergence threshold
@@ -134,12 +134,12 @@ StateVector SparseExp::apply_operator_cached(const SparseOperator& sop, const St
                         d_couplings.push_back(std::make_tuple(n, d_new, value));
                     }
                 }
-                couplings_[d] = d_couplings;
+                search = couplings_.emplace(d, std::move(d_couplings)).first;
                 timings_["couplings"] += t_couplings.get();
             }
             local_timer t_sum;
             // apply the operator
-            const auto& d_couplings = couplings_[d];
+            const auto& d_couplings = search->second;
             for (const auto& op_d_f : d_couplings) {
                 const double value =
                     op_list[std::get<0>(op_d_f)].coefficient() * std::get<2>(op_d_f) * c;
@@ -179,12 +179,12 @@ StateVector SparseExp::apply_operator_cached(const SparseOperator& sop, const St
                             d_couplings.push_back(std::make_tuple(n, d_new, value));
                         }
                     }
-                    couplings_dexc_[d] = d_couplings;
+                    search = couplings_dexc_.emplace(d, std::move(d_couplings)).first;
                     timings_["couplings"] += t_couplings.get();
                 }
                 local_timer t_sum;
                 // apply the operator
-                const auto& d_couplings = couplings_dexc_[d];
+                const auto& d_couplings = search->second;
                 for (const auto& op_d_f : d_couplings) {
                     const double value =
                         op_list[std::get<0>(op_d_f)].coefficient() * std::get<2>(op_d_f) * c;
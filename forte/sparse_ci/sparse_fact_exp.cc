@@ -26,12 +26,16 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "sparse_ci/sparse_fact_exp.h"
 
 namespace forte {
 
+/// Factors with more pairs than this are rotated in parallel
+constexpr size_t fact_exp_parallel_threshold = 4096;
+
 SparseFactExp::SparseFactExp(bool phaseless) : phaseless_(phaseless) {}
 
 StateVector SparseFactExp::compute(const SparseOperator& sop, const StateVector& state,
@@ -58,167 +62,168 @@ StateVector SparseFactExp::compute(const SparseOperator& sop, const StateVector&
 
 StateVector SparseFactExp::compute_cached(const SparseOperator& sop, const StateVector& state,
                                           bool inverse, double screen_thresh) {
-    for (const auto& det_c : state) {
-        const Determinant& det = det_c.first;
-        exp_hash_.add(det);
+    auto& comp = inverse ? compiled_inverse_ : compiled_;
+    // the couplings are compiled again only if the operator or the support of the state change
+    if (not is_compiled(comp, sop, state, inverse)) {
+        compile(comp, sop, state, inverse);
     }
+    return compute_exp(comp, sop, state, inverse, screen_thresh);
+}
 
-    // compute the couplings
-    if (inverse) {
-        if (not initialized_inverse_) {
-            compute_couplings(sop, state, inverse);
-            initialized_inverse_ = true;
-        }
-    } else {
-        if (not initialized_) {
-            compute_couplings(sop, state, inverse);
-            initialized_ = true;
-        }
+bool SparseFactExp::is_compiled(const CompiledOperator& comp, const SparseOperator& sop,
+                                const StateVector& state, bool inverse) const {
+    const auto& op_list = sop.op_list();
+    const size_t nterms = sop.size();
+    if (comp.ops.size() != nterms)
+        return false;
+    for (size_t m = 0; m < nterms; m++) {
+        const size_t n = inverse ? nterms - m - 1 : m;
+        if ((comp.ops[m].first != op_list[n].cre()) or (comp.ops[m].second != op_list[n].ann()))
+            return false;
     }
-    return compute_exp(sop, state, inverse, screen_thresh);
+    // all the determinants of the state must be in the support
+    const auto& dets = comp.dets.wfn_hash();
+    for (const auto& det_c : state) {
+        if (dets.find(det_c.first) >= comp.support_size)
+            return false;
+    }
+    return true;
 }
 
-void SparseFactExp::compute_couplings(const SparseOperator& sop, const StateVector& state0,
-                                      bool inverse) {
+void SparseFactExp::compile(CompiledOperator& comp, const SparseOperator& sop,
+                            const StateVector& state, bool inverse) {
     local_timer t;
     const auto& op_list = sop.op_list();
+    const size_t nterms = sop.size();
 
-    // initialize a state object
-    StateVector state(state0);
-    StateVector new_terms;
-
-    // loop over all operators
-    for (size_t m = 0, nterms = sop.size(); m < nterms; m++) {
-        size_t n = inverse ? nterms - m - 1 : m;
-
-        std::vector<std::tuple<size_t, size_t, double>> d_couplings;
-
-        // zero the new terms
-        new_terms.clear();
+    std::vector<std::pair<Determinant, Determinant>> ops(nterms);
+    for (size_t m = 0; m < nterms; m++) {
+        const size_t n = inverse ? nterms - m - 1 : m;
+        ops[m] = std::make_pair(op_list[n].cre(), op_list[n].ann());
+    }
 
-        const SQOperator& sqop = op_list[n];
-        const Determinant ucre = sqop.cre() - sqop.ann();
-        const Determinant uann = sqop.ann() - sqop.cre();
-        const double sign = inverse ? -1.0 : 1.0;
-        Determinant new_d;
-        // loop over all determinants
-        if (phaseless_) {
-            for (const auto& det_c : state) {
-                const Determinant& d = det_c.first;
+    // the support is the set of determinants in the state. If the operator did not change, the
+    // previous support is retained so that alternating between states does not trigger a
+    // recompilation every time
+    DeterminantHashVec dets;
+    if (ops == comp.ops) {
+        for (size_t i = 0; i < comp.support_size; i++) {
+            dets.add(comp.dets[i]);
+        }
+    }
+    for (const auto& det_c : state) {
+        dets.add(det_c.first);
+    }
 
-                // test if we can apply this operator to this determinant
-                if (d.fast_a_and_b_equal_b(sqop.ann()) and d.fast_a_and_b_eq_zero(ucre)) {
-                    new_d = d;
-                    // we ignore the phase here
-                    apply_op(new_d, sqop.cre(), sqop.ann());
-                    size_t d_idx = exp_hash_.add(d);
-                    size_t new_d_idx = exp_hash_.add(new_d);
-                    d_couplings.emplace_back(d_idx, new_d_idx, sign);
-                    new_terms[new_d] += 1.0;
-                } else if (d.fast_a_and_b_equal_b(sqop.cre()) and d.fast_a_and_b_eq_zero(uann)) {
-                    new_d = d;
-                    // we ignore the phase here
-                    apply_op(new_d, sqop.ann(), sqop.cre());
-                    size_t d_idx = exp_hash_.add(d);
-                    size_t new_d_idx = exp_hash_.add(new_d);
-                    d_couplings.emplace_back(d_idx, new_d_idx, -sign);
-                    new_terms[new_d] += 1.0;
+    comp = CompiledOperator();
+    comp.ops = std::move(ops);
+    comp.support_size = dets.size();
+    comp.dets = std::move(dets);
+    comp.offset.push_back(0);
+
+    const double sign = inverse ? -1.0 : 1.0;
+    std::vector<std::tuple<size_t, size_t, double>> pairs;
+    Determinant new_d;
+    for (size_t m = 0; m < nterms; m++) {
+        const auto& [cre, ann] = comp.ops[m];
+        const Determinant ucre = cre - ann;
+        const Determinant uann = ann - cre;
+
+        // loop over the support and the determinants generated by the previous factors
+        pairs.clear();
+        for (size_t i = 0, ndets = comp.dets.size(); i < ndets; i++) {
+            const Determinant d = comp.dets[i];
+            // test if we can apply this operator to this determinant
+            if (d.fast_a_and_b_equal_b(ann) and d.fast_a_and_b_eq_zero(ucre)) {
+                new_d = d;
+                const double f = apply_op(new_d, cre, ann);
+                // number operators do not contribute
+                if (new_d != d) {
+                    const size_t j = comp.dets.add(new_d);
+                    pairs.emplace_back(i, j, phaseless_ ? sign : sign * f);
                 }
-            }
-        } else {
-            for (const auto& det_c : state) {
-                const Determinant& d = det_c.first;
-
-                // test if we can apply this operator to this determinant
-                if (d.fast_a_and_b_equal_b(sqop.ann()) and d.fast_a_and_b_eq_zero(ucre)) {
-                    new_d = d;
-                    double f = sign * apply_op(new_d, sqop.cre(), sqop.ann());
-                    size_t d_idx = exp_hash_.add(d);
-                    size_t new_d_idx = exp_hash_.add(new_d);
-                    d_couplings.emplace_back(d_idx, new_d_idx, f);
-                    new_terms[new_d] += 1.0;
-                } else if (d.fast_a_and_b_equal_b(sqop.cre()) and d.fast_a_and_b_eq_zero(uann)) {
-                    new_d = d;
-                    double f = -sign * apply_op(new_d, sqop.ann(), sqop.cre());
-                    size_t d_idx = exp_hash_.add(d);
-                    size_t new_d_idx = exp_hash_.add(new_d);
-                    d_couplings.emplace_back(d_idx, new_d_idx, f);
-                    new_terms[new_d] += 1.0;
+            } else if (d.fast_a_and_b_equal_b(cre) and d.fast_a_and_b_eq_zero(uann)) {
+                new_d = d;
+                const double f = apply_op(new_d, ann, cre);
+                if (new_d != d) {
+                    const size_t j = comp.dets.add(new_d);
+                    pairs.emplace_back(j, i, phaseless_ ? sign : sign * f);
                 }
             }
         }
-        for (const auto& d_c : new_terms) {
-            state[d_c.first] = 1.0;
-        }
-        if (inverse) {
-            inverse_couplings_.push_back(d_couplings);
-        } else {
-            couplings_.push_back(d_couplings);
+
+        // a pair is found twice if both determinants are reached before this factor
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end(),
+                                [](const auto& lhs, const auto& rhs) {
+                                    return std::get<0>(lhs) == std::get<0>(rhs);
+                                }),
+                    pairs.end());
+
+        for (const auto& [i, j, f] : pairs) {
+            comp.first.push_back(i);
+            comp.second.push_back(j);
+            comp.factor.push_back(f);
         }
+        comp.offset.push_back(comp.first.size());
     }
     timings_["total"] += t.get();
     timings_["couplings"] += t.get();
 }
 
-StateVector SparseFactExp::compute_exp(const SparseOperator& sop, const StateVector& state0,
-                                       bool inverse, double screen_thresh) {
+StateVector SparseFactExp::compute_exp(const CompiledOperator& comp, const SparseOperator& sop,
+                                       const StateVector& state0, bool inverse,
+                                       double screen_thresh) {
     local_timer t;
 
     // create and fill in the state vector
-    std::vector<double> state_c(exp_hash_.size(), 0.0);
-
-    // temporary space to store new elements
-    std::vector<std::pair<size_t, double>> new_terms(100);
-
+    const auto& dets = comp.dets;
+    std::vector<double> state_c(dets.size(), 0.0);
     for (const auto& det_c : state0) {
-        const Determinant& d = det_c.first;
-        double c = det_c.second;
-        size_t d_idx = exp_hash_.get_idx(d);
-        state_c[d_idx] = c;
+        state_c[dets.get_idx(det_c.first)] = det_c.second;
     }
 
     // loop over all operators
     for (size_t m = 0, nterms = sop.size(); m < nterms; m++) {
-        size_t n = inverse ? nterms - m - 1 : m;
-
-        double amp = sop.term(n).coefficient();
-
-        const std::vector<std::tuple<size_t, size_t, double>>& d_couplings =
-            inverse ? inverse_couplings_[m] : couplings_[m];
-
-        // zero the new terms
-        size_t k = 0;
-        const size_t vec_size = new_terms.size();
-        for (const auto& coupling : d_couplings) {
-            const size_t d_idx = std::get<0>(coupling);
-            const size_t new_d_idx = std::get<1>(coupling);
-            // special case of number operator
-            if (d_idx == new_d_idx)
-                continue;
-            const double f = amp * std::get<2>(coupling);
-            const double c = state_c[d_idx];
-            // do not apply this operator to this determinant if we expect the new determinant
+        const size_t n = inverse ? nterms - m - 1 : m;
+        const double amp = sop.term(n).coefficient();
+        const size_t begin = comp.offset[m];
+        const size_t end = comp.offset[m + 1];
+
+        // the pairs are disjoint, so each one can be rotated independently
+#pragma omp parallel for if (end - begin > fact_exp_parallel_threshold)
+        for (size_t k = begin; k < end; k++) {
+            const double f = amp * comp.factor[k];
+            const size_t i = comp.first[k];
+            const size_t j = comp.second[k];
+            const double ci = state_c[i];
+            const double cj = state_c[j];
+            // do not apply this operator to a determinant if we expect the new determinant
             // to have an amplitude less than screen_thresh
             // (here we use the approximation sin(x) ~ x, for x small)
-            if (std::fabs(f * c) > screen_thresh) {
-                if (k < vec_size) {
-                    new_terms[k] = std::make_pair(d_idx, c * (std::cos(f) - 1.0));
-                    new_terms[k + 1] = std::make_pair(new_d_idx, c * std::sin(f));
-                } else {
-                    new_terms.push_back(std::make_pair(d_idx, c * (std::cos(f) - 1.0)));
-                    new_terms.push_back(std::make_pair(new_d_idx, c * std::sin(f)));
+            const bool rotate_i = std::fabs(f * ci) > screen_thresh;
+            const bool rotate_j = std::fabs(f * cj) > screen_thresh;
+            if (rotate_i or rotate_j) {
+                const double cos_f = std::cos(f);
+                const double sin_f = std::sin(f);
+                double new_ci = ci;
+                double new_cj = cj;
+                if (rotate_i) {
+                    new_ci += ci * (cos_f - 1.0);
+                    new_cj += ci * sin_f;
+                }
+                if (rotate_j) {
+                    new_cj += cj * (cos_f - 1.0);
+                    new_ci -= cj * sin_f;
                 }
-                k += 2;
+                state_c[i] = new_ci;
+                state_c[j] = new_cj;
             }
         }
-        for (size_t j = 0; j < k; j++) {
-            state_c[new_terms[j].first] += new_terms[j].second;
-        }
     }
     StateVector state;
-    for (size_t idx = 0, maxidx = exp_hash_.size(); idx < maxidx; idx++) {
-        const Determinant& d = exp_hash_.get_det(idx);
-        state[d] = state_c[idx];
+    for (size_t idx = 0, maxidx = dets.size(); idx < maxidx; idx++) {
+        state[dets.get_det(idx)] = state_c[idx];
     }
     timings_["total"] += t.get();
     timings_["exp"] += t.get();
@@ -76,11 +76,40 @@ class SparseFactExp {
     std::map<std::string, double> timings() const;
 
   private:
+    /// @brief The couplings of a factorized exponential compiled for a given operator and a
+    /// given determinant support
+    ///
+    /// Each factor exp(t (op - op^+)) rotates pairs of determinants (I, J), with |J> = op |I>.
+    /// The pairs of the m-th factor applied are stored in the range [offset[m], offset[m + 1]) of
+    /// the flat arrays first (I), second (J), and factor (<J|op|I> times the sign of the
+    /// exponent). The pairs of a factor are disjoint, so they can be rotated in parallel.
+    struct CompiledOperator {
+        /// The (creation, annihilation) part of each operator term in the order applied
+        std::vector<std::pair<Determinant, Determinant>> ops;
+        /// The number of determinants in the support (stored first in dets)
+        size_t support_size = 0;
+        /// The support followed by the determinants generated by the exponential
+        DeterminantHashVec dets;
+        /// The first pair of each factor (size = number of factors + 1)
+        std::vector<size_t> offset;
+        /// The index of the determinant I of each pair
+        std::vector<size_t> first;
+        /// The index of the determinant J of each pair
+        std::vector<size_t> second;
+        /// The coupling factor of each pair
+        std::vector<double> factor;
+    };
+
     void apply_exp_op_fast(const Determinant& d, Determinant& new_d, const Determinant& cre,
                            const Determinant& ann, double amp, double c, StateVector& new_terms);
-    void compute_couplings(const SparseOperator& sop, const StateVector& state0, bool inverse);
-    StateVector compute_exp(const SparseOperator& sop, const StateVector& state0, bool inverse,
-                            double screen_thresh);
+    /// @return true if comp can be used to apply the exponential of sop to state
+    bool is_compiled(const CompiledOperator& comp, const SparseOperator& sop,
+                     const StateVector& state, bool inverse) const;
+    /// Compile the couplings of the exponential of sop for the support of state
+    void compile(CompiledOperator& comp, const SparseOperator& sop, const StateVector& state,
+                 bool inverse);
+    StateVector compute_exp(const CompiledOperator& comp, const SparseOperator& sop,
+                            const StateVector& state0, bool inverse, double screen_thresh);
     StateVector compute_cached(const SparseOperator& sop, const StateVector& state, bool inverse,
                                double screen_thresh);
     StateVector compute_on_the_fly_antihermitian(const SparseOperator& sop,
@@ -91,16 +120,10 @@ class SparseFactExp {
 
     /// Ignore the fermionic phase?
     bool phaseless_ = false;
-    /// Are the coupling initialized?
-    bool initialized_ = false;
-    /// Are the inverse couplings initialized?
-    bool initialized_inverse_ = false;
-    /// A map to store the determinants generated by the exponential
-    DeterminantHashVec exp_hash_;
-    /// A vector of determinant couplings
-    std::vector<std::vector<std::tuple<size_t, size_t, double>>> couplings_;
-    /// A vector of determinant couplings used when applying the inverse exponential
-    std::vector<std::vector<std::tuple<size_t, size_t, double>>> inverse_couplings_;
+    /// The compiled couplings used to apply the exponential
+    CompiledOperator compiled_;
+    /// The compiled couplings used to apply the inverse exponential
+    CompiledOperator compiled_inverse_;
     /// A map that stores timing information
     std::map<std::string, double> timings_;
 };
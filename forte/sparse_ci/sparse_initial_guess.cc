@@ -27,6 +27,10 @@
  * @END LICENSE
  */
 
+#include <cmath>
+#include <map>
+#include <unordered_map>
+
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/dimension.h"
@@ -47,27 +51,153 @@
 
 #include "sparse_initial_guess.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_max_threads() 1
+#endif
+
 namespace forte {
 
-std::tuple<std::shared_ptr<psi::Matrix>, std::shared_ptr<psi::Vector>, std::shared_ptr<psi::Matrix>>
-compute_s2_transformed_hamiltonian_matrix(const std::vector<Determinant>& dets,
-                                          std::shared_ptr<ActiveSpaceIntegrals> as_ints) {
-    size_t num_dets = dets.size();
-    // Form the S^2 operator matrix and diagonalize it
-    auto S2 = make_s2_matrix(dets);
+namespace {
+/// A block of guess determinants that share the same spatial configuration
+struct ConfigurationBlock {
+    /// the indices of the determinants in the guess space
+    std::vector<size_t> dets;
+    /// the occupation number of each orbital
+    std::vector<int> occ;
+    /// the S^2 eigenvectors in the basis of dets, grouped by multiplicity
+    std::map<int, std::vector<std::vector<double>>> vecs;
+    /// the multiplicity of the S^2 eigenvectors that are not close to integer spin
+    std::vector<double> non_integer;
+    /// the index of the first function of this block in the basis of each multiplicity
+    std::map<int, size_t> offset;
+};
+
+/// Group the determinants by spatial configuration and diagonalize S^2 within each group.
+/// Since S^2 does not couple different configurations, this gives the same spin-adapted basis
+/// as diagonalizing S^2 over the full guess space.
+std::vector<ConfigurationBlock> make_configuration_blocks(const std::vector<Determinant>& dets,
+                                                          size_t nmo) {
+    std::vector<ConfigurationBlock> blocks;
+    std::unordered_map<Configuration, size_t, Configuration::Hash> conf_map;
+    for (size_t I = 0, maxI = dets.size(); I < maxI; ++I) {
+        Configuration conf(dets[I]);
+        auto [it, inserted] = conf_map.emplace(conf, blocks.size());
+        if (inserted) {
+            ConfigurationBlock block;
+            block.occ.resize(nmo);
+            for (size_t p = 0; p < nmo; ++p) {
+                block.occ[p] = conf.is_docc(p) ? 2 : (conf.is_socc(p) ? 1 : 0);
+            }
+            blocks.push_back(block);
+        }
+        blocks[it->second].dets.push_back(I);
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        auto& block = blocks[b];
+        const size_t n = block.dets.size();
+        std::vector<Determinant> block_dets;
+        for (size_t I : block.dets) {
+            block_dets.push_back(dets[I]);
+        }
+        auto S2 = std::make_shared<psi::Matrix>("S^2", n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i; j < n; ++j) {
+                const double S2ij = spin2(block_dets[i], block_dets[j]);
+                S2->set(i, j, S2ij);
+                S2->set(j, i, S2ij);
+            }
+        }
+        psi::Matrix S2evecs("S^2", n, n);
+        psi::Vector S2evals("S^2", n);
+        S2->diagonalize(S2evecs, S2evals);
+        for (size_t k = 0; k < n; ++k) {
+            const double mult = std::sqrt(1.0 + 4.0 * S2evals.get(k));
+            if (not is_near_integer(mult, 1.0e-6)) {
+                block.non_integer.push_back(mult);
+                continue;
+            }
+            std::vector<double> vec(n);
+            for (size_t i = 0; i < n; ++i) {
+                vec[i] = S2evecs.get(i, k);
+            }
+            block.vecs[std::lround(mult)].push_back(vec);
+        }
+    }
+    return blocks;
+}
+
+/// Build the Hamiltonian in the basis of the spin-adapted functions of multiplicity m.
+/// Only pairs of configurations that differ by at most two electrons are considered.
+std::shared_ptr<psi::Matrix>
+make_spin_adapted_hamiltonian(const std::vector<Determinant>& dets,
+                              const std::vector<ConfigurationBlock>& blocks, int m, size_t nm,
+                              std::shared_ptr<ActiveSpaceIntegrals> as_ints) {
+    auto H = std::make_shared<psi::Matrix>("H", nm, nm);
+
+    // If we are running DiskDF then we need to revert to a single thread loop
+    auto threads = (as_ints->get_integral_type() == DiskDF) ? 1 : omp_get_max_threads();
+
+    const size_t nblocks = blocks.size();
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (size_t bI = 0; bI < nblocks; ++bI) {
+        const auto& blockI = blocks[bI];
+        auto itI = blockI.vecs.find(m);
+        if (itI == blockI.vecs.end())
+            continue;
+        const auto& vecsI = itI->second;
+        const size_t offI = blockI.offset.at(m);
+        const size_t ndetI = blockI.dets.size();
+
+        std::vector<double> Hdet;
+        for (size_t bJ = bI; bJ < nblocks; ++bJ) {
+            const auto& blockJ = blocks[bJ];
+            auto itJ = blockJ.vecs.find(m);
+            if (itJ == blockJ.vecs.end())
+                continue;
 
-    auto S2evecs = std::make_shared<psi::Matrix>("S^2", num_dets, num_dets);
-    auto S2evals = std::make_shared<psi::Vector>("S^2", num_dets);
-    S2->diagonalize(S2evecs, S2evals);
+            // skip configurations that differ by more than two electrons
+            int ndiff = 0;
+            for (size_t p = 0, nmo = blockI.occ.size(); p < nmo; ++p) {
+                ndiff += std::abs(blockI.occ[p] - blockJ.occ[p]);
+            }
+            if (ndiff > 4)
+                continue;
 
-    // Form the Hamiltonian
-    auto H = make_hamiltonian_matrix(dets, as_ints);
+            const auto& vecsJ = itJ->second;
+            const size_t offJ = blockJ.offset.at(m);
+            const size_t ndetJ = blockJ.dets.size();
 
-    // Project H onto the spin-adapted subspace
-    H->transform(S2evecs);
+            Hdet.assign(ndetI * ndetJ, 0.0);
+            for (size_t a = 0; a < ndetI; ++a) {
+                const auto& detA = dets[blockI.dets[a]];
+                for (size_t b = 0; b < ndetJ; ++b) {
+                    Hdet[a * ndetJ + b] = as_ints->slater_rules(detA, dets[blockJ.dets[b]]);
+                }
+            }
 
-    return std::make_tuple(H, S2evals, S2evecs);
+            for (size_t i = 0, ni = vecsI.size(); i < ni; ++i) {
+                for (size_t j = 0, nj = vecsJ.size(); j < nj; ++j) {
+                    double value = 0.0;
+                    for (size_t a = 0; a < ndetI; ++a) {
+                        double Hb = 0.0;
+                        for (size_t b = 0; b < ndetJ; ++b) {
+                            Hb += Hdet[a * ndetJ + b] * vecsJ[j][b];
+                        }
+                        value += vecsI[i][a] * Hb;
+                    }
+                    H->set(offI + i, offJ + j, value);
+                    H->set(offJ + j, offI + i, value);
+                }
+            }
+        }
+    }
+    return H;
 }
+} // namespace
 
 std::pair<sparse_mat, sparse_mat>
 find_initial_guess_det(const std::vector<Determinant>& guess_dets,
@@ -82,44 +212,40 @@ find_initial_guess_det(const std::vector<Determinant>& guess_dets,
         psi::outfile->Printf("\n  Initial guess determinants:         %zu", guess_dets.size());
     }
 
-    auto [HS2full, S2evals, S2evecs] =
-        compute_s2_transformed_hamiltonian_matrix(guess_dets, as_ints);
-
-    // Convert the S2evals to a std::vector
-    std::vector<double> multp_vec(num_guess_dets);
-    for (size_t i = 0; i < num_guess_dets; ++i) {
-        multp_vec[i] = std::sqrt(1.0 + 4.0 * S2evals->get(i));
-    }
-
-    auto groups = find_integer_groups(multp_vec, 1.0e-6);
-
-    std::vector<bool> is_integer_root(num_guess_dets, false);
-    for (const auto& [m, start, end] : groups) {
-        for (size_t i = start; i < end; ++i)
-            is_integer_root[i] = true;
+    // Diagonalize S^2 within each configuration
+    auto blocks = make_configuration_blocks(guess_dets, as_ints->nmo());
+
+    // Count the spin-adapted functions of each multiplicity and assign their offsets
+    std::map<int, size_t> mult_size;
+    std::vector<std::pair<size_t, double>> non_integer_roots;
+    for (size_t b = 0, nb = blocks.size(); b < nb; ++b) {
+        auto& block = blocks[b];
+        for (auto& [m, vecs] : block.vecs) {
+            block.offset[m] = mult_size[m];
+            mult_size[m] += vecs.size();
+        }
+        for (double mult : block.non_integer) {
+            non_integer_roots.emplace_back(b, mult);
+        }
     }
 
     if (print) {
+        psi::outfile->Printf("\n  Number of guess configurations:     %zu", blocks.size());
         psi::outfile->Printf("\n\n  Classification of the initial guess solutions");
         psi::outfile->Printf("\n\n  Number   2S+1   Selected");
         psi::outfile->Printf("\n  ------------------------");
-        for (const auto& [m, start, end] : groups) {
-            psi::outfile->Printf("\n %5d    %4d       %c", end - start, m,
-                                 m == multiplicity ? '*' : ' ');
+        for (const auto& [m, n] : mult_size) {
+            psi::outfile->Printf("\n %5zu    %4d       %c", n, m, m == multiplicity ? '*' : ' ');
         }
         psi::outfile->Printf("\n  ------------------------");
     }
 
-    // count the number of false in is_integer_root
-    size_t num_non_integer_roots =
-        std::count(is_integer_root.begin(), is_integer_root.end(), false);
-
-    if (num_non_integer_roots > 0) {
+    if (non_integer_roots.size() > 0) {
         psi::outfile->Printf("\n\n  The following guess solutions are not close to integer spin "
                              "and will be ignored");
-        for (size_t i = 0; i < num_guess_dets; ++i) {
-            if (!is_integer_root[i])
-                psi::outfile->Printf("\n %5d    %4.2f", i, multp_vec[i]);
+        psi::outfile->Printf("\n\n  Config   2S+1");
+        for (const auto& [b, mult] : non_integer_roots) {
+            psi::outfile->Printf("\n %6zu   %4.2f", b, mult);
         }
     }
 
@@ -130,37 +256,41 @@ find_initial_guess_det(const std::vector<Determinant>& guess_dets,
     double E0 = as_ints->nuclear_repulsion_energy() + as_ints->frozen_core_energy() +
                 as_ints->scalar_energy();
 
-    // Loop over the groups of roots with the same multiplicity and compute the guess vectors
-    for (const auto& [m, start, end] : groups) {
-        // setup dimension objects
-        auto start_dim = psi::Dimension(1);
-        start_dim[0] = start;
-        auto end_dim = psi::Dimension(1);
-        end_dim[0] = end;
-        auto block_dim = psi::Dimension(1);
-        block_dim[0] = end - start;
-        auto col_dim = psi::Dimension(1);
-        col_dim[0] = num_guess_dets;
-        auto zero_dim = psi::Dimension(1);
-        zero_dim[0] = 0;
-
-        auto block_slice = psi::Slice(start_dim, end_dim);
-        auto col_slice = psi::Slice(zero_dim, col_dim);
-        auto HS2_block = HS2full->get_block(block_slice, block_slice);
-        psi::Vector HS2evals_block("HS2", block_dim);
-        psi::Matrix HS2evecs_block("HS2", block_dim, block_dim);
-        HS2_block->diagonalize(HS2evecs_block, HS2evals_block);
-        auto S2evecs_block = S2evecs->get_block(col_slice, block_slice);
-        auto S2evals_block = S2evals->get_block(block_slice);
-
-        std::vector<double> energies = Vector_to_vector_double(HS2evals_block);
+    // Build and diagonalize the Hamiltonian within each multiplicity. Only the target
+    // multiplicity is needed unless we project out the other ones. With a user guess the guess
+    // energies are never used.
+    for (const auto& [m, nm] : mult_size) {
+        if ((user_guess.size() > 0) or ((m != multiplicity) and (not do_spin_project)))
+            continue;
+
+        auto Hm = make_spin_adapted_hamiltonian(guess_dets, blocks, m, nm, as_ints);
+        psi::Vector Hm_evals("H", nm);
+        psi::Matrix Hm_evecs("H", nm, nm);
+        Hm->diagonalize(Hm_evecs, Hm_evals);
+
+        std::vector<double> energies = Vector_to_vector_double(Hm_evals);
         for (auto& e : energies) {
             e += E0;
         }
-        std::vector<double> s2 = Vector_to_vector_double(S2evals_block);
+        std::vector<double> s2(nm, 0.25 * (m * m - 1));
 
-        auto C_block = std::make_shared<psi::Matrix>("C", col_dim, block_dim);
-        C_block->gemm(false, false, 1.0, S2evecs_block, HS2evecs_block, 0.0);
+        // Back transform the eigenvectors to the determinant basis
+        auto C_block = std::make_shared<psi::Matrix>("C", num_guess_dets, nm);
+        for (const auto& block : blocks) {
+            auto it = block.vecs.find(m);
+            if (it == block.vecs.end())
+                continue;
+            const auto& vecs = it->second;
+            const size_t offset = block.offset.at(m);
+            for (size_t i = 0, ni = vecs.size(); i < ni; ++i) {
+                for (size_t r = 0; r < nm; ++r) {
+                    const double c = Hm_evecs.get(offset + i, r);
+                    for (size_t a = 0, na = block.dets.size(); a < na; ++a) {
+                        C_block->add(block.dets[a], r, vecs[i][a] * c);
+                    }
+                }
+            }
+        }
 
         guess_info[m] =
             std::tuple<std::vector<double>, std::vector<double>, std::shared_ptr<psi::Matrix>>(
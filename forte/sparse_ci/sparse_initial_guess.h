@@ -39,17 +39,13 @@ using sparse_mat = std::vector<std::vector<std::pair<size_t, double>>>;
 class DavidsonLiuSolver;
 class ActiveSpaceIntegrals;
 
-/// @brief Return the Hamiltonian matrix transformed into the S^2 eigenbasis
-/// @param guess_dets A vector of guess determinants
-/// @param as_ints The active space integrals object
-/// @return A tuple of the form (S^2 transformed Hamiltonian matrix, S^2 eigenvalues, S^2
-/// eigenvectors)
-std::tuple<std::shared_ptr<psi::Matrix>, std::shared_ptr<psi::Vector>, std::shared_ptr<psi::Matrix>>
-compute_s2_transformed_hamiltonian_matrix(const std::vector<Determinant>& dets,
-                                          std::shared_ptr<ActiveSpaceIntegrals> as_ints);
-
 /// @brief Generate initial guess vectors for the Davidson-Liu solver starting from a set of guess
 /// determinants
+///
+/// The guess determinants are grouped by spatial configuration and S^2 is diagonalized within each
+/// configuration. The Hamiltonian is then built and diagonalized only in the basis of spin-adapted
+/// functions of the target multiplicity (and of the other multiplicities when do_spin_project is
+/// true), skipping pairs of configurations that differ by more than two electrons.
 /// @param guess_dets A vector of guess determinants
 /// @param guess_dets_pos A vector of the positions of the guess determinants in the CI vector
 /// @param num_guess_states The number of guess states to generate
@@ -26,19 +26,23 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <numeric>
 
 #define FMT_HEADER_ONLY
 #include "lib/fmt/core.h"
 
-#include "psi4/liboptions/liboptions.h"
-#include "psi4/libmints/dimension.h"
-#include "psi4/libmints/molecule.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/psi4-dec.h"
 
+#include "base_classes/forte_options.h"
 #include "base_classes/mo_space_info.h"
+#include "integrals/active_space_integrals.h"
 #include "helpers/printing.h"
 
 #include "v2rdm.h"
@@ -57,146 +61,372 @@ struct dm3 {
     double val;
 };
 
-V2RDM::V2RDM(psi::SharedWavefunction ref_wfn, psi::Options& options,
-             std::shared_ptr<ForteIntegrals> ints, std::shared_ptr<MOSpaceInfo> mo_space_info)
-    : Wavefunction(options), ints_(ints), mo_space_info_(mo_space_info) {
-    shallow_copy(ref_wfn);
-    reference_wavefunction_ = ref_wfn;
+namespace {
+/// Number of records read from a v2RDM file at once
+constexpr size_t v2rdm_chunk_size = 1 << 20;
 
-    print_method_banner({"V2RDM-CASSCF Interface"});
+/// Number of records of each v2RDM file included in the checksum of the cache fingerprint
+constexpr size_t v2rdm_fingerprint_records = 4096;
+
+/// The name of the binary file used to cache the active-space RDMs
+const std::string v2rdm_cache_file = "v2rdm_rdms.bin";
+
+/// Tag identifying the cache file format
+constexpr uint64_t v2rdm_cache_tag = 0x46524445324d4452;
+
+/// A permutation of the indices of an RDM element: element (p[0], p[1], ...) of the permuted
+/// index tuple equals idx[perm[k]], and D(permuted) = sign * D(idx)
+struct IndexPermutation {
+    std::vector<size_t> perm;
+    double sign;
+};
+
+/**
+ * @brief Generate the permutational symmetry group of an RDM block
+ * @param nbody the number of upper (= lower) indices
+ * @param same_spin the lists of upper indices with the same spin (lower indices follow)
+ *
+ * The group contains the (signed) permutations of same-spin upper indices, the same for the
+ * lower indices, and the exchange of upper and lower indices (real RDMs are symmetric).
+ */
+std::vector<IndexPermutation>
+rdm_symmetry_group(size_t nbody, const std::vector<std::vector<size_t>>& same_spin) {
+    std::vector<IndexPermutation> generators;
+    std::vector<size_t> id(2 * nbody);
+    std::iota(id.begin(), id.end(), 0);
+
+    for (const auto& group : same_spin) {
+        for (size_t n = 1; n < group.size(); ++n) {
+            for (size_t shift : {size_t(0), nbody}) {
+                auto perm = id;
+                std::swap(perm[group[n - 1] + shift], perm[group[n] + shift]);
+                generators.push_back({perm, -1.0});
+            }
+        }
+    }
+    auto herm = id;
+    std::rotate(herm.begin(), herm.begin() + nbody, herm.end());
+    generators.push_back({herm, 1.0});
+
+    // closure of the generators
+    std::map<std::vector<size_t>, double> elements{{id, 1.0}};
+    std::vector<IndexPermutation> group{{id, 1.0}};
+    for (size_t g = 0; g < group.size(); ++g) {
+        for (const auto& gen : generators) {
+            std::vector<size_t> perm(2 * nbody);
+            for (size_t k = 0; k < 2 * nbody; ++k) {
+                perm[k] = group[g].perm[gen.perm[k]];
+            }
+            if (elements.emplace(perm, group[g].sign * gen.sign).second) {
+                group.push_back({perm, group[g].sign * gen.sign});
+            }
+        }
+    }
+    return group;
+}
+
+/**
+ * @brief Fill in the elements of an RDM block related by permutational symmetry
+ *
+ * v2RDM-CASSCF may store only a unique subset of the elements. Each orbit of the symmetry group
+ * is completed by the thread that owns its canonical (lowest address) element, taking the value
+ * from any nonzero member, so the elements already present are left unchanged.
+ */
+void complete_rdm_symmetry(ambit::Tensor& D, const std::vector<IndexPermutation>& group) {
+    const auto& dims = D.dims();
+    const size_t rank = dims.size();
+    const size_t n = dims[0];
+    std::vector<size_t> strides(rank, 1);
+    for (size_t k = rank - 1; k > 0; --k) {
+        strides[k - 1] = strides[k] * n;
+    }
+    const size_t ng = group.size();
+    auto& data = D.data();
+    const size_t size = data.size();
+
+#pragma omp parallel
+    {
+        std::vector<size_t> idx(rank);
+        std::vector<size_t> addr(ng);
+
+#pragma omp for schedule(dynamic, 4096)
+        for (size_t I = 0; I < size; ++I) {
+            for (size_t k = 0, rem = I; k < rank; ++k) {
+                idx[k] = rem / strides[k];
+                rem %= strides[k];
+            }
+
+            bool canonical = true;
+            bool zero = false;
+            for (size_t g = 0; g < ng; ++g) {
+                size_t J = 0;
+                for (size_t k = 0; k < rank; ++k) {
+                    J += idx[group[g].perm[k]] * strides[k];
+                }
+                if (J < I) {
+                    canonical = false;
+                    break;
+                }
+                zero = zero or (J == I and group[g].sign < 0.0);
+                addr[g] = J;
+            }
+            if (not canonical or zero)
+                continue;
+
+            double value = 0.0;
+            for (size_t g = 0; g < ng; ++g) {
+                if (data[addr[g]] != 0.0) {
+                    value = group[g].sign * data[addr[g]];
+                    break;
+                }
+            }
+            for (size_t g = 0; g < ng; ++g) {
+                data[addr[g]] = group[g].sign * value;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Read all records of a v2RDM density file in large chunks
+ * @param scatter function called (in parallel) for each record, returns false if the record
+ *        refers to an orbital outside the active space
+ * @return the number of records
+ */
+template <typename Record, typename Scatter>
+size_t read_records(std::shared_ptr<PSIO> psio, unsigned int file, const std::string& label,
+                    Scatter scatter) {
+    long int nline;
+    psio_address addr = PSIO_ZERO;
+    psio->open(file, PSIO_OPEN_OLD);
+    psio->read_entry(file, "length", (char*)&nline, sizeof(long int));
+
+    const size_t nrecords = static_cast<size_t>(nline);
+    std::vector<Record> buffer(std::min(nrecords, v2rdm_chunk_size));
+    size_t ninvalid = 0;
+    for (size_t start = 0; start < nrecords; start += buffer.size()) {
+        size_t nread = std::min(buffer.size(), nrecords - start);
+        psio->read(file, label.c_str(), (char*)buffer.data(), nread * sizeof(Record), addr,
+                   &addr);
+#pragma omp parallel for reduction(+ : ninvalid)
+        for (size_t r = 0; r < nread; ++r) {
+            if (not scatter(buffer[r]))
+                ninvalid += 1;
+        }
+    }
+    psio->close(file, 1);
+
+    if (ninvalid > 0) {
+        outfile->Printf("\n  The active block of FORTE is different from V2RDM-CASSCF.");
+        outfile->Printf("\n  Please check the input file and make the active block consistent.");
+        throw psi::PSIEXCEPTION(std::to_string(ninvalid) + " records of " + label +
+                                " refer to orbitals outside the active space of FORTE.");
+    }
+    return nrecords;
+}
+
+/// Append the number of records and a FNV-1a checksum of the first records of a v2RDM file
+template <typename Record>
+void append_fingerprint(std::shared_ptr<PSIO> psio, unsigned int file, const std::string& label,
+                        std::vector<uint64_t>& fingerprint) {
+    long int nline;
+    psio_address addr = PSIO_ZERO;
+    psio->open(file, PSIO_OPEN_OLD);
+    psio->read_entry(file, "length", (char*)&nline, sizeof(long int));
+    std::vector<Record> buffer(std::min(static_cast<size_t>(nline), v2rdm_fingerprint_records));
+    psio->read(file, label.c_str(), (char*)buffer.data(), buffer.size() * sizeof(Record), addr,
+               &addr);
+    psio->close(file, 1);
+
+    uint64_t hash = 0xcbf29ce484222325;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(buffer.data());
+    for (size_t b = 0; b < buffer.size() * sizeof(Record); ++b) {
+        hash = (hash ^ bytes[b]) * 0x100000001b3;
+    }
+    fingerprint.push_back(static_cast<uint64_t>(nline));
+    fingerprint.push_back(hash);
+}
+
+/// Throw if any of the v2RDM files does not exist
+void check_files_exist(std::shared_ptr<PSIO> psio,
+                       const std::map<unsigned int, std::string>& filename) {
+    for (const auto& [file, name] : filename) {
+        if (!psio->exists(file)) {
+            std::string error = "V2RDM file for " + name + " does not exist";
+            throw psi::PSIEXCEPTION(error);
+        }
+    }
+}
+
+const std::map<unsigned int, std::string> d2_filename{
+    {PSIF_V2RDM_D2AA, "D2aa"}, {PSIF_V2RDM_D2AB, "D2ab"}, {PSIF_V2RDM_D2BB, "D2bb"}};
+
+const std::map<unsigned int, std::string> d3_filename{{PSIF_V2RDM_D3AAA, "D3aaa"},
+                                                      {PSIF_V2RDM_D3AAB, "D3aab"},
+                                                      {PSIF_V2RDM_D3BBA, "D3bba"},
+                                                      {PSIF_V2RDM_D3BBB, "D3bbb"}};
+} // namespace
+
+V2RDM::V2RDM(StateInfo state, size_t nroot, std::shared_ptr<MOSpaceInfo> mo_space_info,
+             std::shared_ptr<ActiveSpaceIntegrals> as_ints)
+    : ActiveSpaceMethod(state, nroot, mo_space_info, as_ints) {
     startup();
 }
 
-V2RDM::~V2RDM() {}
+void V2RDM::set_options(std::shared_ptr<ForteOptions> options) {
+    do_3pdm_ = options->get_str("THREEPDC") != "ZERO";
+    avg_dens_spin_ = options->get_bool("AVG_DENS_SPIN");
+    cache_rdms_ = options->get_bool("V2RDM_CACHE_RDMS");
+    write_density_type_ = options->get_str("WRITE_DENSITY_TYPE");
+}
 
 void V2RDM::startup() {
     // number of MO per irrep
-    nmopi_ = this->nmopi();
-    nirrep_ = this->nirrep();
+    nmopi_ = mo_space_info_->dimension("ALL");
+    nirrep_ = mo_space_info_->nirrep();
     fdoccpi_ = mo_space_info_->dimension("FROZEN_DOCC");
     rdoccpi_ = mo_space_info_->dimension("RESTRICTED_DOCC");
     active_ = mo_space_info_->dimension("ACTIVE");
+    nactv_ = mo_space_info_->size("ACTIVE");
+
+    // number of active electrons
+    size_t ninact_docc = mo_space_info_->size("INACTIVE_DOCC");
+    na_ = state_.na() - ninact_docc;
+    nb_ = state_.nb() - ninact_docc;
 
-    // map active absolute index to relative index
+    // map absolute index to relative active index, nactv_ marks the non-active orbitals
+    abs_to_rel_vec_.assign(nmopi_.sum(), nactv_);
     for (size_t h = 0, offset_abs = 0, offset_rel = 0; h < nirrep_; ++h) {
         size_t nact_h = active_[h];
         for (size_t u = 0; u < nact_h; ++u) {
             size_t abs = fdoccpi_[h] + rdoccpi_[h] + u + offset_abs;
-            size_t rel = u + offset_rel;
-            abs_to_rel_[abs] = rel;
+            abs_to_rel_vec_[abs] = u + offset_rel;
         }
         offset_rel += active_[h];
         offset_abs += nmopi_[h];
     }
+}
+
+double V2RDM::compute_energy() {
+    print_method_banner({"V2RDM-CASSCF Interface"});
 
-    // read 2-pdm
-    read_2pdm();
+    // read 2-pdm and 3-pdm, from the cache if possible
+    D2_.clear();
+    D3_.clear();
+    std::vector<uint64_t> fp;
+    if (cache_rdms_) {
+        fp = fingerprint(do_3pdm_);
+    }
+    if (not(cache_rdms_ and read_cache(do_3pdm_, fp))) {
+        read_2pdm();
+        if (do_3pdm_) {
+            read_3pdm();
+        }
+        if (cache_rdms_) {
+            write_cache(fp);
+        }
+    }
+    average_2pdm();
 
     // build opdm
     build_opdm();
 
-    // read 3-pdm
-    if (options_.get_str("THREEPDC") != "ZERO") {
-        read_3pdm();
+    if (do_3pdm_) {
+        average_3pdm();
     }
 
-    // frozen-core energy
-    frozen_core_energy_ = ints_->frozen_core_energy();
-
-    // orbital spaces
-    core_mos_ = mo_space_info_->corr_absolute_mo("RESTRICTED_DOCC");
-    actv_mos_ = mo_space_info_->corr_absolute_mo("ACTIVE");
-
     // write density to files
-    if (options_.get_str("WRITE_DENSITY_TYPE") == "DENSITY") {
+    if (write_density_type_ != "NONE") {
         write_density_to_file();
     }
+
+    double energy = compute_ref_energy();
+    energies_ = std::vector<double>(nroot_, energy);
+
+    psi::Process::environment.globals["CURRENT ENERGY"] = energy;
+    psi::Process::environment.globals["V2RDM ENERGY"] = energy;
+
+    return energy;
+}
+
+std::vector<uint64_t> V2RDM::fingerprint(bool need_3pdm) {
+    std::shared_ptr<PSIO> psio(new PSIO());
+    std::vector<uint64_t> fp;
+    check_files_exist(psio, d2_filename);
+    for (const auto& [file, name] : d2_filename) {
+        append_fingerprint<tpdm>(psio, file, name, fp);
+    }
+    if (need_3pdm) {
+        check_files_exist(psio, d3_filename);
+        for (const auto& [file, name] : d3_filename) {
+            append_fingerprint<dm3>(psio, file, name, fp);
+        }
+    }
+    return fp;
 }
 
 void V2RDM::read_2pdm() {
-    // map file names
-    std::map<unsigned int, std::string> filename;
-    filename[PSIF_V2RDM_D2AA] = "D2aa";
-    filename[PSIF_V2RDM_D2AB] = "D2ab";
-    filename[PSIF_V2RDM_D2BB] = "D2bb";
-
     // test if files exist
     std::string str = "Testing if 2RDM files exist";
     outfile->Printf("\n  %-45s ...", str.c_str());
     std::shared_ptr<PSIO> psio(new PSIO());
-    for (const auto& file : {PSIF_V2RDM_D2AA, PSIF_V2RDM_D2AB, PSIF_V2RDM_D2BB}) {
-        if (!psio->exists(file)) {
-            std::string error = "V2RDM file for " + filename[file] + " does not exist";
-            throw psi::PSIEXCEPTION(error);
-        }
-    }
+    check_files_exist(psio, d2_filename);
     outfile->Printf("    OK.");
 
     // initialization of 2PDM
-    size_t nactv = mo_space_info_->size("ACTIVE");
+    size_t nactv = nactv_;
     size_t nactv2 = nactv * nactv;
     size_t nactv3 = nactv * nactv2;
 
-    // test if active orbitals are consistent in forte and v2rdm-casscf
-    long int nab;
-    psio_address addr_ab = PSIO_ZERO;
-    psio->open(PSIF_V2RDM_D2AB, PSIO_OPEN_OLD);
-    psio->read_entry(PSIF_V2RDM_D2AB, "length", (char*)&nab, sizeof(long int));
-
-    size_t nsymgem = 0; // number of totally symmetric geminals
-    for (size_t h = 0; h < nirrep_; ++h) {
-        nsymgem += active_[h] * active_[h];
-    }
-    for (size_t n = 0; n < nsymgem; ++n) {
-        tpdm d2;
-        psio->read(PSIF_V2RDM_D2AB, "D2ab", (char*)&d2, sizeof(tpdm), addr_ab, &addr_ab);
-        size_t l = static_cast<size_t>(d2.l);
-        if (abs_to_rel_.find(l) == abs_to_rel_.end()) {
-            outfile->Printf("\n  The active block of FORTE is different from "
-                            "V2RDM-CASSCF.");
-            outfile->Printf("\n  Please check the input file and make the "
-                            "active block consistent.");
-            throw psi::PSIEXCEPTION("The active block of FORTE is different from V2RDM-CASSCF.");
-        }
-    }
-    psio->close(PSIF_V2RDM_D2AB, 1);
-
-    // Read 2RDM
+    // Read 2RDM in chunks and scatter the elements in parallel, rejecting the records that refer
+    // to orbitals outside the active space
     str = "Reading 2RDMs";
     outfile->Printf("\n  %-45s ...", str.c_str());
-    for (const auto& file : {PSIF_V2RDM_D2AA, PSIF_V2RDM_D2AB, PSIF_V2RDM_D2BB}) {
+    const auto& rel = abs_to_rel_vec_;
+    auto rel_index = [&](int p) {
+        return (p >= 0 and static_cast<size_t>(p) < rel.size()) ? rel[p] : nactv;
+    };
+    for (const auto& [file, name] : d2_filename) {
         ambit::Tensor D2 =
-            ambit::Tensor::build(ambit::CoreTensor, filename[file], {nactv, nactv, nactv, nactv});
-
-        long int nline;
-        psio_address addr = PSIO_ZERO;
-        psio->open(file, PSIO_OPEN_OLD);
-        psio->read_entry(file, "length", (char*)&nline, sizeof(long int));
-
-        for (int n = 0; n < nline; ++n) {
-            tpdm d2;
-            psio->read(file, filename[file].c_str(), (char*)&d2, sizeof(tpdm), addr, &addr);
-            size_t i = abs_to_rel_[static_cast<size_t>(d2.i)];
-            size_t j = abs_to_rel_[static_cast<size_t>(d2.j)];
-            size_t k = abs_to_rel_[static_cast<size_t>(d2.k)];
-            size_t l = abs_to_rel_[static_cast<size_t>(d2.l)];
-
-            size_t idx = i * nactv3 + j * nactv2 + k * nactv + l;
-            D2.data()[idx] = d2.val;
-        }
-        psio->close(file, 1);
+            ambit::Tensor::build(ambit::CoreTensor, name, {nactv, nactv, nactv, nactv});
+        auto& d2_data = D2.data();
+
+        read_records<tpdm>(psio, file, name, [&](const tpdm& d2) {
+            size_t i = rel_index(d2.i);
+            size_t j = rel_index(d2.j);
+            size_t k = rel_index(d2.k);
+            size_t l = rel_index(d2.l);
+            if (std::max({i, j, k, l}) >= nactv)
+                return false;
+            d2_data[i * nactv3 + j * nactv2 + k * nactv + l] = d2.val;
+            return true;
+        });
 
         D2_.push_back(D2);
     }
     outfile->Printf("    Done.");
 
+    // apply the permutational symmetry
+    str = "Completing 2RDMs by symmetry";
+    outfile->Printf("\n  %-45s ...", str.c_str());
+    auto group_aa = rdm_symmetry_group(2, {{0, 1}});
+    auto group_ab = rdm_symmetry_group(2, {});
+    complete_rdm_symmetry(D2_[0], group_aa);
+    complete_rdm_symmetry(D2_[1], group_ab);
+    complete_rdm_symmetry(D2_[2], group_aa);
+    outfile->Printf("    Done.");
+}
+
+void V2RDM::average_2pdm() {
     // average Daa and Dbb
-    if (options_.get_bool("AVG_DENS_SPIN")) {
+    if (avg_dens_spin_) {
+        size_t nactv = nactv_;
+
         // reference D2aa, D2ab, D2bb to D2_ element
         ambit::Tensor& D2aa = D2_[0];
         ambit::Tensor& D2bb = D2_[2];
 
-        str = "Averaging 2RDM AA and BB blocks";
+        std::string str = "Averaging 2RDM AA and BB blocks";
         outfile->Printf("\n  %-45s ...", str.c_str());
         ambit::Tensor D2 =
             ambit::Tensor::build(ambit::CoreTensor, "D2avg_aa", {nactv, nactv, nactv, nactv});
@@ -214,18 +444,12 @@ void V2RDM::build_opdm() {
     outfile->Printf("\n  %-45s ...", str.c_str());
 
     // initialization of OPDM
-    size_t nactv = mo_space_info_->size("ACTIVE");
+    size_t nactv = nactv_;
     size_t nactv2 = nactv * nactv;
     size_t nactv3 = nactv * nactv2;
     D1a_ = ambit::Tensor::build(ambit::CoreTensor, "D1a", {nactv, nactv});
     D1b_ = ambit::Tensor::build(ambit::CoreTensor, "D1b", {nactv, nactv});
 
-    // number of active electrons
-    size_t nalfa = this->nalpha() - mo_space_info_->size("FROZEN_DOCC") -
-                   mo_space_info_->size("RESTRICTED_DOCC");
-    size_t nbeta = this->nbeta() - mo_space_info_->size("FROZEN_DOCC") -
-                   mo_space_info_->size("RESTRICTED_DOCC");
-
     // reference D2aa, D2ab, D2bb to D2_ element
     ambit::Tensor& D2aa = D2_[0];
     ambit::Tensor& D2ab = D2_[1];
@@ -244,14 +468,14 @@ void V2RDM::build_opdm() {
                 vb += D2ab.data()[x * nactv3 + u * nactv2 + x * nactv + v];
             }
 
-            D1a_.data()[u * nactv + v] = va / (nalfa + nbeta - 1.0);
-            D1b_.data()[u * nactv + v] = vb / (nalfa + nbeta - 1.0);
+            D1a_.data()[u * nactv + v] = va / (na_ + nb_ - 1.0);
+            D1b_.data()[u * nactv + v] = vb / (na_ + nb_ - 1.0);
         }
     }
     outfile->Printf("    Done.");
 
     // average Da and Db
-    if (options_.get_bool("AVG_DENS_SPIN")) {
+    if (avg_dens_spin_) {
         str = "Averaging 1RDM A and B blocks";
         outfile->Printf("\n  %-45s ...", str.c_str());
         ambit::Tensor D = ambit::Tensor::build(ambit::CoreTensor, "D1avg", {nactv, nactv});
@@ -265,90 +489,78 @@ void V2RDM::build_opdm() {
 }
 
 void V2RDM::read_3pdm() {
-    // map file names
-    std::map<unsigned int, std::string> filename;
-    filename[PSIF_V2RDM_D3AAA] = "D3aaa";
-    filename[PSIF_V2RDM_D3AAB] = "D3aab";
-    filename[PSIF_V2RDM_D3BBA] = "D3bba";
-    filename[PSIF_V2RDM_D3BBB] = "D3bbb";
-
     // test if files exist
     std::string str = "Testing if 3RDM files exist";
     outfile->Printf("\n  %-45s ...", str.c_str());
     std::shared_ptr<PSIO> psio(new PSIO());
-    for (const auto& file :
-         {PSIF_V2RDM_D3AAA, PSIF_V2RDM_D3AAB, PSIF_V2RDM_D3BBA, PSIF_V2RDM_D3BBB}) {
-        if (!psio->exists(file)) {
-            std::string error = "V2RDM file for " + filename[file] + " does not exist";
-            throw psi::PSIEXCEPTION(error);
-        }
-    }
+    check_files_exist(psio, d3_filename);
     outfile->Printf("    OK.");
 
     // initialization of 3PDM
-    size_t nactv = mo_space_info_->size("ACTIVE");
+    size_t nactv = nactv_;
     size_t nactv2 = nactv * nactv;
     size_t nactv3 = nactv * nactv2;
     size_t nactv4 = nactv * nactv3;
     size_t nactv5 = nactv * nactv4;
 
-    // Read 3RDM
+    // Read 3RDM in chunks and scatter the elements in parallel, rejecting the records that refer
+    // to orbitals outside the active space
     str = "Reading 3RDMs";
     outfile->Printf("\n  %-45s ...", str.c_str());
-    for (const auto& file :
-         {PSIF_V2RDM_D3AAA, PSIF_V2RDM_D3AAB, PSIF_V2RDM_D3BBA, PSIF_V2RDM_D3BBB}) {
-        ambit::Tensor D3 = ambit::Tensor::build(ambit::CoreTensor, filename[file],
+    const auto& rel = abs_to_rel_vec_;
+    auto rel_index = [&](int p) {
+        return (p >= 0 and static_cast<size_t>(p) < rel.size()) ? rel[p] : nactv;
+    };
+    for (const auto& [file, name] : d3_filename) {
+        ambit::Tensor D3 = ambit::Tensor::build(ambit::CoreTensor, name,
                                                 {nactv, nactv, nactv, nactv, nactv, nactv});
-
-        long int nline;
-        psio_address addr = PSIO_ZERO;
-        psio->open(file, PSIO_OPEN_OLD);
-        psio->read_entry(file, "length", (char*)&nline, sizeof(long int));
-
-        if (file != PSIF_V2RDM_D3BBA) {
-            for (int nl = 0; nl < nline; ++nl) {
-                dm3 d3;
-                psio->read(file, filename[file].c_str(), (char*)&d3, sizeof(dm3), addr, &addr);
-                size_t i = abs_to_rel_[static_cast<size_t>(d3.i)];
-                size_t j = abs_to_rel_[static_cast<size_t>(d3.j)];
-                size_t k = abs_to_rel_[static_cast<size_t>(d3.k)];
-                size_t l = abs_to_rel_[static_cast<size_t>(d3.l)];
-                size_t m = abs_to_rel_[static_cast<size_t>(d3.m)];
-                size_t n = abs_to_rel_[static_cast<size_t>(d3.n)];
-
-                size_t idx = i * nactv5 + j * nactv4 + k * nactv3 + l * nactv2 + m * nactv + n;
-                D3.data()[idx] = d3.val;
-            }
-        } else {
-            for (int nl = 0; nl < nline; ++nl) {
-                dm3 d3;
-                psio->read(file, filename[file].c_str(), (char*)&d3, sizeof(dm3), addr, &addr);
-                size_t i = abs_to_rel_[static_cast<size_t>(d3.i)];
-                size_t j = abs_to_rel_[static_cast<size_t>(d3.j)];
-                size_t k = abs_to_rel_[static_cast<size_t>(d3.k)];
-                size_t l = abs_to_rel_[static_cast<size_t>(d3.l)];
-                size_t m = abs_to_rel_[static_cast<size_t>(d3.m)];
-                size_t n = abs_to_rel_[static_cast<size_t>(d3.n)];
-
-                size_t idx = k * nactv5 + i * nactv4 + j * nactv3 + n * nactv2 + l * nactv + m;
-                D3.data()[idx] = d3.val;
-            }
-        }
-        psio->close(file, 1);
+        auto& d3_data = D3.data();
+
+        // D3bba is stored as D3abb
+        bool bba = file == PSIF_V2RDM_D3BBA;
+        read_records<dm3>(psio, file, name, [&](const dm3& d3) {
+            size_t i = rel_index(d3.i);
+            size_t j = rel_index(d3.j);
+            size_t k = rel_index(d3.k);
+            size_t l = rel_index(d3.l);
+            size_t m = rel_index(d3.m);
+            size_t n = rel_index(d3.n);
+            if (std::max({i, j, k, l, m, n}) >= nactv)
+                return false;
+
+            size_t idx = bba ? k * nactv5 + i * nactv4 + j * nactv3 + n * nactv2 + l * nactv + m
+                             : i * nactv5 + j * nactv4 + k * nactv3 + l * nactv2 + m * nactv + n;
+            d3_data[idx] = d3.val;
+            return true;
+        });
 
         D3_.push_back(D3);
     }
     outfile->Printf("    Done.");
 
+    // apply the permutational symmetry
+    str = "Completing 3RDMs by symmetry";
+    outfile->Printf("\n  %-45s ...", str.c_str());
+    auto group_aaa = rdm_symmetry_group(3, {{0, 1, 2}});
+    complete_rdm_symmetry(D3_[0], group_aaa);
+    complete_rdm_symmetry(D3_[1], rdm_symmetry_group(3, {{0, 1}}));
+    complete_rdm_symmetry(D3_[2], rdm_symmetry_group(3, {{1, 2}}));
+    complete_rdm_symmetry(D3_[3], group_aaa);
+    outfile->Printf("    Done.");
+}
+
+void V2RDM::average_3pdm() {
     // average Daaa and Dbbb, Daab and Dabb
-    if (options_.get_bool("AVG_DENS_SPIN")) {
+    if (avg_dens_spin_) {
+        size_t nactv = nactv_;
+
         // reference D3aaa, D3aab, D3abb, D3bbb to D3_ element
         ambit::Tensor& D3aaa = D3_[0];
         ambit::Tensor& D3aab = D3_[1];
         ambit::Tensor& D3abb = D3_[2];
         ambit::Tensor& D3bbb = D3_[3];
 
-        str = "Averaging 3RDM AAA & BBB, AAB & ABB blocks";
+        std::string str = "Averaging 3RDM AAA & BBB, AAB & ABB blocks";
         outfile->Printf("\n  %-45s ...", str.c_str());
         ambit::Tensor D3 = ambit::Tensor::build(ambit::CoreTensor, "D3avg_aa",
                                                 {nactv, nactv, nactv, nactv, nactv, nactv});
@@ -365,193 +577,248 @@ void V2RDM::read_3pdm() {
     }
 }
 
-double V2RDM::compute_ref_energy() {
-    std::string str = "Computing reference energy";
+bool V2RDM::read_cache(bool need_3pdm, const std::vector<uint64_t>& fingerprint) {
+    std::ifstream in(v2rdm_cache_file, std::ios::binary);
+    if (not in.good())
+        return false;
+
+    // header: tag, number of irreps, active orbitals per irrep, number of 3-RDM blocks
+    std::vector<uint64_t> header(nirrep_ + 3);
+    in.read(reinterpret_cast<char*>(header.data()), header.size() * sizeof(uint64_t));
+    if (not in.good() or header[0] != v2rdm_cache_tag or header[1] != nirrep_)
+        return false;
+    for (size_t h = 0; h < nirrep_; ++h) {
+        if (header[2 + h] != static_cast<uint64_t>(active_[h]))
+            return false;
+    }
+    size_t n3 = header[nirrep_ + 2];
+    if (need_3pdm and n3 == 0)
+        return false;
+
+    // fingerprint of the v2RDM files the cache was built from (2 words per file), the 3-RDM part
+    // is compared only if the 3-RDMs are needed
+    std::vector<uint64_t> cached_fp(2 * (d2_filename.size() + (n3 > 0 ? d3_filename.size() : 0)));
+    in.read(reinterpret_cast<char*>(cached_fp.data()), cached_fp.size() * sizeof(uint64_t));
+    if (not in.good() or
+        not std::equal(fingerprint.begin(), fingerprint.end(), cached_fp.begin())) {
+        outfile->Printf("\n  The v2RDM files changed since %s was written.",
+                        v2rdm_cache_file.c_str());
+        return false;
+    }
+
+    std::string str = "Reading cached RDMs from " + v2rdm_cache_file;
     outfile->Printf("\n  %-45s ...", str.c_str());
 
-    /* Eref = sum_{m} h^{m}_{m} + 0.5 * sum_{mn} v^{mn}_{mn}
-              + \sum_{uv} ( h^{u}_{v} + \sum_{m} v^{mu}_{mv} ) * D^{v}_{u}
-              + 0.25 * \sum_{uvxy} v^{xy}_{uv} * D^{uv}_{xy} */
-    double Eref = frozen_core_energy_ + molecule_->nuclear_repulsion_energy(
-                                            reference_wavefunction_->get_dipole_field_strength());
-    size_t ncore = core_mos_.size();
-    size_t nactv = actv_mos_.size();
-
-    // sum_{m} h^{m}_{m} + 0.5 * sum_{mn} v^{mn}_{mn}
-    for (size_t m = 0; m < ncore; ++m) {
-        size_t nm = core_mos_[m];
-        Eref += ints_->oei_a(nm, nm);
-        Eref += ints_->oei_b(nm, nm);
-
-        for (size_t n = 0; n < ncore; ++n) {
-            size_t nn = core_mos_[n];
-            Eref += 0.5 * ints_->aptei_aa(nm, nn, nm, nn);
-            Eref += 0.5 * ints_->aptei_bb(nm, nn, nm, nn);
-
-            Eref += 0.5 * ints_->aptei_ab(nm, nn, nm, nn);
-            Eref += 0.5 * ints_->aptei_ab(nn, nm, nn, nm);
+    size_t nactv = nactv_;
+    std::vector<ambit::Tensor> D2;
+    for (const std::string& name : {"D2aa", "D2ab", "D2bb"}) {
+        D2.push_back(
+            ambit::Tensor::build(ambit::CoreTensor, name, {nactv, nactv, nactv, nactv}));
+        auto& data = D2.back().data();
+        in.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(double));
+    }
+    std::vector<ambit::Tensor> D3;
+    if (need_3pdm) {
+        for (const std::string& name : {"D3aaa", "D3aab", "D3bba", "D3bbb"}) {
+            D3.push_back(ambit::Tensor::build(ambit::CoreTensor, name,
+                                              {nactv, nactv, nactv, nactv, nactv, nactv}));
+            auto& data = D3.back().data();
+            in.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(double));
         }
     }
+    if (not in.good()) {
+        outfile->Printf("    Failed.");
+        return false;
+    }
 
-    // \sum_{uv} ( h^{u}_{v} + \sum_{m} v^{mu}_{mv} ) * D^{v}_{u}
-    ambit::Tensor sum = ambit::Tensor::build(ambit::CoreTensor, "sum_a", {nactv, nactv});
-    sum.iterate([&](const std::vector<size_t>& i, double& value) {
-        size_t nu = actv_mos_[i[0]];
-        size_t nv = actv_mos_[i[1]];
-        value = ints_->oei_a(nu, nv);
+    D2_ = D2;
+    D3_ = D3;
+    outfile->Printf("    Done.");
+    return true;
+}
 
-        for (size_t m = 0; m < ncore; ++m) {
-            size_t nm = core_mos_[m];
-            value += ints_->aptei_aa(nm, nu, nm, nv);
-            value += ints_->aptei_ab(nu, nm, nv, nm);
-        }
-    });
-    Eref += sum("uv") * D1a_("uv");
-
-    sum.zero();
-    sum.iterate([&](const std::vector<size_t>& i, double& value) {
-        size_t nu = actv_mos_[i[0]];
-        size_t nv = actv_mos_[i[1]];
-        value = ints_->oei_b(nu, nv);
-
-        for (size_t m = 0; m < ncore; ++m) {
-            size_t nm = core_mos_[m];
-            value += ints_->aptei_bb(nm, nu, nm, nv);
-            value += ints_->aptei_ab(nm, nu, nm, nv);
+void V2RDM::write_cache(const std::vector<uint64_t>& fingerprint) {
+    std::string str = "Writing RDMs to " + v2rdm_cache_file;
+    outfile->Printf("\n  %-45s ...", str.c_str());
+
+    std::vector<uint64_t> header{v2rdm_cache_tag, nirrep_};
+    for (size_t h = 0; h < nirrep_; ++h) {
+        header.push_back(active_[h]);
+    }
+    header.push_back(D3_.size());
+    header.insert(header.end(), fingerprint.begin(), fingerprint.end());
+
+    std::ofstream out(v2rdm_cache_file, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(header.data()), header.size() * sizeof(uint64_t));
+    for (const auto& blocks : {D2_, D3_}) {
+        for (const auto& D : blocks) {
+            const auto& data = D.data();
+            out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
         }
-    });
-    Eref += sum("uv") * D1b_("uv");
+    }
+    outfile->Printf(out.good() ? "    Done." : "    Failed.");
+}
 
-    // 0.25 * \sum_{uvxy} v^{xy}_{uv} * D^{uv}_{xy}
-    ambit::Tensor& D2aa = D2_[0];
-    ambit::Tensor& D2ab = D2_[1];
-    ambit::Tensor& D2bb = D2_[2];
-    sum = ambit::Tensor::build(ambit::CoreTensor, "sum_aa", {nactv, nactv, nactv, nactv});
-    sum.iterate([&](const std::vector<size_t>& i, double& value) {
-        size_t nu = actv_mos_[i[0]];
-        size_t nv = actv_mos_[i[1]];
-        size_t nx = actv_mos_[i[2]];
-        size_t ny = actv_mos_[i[3]];
-        value = ints_->aptei_aa(nu, nv, nx, ny);
-    });
-    Eref += 0.25 * sum("uvxy") * D2aa("uvxy");
-
-    sum.zero();
-    sum.iterate([&](const std::vector<size_t>& i, double& value) {
-        size_t nu = actv_mos_[i[0]];
-        size_t nv = actv_mos_[i[1]];
-        size_t nx = actv_mos_[i[2]];
-        size_t ny = actv_mos_[i[3]];
-        value = ints_->aptei_bb(nu, nv, nx, ny);
-    });
-    Eref += 0.25 * sum("uvxy") * D2bb("uvxy");
-
-    sum.zero();
-    sum.iterate([&](const std::vector<size_t>& i, double& value) {
-        size_t nu = actv_mos_[i[0]];
-        size_t nv = actv_mos_[i[1]];
-        size_t nx = actv_mos_[i[2]];
-        size_t ny = actv_mos_[i[3]];
-        value = ints_->aptei_ab(nu, nv, nx, ny);
-    });
-    Eref += sum("uvxy") * D2ab("uvxy");
+double V2RDM::compute_ref_energy() {
+    std::string str = "Computing reference energy";
+    outfile->Printf("\n  %-45s ...", str.c_str());
+
+    /* E = E_nuc + E_scalar + E_core + \sum_{uv} h^{u}_{v} * D^{v}_{u}
+           + 0.25 * \sum_{uvxy} v^{xy}_{uv} * D^{uv}_{xy}
+       where h is dressed by the core orbitals */
+    double Eref = as_ints_->nuclear_repulsion_energy() + as_ints_->scalar_energy() +
+                  as_ints_->frozen_core_energy();
+
+    size_t nactv = nactv_;
+    auto build = [nactv](const std::string& name, size_t rank, const std::vector<double>& data) {
+        ambit::Tensor T =
+            ambit::Tensor::build(ambit::CoreTensor, name, std::vector<size_t>(rank, nactv));
+        T.data() = data;
+        return T;
+    };
+    ambit::Tensor oei_a = build("oei_a", 2, as_ints_->oei_a_vector());
+    ambit::Tensor oei_b = build("oei_b", 2, as_ints_->oei_b_vector());
+    Eref += oei_a("uv") * D1a_("uv");
+    Eref += oei_b("uv") * D1b_("uv");
+
+    ambit::Tensor tei_aa = build("tei_aa", 4, as_ints_->tei_aa_vector());
+    ambit::Tensor tei_ab = build("tei_ab", 4, as_ints_->tei_ab_vector());
+    ambit::Tensor tei_bb = build("tei_bb", 4, as_ints_->tei_bb_vector());
+    Eref += 0.25 * tei_aa("uvxy") * D2_[0]("uvxy");
+    Eref += tei_ab("uvxy") * D2_[1]("uvxy");
+    Eref += 0.25 * tei_bb("uvxy") * D2_[2]("uvxy");
 
     outfile->Printf("    Done.");
     return Eref;
 }
 
-std::shared_ptr<RDMs> V2RDM::reference() {
-    std::string str = "Converting to RDMs";
-    outfile->Printf("\n  %-45s ...", str.c_str());
-    // if 3-RDMs are needed
-    if (options_.get_str("THREEPDC") != "ZERO") {
-        auto return_ref = std::make_shared<RDMsSpinDependent>(D1a_, D1b_, D2_[0], D2_[1], D2_[3],
-                                                              D3_[0], D3_[1], D3_[2], D3_[3]);
-        if (options_.get_str("WRITE_DENSITY_TYPE") == "CUMULANT") {
-            write_density_to_file();
-        }
+std::vector<std::shared_ptr<RDMs>>
+V2RDM::rdms(const std::vector<std::pair<size_t, size_t>>& root_list, int max_rdm_level,
+            RDMsType type) {
+    if (max_rdm_level == 3 and not do_3pdm_) {
+        throw std::runtime_error("V2RDM: the 3-RDMs were not read (THREEPDC = ZERO)");
+    }
 
-        outfile->Printf("    Done.");
-        return return_ref;
+    std::shared_ptr<RDMs> rdms;
+    if (max_rdm_level == 1) {
+        rdms = std::make_shared<RDMsSpinDependent>(D1a_, D1b_);
+    } else if (max_rdm_level == 2) {
+        rdms = std::make_shared<RDMsSpinDependent>(D1a_, D1b_, D2_[0], D2_[1], D2_[2]);
     } else {
-        auto return_ref = std::make_shared<RDMsSpinDependent>(D1a_, D1b_, D2_[0], D2_[1], D2_[3]);
-        if (options_.get_str("WRITE_DENSITY_TYPE") == "CUMULANT") {
-            write_density_to_file();
+        rdms = std::make_shared<RDMsSpinDependent>(D1a_, D1b_, D2_[0], D2_[1], D2_[2], D3_[0],
+                                                   D3_[1], D3_[2], D3_[3]);
+    }
+
+    if (type == RDMsType::spin_free) {
+        if (max_rdm_level == 1) {
+            rdms = std::make_shared<RDMsSpinFree>(rdms->SF_G1());
+        } else if (max_rdm_level == 2) {
+            rdms = std::make_shared<RDMsSpinFree>(rdms->SF_G1(), rdms->SF_G2());
+        } else {
+            rdms = std::make_shared<RDMsSpinFree>(rdms->SF_G1(), rdms->SF_G2(), rdms->SF_G3());
         }
-        outfile->Printf("    Done.");
-        return return_ref;
     }
+
+    // v2RDM provides the densities of a single state
+    return std::vector<std::shared_ptr<RDMs>>(root_list.size(), rdms);
+}
+
+std::vector<std::shared_ptr<RDMs>>
+V2RDM::transition_rdms(const std::vector<std::pair<size_t, size_t>>&,
+                       std::shared_ptr<ActiveSpaceMethod>, int, RDMsType) {
+    throw std::runtime_error("V2RDM::transition_rdms is not implemented!");
+    return std::vector<std::shared_ptr<RDMs>>();
 }
 
 void V2RDM::write_density_to_file() {
     std::string str = "Writing density matrices to files";
     outfile->Printf("\n  %-45s ...", str.c_str());
 
-    std::vector<std::string> filenames;
-    if (options_.get_str("WRITE_DENSITY_TYPE") == "DENSITY") {
-        for (const std::string& spin : {"a", "b"}) {
-            filenames.push_back("file_opdm_" + spin);
-        }
-        for (const std::string& spin : {"aa", "ab", "bb"}) {
-            filenames.push_back("file_2pdm_" + spin);
+    int level = do_3pdm_ ? 3 : 2;
+    auto ref = rdms({{0, 0}}, level, RDMsType::spin_dependent)[0];
+
+    std::vector<std::pair<std::string, ambit::Tensor>> blocks;
+    if (write_density_type_ == "DENSITY") {
+        blocks = {{"file_opdm_a", ref->g1a()},   {"file_opdm_b", ref->g1b()},
+                  {"file_2pdm_aa", ref->g2aa()}, {"file_2pdm_ab", ref->g2ab()},
+                  {"file_2pdm_bb", ref->g2bb()}};
+        if (level == 3) {
+            blocks.insert(blocks.end(), {{"file_3pdm_aaa", ref->g3aaa()},
+                                         {"file_3pdm_aab", ref->g3aab()},
+                                         {"file_3pdm_abb", ref->g3abb()},
+                                         {"file_3pdm_bbb", ref->g3bbb()}});
         }
-        for (const std::string& spin : {"aaa", "aab", "abb", "bbb"}) {
-            filenames.push_back("file_3pdm_" + spin);
-        }
-    } else if (options_.get_str("WRITE_DENSITY_TYPE") == "CUMULANT") {
-        for (const std::string& spin : {"a", "b"}) {
-            filenames.push_back("file_opdc_" + spin);
-        }
-        for (const std::string& spin : {"aa", "ab", "bb"}) {
-            filenames.push_back("file_2pdc_" + spin);
-        }
-        for (const std::string& spin : {"aaa", "aab", "abb", "bbb"}) {
-            filenames.push_back("file_3pdc_" + spin);
+    } else if (write_density_type_ == "CUMULANT") {
+        blocks = {{"file_opdc_a", ref->L1a()},   {"file_opdc_b", ref->L1b()},
+                  {"file_2pdc_aa", ref->L2aa()}, {"file_2pdc_ab", ref->L2ab()},
+                  {"file_2pdc_bb", ref->L2bb()}};
+        if (level == 3) {
+            blocks.insert(blocks.end(), {{"file_3pdc_aaa", ref->L3aaa()},
+                                         {"file_3pdc_aab", ref->L3aab()},
+                                         {"file_3pdc_abb", ref->L3abb()},
+                                         {"file_3pdc_bbb", ref->L3bbb()}});
         }
     }
 
-    std::ofstream outfstr;
-    outfstr.open(filenames[0]);
-    D1a_.iterate([&](const std::vector<size_t>& i, double& value) {
-        outfstr << fmt::format("{:>4} {:>4}  {:>20.15f}\n", i[0], i[1], value);
-    });
-    outfstr.close();
-    outfstr.clear();
-    outfstr.open(filenames[1]);
-    D1b_.iterate([&](const std::vector<size_t>& i, double& value) {
-        outfstr << fmt::format("{:>4} {:>4}  {:>20.15f}\n", i[0], i[1], value);
-    });
-    outfstr.close();
-    outfstr.clear();
-
-    for (int m = 0; m < 3; ++m) {
-        outfstr.open(filenames[m + 2]);
-
-        ambit::Tensor& D2 = D2_[m];
-        D2.iterate([&](const std::vector<size_t>& i, double& value) {
-            outfstr << fmt::format("{:>4} {:>4} {:>4} {:>4}  {:>20.15f}\n", i[0], i[1], i[2], i[3],
-                                   value);
+    for (auto& [filename, D] : blocks) {
+        std::ofstream outfstr(filename);
+        D.iterate([&](const std::vector<size_t>& i, double& value) {
+            for (size_t k : i) {
+                outfstr << fmt::format("{:>4} ", k);
+            }
+            outfstr << fmt::format(" {:>20.15f}\n", value);
         });
-
-        outfstr.close();
-        outfstr.clear();
     }
 
-    if (options_.get_str("THREEPDC") != "ZERO") {
-        for (int m = 0; m < 4; ++m) {
-            outfstr.open(filenames[m + 5]);
-
-            ambit::Tensor& D3 = D3_[m];
-            D3.iterate([&](const std::vector<size_t>& i, double& value) {
-                outfstr << fmt::format("{:>4} {:>4} {:>4} {:>4} {:>4} {:>4}  {:>20.15f}\n", i[0],
-                                       i[1], i[2], i[3], i[4], i[5], value);
-            });
+    outfile->Printf("    Done.");
+}
 
-            outfstr.close();
-            outfstr.clear();
-        }
+void write_v2rdm_densities(std::shared_ptr<RDMs> rdms, std::shared_ptr<MOSpaceInfo> mo_space_info) {
+    if (rdms->rdm_type() != RDMsType::spin_dependent or rdms->max_rdm_level() < 2) {
+        throw std::runtime_error("write_v2rdm_densities: spin-dependent 2- or 3-RDMs are required");
     }
+    // relative active index -> absolute index
+    std::vector<size_t> actv = mo_space_info->absolute_mo("ACTIVE");
+    size_t nactv = actv.size();
+    std::shared_ptr<PSIO> psio(new PSIO());
 
-    outfile->Printf("    Done.");
+    // store the nonzero elements of a block as (absolute indices, value) records
+    auto write_file = [&](unsigned int file, const std::string& label, ambit::Tensor D,
+                          auto make_record) {
+        std::vector<decltype(make_record(std::vector<size_t>(), 0.0))> records;
+        D.iterate([&](const std::vector<size_t>& i, double& value) {
+            if (value != 0.0)
+                records.push_back(make_record(i, value));
+        });
+        long int nline = records.size();
+        psio_address addr = PSIO_ZERO;
+        psio->open(file, PSIO_OPEN_NEW);
+        psio->write_entry(file, "length", (char*)&nline, sizeof(long int));
+        psio->write(file, label.c_str(), (char*)records.data(), nline * sizeof(records[0]), addr,
+                    &addr);
+        psio->close(file, 1);
+    };
+    auto mo = [&](size_t u) { return static_cast<int>(actv[u]); };
+    auto d2 = [&](const std::vector<size_t>& i, double value) {
+        return tpdm{mo(i[0]), mo(i[1]), mo(i[2]), mo(i[3]), value};
+    };
+    auto d3 = [&](const std::vector<size_t>& i, double value) {
+        return dm3{mo(i[0]), mo(i[1]), mo(i[2]), mo(i[3]), mo(i[4]), mo(i[5]), value};
+    };
+
+    write_file(PSIF_V2RDM_D2AA, "D2aa", rdms->g2aa(), d2);
+    write_file(PSIF_V2RDM_D2AB, "D2ab", rdms->g2ab(), d2);
+    write_file(PSIF_V2RDM_D2BB, "D2bb", rdms->g2bb(), d2);
+
+    if (rdms->max_rdm_level() == 3) {
+        write_file(PSIF_V2RDM_D3AAA, "D3aaa", rdms->g3aaa(), d3);
+        write_file(PSIF_V2RDM_D3AAB, "D3aab", rdms->g3aab(), d3);
+        // D3bba[ijk][lmn] (i,j,l,m beta) is stored as D3abb[kij][nlm]
+        ambit::Tensor D3bba = ambit::Tensor::build(ambit::CoreTensor, "D3bba",
+                                                   std::vector<size_t>(6, nactv));
+        D3bba("ijklmn") = rdms->g3abb()("kijnlm");
+        write_file(PSIF_V2RDM_D3BBA, "D3bba", D3bba, d3);
+        write_file(PSIF_V2RDM_D3BBB, "D3bbb", rdms->g3bbb(), d3);
+    }
 }
 } // namespace forte
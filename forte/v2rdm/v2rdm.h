@@ -28,10 +28,10 @@
 
 #pragma once
 
-#include <map>
-#include "psi4/libmints/wavefunction.h"
+#include "psi4/libmints/dimension.h"
 #include "psi4/libpsio/psio.hpp"
-#include "integrals/integrals.h"
+
+#include "base_classes/active_space_method.h"
 #include "base_classes/rdms.h"
 
 #define PSIF_V2RDM_D2AA 270
@@ -42,40 +42,55 @@
 #define PSIF_V2RDM_D3BBA 275
 #define PSIF_V2RDM_D3BBB 276
 
-using namespace ambit;
-
 namespace forte {
 
-class V2RDM : public psi::Wavefunction {
+class ForteOptions;
+
+/**
+ * @class V2RDM
+ *
+ * @brief Active space method that reads the densities computed by v2RDM-CASSCF
+ *
+ * The 2- and 3-RDMs are read from the PSIO files written by v2RDM-CASSCF (tpdm_write and
+ * 3pdm_write), the 1-RDMs are obtained by partial trace of the 2-RDMs, and the energy is evaluated
+ * from the RDMs and the active space integrals.
+ */
+class V2RDM : public ActiveSpaceMethod {
   public:
+    // ==> Class Constructor and Destructor <==
     /**
-     * V2RDM Constructor
-     * @param ref_wfn The reference wavefunction object
-     * @param options The main options object
-     * @param ints A pointer to an allocated integral object
-     * @param mo_space_info The MOSpaceInfo object
+     * @brief V2RDM Constructor
+     * @param state the electronic state to compute
+     * @param nroot the number of roots
+     * @param mo_space_info a MOSpaceInfo object that defines the orbital spaces
+     * @param as_ints molecular integrals defined only for the active space orbitals
      */
-    V2RDM(psi::SharedWavefunction ref_wfn, psi::Options& options,
-          std::shared_ptr<ForteIntegrals> ints, std::shared_ptr<MOSpaceInfo> mo_space_info);
+    V2RDM(StateInfo state, size_t nroot, std::shared_ptr<MOSpaceInfo> mo_space_info,
+          std::shared_ptr<ActiveSpaceIntegrals> as_ints);
 
-    /// Destructor
-    ~V2RDM();
+    ~V2RDM() = default;
 
-    /// Returns the reference object of forte
-    std::shared_ptr<RDMs> reference();
+    // ==> Class Interface <==
 
-  protected:
-    /// Start-up function called in the constructor
-    void startup();
+    /// Read the v2RDM densities and compute the energy
+    double compute_energy() override;
 
-    /// The molecular integrals
-    std::shared_ptr<ForteIntegrals> ints_;
+    /// Returns the reduced density matrices up to a given rank (max_rdm_level)
+    std::vector<std::shared_ptr<RDMs>> rdms(const std::vector<std::pair<size_t, size_t>>& root_list,
+                                            int max_rdm_level, RDMsType type) override;
 
-    /// The frozen-core energy
-    double frozen_core_energy_;
+    /// Returns the transition reduced density matrices (not available for v2RDM)
+    std::vector<std::shared_ptr<RDMs>>
+    transition_rdms(const std::vector<std::pair<size_t, size_t>>& root_list,
+                    std::shared_ptr<ActiveSpaceMethod> method2, int max_rdm_level,
+                    RDMsType type) override;
 
-    /// MO space info
-    std::shared_ptr<MOSpaceInfo> mo_space_info_;
+    /// Set the options
+    void set_options(std::shared_ptr<ForteOptions> options) override;
+
+  private:
+    /// Start-up function called in the constructor
+    void startup();
 
     /// Number of irrep
     size_t nirrep_;
@@ -87,13 +102,23 @@ class V2RDM : public psi::Wavefunction {
     psi::Dimension rdoccpi_;
     /// Active per irrep
     psi::Dimension active_;
-    /// Map active absolute index to relative index
-    std::map<size_t, size_t> abs_to_rel_;
-
-    /// List of core MOs
-    std::vector<size_t> core_mos_;
-    /// List of active MOs
-    std::vector<size_t> actv_mos_;
+    /// Number of active orbitals
+    size_t nactv_;
+    /// Number of active alpha electrons
+    size_t na_;
+    /// Number of active beta electrons
+    size_t nb_;
+    /// Map absolute index to relative active index (nactv_ for non-active orbitals)
+    std::vector<size_t> abs_to_rel_vec_;
+
+    /// Read and use the 3-RDMs
+    bool do_3pdm_ = true;
+    /// Average the alpha and beta densities
+    bool avg_dens_spin_ = false;
+    /// Cache the active-space densities in a binary file
+    bool cache_rdms_ = false;
+    /// Write densities (DENSITY) or cumulants (CUMULANT) to text files
+    std::string write_density_type_ = "NONE";
 
     /// Read two particle density
     void read_2pdm();
@@ -101,8 +126,19 @@ class V2RDM : public psi::Wavefunction {
     void build_opdm();
     /// Read three particle density
     void read_3pdm();
-
-    /// Compute the reference energy
+    /// Average the alpha and beta two particle densities
+    void average_2pdm();
+    /// Average the alpha and beta three particle densities
+    void average_3pdm();
+
+    /// Fingerprint of the v2RDM files: the number of records and a checksum of the first records
+    std::vector<uint64_t> fingerprint(bool need_3pdm);
+    /// Read the active-space densities from the binary cache, return false if not usable
+    bool read_cache(bool need_3pdm, const std::vector<uint64_t>& fingerprint);
+    /// Write the active-space densities to the binary cache
+    void write_cache(const std::vector<uint64_t>& fingerprint);
+
+    /// Compute the energy from the densities and the active space integrals
     double compute_ref_energy();
 
     /// One particle density matrix (active only)
@@ -121,4 +157,11 @@ class V2RDM : public psi::Wavefunction {
     /// 3PDM: file_3pdm_aaa, file_3pdm_aab, file_3pdm_abb, file_3pdm_bbb
     void write_density_to_file();
 };
+
+/**
+ * @brief Write spin-dependent RDMs to the PSIO files in the format of v2RDM-CASSCF
+ * @param rdms the active space RDMs (level 2 or 3)
+ * @param mo_space_info the MOSpaceInfo object used to map active to absolute indices
+ */
+void write_v2rdm_densities(std::shared_ptr<RDMs> rdms, std::shared_ptr<MOSpaceInfo> mo_space_info);
 } // namespace forte
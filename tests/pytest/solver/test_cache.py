@@ -0,0 +1,100 @@
+"""Test caching of the outputs of the solver graph."""
+
+import numpy as np
+import pytest
+
+from forte.cache import Cache
+from forte.solvers import solver_factory, HF, ActiveSpaceSolver, run_graph
+
+
+xyz = """
+H 0.0 0.0 0.0
+H 0.0 0.0 1.0
+"""
+
+
+def make_graph(cache):
+    input = solver_factory(molecule=xyz, basis="cc-pVDZ", cache=cache)
+    state = input.state(charge=0, multiplicity=1, sym="ag")
+    hf = HF(input, state=state)
+    # two active space solvers that share the same orbitals
+    mo_spaces_1 = input.mo_spaces(active=[1, 0, 0, 0, 0, 1, 0, 0])
+    mo_spaces_2 = input.mo_spaces(active=[2, 0, 0, 0, 0, 2, 0, 0])
+    fci_1 = ActiveSpaceSolver(hf, type="FCI", states={state: 2}, mo_spaces=mo_spaces_1)
+    fci_2 = ActiveSpaceSolver(hf, type="FCI", states={state: 1}, mo_spaces=mo_spaces_2)
+    return state, hf, fci_1, fci_2
+
+
+def test_cache(tmp_path):
+    """Test that a second evaluation of the same graph reads the results from the cache."""
+
+    cache = Cache(str(tmp_path))
+
+    state, hf, fci_1, fci_2 = make_graph(cache)
+    run_graph([fci_1, fci_2])
+    assert not hf.from_cache
+    assert not fci_1.from_cache
+    assert not fci_2.from_cache
+
+    # rebuild the same graph and run it again
+    state, hf_c, fci_1c, fci_2c = make_graph(cache)
+    run_graph([fci_1c, fci_2c])
+    assert hf_c.from_cache
+    assert fci_1c.from_cache
+    assert fci_2c.from_cache
+
+    assert hf_c.value("hf energy") == pytest.approx(hf.value("hf energy"), 1.0e-12)
+    for fci, fci_c in [(fci_1, fci_1c), (fci_2, fci_2c)]:
+        ref_energy = fci.value("active space energy")[state]
+        assert fci_c.value("active space energy")[state] == pytest.approx(ref_energy, 1.0e-12)
+
+        # the integrals, RDMs, and CI vectors are restored together with the energies
+        for label in ["active space integrals", "active space rdms"]:
+            for name, value in fci.value(label).items():
+                assert np.allclose(fci_c.value(label)[name], value, atol=1.0e-12)
+        assert np.allclose(np.abs(fci_c.value("ci vectors")[state]), np.abs(fci.value("ci vectors")[state]))
+
+
+def test_run_graph_processes(tmp_path):
+    """Test that independent solvers run in separate processes give the same results."""
+
+    state, hf, fci_1, fci_2 = make_graph(Cache(str(tmp_path / "serial")))
+    run_graph([fci_1, fci_2])
+
+    # the two active space solvers are run by two processes and read back from the cache
+    state, hf_p, fci_1p, fci_2p = make_graph(Cache(str(tmp_path / "processes")))
+    run_graph([fci_1p, fci_2p], nprocs=2)
+    assert not hf_p.from_cache
+    assert fci_1p.from_cache
+    assert fci_2p.from_cache
+
+    for fci, fci_p in [(fci_1, fci_1p), (fci_2, fci_2p)]:
+        ref_energy = fci.value("active space energy")[state]
+        assert fci_p.value("active space energy")[state] == pytest.approx(ref_energy, 1.0e-10)
+
+
+def test_cache_key_options():
+    """Test that computations that differ only by their options have different keys."""
+    input = solver_factory(molecule=xyz, basis="cc-pVDZ", cache=False)
+    state = input.state(charge=0, multiplicity=1, sym="ag")
+    hf_pk = HF(input, state=state)
+    hf_df = HF(input, state=state, options={"SCF_TYPE": "DF"})
+    assert hf_pk.content_key() != hf_df.content_key()
+
+    mo_spaces = input.mo_spaces(active=[1, 0, 0, 0, 0, 1, 0, 0])
+    fci_1 = ActiveSpaceSolver(hf_pk, type="FCI", states={state: 1}, mo_spaces=mo_spaces)
+    fci_2 = ActiveSpaceSolver(
+        hf_pk, type="FCI", states={state: 1}, mo_spaces=mo_spaces, options={"DL_MAXITER": 10}
+    )
+    fci_3 = ActiveSpaceSolver(hf_df, type="FCI", states={state: 1}, mo_spaces=mo_spaces)
+    assert len({fci_1.content_key(), fci_2.content_key(), fci_3.content_key()}) == 3
+
+
+def test_cache_key():
+    """Test that cache keys do not depend on the order of dictionary entries."""
+    assert Cache.key({"a": 1, "b": 2.0}) == Cache.key({"b": 2.0, "a": 1})
+    assert Cache.key({"a": 1, "b": 2.0}) != Cache.key({"a": 1, "b": 2.0000001})
+
+
+if __name__ == "__main__":
+    test_cache_key()
@@ -170,5 +170,19 @@ def test_sparse_ci4():
     assert wfn[det("020")] == pytest.approx(0.676180171388, abs=1e-9)
     assert wfn[det("-+0")] == pytest.approx(0.016058887563, abs=1e-9)
 
+    # the compiled couplings are reused when only the amplitudes change and are recompiled when
+    # the state has determinants outside the support
+    factexp_otf = forte.SparseFactExp()
+    op = forte.SparseOperator(antihermitian=True)
+    op.add_term_from_str('[1a+ 0a-]', 0.3)
+    op.add_term_from_str('[1a+ 1b+ 0b- 0a-]', 0.2)
+    op.add_term_from_str('[1b+ 0b-]', -0.15)
+    op.add_term_from_str('[2a+ 2b+ 1b- 1a-]', 0.11)
+    for state in [ref, forte.StateVector({det("+-0"): 0.6, det("002"): 0.8}), ref]:
+        wfn = factexp.compute(op, state)
+        wfn_otf = factexp_otf.compute(op, state, algorithm='onthefly')
+        for d in ["200", "+-0", "-+0", "020", "002"]:
+            assert wfn[det(d)] == pytest.approx(wfn_otf[det(d)], abs=1e-9)
+
 
 test_sparse_ci4()